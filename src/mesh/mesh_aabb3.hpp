@@ -0,0 +1,209 @@
+#pragma once
+
+#include "mesh_vector3.hpp"
+
+namespace mesh
+{
+    namespace detail
+    {
+        /// Entry distance of one ray slab
+        ///
+        /// A ray parallel to a slab with its origin on a slab plane gives 0 * inf = NaN;
+        /// such a plane does not bound the ray, so NaN counts as -inf here and +inf in slab_far.
+        /// @param p_t1                 Distance to the lower plane
+        /// @param p_t2                 Distance to the upper plane
+        /// @return                     Entry distance
+        constexpr double slab_near(const double p_t1, const double p_t2)
+        {
+            return std::min(p_t1 == p_t1 ? p_t1 : -std::numeric_limits<double>::infinity(), p_t2 == p_t2 ? p_t2 : -std::numeric_limits<double>::infinity());
+        }
+
+        /// Exit distance of one ray slab (see slab_near)
+        /// @param p_t1                 Distance to the lower plane
+        /// @param p_t2                 Distance to the upper plane
+        /// @return                     Exit distance
+        constexpr double slab_far(const double p_t1, const double p_t2)
+        {
+            return std::max(p_t1 == p_t1 ? p_t1 : std::numeric_limits<double>::infinity(), p_t2 == p_t2 ? p_t2 : std::numeric_limits<double>::infinity());
+        }
+    }
+
+    /// 3D Axis-aligned bounding box
+    struct aabb3
+    {
+        /// Minimum corner
+        vector3 minimum;
+
+        /// Maximum corner
+        vector3 maximum;
+
+        /// Default constructor
+        aabb3() = default;
+
+        /// Construct a box from its minimum and maximum corners
+        /// @param p_minimum            Minimum corner
+        /// @param p_maximum            Maximum corner
+        constexpr explicit aabb3(const vector3& p_minimum, const vector3& p_maximum)
+            : minimum(p_minimum), maximum(p_maximum)
+        {
+        }
+
+        /// Construct an empty box ready to be expanded
+        /// @return                     Empty box
+        static constexpr aabb3 empty()
+        {
+            return aabb3{
+                vector3{ std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() },
+                vector3{ -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() }
+            };
+        }
+
+        /// Check if box is empty
+        /// @return                     True if empty
+        constexpr bool is_empty() const
+        {
+            return minimum.x > maximum.x || minimum.y > maximum.y || minimum.z > maximum.z;
+        }
+
+        /// Calculate box center
+        /// @return                     Center point
+        constexpr vector3 center() const
+        {
+            return (minimum + maximum) * 0.5;
+        }
+
+        /// Calculate box size
+        /// @return                     Size along each axis
+        constexpr vector3 size() const
+        {
+            return maximum - minimum;
+        }
+
+        /// Calculate box surface area
+        /// @return                     Surface area
+        constexpr double surface_area() const
+        {
+            const vector3 s = size();
+            return 2.0 * (s.x * s.y + s.y * s.z + s.z * s.x);
+        }
+
+        /// Expand box to contain a point
+        /// @param p_point              Point to contain
+        constexpr void expand(const vector3& p_point)
+        {
+            minimum = vector3{ std::min(minimum.x, p_point.x), std::min(minimum.y, p_point.y), std::min(minimum.z, p_point.z) };
+            maximum = vector3{ std::max(maximum.x, p_point.x), std::max(maximum.y, p_point.y), std::max(maximum.z, p_point.z) };
+        }
+
+        /// Expand box to contain another box
+        /// @param p_box                Box to contain
+        constexpr void expand(const aabb3& p_box)
+        {
+            minimum = vector3{ std::min(minimum.x, p_box.minimum.x), std::min(minimum.y, p_box.minimum.y), std::min(minimum.z, p_box.minimum.z) };
+            maximum = vector3{ std::max(maximum.x, p_box.maximum.x), std::max(maximum.y, p_box.maximum.y), std::max(maximum.z, p_box.maximum.z) };
+        }
+
+        /// Calculate box grown by a margin on every side
+        /// @param p_margin             Margin to grow by
+        /// @return                     Grown box
+        constexpr aabb3 grown(const double p_margin) const
+        {
+            return aabb3{ minimum - vector3{ p_margin, p_margin, p_margin }, maximum + vector3{ p_margin, p_margin, p_margin } };
+        }
+
+        /// Check if box contains a point
+        /// @param p_point              Point to test
+        /// @return                     True if contained
+        constexpr bool contains(const vector3& p_point) const
+        {
+            return p_point.x >= minimum.x && p_point.x <= maximum.x &&
+                p_point.y >= minimum.y && p_point.y <= maximum.y &&
+                p_point.z >= minimum.z && p_point.z <= maximum.z;
+        }
+
+        /// Check if box intersects another box
+        /// @param p_box                Box to test
+        /// @return                     True if intersecting
+        constexpr bool intersects(const aabb3& p_box) const
+        {
+            return minimum.x <= p_box.maximum.x && maximum.x >= p_box.minimum.x &&
+                minimum.y <= p_box.maximum.y && maximum.y >= p_box.minimum.y &&
+                minimum.z <= p_box.maximum.z && maximum.z >= p_box.minimum.z;
+        }
+
+        /// Calculate closest point in box to a point
+        /// @param p_point              Point to clamp
+        /// @return                     Closest point
+        constexpr vector3 closest_point(const vector3& p_point) const
+        {
+            return vector3{
+                std::min(std::max(p_point.x, minimum.x), maximum.x),
+                std::min(std::max(p_point.y, minimum.y), maximum.y),
+                std::min(std::max(p_point.z, minimum.z), maximum.z)
+            };
+        }
+
+        /// Calculate squared distance from box to point
+        /// @param p_point              Point to measure
+        /// @return                     Squared distance (zero if inside)
+        constexpr double distance2_to(const vector3& p_point) const
+        {
+            return (closest_point(p_point) - p_point).length2();
+        }
+
+        /// Intersect ray with box (slab test)
+        /// @param p_origin             Ray origin
+        /// @param p_inv_direction      Reciprocal of the ray direction
+        /// @param p_max_distance       Maximum distance along the ray
+        /// @param p_distance           Optional entry distance
+        /// @return                     True if intersection
+        constexpr bool intersect_ray_inv(const vector3& p_origin, const vector3& p_inv_direction, const double p_max_distance, double* p_distance = nullptr) const
+        {
+            const double tx1 = (minimum.x - p_origin.x) * p_inv_direction.x;
+            const double tx2 = (maximum.x - p_origin.x) * p_inv_direction.x;
+            const double ty1 = (minimum.y - p_origin.y) * p_inv_direction.y;
+            const double ty2 = (maximum.y - p_origin.y) * p_inv_direction.y;
+            const double tz1 = (minimum.z - p_origin.z) * p_inv_direction.z;
+            const double tz2 = (maximum.z - p_origin.z) * p_inv_direction.z;
+
+            const double t_near = std::max(std::max(detail::slab_near(tx1, tx2), detail::slab_near(ty1, ty2)), std::max(detail::slab_near(tz1, tz2), 0.0));
+            const double t_far = std::min(std::min(detail::slab_far(tx1, tx2), detail::slab_far(ty1, ty2)), std::min(detail::slab_far(tz1, tz2), p_max_distance));
+            if (t_near > t_far)
+                return false;
+
+            if (p_distance)
+                *p_distance = t_near;
+
+            return true;
+        }
+
+        /// Intersect ray with box
+        /// @param p_origin             Ray origin
+        /// @param p_direction          Ray direction
+        /// @param p_distance           Optional entry distance
+        /// @return                     True if intersection
+        constexpr bool intersect_ray(const vector3& p_origin, const vector3& p_direction, double* p_distance = nullptr) const
+        {
+            const vector3 inv{ 1.0 / p_direction.x, 1.0 / p_direction.y, 1.0 / p_direction.z };
+            return intersect_ray_inv(p_origin, inv, std::numeric_limits<double>::infinity(), p_distance);
+        }
+
+        /// Box equality operator
+        /// @param p_a                  First box to compare
+        /// @param p_b                  Second box to compare
+        /// @return                     True if equal
+        friend constexpr bool operator==(const aabb3& p_a, const aabb3& p_b)
+        {
+            return p_a.minimum == p_b.minimum && p_a.maximum == p_b.maximum;
+        }
+
+        /// Box inequality operator
+        /// @param p_a                  First box to compare
+        /// @param p_b                  Second box to compare
+        /// @return                     True if not equal
+        friend constexpr bool operator!=(const aabb3& p_a, const aabb3& p_b)
+        {
+            return p_a.minimum != p_b.minimum || p_a.maximum != p_b.maximum;
+        }
+    };
+}
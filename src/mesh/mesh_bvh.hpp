@@ -0,0 +1,1159 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+#include "mesh_ray_packet.hpp"
+
+namespace mesh
+{
+    /// Options for building a bounding volume hierarchy
+    struct bvh_options
+    {
+        /// Maximum number of triangles in a leaf (larger leaves only when triangles cannot be split)
+        std::uint32_t max_leaf_size = 4;
+
+        /// Number of bins per axis when evaluating the surface area heuristic
+        std::uint32_t bins = 16;
+    };
+
+    /// Bounding volume hierarchy node
+    ///
+    /// Leaves hold count triangles starting at first. Internal nodes have a zero
+    /// count and children at first and first + 1.
+    struct bvh_node
+    {
+        aabb3 bounds;                   ///< Bounds of everything below the node
+        std::uint32_t first = 0;        ///< First triangle (leaf) or left child (internal)
+        std::uint32_t count = 0;        ///< Number of triangles (zero for internal nodes)
+
+        /// Check if the node is a leaf
+        constexpr bool is_leaf() const
+        {
+            return count != 0;
+        }
+    };
+
+    /// Far-field expansion of a node's triangles for fast winding numbers
+    struct bvh_expansion
+    {
+        vector3 center;                 ///< Area-weighted centroid
+        vector3 normal;                 ///< Sum of area-weighted normals (first-order term)
+        double moment[9] = {};          ///< Sum of area-weighted normal times centroid offset (second-order term, row-major)
+        double radius = 0.0;            ///< Distance from the center to the farthest vertex
+        double area = 0.0;              ///< Total triangle area
+    };
+
+    /// Range of vertices whose positions changed
+    struct bvh_vertex_range
+    {
+        std::uint32_t first = 0;        ///< First vertex
+        std::uint32_t count = 0;        ///< Number of vertices
+    };
+
+    /// Options for refitting a hierarchy to moved vertices
+    struct bvh_refit_options
+    {
+        /// Rebuild a subtree once its share of the root's surface area has grown by this factor since it was built (zero never rebuilds)
+        double rebuild_threshold = 2.0;
+
+        /// Smallest subtree, in triangles, worth rebuilding
+        std::uint32_t min_rebuild_triangles = 32;
+    };
+
+    /// Outcome of a refit
+    struct bvh_refit_result
+    {
+        bool ok = false;                        ///< False if the mesh no longer matches the hierarchy
+        std::size_t refitted_triangles = 0;     ///< Triangles re-read from the mesh
+        std::size_t refitted_nodes = 0;         ///< Nodes whose bounds were recomputed
+        std::size_t rebuilt_subtrees = 0;       ///< Subtrees rebuilt because their quality degraded
+        std::size_t rebuilt_triangles = 0;      ///< Triangles in rebuilt subtrees
+    };
+
+    /// Result of a closest-point query
+    struct bvh_closest_hit
+    {
+        bool hit = false;               ///< True if a triangle was within range
+        vector3 point;                  ///< Closest surface point
+        double distance2 = std::numeric_limits<double>::infinity();    ///< Squared distance to the point
+        std::uint32_t triangle = 0;     ///< Mesh triangle index holding the point
+    };
+
+    /// Result of a ray query
+    struct bvh_ray_hit
+    {
+        bool hit = false;               ///< True if the ray hit a triangle
+        double distance = std::numeric_limits<double>::infinity();     ///< Distance along the ray
+        std::uint32_t triangle = 0;     ///< Mesh triangle index hit
+    };
+
+    /// Triangle bounding volume hierarchy for closest-point, ray and inside queries
+    ///
+    /// Built top-down with a binned surface area heuristic. Triangles are copied
+    /// into leaf order so leaf tests read contiguous memory. Every node also keeps
+    /// a second-order expansion of its triangles, giving fast generalized
+    /// winding numbers (Barill et al.): distant nodes contribute their expansion
+    /// and only nearby leaves are summed exactly.
+    ///
+    /// Meshes that deform without changing topology are handled with refit(),
+    /// which updates only the nodes above moved vertices and rebuilds subtrees
+    /// whose quality degraded too far.
+    class mesh_bvh
+    {
+    public:
+        /// Construct an empty hierarchy
+        mesh_bvh() = default;
+
+        /// Build a hierarchy over a mesh
+        /// @param p_mesh               Mesh to build over
+        /// @param p_options            Build options
+        explicit mesh_bvh(const indexed_mesh& p_mesh, const bvh_options& p_options = bvh_options{})
+        {
+            build(p_mesh, p_options);
+        }
+
+        /// Rebuild the hierarchy over a mesh
+        /// @param p_mesh               Mesh to build over
+        /// @param p_options            Build options
+        void build(const indexed_mesh& p_mesh, const bvh_options& p_options = bvh_options{})
+        {
+            MESH_PROFILE_SCOPE("bvh.build", p_mesh.triangle_count());
+            const std::size_t count = p_mesh.triangle_count();
+            m_options = p_options;
+            m_nodes.clear();
+            m_free_pairs.clear();
+            m_indices.resize(count);
+            m_triangles.resize(count);
+            m_vertex_start.clear();
+            m_vertex_triangles.clear();
+            m_build_cost = 0.0;
+            if (count == 0)
+            {
+                m_expansions.clear();
+                m_parents.clear();
+                m_depths.clear();
+                m_shares.clear();
+                m_slots.clear();
+                m_slot_leaf.clear();
+                return;
+            }
+
+            // Per-triangle bounds and centroids
+            std::vector<aabb3> boxes(count);
+            std::vector<vector3> centroids(count);
+            parallel_for(count, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t t = p_begin; t < p_end; ++t)
+                {
+                    const triangle3 tri = p_mesh.triangle(t);
+                    boxes[t] = aabb3::empty();
+                    boxes[t].expand(tri.point1);
+                    boxes[t].expand(tri.point2);
+                    boxes[t].expand(tri.point3);
+                    centroids[t] = (tri.point1 + tri.point2 + tri.point3) / 3.0;
+                    m_indices[t] = static_cast<std::uint32_t>(t);
+                }
+            }, 4096);
+
+            m_nodes.reserve(count * 2);
+            m_nodes.push_back(bvh_node{});
+            subdivide(0, 0, static_cast<std::uint32_t>(count), 0, boxes, centroids, p_options);
+
+            for (std::size_t i = 0; i < count; ++i)
+                m_triangles[i] = p_mesh.triangle(m_indices[i]);
+            compute_expansions();
+
+            // Refit lookups: node parents and depths, the leaf of every
+            // triangle and the triangles of every vertex
+            m_parents.clear();
+            m_depths.clear();
+            m_shares.clear();
+            m_node_stamp.clear();
+            resize_node_data();
+            m_slots.resize(count);
+            m_slot_leaf.resize(count);
+            m_slot_stamp.assign(count, 0);
+            m_epoch = 0;
+            m_parents[0] = no_node;
+            m_depths[0] = 0;
+            index_subtree(0);
+            for (std::size_t i = 0; i < count; ++i)
+                m_slots[m_indices[i]] = static_cast<std::uint32_t>(i);
+
+            m_vertex_start.assign(p_mesh.vertex_count() + 1, 0);
+            for (const std::uint32_t v : p_mesh.indices)
+                ++m_vertex_start[v + 1];
+            for (std::size_t v = 0; v < p_mesh.vertex_count(); ++v)
+                m_vertex_start[v + 1] += m_vertex_start[v];
+            m_vertex_triangles.resize(p_mesh.indices.size());
+            std::vector<std::uint32_t> fill(m_vertex_start.begin(), m_vertex_start.end() - 1);
+            for (std::size_t i = 0; i < p_mesh.indices.size(); ++i)
+                m_vertex_triangles[fill[p_mesh.indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+            m_build_cost = sah_cost();
+        }
+
+        /// Refit the hierarchy after every vertex moved
+        ///
+        /// The mesh must have the same vertex count and triangles as when the
+        /// hierarchy was built; only positions may change.
+        /// @param p_mesh               Mesh with updated positions
+        /// @param p_options            Refit options
+        /// @return                     Refit outcome
+        bvh_refit_result refit(const indexed_mesh& p_mesh, const bvh_refit_options& p_options = bvh_refit_options{})
+        {
+            bvh_refit_result result;
+            if (!matches(p_mesh))
+                return result;
+            result.ok = true;
+            if (m_nodes.empty())
+                return result;
+
+            MESH_PROFILE_SCOPE("bvh.refit", m_triangles.size());
+            parallel_for(m_triangles.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t i = p_begin; i < p_end; ++i)
+                    m_triangles[i] = p_mesh.triangle(m_indices[i]);
+            }, 4096);
+
+            const std::uint32_t epoch = next_epoch();
+            std::vector<std::vector<std::uint32_t>> levels(max_depth + 1);
+            for (std::uint32_t n = 0; n < m_nodes.size(); ++n)
+            {
+                if (m_depths[n] != free_depth)
+                {
+                    m_node_stamp[n] = epoch;
+                    levels[m_depths[n]].push_back(n);
+                }
+            }
+            result.refitted_triangles = m_triangles.size();
+            result.refitted_nodes = refit_levels(levels);
+            rebuild_degraded(levels, p_options, result);
+            return result;
+        }
+
+        /// Refit the hierarchy after some vertices moved
+        ///
+        /// Only triangles using the listed vertices are re-read, and only their
+        /// leaves and ancestors are updated, independent subtrees in parallel. The mesh
+        /// must have the same vertex count and triangles as when the hierarchy
+        /// was built; only positions may change.
+        /// @param p_mesh               Mesh with updated positions
+        /// @param p_ranges             Ranges of moved vertices (may overlap)
+        /// @param p_count              Number of ranges
+        /// @param p_options            Refit options
+        /// @return                     Refit outcome
+        bvh_refit_result refit(const indexed_mesh& p_mesh, const bvh_vertex_range* p_ranges, const std::size_t p_count, const bvh_refit_options& p_options = bvh_refit_options{})
+        {
+            bvh_refit_result result;
+            if (!matches(p_mesh))
+                return result;
+            result.ok = true;
+            if (m_nodes.empty())
+                return result;
+
+            // Collect the triangles using a moved vertex
+            const std::uint32_t epoch = next_epoch();
+            const std::size_t vertex_count = p_mesh.vertex_count();
+            std::vector<std::uint32_t> slots;
+            for (std::size_t r = 0; r < p_count; ++r)
+            {
+                const std::size_t first = std::min<std::size_t>(p_ranges[r].first, vertex_count);
+                const std::size_t last = std::min<std::size_t>(first + p_ranges[r].count, vertex_count);
+                for (std::size_t v = first; v < last; ++v)
+                {
+                    for (std::uint32_t k = m_vertex_start[v]; k < m_vertex_start[v + 1]; ++k)
+                    {
+                        const std::uint32_t slot = m_slots[m_vertex_triangles[k]];
+                        if (m_slot_stamp[slot] != epoch)
+                        {
+                            m_slot_stamp[slot] = epoch;
+                            slots.push_back(slot);
+                        }
+                    }
+                }
+            }
+
+            MESH_PROFILE_SCOPE("bvh.refit_partial", slots.size());
+            parallel_for(slots.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t i = p_begin; i < p_end; ++i)
+                    m_triangles[slots[i]] = p_mesh.triangle(m_indices[slots[i]]);
+            }, 4096);
+
+            // Their leaves and every ancestor, grouped by depth
+            std::vector<std::vector<std::uint32_t>> levels(max_depth + 1);
+            for (const std::uint32_t slot : slots)
+            {
+                for (std::uint32_t n = m_slot_leaf[slot]; n != no_node && m_node_stamp[n] != epoch; n = m_parents[n])
+                {
+                    m_node_stamp[n] = epoch;
+                    levels[m_depths[n]].push_back(n);
+                }
+            }
+            result.refitted_triangles = slots.size();
+            result.refitted_nodes = refit_levels(levels);
+            rebuild_degraded(levels, p_options, result);
+            return result;
+        }
+
+        /// Calculate the surface area heuristic cost of the hierarchy
+        ///
+        /// The expected number of node visits and triangle tests for a random
+        /// ray through the root bounds, counting both as one unit.
+        /// @return                     Cost (zero when empty)
+        double sah_cost() const
+        {
+            if (m_nodes.empty())
+                return 0.0;
+            const double root_area = m_nodes[0].bounds.surface_area();
+            if (!(root_area > 0.0))
+                return static_cast<double>(m_triangles.size());
+
+            double cost = 0.0;
+            std::uint32_t stack[stack_size];
+            std::size_t top = 0;
+            stack[top++] = 0;
+            while (top != 0)
+            {
+                const bvh_node& node = m_nodes[stack[--top]];
+                cost += node.bounds.surface_area() / root_area * (node.is_leaf() ? node.count : 1.0);
+                if (!node.is_leaf())
+                {
+                    stack[top++] = node.first;
+                    stack[top++] = node.first + 1;
+                }
+            }
+            return cost;
+        }
+
+        /// Get the hierarchy quality relative to its last full build
+        /// @return                     Current cost over the cost after build (one when unchanged, larger is worse)
+        double quality() const
+        {
+            return m_build_cost > 0.0 ? sah_cost() / m_build_cost : 1.0;
+        }
+
+        /// Get the nodes (the root is node zero)
+        ///
+        /// After partial rebuilds some node pairs may be unused; visit nodes from
+        /// the root rather than iterating the array.
+        const std::vector<bvh_node>& nodes() const
+        {
+            return m_nodes;
+        }
+
+        /// Get the triangles in leaf order
+        const std::vector<triangle3>& triangles() const
+        {
+            return m_triangles;
+        }
+
+        /// Get the mesh triangle index of each leaf-order triangle
+        const std::vector<std::uint32_t>& triangle_indices() const
+        {
+            return m_indices;
+        }
+
+        /// Get the far-field expansion of each node
+        const std::vector<bvh_expansion>& expansions() const
+        {
+            return m_expansions;
+        }
+
+        /// Check if the hierarchy holds no triangles
+        bool empty() const
+        {
+            return m_nodes.empty();
+        }
+
+        /// Find the closest surface point to a point
+        /// @param p_point              Query point
+        /// @param p_max_distance       Ignore triangles farther than this
+        /// @return                     Closest hit (hit is false if nothing is in range)
+        bvh_closest_hit closest_point(const vector3& p_point, const double p_max_distance = std::numeric_limits<double>::infinity()) const
+        {
+            MESH_PROFILE_COUNT("bvh.closest_point", 1);
+            bvh_closest_hit result;
+            result.distance2 = p_max_distance * p_max_distance;
+            if (m_nodes.empty() || m_nodes[0].bounds.distance2_to(p_point) > result.distance2)
+                return result;
+
+            std::uint32_t stack[stack_size];
+            std::size_t top = 0;
+            stack[top++] = 0;
+            while (top != 0)
+            {
+                const bvh_node& node = m_nodes[stack[--top]];
+                if (node.bounds.distance2_to(p_point) > result.distance2)
+                    continue;
+
+                if (node.is_leaf())
+                {
+                    vector3 closest;
+                    const std::size_t i = closest_triangle(m_triangles.data() + node.first, node.count, p_point, result.distance2, &closest);
+                    if (i != node.count)
+                    {
+                        result.hit = true;
+                        result.point = closest;
+                        result.triangle = m_indices[node.first + i];
+                    }
+                    continue;
+                }
+
+                // Visit the nearer child first
+                const double d_left = m_nodes[node.first].bounds.distance2_to(p_point);
+                const double d_right = m_nodes[node.first + 1].bounds.distance2_to(p_point);
+                if (d_left <= d_right)
+                {
+                    stack[top++] = node.first + 1;
+                    stack[top++] = node.first;
+                }
+                else
+                {
+                    stack[top++] = node.first;
+                    stack[top++] = node.first + 1;
+                }
+            }
+            return result;
+        }
+
+        /// Find the closest surface points to a batch of points in parallel
+        /// @param p_points             Query points
+        /// @param p_count              Number of points
+        /// @param p_results            Receives one hit per point
+        /// @param p_max_distance       Ignore triangles farther than this
+        void closest_points(const vector3* p_points, const std::size_t p_count, bvh_closest_hit* p_results, const double p_max_distance = std::numeric_limits<double>::infinity()) const
+        {
+            MESH_PROFILE_SCOPE("bvh.closest_points", p_count);
+            parallel_for(p_count, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t i = p_begin; i < p_end; ++i)
+                    p_results[i] = closest_point(p_points[i], p_max_distance);
+            }, 256);
+        }
+
+        /// Find the first triangle hit by a ray
+        /// @param p_origin             Ray origin
+        /// @param p_direction          Ray direction
+        /// @param p_max_distance       Maximum hit distance (in units of the direction length)
+        /// @return                     Closest hit (hit is false on a miss)
+        bvh_ray_hit intersect_ray(const vector3& p_origin, const vector3& p_direction, const double p_max_distance = std::numeric_limits<double>::infinity()) const
+        {
+            MESH_PROFILE_COUNT("bvh.intersect_ray", 1);
+            bvh_ray_hit result;
+            result.distance = p_max_distance;
+            if (m_nodes.empty())
+                return result;
+
+            const vector3 inv{ 1.0 / p_direction.x, 1.0 / p_direction.y, 1.0 / p_direction.z };
+            std::uint32_t stack[stack_size];
+            std::size_t top = 0;
+            stack[top++] = 0;
+            while (top != 0)
+            {
+                const bvh_node& node = m_nodes[stack[--top]];
+                if (!node.bounds.intersect_ray_inv(p_origin, inv, result.distance))
+                    continue;
+
+                if (node.is_leaf())
+                {
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                    {
+                        double dist = 0.0;
+                        if (m_triangles[i].intersect_ray(p_origin, p_direction, nullptr, &dist) && dist <= result.distance)
+                        {
+                            result.hit = true;
+                            result.distance = dist;
+                            result.triangle = m_indices[i];
+                        }
+                    }
+                    continue;
+                }
+
+                // Visit the child on the near side of the ray first
+                const bool left_first = p_direction.dot(m_nodes[node.first + 1].bounds.center() - m_nodes[node.first].bounds.center()) >= 0.0;
+                stack[top++] = left_first ? node.first + 1 : node.first;
+                stack[top++] = left_first ? node.first : node.first + 1;
+            }
+            return result;
+        }
+
+        /// Find the first triangle hit by every lane of a ray packet
+        ///
+        /// Coherent packets descend the hierarchy together, testing each box and
+        /// leaf triangle against the lanes still active below it. Packets whose
+        /// lanes disagree on direction signs, or that have a single active lane,
+        /// fall back to intersect_ray() per lane.
+        /// @param p_packet             Ray packet (maximum distances shrink to the hits found)
+        /// @param p_hit                Closest-hit results indexed by mesh triangle
+        /// @param p_active             Active lanes
+        /// @return                     Hit mask
+        template <std::size_t N>
+        ray_mask intersect_rays(ray_packet<N>& p_packet, ray_packet_hit<N>& p_hit, const ray_mask p_active = ray_packet<N>::all) const
+        {
+            MESH_PROFILE_COUNT("bvh.intersect_rays", mask_count(p_active));
+            if (m_nodes.empty() || p_active == 0)
+                return p_hit.mask & p_active;
+
+            // Incoherent lanes would disagree on the child order, so trace them one by one
+            if (mask_count(p_active) < 2 || !p_packet.is_coherent(p_active))
+            {
+                for (std::size_t lane = 0; lane < N; ++lane)
+                {
+                    if (!(p_active & (ray_mask{ 1 } << lane)))
+                        continue;
+
+                    const bvh_ray_hit hit = intersect_ray(p_packet.origin(lane), p_packet.direction(lane), p_packet.max_distance[lane]);
+                    if (hit.hit)
+                    {
+                        p_packet.max_distance[lane] = hit.distance;
+                        p_hit.distance[lane] = hit.distance;
+                        p_hit.index[lane] = hit.triangle;
+                        p_hit.mask |= ray_mask{ 1 } << lane;
+                    }
+                }
+                return p_hit.mask & p_active;
+            }
+
+            // Every lane shares the direction signs, so the first one orders the children
+            std::size_t lead = 0;
+            while (!(p_active & (ray_mask{ 1 } << lead)))
+                ++lead;
+            const vector3 direction = p_packet.direction(lead);
+
+            alignas(64) double dist[N];
+            std::pair<std::uint32_t, ray_mask> stack[stack_size];
+            std::size_t top = 0;
+            stack[top++] = std::make_pair(std::uint32_t{ 0 }, p_active);
+            while (top != 0)
+            {
+                const std::pair<std::uint32_t, ray_mask> entry = stack[--top];
+                const bvh_node& node = m_nodes[entry.first];
+                const ray_mask mask = p_packet.intersect_aabb(node.bounds, nullptr, entry.second);
+                if (mask == 0)
+                    continue;
+
+                if (node.is_leaf())
+                {
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                    {
+                        ray_mask hits = p_packet.intersect_triangle(m_triangles[i], dist, mask);
+                        for (; hits; hits &= hits - 1)
+                        {
+                            std::size_t lane = 0;
+                            while (!(hits & (ray_mask{ 1 } << lane)))
+                                ++lane;
+
+                            p_packet.max_distance[lane] = dist[lane];
+                            p_hit.distance[lane] = dist[lane];
+                            p_hit.index[lane] = m_indices[i];
+                            p_hit.mask |= ray_mask{ 1 } << lane;
+                        }
+                    }
+                    continue;
+                }
+
+                // Visit the child on the near side of the rays first
+                const bool left_first = direction.dot(m_nodes[node.first + 1].bounds.center() - m_nodes[node.first].bounds.center()) >= 0.0;
+                stack[top++] = std::make_pair(left_first ? node.first + 1 : node.first, mask);
+                stack[top++] = std::make_pair(left_first ? node.first : node.first + 1, mask);
+            }
+            return p_hit.mask & p_active;
+        }
+
+        /// Calculate the generalized winding number at a point
+        ///
+        /// Nodes whose expansion center is more than p_beta radii away contribute
+        /// their far-field term; larger values are more accurate and slower. The result is
+        /// near one inside a closed outward-facing mesh, near zero outside, and
+        /// degrades gracefully for meshes with holes.
+        /// @param p_point              Query point
+        /// @param p_beta               Accuracy parameter (distance in node radii)
+        /// @return                     Winding number
+        double winding_number(const vector3& p_point, const double p_beta = 2.0) const
+        {
+            MESH_PROFILE_COUNT("bvh.winding_number", 1);
+            if (m_nodes.empty())
+                return 0.0;
+
+            const double beta2 = p_beta * p_beta;
+            double sum = 0.0;
+            std::uint32_t stack[stack_size];
+            std::size_t top = 0;
+            stack[top++] = 0;
+            while (top != 0)
+            {
+                const std::uint32_t index = stack[--top];
+                const bvh_node& node = m_nodes[index];
+                const bvh_expansion& expansion = m_expansions[index];
+
+                // Far away: the expansion of the node's triangles
+                const vector3 r = expansion.center - p_point;
+                const double d2 = r.length2();
+                if (d2 > beta2 * expansion.radius * expansion.radius)
+                {
+                    const double inv_d2 = 1.0 / d2;
+                    const double inv_d3 = inv_d2 / std::sqrt(d2);
+                    const double* m = expansion.moment;
+                    const double trace = m[0] + m[4] + m[8];
+                    const double rmr = r.x * (m[0] * r.x + m[1] * r.y + m[2] * r.z) +
+                                       r.y * (m[3] * r.x + m[4] * r.y + m[5] * r.z) +
+                                       r.z * (m[6] * r.x + m[7] * r.y + m[8] * r.z);
+                    sum += (expansion.normal.dot(r) + trace - 3.0 * rmr * inv_d2) * inv_d3;
+                    continue;
+                }
+
+                if (node.is_leaf())
+                {
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                        sum += m_triangles[i].solid_angle(p_point);
+                    continue;
+                }
+
+                stack[top++] = node.first;
+                stack[top++] = node.first + 1;
+            }
+            return sum / (4.0 * 3.14159265358979323846);
+        }
+
+        /// Calculate winding numbers for a batch of points in parallel
+        /// @param p_points             Query points
+        /// @param p_count              Number of points
+        /// @param p_results            Receives one winding number per point
+        /// @param p_beta               Accuracy parameter (distance in node radii)
+        void winding_numbers(const vector3* p_points, const std::size_t p_count, double* p_results, const double p_beta = 2.0) const
+        {
+            MESH_PROFILE_SCOPE("bvh.winding_numbers", p_count);
+            parallel_for(p_count, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t i = p_begin; i < p_end; ++i)
+                    p_results[i] = winding_number(p_points[i], p_beta);
+            }, 256);
+        }
+
+        /// Check if a point is inside the mesh (winding number above one half)
+        /// @param p_point              Query point
+        /// @return                     True if inside
+        bool contains(const vector3& p_point) const
+        {
+            return winding_number(p_point) > 0.5;
+        }
+
+        /// Classify a batch of points as inside or outside in parallel
+        /// @param p_points             Query points
+        /// @param p_count              Number of points
+        /// @param p_results            Receives true for each inside point
+        /// @return                     Number of inside points
+        std::size_t contains(const vector3* p_points, const std::size_t p_count, bool* p_results) const
+        {
+            MESH_PROFILE_SCOPE("bvh.contains", p_count);
+            parallel_for(p_count, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t i = p_begin; i < p_end; ++i)
+                    p_results[i] = contains(p_points[i]);
+            }, 256);
+            return static_cast<std::size_t>(std::count(p_results, p_results + p_count, true));
+        }
+
+    private:
+        /// Deepest level split, keeping traversal stacks within stack_size entries
+        static constexpr std::uint32_t max_depth = 60;
+
+        /// Traversal stack capacity
+        static constexpr std::size_t stack_size = 64;
+
+        /// Parent of the root
+        static constexpr std::uint32_t no_node = UINT32_MAX;
+
+        /// Depth of unused nodes
+        static constexpr std::uint8_t free_depth = UINT8_MAX;
+
+        /// Depth whose subtrees are refitted in parallel
+        static constexpr std::size_t refit_split_depth = 8;
+
+        /// Check if a mesh has the layout the hierarchy was built from
+        bool matches(const indexed_mesh& p_mesh) const
+        {
+            return p_mesh.triangle_count() == m_triangles.size() && (m_nodes.empty() || p_mesh.vertex_count() + 1 == m_vertex_start.size());
+        }
+
+        /// Start a new round of slot and node stamps
+        std::uint32_t next_epoch()
+        {
+            if (++m_epoch == 0)
+            {
+                std::fill(m_slot_stamp.begin(), m_slot_stamp.end(), 0u);
+                std::fill(m_node_stamp.begin(), m_node_stamp.end(), 0u);
+                m_epoch = 1;
+            }
+            return m_epoch;
+        }
+
+        /// Size the per-node arrays to the node count
+        void resize_node_data()
+        {
+            m_expansions.resize(m_nodes.size());
+            m_parents.resize(m_nodes.size(), no_node);
+            m_depths.resize(m_nodes.size(), free_depth);
+            m_shares.resize(m_nodes.size(), 0.0);
+            m_node_stamp.resize(m_nodes.size(), 0);
+        }
+
+        /// Allocate a pair of sibling nodes, reusing pairs freed by rebuilds
+        std::uint32_t allocate_pair()
+        {
+            if (!m_free_pairs.empty())
+            {
+                const std::uint32_t pair = m_free_pairs.back();
+                m_free_pairs.pop_back();
+                return pair;
+            }
+            const std::uint32_t pair = static_cast<std::uint32_t>(m_nodes.size());
+            m_nodes.push_back(bvh_node{});
+            m_nodes.push_back(bvh_node{});
+            return pair;
+        }
+
+        /// Record parents, depths, area shares and triangle leaves below a node
+        ///
+        /// Also stamps the nodes with the current epoch. The node's own parent and
+        /// depth must already be set.
+        void index_subtree(const std::uint32_t p_node)
+        {
+            const double root_area = m_nodes[0].bounds.surface_area();
+            std::uint32_t stack[stack_size];
+            std::size_t top = 0;
+            stack[top++] = p_node;
+            while (top != 0)
+            {
+                const std::uint32_t index = stack[--top];
+                const bvh_node& node = m_nodes[index];
+                m_node_stamp[index] = m_epoch;
+                m_shares[index] = root_area > 0.0 ? node.bounds.surface_area() / root_area : 0.0;
+                if (node.is_leaf())
+                {
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                        m_slot_leaf[i] = index;
+                    continue;
+                }
+                for (const std::uint32_t child : { node.first, node.first + 1 })
+                {
+                    m_parents[child] = index;
+                    m_depths[child] = static_cast<std::uint8_t>(m_depths[index] + 1);
+                    stack[top++] = child;
+                }
+            }
+        }
+
+        /// Recompute the bounds and expansion of one node from its triangles or children
+        void refit_node(const std::uint32_t p_node)
+        {
+            bvh_node& node = m_nodes[p_node];
+            if (node.is_leaf())
+            {
+                node.bounds = aabb3::empty();
+                for (std::uint32_t t = node.first; t < node.first + node.count; ++t)
+                {
+                    node.bounds.expand(m_triangles[t].point1);
+                    node.bounds.expand(m_triangles[t].point2);
+                    node.bounds.expand(m_triangles[t].point3);
+                }
+            }
+            else
+            {
+                node.bounds = m_nodes[node.first].bounds;
+                node.bounds.expand(m_nodes[node.first + 1].bounds);
+            }
+            update_expansion(p_node);
+        }
+
+        /// Refit the stamped nodes below and including a node, children first
+        ///
+        /// Walks in depth-first order, which follows the node layout.
+        /// @return                     Number of nodes updated
+        std::size_t refit_below(const std::uint32_t p_node)
+        {
+            constexpr std::uint32_t expanded = 0x80000000u;
+            std::size_t updated = 0;
+            std::uint32_t stack[stack_size * 2];
+            std::size_t top = 0;
+            stack[top++] = p_node;
+            while (top != 0)
+            {
+                const std::uint32_t entry = stack[--top];
+                const std::uint32_t index = entry & ~expanded;
+                const bvh_node& node = m_nodes[index];
+                if (!(entry & expanded) && !node.is_leaf())
+                {
+                    stack[top++] = index | expanded;
+                    for (const std::uint32_t child : { node.first, node.first + 1 })
+                    {
+                        if (m_node_stamp[child] == m_epoch)
+                            stack[top++] = child;
+                    }
+                    continue;
+                }
+                refit_node(index);
+                ++updated;
+            }
+            return updated;
+        }
+
+        /// Refit stamped nodes grouped by depth
+        ///
+        /// Subtrees below refit_split_depth are refitted in parallel, then the
+        /// few nodes above them on the calling thread.
+        /// @return                     Number of nodes updated
+        std::size_t refit_levels(const std::vector<std::vector<std::uint32_t>>& p_levels)
+        {
+            const std::vector<std::uint32_t>& roots = p_levels[refit_split_depth];
+            std::atomic<std::size_t> updated{ 0 };
+            parallel_for(roots.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                std::size_t local = 0;
+                for (std::size_t i = p_begin; i < p_end; ++i)
+                    local += refit_below(roots[i]);
+                updated += local;
+            });
+
+            std::size_t total = updated;
+            for (std::size_t d = refit_split_depth; d-- > 0;)
+            {
+                for (const std::uint32_t n : p_levels[d])
+                    refit_node(n);
+                total += p_levels[d].size();
+            }
+            return total;
+        }
+
+        /// Rebuild the topmost refitted subtrees whose share of the root's area grew too much
+        ///
+        /// Every refitted node carries the current epoch stamp. Going down level
+        /// by level, chosen nodes and their descendants clear it so nothing
+        /// inside a chosen subtree is chosen again.
+        void rebuild_degraded(const std::vector<std::vector<std::uint32_t>>& p_levels, const bvh_refit_options& p_options, bvh_refit_result& p_result)
+        {
+            const double root_area = m_nodes[0].bounds.surface_area();
+            if (!(p_options.rebuild_threshold > 0.0) || !(root_area > 0.0))
+                return;
+
+            std::vector<std::uint32_t> chosen;
+            for (std::size_t d = 1; d < p_levels.size(); ++d)
+            {
+                for (const std::uint32_t n : p_levels[d])
+                {
+                    if (m_node_stamp[m_parents[n]] != m_epoch)
+                    {
+                        m_node_stamp[n] = 0;
+                        continue;
+                    }
+
+                    const double share = m_nodes[n].bounds.surface_area() / root_area;
+                    if (m_nodes[n].is_leaf() || !(share > m_shares[n] * p_options.rebuild_threshold))
+                        continue;
+                    const auto range = subtree_range(n);
+                    if (range.second - range.first >= p_options.min_rebuild_triangles)
+                    {
+                        m_node_stamp[n] = 0;
+                        chosen.push_back(n);
+                    }
+                }
+            }
+
+            for (const std::uint32_t n : chosen)
+            {
+                const auto range = subtree_range(n);
+                rebuild_subtree(n);
+                ++p_result.rebuilt_subtrees;
+                p_result.rebuilt_triangles += range.second - range.first;
+            }
+        }
+
+        /// Get the range of leaf-order triangles below a node
+        std::pair<std::uint32_t, std::uint32_t> subtree_range(const std::uint32_t p_node) const
+        {
+            std::uint32_t left = p_node;
+            std::uint32_t right = p_node;
+            while (!m_nodes[left].is_leaf())
+                left = m_nodes[left].first;
+            while (!m_nodes[right].is_leaf())
+                right = m_nodes[right].first + 1;
+            return std::make_pair(m_nodes[left].first, m_nodes[right].first + m_nodes[right].count);
+        }
+
+        /// Rebuild the subtree below a node from its current triangles
+        void rebuild_subtree(const std::uint32_t p_node)
+        {
+            const auto range = subtree_range(p_node);
+            const std::uint32_t begin = range.first;
+            const std::uint32_t count = range.second - range.first;
+            MESH_PROFILE_SCOPE("bvh.rebuild_subtree", count);
+
+            // Release the old descendants
+            std::uint32_t stack[stack_size];
+            std::size_t top = 0;
+            stack[top++] = p_node;
+            while (top != 0)
+            {
+                const bvh_node& node = m_nodes[stack[--top]];
+                if (node.is_leaf())
+                    continue;
+                m_free_pairs.push_back(node.first);
+                m_depths[node.first] = free_depth;
+                m_depths[node.first + 1] = free_depth;
+                stack[top++] = node.first;
+                stack[top++] = node.first + 1;
+            }
+
+            // Split with local triangle ids, then map back to mesh triangles
+            const std::vector<std::uint32_t> ids(m_indices.begin() + begin, m_indices.begin() + range.second);
+            const std::vector<triangle3> triangles(m_triangles.begin() + begin, m_triangles.begin() + range.second);
+            std::vector<aabb3> boxes(count, aabb3::empty());
+            std::vector<vector3> centroids(count);
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                const triangle3& tri = triangles[i];
+                boxes[i].expand(tri.point1);
+                boxes[i].expand(tri.point2);
+                boxes[i].expand(tri.point3);
+                centroids[i] = (tri.point1 + tri.point2 + tri.point3) / 3.0;
+                m_indices[begin + i] = i;
+            }
+            subdivide(p_node, begin, range.second, m_depths[p_node], boxes, centroids, m_options);
+            for (std::uint32_t i = begin; i < range.second; ++i)
+            {
+                const std::uint32_t local = m_indices[i];
+                m_indices[i] = ids[local];
+                m_triangles[i] = triangles[local];
+                m_slots[ids[local]] = i;
+            }
+
+            resize_node_data();
+            index_subtree(p_node);
+            refit_below(p_node);
+        }
+
+        /// Split a node's triangles with the binned surface area heuristic
+        void subdivide(const std::uint32_t p_node, const std::uint32_t p_begin, const std::uint32_t p_end, const std::uint32_t p_depth,
+                       const std::vector<aabb3>& p_boxes, const std::vector<vector3>& p_centroids, const bvh_options& p_options)
+        {
+            // Bounds of the triangles and of their centroids
+            aabb3 bounds = aabb3::empty();
+            aabb3 centroid_bounds = aabb3::empty();
+            for (std::uint32_t i = p_begin; i < p_end; ++i)
+            {
+                bounds.expand(p_boxes[m_indices[i]]);
+                centroid_bounds.expand(p_centroids[m_indices[i]]);
+            }
+            m_nodes[p_node].bounds = bounds;
+            m_nodes[p_node].first = p_begin;
+            m_nodes[p_node].count = p_end - p_begin;
+
+            // Depth is capped so traversal stacks stay small
+            const std::uint32_t count = p_end - p_begin;
+            if (count <= 1 || p_depth >= max_depth)
+                return;
+
+            // Evaluate bin boundaries on every axis
+            struct bin
+            {
+                aabb3 bounds = aabb3::empty();
+                std::uint32_t count = 0;
+            };
+
+            const std::uint32_t bin_count = std::max<std::uint32_t>(p_options.bins, 2);
+            std::vector<bin> bins(bin_count);
+            std::vector<double> right_cost(bin_count);
+            double best_cost = std::numeric_limits<double>::infinity();
+            int best_axis = -1;
+            std::uint32_t best_split = 0;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const double lo = axis == 0 ? centroid_bounds.minimum.x : axis == 1 ? centroid_bounds.minimum.y : centroid_bounds.minimum.z;
+                const double hi = axis == 0 ? centroid_bounds.maximum.x : axis == 1 ? centroid_bounds.maximum.y : centroid_bounds.maximum.z;
+                if (!(hi > lo))
+                    continue;
+
+                std::fill(bins.begin(), bins.end(), bin{});
+                const double scale = bin_count / (hi - lo);
+                for (std::uint32_t i = p_begin; i < p_end; ++i)
+                {
+                    const std::uint32_t t = m_indices[i];
+                    bin& b = bins[bin_of(p_centroids[t], axis, lo, scale, bin_count)];
+                    b.bounds.expand(p_boxes[t]);
+                    ++b.count;
+                }
+
+                // Sweep from the right, then from the left evaluating each split
+                aabb3 box = aabb3::empty();
+                std::uint32_t n = 0;
+                for (std::uint32_t s = bin_count - 1; s > 0; --s)
+                {
+                    box.expand(bins[s].bounds);
+                    n += bins[s].count;
+                    right_cost[s] = n == 0 ? 0.0 : box.surface_area() * n;
+                }
+                box = aabb3::empty();
+                n = 0;
+                for (std::uint32_t s = 1; s < bin_count; ++s)
+                {
+                    box.expand(bins[s - 1].bounds);
+                    n += bins[s - 1].count;
+                    if (n == 0 || n == count)
+                        continue;
+
+                    const double cost = box.surface_area() * n + right_cost[s];
+                    if (cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_split = s;
+                    }
+                }
+            }
+
+            // Keep a leaf when splitting does not pay off or is impossible
+            const double leaf_cost = bounds.surface_area() * count;
+            if (best_axis < 0 || (count <= p_options.max_leaf_size && best_cost >= leaf_cost))
+                return;
+
+            const double lo = best_axis == 0 ? centroid_bounds.minimum.x : best_axis == 1 ? centroid_bounds.minimum.y : centroid_bounds.minimum.z;
+            const double hi = best_axis == 0 ? centroid_bounds.maximum.x : best_axis == 1 ? centroid_bounds.maximum.y : centroid_bounds.maximum.z;
+            const double scale = bin_count / (hi - lo);
+            const auto middle = std::partition(m_indices.begin() + p_begin, m_indices.begin() + p_end, [&](const std::uint32_t p_t)
+            {
+                return bin_of(p_centroids[p_t], best_axis, lo, scale, bin_count) < best_split;
+            });
+            const std::uint32_t split = static_cast<std::uint32_t>(middle - m_indices.begin());
+
+            // Children are allocated as a pair
+            const std::uint32_t left = allocate_pair();
+            m_nodes[p_node].first = left;
+            m_nodes[p_node].count = 0;
+            subdivide(left, p_begin, split, p_depth + 1, p_boxes, p_centroids, p_options);
+            subdivide(left + 1, split, p_end, p_depth + 1, p_boxes, p_centroids, p_options);
+        }
+
+        /// Get the bin of a centroid along an axis
+        static std::uint32_t bin_of(const vector3& p_centroid, const int p_axis, const double p_lo, const double p_scale, const std::uint32_t p_bins)
+        {
+            const double c = p_axis == 0 ? p_centroid.x : p_axis == 1 ? p_centroid.y : p_centroid.z;
+            const double b = (c - p_lo) * p_scale;
+            return std::min(static_cast<std::uint32_t>(std::max(b, 0.0)), p_bins - 1);
+        }
+
+        /// Compute the far-field expansion of every node bottom-up
+        void compute_expansions()
+        {
+            // Children always follow their parent so a reverse sweep visits them first
+            m_expansions.assign(m_nodes.size(), bvh_expansion());
+            for (std::size_t n = m_nodes.size(); n-- > 0;)
+                update_expansion(static_cast<std::uint32_t>(n));
+        }
+
+        /// Compute the far-field expansion of a node from its triangles or children
+        ///
+        /// Each triangle is treated as its area-weighted normal at its centroid.
+        /// Expanding the solid angle about the node center gives the summed
+        /// normal as the first-order term and the normal-offset moments as the
+        /// second-order term. Parents shift their children's terms to their own
+        /// center, so children must be up to date.
+        void update_expansion(const std::uint32_t p_node)
+        {
+            const bvh_node& node = m_nodes[p_node];
+            bvh_expansion& expansion = m_expansions[p_node];
+            expansion = bvh_expansion();
+            if (node.is_leaf())
+            {
+                vector3 weighted{ 0.0, 0.0, 0.0 };
+                for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                {
+                    const triangle3& tri = m_triangles[i];
+                    const double area = tri.normal().length() * 0.5;
+                    weighted += (tri.point1 + tri.point2 + tri.point3) * (area / 3.0);
+                    expansion.area += area;
+                }
+                expansion.center = expansion.area > 0.0 ? weighted / expansion.area : node.bounds.center();
+
+                for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                {
+                    const triangle3& tri = m_triangles[i];
+                    const vector3 normal = tri.normal() * 0.5;
+                    expansion.normal += normal;
+                    add_moment(expansion.moment, normal, (tri.point1 + tri.point2 + tri.point3) / 3.0 - expansion.center);
+                    for (const vector3& p : { tri.point1, tri.point2, tri.point3 })
+                        expansion.radius = std::max(expansion.radius, (p - expansion.center).length());
+                }
+                return;
+            }
+
+            const std::uint32_t children[2] = { node.first, node.first + 1 };
+            vector3 weighted{ 0.0, 0.0, 0.0 };
+            for (const std::uint32_t child : children)
+            {
+                weighted += m_expansions[child].center * m_expansions[child].area;
+                expansion.area += m_expansions[child].area;
+            }
+            expansion.center = expansion.area > 0.0 ? weighted / expansion.area : node.bounds.center();
+
+            for (const std::uint32_t child : children)
+            {
+                const bvh_expansion& c = m_expansions[child];
+                const vector3 shift = c.center - expansion.center;
+                expansion.normal += c.normal;
+                for (int k = 0; k < 9; ++k)
+                    expansion.moment[k] += c.moment[k];
+                add_moment(expansion.moment, c.normal, shift);
+                expansion.radius = std::max(expansion.radius, c.radius + shift.length());
+            }
+
+            // The farthest bounds corner is sometimes the tighter bound
+            const vector3 corner{
+                std::max(expansion.center.x - node.bounds.minimum.x, node.bounds.maximum.x - expansion.center.x),
+                std::max(expansion.center.y - node.bounds.minimum.y, node.bounds.maximum.y - expansion.center.y),
+                std::max(expansion.center.z - node.bounds.minimum.z, node.bounds.maximum.z - expansion.center.z)
+            };
+            expansion.radius = std::min(expansion.radius, corner.length());
+        }
+
+        /// Add the outer product of a normal and an offset to a moment
+        static void add_moment(double* p_moment, const vector3& p_normal, const vector3& p_offset)
+        {
+            const double n[3] = { p_normal.x, p_normal.y, p_normal.z };
+            const double d[3] = { p_offset.x, p_offset.y, p_offset.z };
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 3; ++j)
+                    p_moment[i * 3 + j] += n[i] * d[j];
+        }
+
+        bvh_options m_options;
+        std::vector<bvh_node> m_nodes;
+        std::vector<bvh_expansion> m_expansions;
+        std::vector<triangle3> m_triangles;
+        std::vector<std::uint32_t> m_indices;
+
+        // Refit lookups
+        std::vector<std::uint32_t> m_parents;           ///< Parent of each node
+        std::vector<std::uint8_t> m_depths;             ///< Depth of each node (free_depth when unused)
+        std::vector<double> m_shares;                   ///< Node area over root area when the node was built
+        std::vector<std::uint32_t> m_free_pairs;        ///< Unused node pairs left by rebuilds
+        std::vector<std::uint32_t> m_slots;             ///< Leaf-order position of each mesh triangle
+        std::vector<std::uint32_t> m_slot_leaf;         ///< Leaf holding each leaf-order triangle
+        std::vector<std::uint32_t> m_vertex_start;      ///< First entry of each vertex in m_vertex_triangles (vertex count + 1)
+        std::vector<std::uint32_t> m_vertex_triangles;  ///< Mesh triangles using each vertex
+        std::vector<std::uint32_t> m_slot_stamp;        ///< Last refit epoch that visited each leaf-order triangle
+        std::vector<std::uint32_t> m_node_stamp;        ///< Last refit epoch that visited each node
+        std::uint32_t m_epoch = 0;
+        double m_build_cost = 0.0;
+    };
+}
@@ -0,0 +1,550 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_vector2.hpp"
+
+namespace mesh
+{
+    // Binary mesh cache layout (little-endian, every offset from the file start):
+    //
+    //     header          64 bytes (mesh_cache_header)
+    //     section table   section_count x 32 bytes (mesh_cache_section_entry)
+    //     sections        each aligned to 64 bytes, stored as the in-memory arrays
+    //
+    // Section payloads are the raw arrays the library uses (vector3 positions,
+    // uint32 indices, ...), so a mapped file is used in place with no copies
+    // or parsing. The checksum covers everything after the header.
+    //
+    // Prebuilt BVH sections are not written or read yet: mesh_bvh cannot be
+    // restored from stored nodes without also rebuilding its refit bookkeeping.
+    // Their identifier is reserved so caches written later stay compatible.
+
+    /// Well-known mesh cache section identifiers
+    enum class mesh_cache_section : std::uint32_t
+    {
+        positions = 1,          ///< vector3 per vertex
+        indices = 2,            ///< uint32 per triangle corner
+        normals = 3,            ///< vector3 per vertex
+        texcoords = 4,          ///< vector2 per vertex
+        edge_adjacency = 5,     ///< uint32 neighbour triangle per triangle edge (compute_edge_adjacency)
+        bvh = 6,                ///< Reserved for prebuilt bounding volume hierarchy nodes (not written or read yet)
+        user = 0x10000          ///< First identifier available for application sections
+    };
+
+    /// Result of opening a mesh cache
+    enum class mesh_cache_status
+    {
+        ok,                     ///< Cache is valid
+        open_failed,            ///< File could not be opened or mapped
+        bad_magic,              ///< Not a mesh cache
+        bad_version,            ///< Unsupported format version or byte order
+        truncated,              ///< Header, table or a section lies outside the data
+        bad_section,            ///< Section misaligned, mis-sized, overlapping the header or table, or indices out of range
+        checksum_mismatch,      ///< Data does not match the stored checksum
+        misaligned              ///< Caller memory is not 8-byte aligned
+    };
+
+    /// Mesh cache file header
+    struct mesh_cache_header
+    {
+        char magic[8];                  ///< "MESHCACH"
+        std::uint32_t version;          ///< Format version
+        std::uint32_t endian;           ///< 0x01020304 written in native order
+        std::uint64_t file_size;        ///< Total size in bytes
+        std::uint64_t checksum;         ///< Checksum of the bytes after the header
+        std::uint32_t section_count;    ///< Number of section table entries
+        std::uint32_t reserved[7];      ///< Zero
+    };
+
+    /// Mesh cache section table entry
+    struct mesh_cache_section_entry
+    {
+        std::uint32_t id;               ///< Section identifier
+        std::uint32_t element_size;     ///< Bytes per element
+        std::uint64_t offset;           ///< Offset from the file start (64-byte aligned)
+        std::uint64_t count;            ///< Number of elements
+        std::uint64_t reserved;         ///< Zero
+    };
+
+    static_assert(sizeof(mesh_cache_header) == 64, "mesh cache header must be 64 bytes");
+    static_assert(sizeof(mesh_cache_section_entry) == 32, "mesh cache section entry must be 32 bytes");
+
+    namespace detail
+    {
+        /// Mesh cache format version
+        constexpr std::uint32_t mesh_cache_version = 1;
+
+        /// Section alignment in bytes
+        constexpr std::uint64_t mesh_cache_alignment = 64;
+
+        /// Byte order marker
+        constexpr std::uint32_t mesh_cache_endian = 0x01020304;
+
+        /// Round up to the section alignment
+        constexpr std::uint64_t mesh_cache_align(const std::uint64_t p_value)
+        {
+            return (p_value + mesh_cache_alignment - 1) & ~(mesh_cache_alignment - 1);
+        }
+
+        /// Rotate left
+        constexpr std::uint64_t rotl64(const std::uint64_t p_value, const int p_shift)
+        {
+            return (p_value << p_shift) | (p_value >> (64 - p_shift));
+        }
+
+        /// Fast 64-bit checksum processing four independent 8-byte lanes per step
+        ///
+        /// Multiply-rotate mixing in the style of xxHash64. Not a cryptographic
+        /// hash: it detects truncation and corruption, not tampering.
+        inline std::uint64_t mesh_cache_checksum(const void* p_data, const std::size_t p_size)
+        {
+            constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+            constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+            constexpr std::uint64_t prime3 = 0x165667B19E3779F9ull;
+            const auto* bytes = static_cast<const unsigned char*>(p_data);
+
+            auto read64 = [](const unsigned char* p_p)
+            {
+                std::uint64_t v;
+                std::memcpy(&v, p_p, sizeof(v));
+                return v;
+            };
+            auto mix = [](const std::uint64_t p_acc, const std::uint64_t p_input)
+            {
+                return rotl64(p_acc + p_input * prime2, 31) * prime1;
+            };
+
+            std::uint64_t lanes[4] = { prime1 + prime2, prime2, 0, 0 - prime1 };
+            std::size_t i = 0;
+            for (; i + 32 <= p_size; i += 32)
+            {
+                lanes[0] = mix(lanes[0], read64(bytes + i));
+                lanes[1] = mix(lanes[1], read64(bytes + i + 8));
+                lanes[2] = mix(lanes[2], read64(bytes + i + 16));
+                lanes[3] = mix(lanes[3], read64(bytes + i + 24));
+            }
+
+            std::uint64_t h = rotl64(lanes[0], 1) + rotl64(lanes[1], 7) + rotl64(lanes[2], 12) + rotl64(lanes[3], 18) + p_size;
+            for (; i + 8 <= p_size; i += 8)
+                h = rotl64(h ^ mix(0, read64(bytes + i)), 27) * prime1 + prime3;
+            for (; i < p_size; ++i)
+                h = rotl64(h ^ (bytes[i] * prime3), 11) * prime1;
+
+            h ^= h >> 33;
+            h *= prime2;
+            h ^= h >> 29;
+            h *= prime3;
+            h ^= h >> 32;
+            return h;
+        }
+    }
+
+    /// Builds a mesh cache from in-memory arrays
+    class mesh_cache_writer
+    {
+    public:
+        /// Construct an empty writer
+        mesh_cache_writer() = default;
+
+        /// Construct a writer holding the positions and indices of a mesh
+        /// @param p_mesh               Mesh to store (must outlive the writer)
+        explicit mesh_cache_writer(const indexed_mesh& p_mesh)
+        {
+            add_section(mesh_cache_section::positions, p_mesh.vertices.data(), p_mesh.vertices.size());
+            add_section(mesh_cache_section::indices, p_mesh.indices.data(), p_mesh.indices.size());
+        }
+
+        /// Add a section of trivially copyable elements (the data must outlive the writer)
+        /// @param p_id                 Section identifier
+        /// @param p_data               Elements
+        /// @param p_count              Number of elements
+        template <typename T>
+        void add_section(const mesh_cache_section p_id, const T* p_data, const std::size_t p_count)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "mesh cache sections must be trivially copyable");
+            add_section(p_id, p_data, sizeof(T), p_count);
+        }
+
+        /// Add a section of raw elements (the data must outlive the writer)
+        /// @param p_id                 Section identifier
+        /// @param p_data               Element bytes
+        /// @param p_element_size       Bytes per element
+        /// @param p_count              Number of elements
+        void add_section(const mesh_cache_section p_id, const void* p_data, const std::size_t p_element_size, const std::size_t p_count)
+        {
+            m_sections.push_back(pending{ static_cast<std::uint32_t>(p_id), static_cast<std::uint32_t>(p_element_size), p_count, p_data });
+        }
+
+        /// Serialize the cache to memory
+        /// @return                     Cache bytes
+        std::vector<std::uint8_t> serialize() const
+        {
+            // Lay out the table and the aligned sections
+            std::vector<mesh_cache_section_entry> table(m_sections.size());
+            std::uint64_t offset = detail::mesh_cache_align(sizeof(mesh_cache_header) + table.size() * sizeof(mesh_cache_section_entry));
+            for (std::size_t i = 0; i < m_sections.size(); ++i)
+            {
+                table[i] = mesh_cache_section_entry{ m_sections[i].id, m_sections[i].element_size, offset, m_sections[i].count, 0 };
+                offset = detail::mesh_cache_align(offset + m_sections[i].count * m_sections[i].element_size);
+            }
+
+            std::vector<std::uint8_t> bytes(static_cast<std::size_t>(offset), 0);
+            std::memcpy(bytes.data() + sizeof(mesh_cache_header), table.data(), table.size() * sizeof(mesh_cache_section_entry));
+            for (std::size_t i = 0; i < m_sections.size(); ++i)
+            {
+                const std::size_t size = m_sections[i].count * m_sections[i].element_size;
+                if (size != 0)
+                    std::memcpy(bytes.data() + table[i].offset, m_sections[i].data, size);
+            }
+
+            mesh_cache_header header{};
+            std::memcpy(header.magic, "MESHCACH", 8);
+            header.version = detail::mesh_cache_version;
+            header.endian = detail::mesh_cache_endian;
+            header.file_size = offset;
+            header.section_count = static_cast<std::uint32_t>(table.size());
+            header.checksum = detail::mesh_cache_checksum(bytes.data() + sizeof(header), bytes.size() - sizeof(header));
+            std::memcpy(bytes.data(), &header, sizeof(header));
+            return bytes;
+        }
+
+        /// Write the cache to a file
+        /// @param p_path               File path
+        /// @return                     True on success
+        bool write(const std::string& p_path) const
+        {
+            const std::vector<std::uint8_t> bytes = serialize();
+            std::ofstream file(p_path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            return static_cast<bool>(file);
+        }
+
+    private:
+        /// Section waiting to be serialized
+        struct pending
+        {
+            std::uint32_t id;
+            std::uint32_t element_size;
+            std::size_t count;
+            const void* data;
+        };
+
+        std::vector<pending> m_sections;    ///< Sections in file order
+    };
+
+    /// Read-only view of a mesh cache, memory mapped from a file or over caller memory
+    ///
+    /// Opening validates the header, the section table and the section bounds
+    /// in time proportional to the section count. With p_verify the checksum
+    /// and index ranges are also checked, which reads the whole file once;
+    /// trusted caches can skip it for constant-time loads.
+    class mesh_cache
+    {
+    public:
+        mesh_cache() = default;
+        mesh_cache(const mesh_cache&) = delete;
+        mesh_cache& operator=(const mesh_cache&) = delete;
+
+        /// Destructor unmaps the file
+        ~mesh_cache()
+        {
+            close();
+        }
+
+        /// Map and validate a cache file
+        /// @param p_path               File path
+        /// @param p_verify             Verify the checksum and index ranges
+        /// @return                     Status
+        mesh_cache_status open(const std::string& p_path, const bool p_verify = true)
+        {
+            close();
+#if defined(_WIN32)
+            m_file = CreateFileA(p_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+                return mesh_cache_status::open_failed;
+
+            LARGE_INTEGER size;
+            size.QuadPart = 0;
+            if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+            {
+                close();
+                return size.QuadPart == 0 ? mesh_cache_status::truncated : mesh_cache_status::open_failed;
+            }
+
+            m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            const void* view = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (!view)
+            {
+                close();
+                return mesh_cache_status::open_failed;
+            }
+            m_mapped_size = static_cast<std::size_t>(size.QuadPart);
+#else
+            const int fd = ::open(p_path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return mesh_cache_status::open_failed;
+
+            struct stat info{};
+            if (::fstat(fd, &info) != 0)
+            {
+                ::close(fd);
+                return mesh_cache_status::open_failed;
+            }
+            if (info.st_size == 0)
+            {
+                ::close(fd);
+                return mesh_cache_status::truncated;
+            }
+
+            void* view = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (view == MAP_FAILED)
+                return mesh_cache_status::open_failed;
+            m_mapped_size = static_cast<std::size_t>(info.st_size);
+#endif
+            m_mapped = view;
+            const mesh_cache_status status = validate(view, m_mapped_size, p_verify);
+            if (status != mesh_cache_status::ok)
+                close();
+            return status;
+        }
+
+        /// Validate a cache held in caller memory (not copied; must stay valid and 8-byte aligned, or misaligned is returned)
+        /// @param p_data               Cache bytes
+        /// @param p_size               Number of bytes
+        /// @param p_verify             Verify the checksum and index ranges
+        /// @return                     Status
+        mesh_cache_status open(const void* p_data, const std::size_t p_size, const bool p_verify = true)
+        {
+            close();
+            return validate(p_data, p_size, p_verify);
+        }
+
+        /// Release the mapping
+        void close()
+        {
+#if defined(_WIN32)
+            if (m_mapped)
+                UnmapViewOfFile(m_mapped);
+            if (m_mapping)
+                CloseHandle(m_mapping);
+            if (m_file != INVALID_HANDLE_VALUE)
+                CloseHandle(m_file);
+            m_mapping = nullptr;
+            m_file = INVALID_HANDLE_VALUE;
+#else
+            if (m_mapped)
+                ::munmap(const_cast<void*>(m_mapped), m_mapped_size);
+#endif
+            m_mapped = nullptr;
+            m_mapped_size = 0;
+            m_data = nullptr;
+            m_size = 0;
+            m_table = nullptr;
+            m_section_count = 0;
+        }
+
+        /// Check if a cache is open
+        bool is_open() const
+        {
+            return m_data != nullptr;
+        }
+
+        /// Get the cache size in bytes
+        std::size_t size() const
+        {
+            return m_size;
+        }
+
+        /// Check if a section is present
+        /// @param p_id                 Section identifier
+        /// @return                     True if present
+        bool has_section(const mesh_cache_section p_id) const
+        {
+            return find(p_id) != nullptr;
+        }
+
+        /// Get a section as a typed array
+        /// @param p_id                 Section identifier
+        /// @param p_count              Receives the element count
+        /// @return                     Elements, or nullptr if missing, the element size differs from T or the data is not aligned for T
+        template <typename T>
+        const T* section(const mesh_cache_section p_id, std::size_t& p_count) const
+        {
+            p_count = 0;
+            const mesh_cache_section_entry* s = find(p_id);
+            if (!s || s->element_size != sizeof(T))
+                return nullptr;
+
+            const std::uint8_t* data = m_data + s->offset;
+            if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0)
+                return nullptr;
+            p_count = static_cast<std::size_t>(s->count);
+            return reinterpret_cast<const T*>(data);
+        }
+
+        /// Get the vertex positions
+        const vector3* positions() const
+        {
+            std::size_t count = 0;
+            return section<vector3>(mesh_cache_section::positions, count);
+        }
+
+        /// Get the number of vertices
+        std::size_t vertex_count() const
+        {
+            std::size_t count = 0;
+            section<vector3>(mesh_cache_section::positions, count);
+            return count;
+        }
+
+        /// Get the triangle indices
+        const std::uint32_t* indices() const
+        {
+            std::size_t count = 0;
+            return section<std::uint32_t>(mesh_cache_section::indices, count);
+        }
+
+        /// Get the number of triangles
+        std::size_t triangle_count() const
+        {
+            std::size_t count = 0;
+            section<std::uint32_t>(mesh_cache_section::indices, count);
+            return count / 3;
+        }
+
+        /// Copy the positions and indices into a mesh
+        /// @return                     Mesh
+        indexed_mesh to_mesh() const
+        {
+            indexed_mesh result;
+            const vector3* p = positions();
+            const std::uint32_t* i = indices();
+            if (p)
+                result.vertices.assign(p, p + vertex_count());
+            if (i)
+                result.indices.assign(i, i + triangle_count() * 3);
+            return result;
+        }
+
+    private:
+        /// Validate cache bytes and publish them on success
+        mesh_cache_status validate(const void* p_data, const std::size_t p_size, const bool p_verify)
+        {
+            // Header (the table and sections are read in place, so the data must be aligned for them)
+            if (reinterpret_cast<std::uintptr_t>(p_data) % alignof(std::uint64_t) != 0)
+                return mesh_cache_status::misaligned;
+            if (p_size < sizeof(mesh_cache_header))
+                return mesh_cache_status::truncated;
+            mesh_cache_header header;
+            std::memcpy(&header, p_data, sizeof(header));
+            if (std::memcmp(header.magic, "MESHCACH", 8) != 0)
+                return mesh_cache_status::bad_magic;
+            if (header.version != detail::mesh_cache_version || header.endian != detail::mesh_cache_endian)
+                return mesh_cache_status::bad_version;
+            if (header.file_size > p_size || header.file_size < sizeof(header))
+                return mesh_cache_status::truncated;
+
+            // Section table and section bounds
+            const auto* bytes = static_cast<const std::uint8_t*>(p_data);
+            const std::uint64_t size = header.file_size;
+            if (header.section_count > (size - sizeof(header)) / sizeof(mesh_cache_section_entry))
+                return mesh_cache_status::truncated;
+            const auto* table = reinterpret_cast<const mesh_cache_section_entry*>(bytes + sizeof(header));
+            const std::uint64_t table_end = sizeof(header) + std::uint64_t{ header.section_count } * sizeof(mesh_cache_section_entry);
+            for (std::uint32_t i = 0; i < header.section_count; ++i)
+            {
+                const mesh_cache_section_entry& s = table[i];
+                if (s.offset % detail::mesh_cache_alignment != 0 || s.offset < table_end || s.element_size == 0)
+                    return mesh_cache_status::bad_section;
+                if (s.offset > size || s.count > (size - s.offset) / s.element_size)
+                    return mesh_cache_status::truncated;
+            }
+
+            if (p_verify && detail::mesh_cache_checksum(bytes + sizeof(header), static_cast<std::size_t>(size - sizeof(header))) != header.checksum)
+                return mesh_cache_status::checksum_mismatch;
+
+            m_data = bytes;
+            m_size = static_cast<std::size_t>(size);
+            m_table = table;
+            m_section_count = header.section_count;
+
+            // Well-known sections must have the library's element sizes
+            std::size_t count = 0;
+            if ((find(mesh_cache_section::positions) && !section<vector3>(mesh_cache_section::positions, count)) ||
+                (find(mesh_cache_section::indices) && !section<std::uint32_t>(mesh_cache_section::indices, count)) ||
+                (find(mesh_cache_section::normals) && !section<vector3>(mesh_cache_section::normals, count)) ||
+                (find(mesh_cache_section::texcoords) && !section<vector2>(mesh_cache_section::texcoords, count)) ||
+                (find(mesh_cache_section::edge_adjacency) && !section<std::uint32_t>(mesh_cache_section::edge_adjacency, count)) ||
+                (p_verify && !indices_in_range()))
+            {
+                m_data = nullptr;
+                m_size = 0;
+                m_table = nullptr;
+                m_section_count = 0;
+                return mesh_cache_status::bad_section;
+            }
+            return mesh_cache_status::ok;
+        }
+
+        /// Find a section table entry
+        const mesh_cache_section_entry* find(const mesh_cache_section p_id) const
+        {
+            for (std::uint32_t i = 0; i < m_section_count; ++i)
+            {
+                if (m_table[i].id == static_cast<std::uint32_t>(p_id))
+                    return &m_table[i];
+            }
+            return nullptr;
+        }
+
+        /// Check the indices reference existing vertices
+        bool indices_in_range() const
+        {
+            std::size_t index_count = 0;
+            const std::uint32_t* idx = section<std::uint32_t>(mesh_cache_section::indices, index_count);
+            const std::size_t vertices = vertex_count();
+            for (std::size_t i = 0; i < index_count; ++i)
+            {
+                if (idx[i] >= vertices)
+                    return false;
+            }
+            return true;
+        }
+
+        const std::uint8_t* m_data = nullptr;                   ///< Cache bytes
+        std::size_t m_size = 0;                                 ///< Cache size from the header
+        const mesh_cache_section_entry* m_table = nullptr;      ///< Section table
+        std::uint32_t m_section_count = 0;                      ///< Section table entries
+        const void* m_mapped = nullptr;                         ///< Mapped view (file caches only)
+        std::size_t m_mapped_size = 0;                          ///< Mapped view size
+#if defined(_WIN32)
+        HANDLE m_file = INVALID_HANDLE_VALUE;                   ///< File handle
+        HANDLE m_mapping = nullptr;                             ///< File mapping handle
+#endif
+    };
+}
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+#include "mesh_sparse_matrix.hpp"
+#include "mesh_vertex_cache.hpp"
+
+namespace mesh
+{
+    /// Differential quantities at a vertex
+    struct vertex_curvature
+    {
+        vector3 normal;                 ///< Unit area-weighted normal
+        double mean = 0.0;              ///< Mean curvature (positive where the surface bends away from the normal, 1/r on a sphere)
+        double gaussian = 0.0;          ///< Gaussian curvature (angle defect over area)
+        double k1 = 0.0;                ///< Larger principal curvature
+        double k2 = 0.0;                ///< Smaller principal curvature
+        vector3 direction1;             ///< Unit tangent direction of k1
+        vector3 direction2;             ///< Unit tangent direction of k2
+    };
+
+    /// Laplacian smoothing options
+    struct smoothing_options
+    {
+        /// Number of iterations
+        int iterations = 10;
+
+        /// Fraction of the way each vertex moves towards its weighted neighbour average
+        double lambda = 0.5;
+
+        /// Second step of each iteration (negative, e.g. -0.53, for Taubin smoothing without shrinking; zero to skip)
+        double mu = 0.0;
+
+        /// Keep vertices on boundary and non-manifold edges in place
+        bool fix_boundary = true;
+    };
+
+    namespace detail
+    {
+        /// Cotangent of the angle between two vectors (zero if they are parallel)
+        inline double cotangent(const vector3& p_u, const vector3& p_v)
+        {
+            const double sine = p_u.cross(p_v).length();
+            return sine > 0.0 ? p_u.dot(p_v) / sine : 0.0;
+        }
+
+        /// Cotangent at each triangle corner (three per triangle)
+        inline std::vector<double> corner_cotangents(const indexed_mesh& p_mesh)
+        {
+            std::vector<double> cot(p_mesh.indices.size());
+            parallel_for(p_mesh.triangle_count(), [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t t = p_begin; t < p_end; ++t)
+                {
+                    for (std::size_t c = 0; c < 3; ++c)
+                    {
+                        const vector3& p = p_mesh.vertices[p_mesh.indices[t * 3 + c]];
+                        const vector3& a = p_mesh.vertices[p_mesh.indices[t * 3 + (c + 1) % 3]];
+                        const vector3& b = p_mesh.vertices[p_mesh.indices[t * 3 + (c + 2) % 3]];
+                        cot[t * 3 + c] = cotangent(a - p, b - p);
+                    }
+                }
+            }, 1024);
+            return cot;
+        }
+
+        /// Corner of a triangle holding a vertex
+        inline std::size_t corner_of(const indexed_mesh& p_mesh, const std::uint32_t p_triangle, const std::uint32_t p_vertex)
+        {
+            const std::uint32_t* tri = p_mesh.indices.data() + std::size_t{ p_triangle } * 3;
+            return tri[0] == p_vertex ? 0 : (tri[1] == p_vertex ? 1 : 2);
+        }
+
+        /// Flag vertices on boundary or non-manifold edges
+        inline std::vector<std::uint8_t> boundary_vertices(const indexed_mesh& p_mesh)
+        {
+            const std::vector<std::uint32_t> neighbors = compute_edge_adjacency(p_mesh);
+            std::vector<std::uint8_t> boundary(p_mesh.vertex_count(), 0);
+            for (std::size_t i = 0; i < neighbors.size(); ++i)
+            {
+                if (neighbors[i] == no_neighbor)
+                {
+                    boundary[p_mesh.indices[i]] = 1;
+                    boundary[p_mesh.indices[i - i % 3 + (i + 1) % 3]] = 1;
+                }
+            }
+            return boundary;
+        }
+    }
+
+    /// Assemble the cotangent Laplacian
+    ///
+    /// Off-diagonal entry (i, j) is (cot a + cot b) / 2 for the angles opposite
+    /// edge ij, and each diagonal entry is minus its row sum, so the matrix is
+    /// symmetric, negative semi-definite and annihilates constants. Applied to
+    /// vertex positions it gives the mean curvature normal times the vertex
+    /// area. Rows are assembled in parallel from precomputed corner
+    /// cotangents; the weights stay valid while only the geometry changes
+    /// slightly, so iterative schemes can reuse the matrix.
+    /// @param p_mesh               Mesh
+    /// @return                     Vertex count square matrix
+    inline sparse_matrix build_cotangent_laplacian(const indexed_mesh& p_mesh)
+    {
+        MESH_PROFILE_SCOPE("curvature.laplacian", p_mesh.triangle_count());
+        const detail::vertex_triangles adjacency(p_mesh);
+        const std::vector<double> cot = detail::corner_cotangents(p_mesh);
+
+        struct entry
+        {
+            std::uint32_t column;
+            double value;
+        };
+
+        // Gather and merge the weights of one row, diagonal included
+        auto gather = [&](const std::uint32_t p_vertex, std::vector<entry>& p_row)
+        {
+            p_row.clear();
+            double sum = 0.0;
+            for (std::uint32_t k = adjacency.offsets[p_vertex]; k < adjacency.offsets[p_vertex + 1]; ++k)
+            {
+                const std::uint32_t t = adjacency.triangles[k];
+                const std::size_t c = detail::corner_of(p_mesh, t, p_vertex);
+                const std::size_t c1 = t * 3 + (c + 1) % 3;
+                const std::size_t c2 = t * 3 + (c + 2) % 3;
+                p_row.push_back(entry{ p_mesh.indices[c1], 0.5 * cot[c2] });
+                p_row.push_back(entry{ p_mesh.indices[c2], 0.5 * cot[c1] });
+                sum += 0.5 * (cot[c1] + cot[c2]);
+            }
+            p_row.push_back(entry{ p_vertex, -sum });
+            std::sort(p_row.begin(), p_row.end(), [](const entry& p_a, const entry& p_b)
+            {
+                return p_a.column < p_b.column;
+            });
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < p_row.size(); ++i)
+            {
+                if (count != 0 && p_row[count - 1].column == p_row[i].column)
+                    p_row[count - 1].value += p_row[i].value;
+                else
+                    p_row[count++] = p_row[i];
+            }
+            p_row.resize(count);
+        };
+
+        sparse_matrix laplacian;
+        laplacian.rows = p_mesh.vertex_count();
+        laplacian.cols = p_mesh.vertex_count();
+        laplacian.offsets.assign(laplacian.rows + 1, 0);
+        parallel_for(laplacian.rows, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            std::vector<entry> row;
+            for (std::size_t v = p_begin; v < p_end; ++v)
+            {
+                gather(static_cast<std::uint32_t>(v), row);
+                laplacian.offsets[v + 1] = static_cast<std::uint32_t>(row.size());
+            }
+        }, 1024);
+        std::partial_sum(laplacian.offsets.begin(), laplacian.offsets.end(), laplacian.offsets.begin());
+
+        laplacian.columns.resize(laplacian.offsets.back());
+        laplacian.values.resize(laplacian.offsets.back());
+        parallel_for(laplacian.rows, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            std::vector<entry> row;
+            for (std::size_t v = p_begin; v < p_end; ++v)
+            {
+                gather(static_cast<std::uint32_t>(v), row);
+                for (std::size_t i = 0; i < row.size(); ++i)
+                {
+                    laplacian.columns[laplacian.offsets[v] + i] = row[i].column;
+                    laplacian.values[laplacian.offsets[v] + i] = row[i].value;
+                }
+            }
+        }, 1024);
+        return laplacian;
+    }
+
+    /// Calculate the mixed Voronoi area of each vertex
+    ///
+    /// Implements Meyer et al., "Discrete Differential-Geometry Operators for
+    /// Triangulated 2-Manifolds": Voronoi regions for non-obtuse triangles,
+    /// falling back to half or a quarter of obtuse triangles so the areas
+    /// tile the surface exactly.
+    /// @param p_mesh               Mesh
+    /// @return                     Area per vertex (the lumped mass matrix)
+    inline std::vector<double> compute_vertex_areas(const indexed_mesh& p_mesh)
+    {
+        MESH_PROFILE_SCOPE("curvature.areas", p_mesh.vertex_count());
+        const detail::vertex_triangles adjacency(p_mesh);
+        const std::vector<double> cot = detail::corner_cotangents(p_mesh);
+        std::vector<double> areas(p_mesh.vertex_count(), 0.0);
+        parallel_for(areas.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            for (std::size_t v = p_begin; v < p_end; ++v)
+            {
+                double area = 0.0;
+                for (std::uint32_t k = adjacency.offsets[v]; k < adjacency.offsets[v + 1]; ++k)
+                {
+                    const std::uint32_t t = adjacency.triangles[k];
+                    const std::size_t c = detail::corner_of(p_mesh, t, static_cast<std::uint32_t>(v));
+                    const std::size_t c1 = t * 3 + (c + 1) % 3;
+                    const std::size_t c2 = t * 3 + (c + 2) % 3;
+                    const vector3& p = p_mesh.vertices[v];
+                    const vector3 e1 = p_mesh.vertices[p_mesh.indices[c1]] - p;
+                    const vector3 e2 = p_mesh.vertices[p_mesh.indices[c2]] - p;
+                    if (cot[t * 3 + c] < 0.0)
+                        area += e1.cross(e2).length() * 0.25;
+                    else if (cot[c1] < 0.0 || cot[c2] < 0.0)
+                        area += e1.cross(e2).length() * 0.125;
+                    else
+                        area += (e1.length2() * cot[c2] + e2.length2() * cot[c1]) * 0.125;
+                }
+                areas[v] = area;
+            }
+        }, 1024);
+        return areas;
+    }
+
+    /// Estimate curvature at every vertex from an assembled Laplacian
+    ///
+    /// Mean curvature comes from the cotangent Laplacian and Gaussian
+    /// curvature from the angle defect, both divided by the mixed area;
+    /// principal curvatures follow from them. Principal directions are the
+    /// eigenvectors of a curvature tensor fitted by least squares to the
+    /// normal curvatures along the edges. Boundary vertices get the boundary
+    /// angle defect but their mean curvature is unreliable.
+    /// @param p_mesh               Mesh
+    /// @param p_laplacian          Cotangent Laplacian of the mesh (see build_cotangent_laplacian())
+    /// @param p_areas              Vertex areas of the mesh (see compute_vertex_areas())
+    /// @return                     Curvature per vertex
+    inline std::vector<vertex_curvature> compute_curvature(const indexed_mesh& p_mesh, const sparse_matrix& p_laplacian, const std::vector<double>& p_areas)
+    {
+        MESH_PROFILE_SCOPE("curvature.compute", p_mesh.vertex_count());
+        constexpr double pi = 3.14159265358979323846;
+        const detail::vertex_triangles adjacency(p_mesh);
+        const std::vector<std::uint8_t> boundary = detail::boundary_vertices(p_mesh);
+        std::vector<vertex_curvature> result(p_mesh.vertex_count());
+        parallel_for(result.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            for (std::size_t v = p_begin; v < p_end; ++v)
+            {
+                vertex_curvature& curvature = result[v];
+                const vector3& p = p_mesh.vertices[v];
+                if (p_areas[v] <= 0.0)
+                    continue;
+
+                // Normal and angle sum from the incident triangles
+                vector3 normal;
+                double angles = 0.0;
+                for (std::uint32_t k = adjacency.offsets[v]; k < adjacency.offsets[v + 1]; ++k)
+                {
+                    const std::uint32_t t = adjacency.triangles[k];
+                    const std::size_t c = detail::corner_of(p_mesh, t, static_cast<std::uint32_t>(v));
+                    const vector3 e1 = p_mesh.vertices[p_mesh.indices[t * 3 + (c + 1) % 3]] - p;
+                    const vector3 e2 = p_mesh.vertices[p_mesh.indices[t * 3 + (c + 2) % 3]] - p;
+                    const vector3 n = e1.cross(e2);
+                    normal += n;
+                    angles += std::atan2(n.length(), e1.dot(e2));
+                }
+                if (normal.length2() == 0.0)
+                    continue;
+                normal = normal.normalized();
+                curvature.normal = normal;
+
+                // Laplacian of the position is minus twice the mean curvature normal times the area
+                vector3 laplace;
+                for (std::uint32_t k = p_laplacian.offsets[v]; k < p_laplacian.offsets[v + 1]; ++k)
+                    laplace += (p_mesh.vertices[p_laplacian.columns[k]] - p) * p_laplacian.values[k];
+                curvature.mean = -laplace.dot(normal) / (2.0 * p_areas[v]);
+                curvature.gaussian = ((boundary[v] ? pi : 2.0 * pi) - angles) / p_areas[v];
+                const double spread = std::sqrt(std::max(curvature.mean * curvature.mean - curvature.gaussian, 0.0));
+                curvature.k1 = curvature.mean + spread;
+                curvature.k2 = curvature.mean - spread;
+
+                // Tangent frame
+                const vector3 axis = std::abs(normal.x) < std::abs(normal.y)
+                    ? (std::abs(normal.x) < std::abs(normal.z) ? vector3(1.0, 0.0, 0.0) : vector3(0.0, 0.0, 1.0))
+                    : (std::abs(normal.y) < std::abs(normal.z) ? vector3(0.0, 1.0, 0.0) : vector3(0.0, 0.0, 1.0));
+                const vector3 u = normal.cross(axis).normalized();
+                const vector3 w = normal.cross(u);
+
+                // Fit k(theta) = a cos^2 + 2 b cos sin + c sin^2 to the edge normal curvatures
+                double m[3][3] = {};
+                double r[3] = {};
+                for (std::uint32_t k = p_laplacian.offsets[v]; k < p_laplacian.offsets[v + 1]; ++k)
+                {
+                    const vector3 d = p_mesh.vertices[p_laplacian.columns[k]] - p;
+                    const double length2 = d.length2();
+                    if (p_laplacian.columns[k] == v || length2 == 0.0)
+                        continue;
+                    const double kappa = -2.0 * d.dot(normal) / length2;
+                    const double x = d.dot(u);
+                    const double y = d.dot(w);
+                    const double t2 = x * x + y * y;
+                    if (t2 == 0.0)
+                        continue;
+                    const double row[3] = { x * x / t2, 2.0 * x * y / t2, y * y / t2 };
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        for (int j = 0; j < 3; ++j)
+                            m[i][j] += row[i] * row[j];
+                        r[i] += row[i] * kappa;
+                    }
+                }
+                const double det =
+                    m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+                    m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                    m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+                double theta = 0.0;
+                if (std::abs(det) > 1e-12)
+                {
+                    // Cramer's rule for the tensor entries
+                    const double a = (r[0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) - m[0][1] * (r[1] * m[2][2] - m[1][2] * r[2]) + m[0][2] * (r[1] * m[2][1] - m[1][1] * r[2])) / det;
+                    const double b = (m[0][0] * (r[1] * m[2][2] - m[1][2] * r[2]) - r[0] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) + m[0][2] * (m[1][0] * r[2] - r[1] * m[2][0])) / det;
+                    const double c = (m[0][0] * (m[1][1] * r[2] - r[1] * m[2][1]) - m[0][1] * (m[1][0] * r[2] - r[1] * m[2][0]) + r[0] * (m[1][0] * m[2][1] - m[1][1] * m[2][0])) / det;
+                    theta = 0.5 * std::atan2(2.0 * b, a - c);
+                }
+                curvature.direction1 = u * std::cos(theta) + w * std::sin(theta);
+                curvature.direction2 = normal.cross(curvature.direction1);
+            }
+        }, 512);
+        return result;
+    }
+
+    /// Estimate curvature at every vertex
+    /// @param p_mesh               Mesh
+    /// @return                     Curvature per vertex
+    inline std::vector<vertex_curvature> compute_curvature(const indexed_mesh& p_mesh)
+    {
+        return compute_curvature(p_mesh, build_cotangent_laplacian(p_mesh), compute_vertex_areas(p_mesh));
+    }
+
+    /// Smooth vertex positions with an assembled Laplacian
+    ///
+    /// Each step moves every vertex towards the average of its neighbours
+    /// weighted by the Laplacian row, as one parallel sparse product over all
+    /// three coordinates. The weights are not recomputed, so a matrix built
+    /// once serves every iteration. A negative mu adds Taubin's inflating
+    /// step, which removes noise without shrinking the surface.
+    /// @param p_mesh               Mesh whose vertices are smoothed
+    /// @param p_laplacian          Laplacian of the mesh (e.g. from build_cotangent_laplacian())
+    /// @param p_options            Smoothing options
+    inline void smooth_laplacian(indexed_mesh& p_mesh, const sparse_matrix& p_laplacian, const smoothing_options& p_options = smoothing_options{})
+    {
+        MESH_PROFILE_SCOPE("curvature.smooth", p_mesh.vertex_count());
+
+        // Inverse of the total weight per vertex; zero keeps a vertex in place
+        const std::vector<std::uint8_t> boundary = p_options.fix_boundary ? detail::boundary_vertices(p_mesh) : std::vector<std::uint8_t>(p_mesh.vertex_count(), 0);
+        std::vector<double> scale = p_laplacian.diagonal();
+        for (std::size_t v = 0; v < scale.size(); ++v)
+            scale[v] = scale[v] < 0.0 && !boundary[v] ? -1.0 / scale[v] : 0.0;
+
+        std::vector<vector3> laplace(p_mesh.vertex_count());
+        auto step = [&](const double p_factor)
+        {
+            p_laplacian.multiply(p_mesh.vertices.data(), laplace.data());
+            parallel_for(laplace.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t v = p_begin; v < p_end; ++v)
+                    p_mesh.vertices[v] += laplace[v] * (p_factor * scale[v]);
+            }, 4096);
+        };
+        for (int i = 0; i < p_options.iterations; ++i)
+        {
+            step(p_options.lambda);
+            if (p_options.mu != 0.0)
+                step(p_options.mu);
+        }
+    }
+}
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mesh_aabb3.hpp"
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+#include "mesh_spatial_hash.hpp"
+
+namespace mesh
+{
+    /// Connected area that differs between two revisions of a mesh
+    struct mesh_diff_region
+    {
+        aabb3 bounds = aabb3::empty();          ///< Bounds of the changed triangles of both revisions
+        std::vector<std::uint32_t> removed;     ///< Old triangles in the region
+        std::vector<std::uint32_t> added;       ///< New triangles in the region
+    };
+
+    /// Geometric difference between two revisions of a mesh
+    struct mesh_diff
+    {
+        std::vector<std::uint32_t> matches;     ///< Matching new triangle of each old triangle (no_neighbor if removed)
+        std::vector<std::uint32_t> removed;     ///< Old triangles without a match, ascending
+        std::vector<std::uint32_t> added;       ///< New triangles without a match, ascending
+        std::vector<mesh_diff_region> regions;  ///< Changed areas, ordered by their first changed triangle
+
+        /// Check whether the revisions describe the same geometry
+        /// @return                     True if every triangle has a match
+        bool identical() const
+        {
+            return removed.empty() && added.empty();
+        }
+    };
+
+    namespace detail
+    {
+        /// Finalize a 64-bit hash (SplitMix64)
+        constexpr std::uint64_t mix_hash(std::uint64_t p_value)
+        {
+            p_value += 0x9E3779B97F4A7C15ull;
+            p_value = (p_value ^ (p_value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            p_value = (p_value ^ (p_value >> 27)) * 0x94D049BB133111EBull;
+            return p_value ^ (p_value >> 31);
+        }
+
+        /// Get the centroid of a mesh triangle
+        inline vector3 triangle_centroid(const indexed_mesh& p_mesh, const std::size_t p_triangle)
+        {
+            const std::uint32_t* tri = p_mesh.indices.data() + p_triangle * 3;
+            return (p_mesh.vertices[tri[0]] + p_mesh.vertices[tri[1]] + p_mesh.vertices[tri[2]]) / 3.0;
+        }
+
+        /// Check whether two triangles have the same corners within a tolerance, allowing a cyclic rotation
+        inline bool corners_match(const indexed_mesh& p_a, const std::size_t p_ta, const indexed_mesh& p_b, const std::size_t p_tb, const double p_tolerance2)
+        {
+            const std::uint32_t* a = p_a.indices.data() + p_ta * 3;
+            const std::uint32_t* b = p_b.indices.data() + p_tb * 3;
+            for (int r = 0; r < 3; ++r)
+            {
+                bool match = true;
+                for (int i = 0; i < 3 && match; ++i)
+                    match = (p_a.vertices[a[i]] - p_b.vertices[b[(i + r) % 3]]).length2() <= p_tolerance2;
+                if (match)
+                    return true;
+            }
+            return false;
+        }
+    }
+
+    /// Hash the geometry of a mesh independently of its vertex and triangle order
+    ///
+    /// Corners are snapped to a grid with the tolerance as cell size, each
+    /// triangle is hashed from its snapped corners starting at the smallest
+    /// (so the winding counts but the starting corner does not), and the
+    /// triangle hashes are summed. Vertex order, triangle order, duplicate or
+    /// unused vertices and any change that keeps every corner in its cell
+    /// leave the hash unchanged. A corner close to a cell boundary can still
+    /// cross it under a tiny perturbation, so equal hashes are the fast path
+    /// and diff_meshes() decides when they differ.
+    /// @param p_mesh               Mesh
+    /// @param p_tolerance          Grid cell size
+    /// @return                     Geometric hash
+    inline std::uint64_t geometric_hash(const indexed_mesh& p_mesh, const double p_tolerance = 1e-6)
+    {
+        MESH_PROFILE_SCOPE("diff.hash", p_mesh.triangle_count());
+        const double inv_cell = 1.0 / p_tolerance;
+        std::atomic<std::uint64_t> sum(0);
+        parallel_for(p_mesh.triangle_count(), [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            std::uint64_t partial = 0;
+            for (std::size_t t = p_begin; t < p_end; ++t)
+            {
+                std::int64_t cells[3][3];
+                for (int c = 0; c < 3; ++c)
+                {
+                    const vector3& p = p_mesh.vertices[p_mesh.indices[t * 3 + c]];
+                    cells[c][0] = std::llround(p.x * inv_cell);
+                    cells[c][1] = std::llround(p.y * inv_cell);
+                    cells[c][2] = std::llround(p.z * inv_cell);
+                }
+
+                // Start at the lexicographically smallest rotation
+                auto less = [&](const int p_a, const int p_b)
+                {
+                    for (int k = 0; k < 9; ++k)
+                    {
+                        const std::int64_t* a = cells[(p_a + k / 3) % 3];
+                        const std::int64_t* b = cells[(p_b + k / 3) % 3];
+                        if (a[k % 3] != b[k % 3])
+                            return a[k % 3] < b[k % 3];
+                    }
+                    return false;
+                };
+                int first = 0;
+                for (int r = 1; r < 3; ++r)
+                {
+                    if (less(r, first))
+                        first = r;
+                }
+
+                std::uint64_t h = 0;
+                for (int k = 0; k < 9; ++k)
+                    h = detail::mix_hash(h ^ static_cast<std::uint64_t>(cells[(first + k / 3) % 3][k % 3]));
+                partial += h;
+            }
+            sum.fetch_add(partial, std::memory_order_relaxed);
+        }, 4096);
+        return detail::mix_hash(sum.load() ^ p_mesh.triangle_count());
+    }
+
+    /// Compare two revisions of a mesh geometrically
+    ///
+    /// A triangle is unchanged if the other revision has a triangle whose
+    /// corners lie within the tolerance of its own, in the same winding but
+    /// starting at any corner. Candidates are found through a spatial hash of
+    /// the new triangle centroids and tested in parallel; each new triangle
+    /// matches at most one old triangle, lowest old index first, so the
+    /// result does not depend on the thread count. Changed triangles of both
+    /// revisions are grouped into regions for incremental recomputation by
+    /// joining triangles with corners within the tolerance of each other,
+    /// so each region is a connected patch. Both meshes must have valid
+    /// indices.
+    /// @param p_old                Old revision
+    /// @param p_new                New revision
+    /// @param p_tolerance          Largest corner distance still considered unchanged
+    /// @return                     Difference
+    inline mesh_diff diff_meshes(const indexed_mesh& p_old, const indexed_mesh& p_new, const double p_tolerance = 1e-6)
+    {
+        MESH_PROFILE_SCOPE("diff.compare", p_old.triangle_count() + p_new.triangle_count());
+        const std::size_t old_count = p_old.triangle_count();
+        const std::size_t new_count = p_new.triangle_count();
+        const double tolerance2 = p_tolerance * p_tolerance;
+
+        // Centroids move by at most the tolerance when all corners do
+        std::vector<vector3> centroids(new_count);
+        parallel_for(new_count, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            for (std::size_t t = p_begin; t < p_end; ++t)
+                centroids[t] = detail::triangle_centroid(p_new, t);
+        }, 4096);
+        spatial_hash grid(p_tolerance);
+        grid.build(centroids);
+
+        // Lowest matching new triangle of each old triangle
+        mesh_diff result;
+        result.matches.assign(old_count, no_neighbor);
+        parallel_for(old_count, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            for (std::size_t t = p_begin; t < p_end; ++t)
+            {
+                grid.query_radius(detail::triangle_centroid(p_old, t), p_tolerance, [&](const std::uint32_t p_index, const vector3&, const double)
+                {
+                    if (p_index < result.matches[t] && detail::corners_match(p_old, t, p_new, p_index, tolerance2))
+                        result.matches[t] = p_index;
+                });
+            }
+        }, 256);
+
+        // Resolve duplicates serially: later old triangles take the next free match
+        std::vector<std::uint8_t> used(new_count, 0);
+        for (std::size_t t = 0; t < old_count; ++t)
+        {
+            std::uint32_t match = result.matches[t];
+            if (match != no_neighbor && used[match])
+            {
+                match = no_neighbor;
+                grid.query_radius(detail::triangle_centroid(p_old, t), p_tolerance, [&](const std::uint32_t p_index, const vector3&, const double)
+                {
+                    if (p_index < match && !used[p_index] && detail::corners_match(p_old, t, p_new, p_index, tolerance2))
+                        match = p_index;
+                });
+                result.matches[t] = match;
+            }
+            if (match != no_neighbor)
+                used[match] = 1;
+            else
+                result.removed.push_back(static_cast<std::uint32_t>(t));
+        }
+        for (std::size_t t = 0; t < new_count; ++t)
+        {
+            if (!used[t])
+                result.added.push_back(static_cast<std::uint32_t>(t));
+        }
+        if (result.identical())
+            return result;
+
+        // Group changed triangles with corners within the tolerance of each other
+        MESH_PROFILE_SCOPE("diff.regions", result.removed.size() + result.added.size());
+        const std::size_t changed = result.removed.size() + result.added.size();
+        std::vector<vector3> corners(changed * 3);
+        for (std::size_t i = 0; i < changed; ++i)
+        {
+            const triangle3 tri = i < result.removed.size() ? p_old.triangle(result.removed[i]) : p_new.triangle(result.added[i - result.removed.size()]);
+            corners[i * 3 + 0] = tri.point1;
+            corners[i * 3 + 1] = tri.point2;
+            corners[i * 3 + 2] = tri.point3;
+        }
+        spatial_hash corner_grid(p_tolerance);
+        corner_grid.build(corners);
+
+        std::vector<std::uint32_t> parent(changed);
+        for (std::size_t i = 0; i < changed; ++i)
+            parent[i] = static_cast<std::uint32_t>(i);
+        auto find = [&](std::uint32_t p_item)
+        {
+            while (parent[p_item] != p_item)
+                p_item = parent[p_item] = parent[parent[p_item]];
+            return p_item;
+        };
+        for (std::size_t c = 0; c < corners.size(); ++c)
+        {
+            corner_grid.query_radius(corners[c], p_tolerance, [&](const std::uint32_t p_index, const vector3&, const double)
+            {
+                const std::uint32_t a = find(static_cast<std::uint32_t>(c / 3));
+                const std::uint32_t b = find(p_index / 3);
+                if (a != b)
+                    parent[std::max(a, b)] = std::min(a, b);
+            });
+        }
+
+        // Regions in order of their smallest member, removed triangles before added ones
+        std::vector<std::uint32_t> region(changed, no_neighbor);
+        for (std::size_t i = 0; i < changed; ++i)
+        {
+            const std::uint32_t root = find(static_cast<std::uint32_t>(i));
+            if (region[root] == no_neighbor)
+            {
+                region[root] = static_cast<std::uint32_t>(result.regions.size());
+                result.regions.emplace_back();
+            }
+            mesh_diff_region& r = result.regions[region[root]];
+            r.bounds.expand(corners[i * 3 + 0]);
+            r.bounds.expand(corners[i * 3 + 1]);
+            r.bounds.expand(corners[i * 3 + 2]);
+            if (i < result.removed.size())
+                r.removed.push_back(result.removed[i]);
+            else
+                r.added.push_back(result.added[i - result.removed.size()]);
+        }
+        return result;
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "mesh_vector3.hpp"
+
+namespace mesh
+{
+    /// Approximate reciprocal square root
+    ///
+    /// Starts from a bit-level estimate (3.4e-2 relative error) and refines it
+    /// with Newton iterations, each roughly squaring the error. Measured
+    /// maximum relative errors over positive normal doubles:
+    ///
+    ///     Iterations  Error
+    ///     1           1.8e-3
+    ///     2           4.6e-6
+    ///     3           3.2e-11
+    ///     4           4.3e-16 (about two ulps, like the exact path)
+    ///
+    /// The default of three iterations is the cheapest that stays below 1e-6.
+    /// Lengths and normalized vectors add at most a few ulps on top.
+    ///
+    /// Only normal positive inputs are covered by these bounds. Zero gives a
+    /// large finite value rather than infinity, so zero vectors stay zero when
+    /// scaled by it; denormals, infinities and NaN are not supported.
+    /// @tparam Iterations          Number of Newton iterations
+    /// @param p_value              Positive value
+    /// @return                     Approximately 1 / sqrt(p_value)
+    template <int Iterations = 3>
+    inline double fast_rsqrt(const double p_value)
+    {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &p_value, sizeof(bits));
+        bits = 0x5FE6EB50C7B537A9ull - (bits >> 1);
+        double y = 0.0;
+        std::memcpy(&y, &bits, sizeof(y));
+
+        const double half = p_value * 0.5;
+        for (int i = 0; i < Iterations; ++i)
+            y = y * (1.5 - half * y * y);
+        return y;
+    }
+
+    /// Approximate vector length
+    /// @tparam Iterations          Number of Newton iterations (see fast_rsqrt for error bounds)
+    /// @param p_v                  Vector
+    /// @return                     Length
+    template <int Iterations = 3>
+    inline double fast_length(const vector3& p_v)
+    {
+        const double l2 = p_v.length2();
+        return l2 * fast_rsqrt<Iterations>(l2);
+    }
+
+    /// Approximate normalized vector, multiplying by the reciprocal length
+    ///
+    /// Branch-free: the zero vector maps to itself without a special case.
+    /// @tparam Iterations          Number of Newton iterations (see fast_rsqrt for error bounds)
+    /// @param p_v                  Vector
+    /// @return                     Normalized vector
+    template <int Iterations = 3>
+    inline vector3 fast_normalized(const vector3& p_v)
+    {
+        return p_v * fast_rsqrt<Iterations>(p_v.length2());
+    }
+
+    /// Approximate lengths of a packed list of vectors
+    ///
+    /// The loop body is branch-free so compilers vectorize it.
+    /// @tparam Iterations          Number of Newton iterations (see fast_rsqrt for error bounds)
+    /// @param p_vectors            Vectors
+    /// @param p_count              Number of vectors
+    /// @param p_results            Length per vector (p_count entries)
+    template <int Iterations = 3>
+    inline void fast_lengths(const vector3* p_vectors, const std::size_t p_count, double* p_results)
+    {
+        for (std::size_t i = 0; i < p_count; ++i)
+            p_results[i] = fast_length<Iterations>(p_vectors[i]);
+    }
+
+    /// Approximately normalize a packed list of vectors
+    ///
+    /// The loop body is branch-free so compilers vectorize it. Input and output
+    /// may be the same array.
+    /// @tparam Iterations          Number of Newton iterations (see fast_rsqrt for error bounds)
+    /// @param p_vectors            Vectors
+    /// @param p_count              Number of vectors
+    /// @param p_results            Normalized vector per input (p_count entries)
+    template <int Iterations = 3>
+    inline void fast_normalize(const vector3* p_vectors, const std::size_t p_count, vector3* p_results)
+    {
+        for (std::size_t i = 0; i < p_count; ++i)
+            p_results[i] = fast_normalized<Iterations>(p_vectors[i]);
+    }
+
+    /// Exactly normalize a packed list of vectors
+    /// @param p_vectors            Vectors
+    /// @param p_count              Number of vectors
+    /// @param p_results            Normalized vector per input (p_count entries)
+    inline void normalize(const vector3* p_vectors, const std::size_t p_count, vector3* p_results)
+    {
+        for (std::size_t i = 0; i < p_count; ++i)
+            p_results[i] = p_vectors[i].normalized();
+    }
+}
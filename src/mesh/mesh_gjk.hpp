@@ -0,0 +1,930 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_plane3.hpp"
+#include "mesh_profile.hpp"
+#include "mesh_transform3.hpp"
+
+namespace mesh
+{
+    // Convex shapes are described by support policies: any type with a member
+    //
+    //     vector3 support(const vector3& p_direction, std::uint32_t& p_hint) const
+    //
+    // returning the point of the shape furthest along p_direction. The hint is
+    // per-query state a shape may use to start its search (hill-climbing hulls
+    // use it as the last support vertex); other shapes ignore it. The GJK and
+    // EPA functions are templates over both shapes so each pair of shapes gets
+    // its own fully inlined loop.
+
+    /// Sphere support policy
+    struct sphere_shape
+    {
+        vector3 center;             ///< Sphere center
+        double radius = 0.0;        ///< Sphere radius
+
+        /// Get the support point in a direction
+        vector3 support(const vector3& p_direction, std::uint32_t&) const
+        {
+            return center + p_direction.normalized() * radius;
+        }
+    };
+
+    /// Axis-aligned box support policy
+    struct box_shape
+    {
+        vector3 center;             ///< Box center
+        vector3 half_extents;       ///< Box half size along each axis
+
+        /// Get the support point in a direction
+        constexpr vector3 support(const vector3& p_direction, std::uint32_t&) const
+        {
+            return vector3{
+                center.x + (p_direction.x >= 0.0 ? half_extents.x : -half_extents.x),
+                center.y + (p_direction.y >= 0.0 ? half_extents.y : -half_extents.y),
+                center.z + (p_direction.z >= 0.0 ? half_extents.z : -half_extents.z)
+            };
+        }
+    };
+
+    /// Capsule support policy
+    struct capsule_shape
+    {
+        vector3 point1;             ///< First segment end point
+        vector3 point2;             ///< Second segment end point
+        double radius = 0.0;        ///< Capsule radius
+
+        /// Get the support point in a direction
+        vector3 support(const vector3& p_direction, std::uint32_t&) const
+        {
+            const vector3& end = point1.dot(p_direction) >= point2.dot(p_direction) ? point1 : point2;
+            return end + p_direction.normalized() * radius;
+        }
+    };
+
+    /// Point cloud support policy (convex hull of the points, searched linearly)
+    struct point_cloud_shape
+    {
+        const vector3* points = nullptr;    ///< Points (not owned)
+        std::size_t count = 0;              ///< Number of points
+
+        /// Get the support point in a direction (the origin for an empty cloud)
+        vector3 support(const vector3& p_direction, std::uint32_t& p_hint) const
+        {
+            p_hint = 0;
+            if (count == 0)
+                return vector3{ 0.0, 0.0, 0.0 };
+
+            std::size_t best = 0;
+            double best_dot = points[0].dot(p_direction);
+            for (std::size_t i = 1; i < count; ++i)
+            {
+                const double d = points[i].dot(p_direction);
+                if (d > best_dot)
+                {
+                    best_dot = d;
+                    best = i;
+                }
+            }
+
+            p_hint = static_cast<std::uint32_t>(best);
+            return points[best];
+        }
+    };
+
+    /// Support policy of a shape placed by an affine transform
+    ///
+    /// The support of the transformed shape along d is the transformed support
+    /// of the local shape along L^T d, where L is the linear part, so any policy
+    /// can be moved, rotated or scaled without rebuilding it. Use a reference
+    /// type (transformed_shape<const convex_hull_shape&>) to avoid copying large
+    /// shapes.
+    /// @tparam TShape              Support policy in the local frame
+    template <typename TShape>
+    struct transformed_shape
+    {
+        TShape shape;               ///< Shape in its local frame
+        transform3 transform;       ///< Local to world transform (the linear part must be invertible)
+
+        /// Get the support point in a direction
+        vector3 support(const vector3& p_direction, std::uint32_t& p_hint) const
+        {
+            const vector3 local{ transform.x_axis.dot(p_direction), transform.y_axis.dot(p_direction), transform.z_axis.dot(p_direction) };
+            return transform.transform_point(shape.support(local, p_hint));
+        }
+    };
+
+    /// Convex hull support policy with vertex adjacency for hill-climbing
+    ///
+    /// Support queries walk from the hint vertex to the neighbour that is
+    /// furthest along the direction until no neighbour improves, which on a
+    /// convex hull ends at the global support vertex. With warm-started hints
+    /// the walk usually takes a step or two.
+    struct convex_hull_shape
+    {
+        /// Hull vertices
+        std::vector<vector3> vertices;
+
+        /// Start of each vertex's neighbour list in adjacency (vertex count + 1 entries)
+        std::vector<std::uint32_t> adjacency_offsets;
+
+        /// Neighbour vertex indices
+        std::vector<std::uint32_t> adjacency;
+
+        /// Build a hull from a closed convex triangle mesh
+        /// @param p_mesh               Convex mesh (every vertex must be used by a triangle)
+        /// @return                     Hull with edge adjacency from the triangles
+        static convex_hull_shape from_mesh(const indexed_mesh& p_mesh)
+        {
+            convex_hull_shape hull;
+            hull.vertices = p_mesh.vertices;
+
+            std::vector<std::vector<std::uint32_t>> neighbors(p_mesh.vertex_count());
+            for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+            {
+                for (int e = 0; e < 3; ++e)
+                {
+                    const std::uint32_t i = p_mesh.indices[t * 3 + e];
+                    const std::uint32_t j = p_mesh.indices[t * 3 + (e + 1) % 3];
+                    neighbors[i].push_back(j);
+                    neighbors[j].push_back(i);
+                }
+            }
+
+            hull.set_adjacency(neighbors);
+            return hull;
+        }
+
+        /// Build a hull from bounding planes (normals facing outward)
+        ///
+        /// Vertices are the intersections of plane triples that lie inside all
+        /// planes; two vertices are adjacent when they share two planes.
+        /// Intended for small hulls: the cost is cubic in the plane count.
+        /// @param p_planes             Bounding planes of a closed convex region
+        /// @param p_tolerance          Distance tolerance for inside and duplicate tests
+        /// @return                     Hull with vertices and edge adjacency
+        static convex_hull_shape from_planes(const std::vector<plane3>& p_planes, const double p_tolerance = 1e-9)
+        {
+            convex_hull_shape hull;
+            std::vector<std::vector<std::uint32_t>> vertex_planes;
+            const std::size_t n = p_planes.size();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                for (std::size_t j = i + 1; j < n; ++j)
+                {
+                    for (std::size_t k = j + 1; k < n; ++k)
+                    {
+                        // Solve the three plane equations by Cramer's rule
+                        const vector3& n1 = p_planes[i].normal;
+                        const vector3& n2 = p_planes[j].normal;
+                        const vector3& n3 = p_planes[k].normal;
+                        const vector3 c23 = n2.cross(n3);
+                        const double det = n1.dot(c23);
+                        if (std::abs(det) <= 1e-12)
+                            continue;
+
+                        const vector3 point = (c23 * p_planes[i].distance +
+                                               n3.cross(n1) * p_planes[j].distance +
+                                               n1.cross(n2) * p_planes[k].distance) / det;
+
+                        // Keep points inside every plane
+                        bool inside = true;
+                        for (const auto& plane : p_planes)
+                        {
+                            if (plane.distance_to(point) > p_tolerance)
+                            {
+                                inside = false;
+                                break;
+                            }
+                        }
+                        if (!inside)
+                            continue;
+
+                        // Merge with an existing vertex at the same position
+                        std::size_t v = 0;
+                        while (v < hull.vertices.size() && (hull.vertices[v] - point).length2() > p_tolerance * p_tolerance)
+                            ++v;
+                        if (v == hull.vertices.size())
+                        {
+                            hull.vertices.push_back(point);
+                            vertex_planes.emplace_back();
+                        }
+
+                        auto& planes = vertex_planes[v];
+                        for (const std::size_t p : { i, j, k })
+                        {
+                            if (std::find(planes.begin(), planes.end(), static_cast<std::uint32_t>(p)) == planes.end())
+                                planes.push_back(static_cast<std::uint32_t>(p));
+                        }
+                    }
+                }
+            }
+
+            // Vertices sharing two planes lie on a common edge
+            std::vector<std::vector<std::uint32_t>> neighbors(hull.vertices.size());
+            for (std::size_t a = 0; a < hull.vertices.size(); ++a)
+            {
+                for (std::size_t b = a + 1; b < hull.vertices.size(); ++b)
+                {
+                    int shared = 0;
+                    for (const std::uint32_t p : vertex_planes[a])
+                        shared += std::count(vertex_planes[b].begin(), vertex_planes[b].end(), p) != 0 ? 1 : 0;
+                    if (shared >= 2)
+                    {
+                        neighbors[a].push_back(static_cast<std::uint32_t>(b));
+                        neighbors[b].push_back(static_cast<std::uint32_t>(a));
+                    }
+                }
+            }
+
+            hull.set_adjacency(neighbors);
+            return hull;
+        }
+
+        /// Get the support point in a direction
+        vector3 support(const vector3& p_direction, std::uint32_t& p_hint) const
+        {
+            std::uint32_t current = p_hint < vertices.size() ? p_hint : 0;
+            double best = vertices[current].dot(p_direction);
+            for (;;)
+            {
+                // Move to the best improving neighbour
+                const std::uint32_t from = current;
+                for (std::uint32_t n = adjacency_offsets[from]; n < adjacency_offsets[from + 1]; ++n)
+                {
+                    const double d = vertices[adjacency[n]].dot(p_direction);
+                    if (d > best)
+                    {
+                        best = d;
+                        current = adjacency[n];
+                    }
+                }
+
+                if (current == from)
+                    break;
+            }
+
+            p_hint = current;
+            return vertices[current];
+        }
+
+    private:
+        /// Store per-vertex neighbour lists (deduplicated) as compressed rows
+        void set_adjacency(std::vector<std::vector<std::uint32_t>>& p_neighbors)
+        {
+            adjacency_offsets.assign(1, 0);
+            adjacency.clear();
+            for (auto& list : p_neighbors)
+            {
+                std::sort(list.begin(), list.end());
+                list.erase(std::unique(list.begin(), list.end()), list.end());
+                adjacency.insert(adjacency.end(), list.begin(), list.end());
+                adjacency_offsets.push_back(static_cast<std::uint32_t>(adjacency.size()));
+            }
+        }
+    };
+
+    /// Warm-start state carried between GJK queries on the same shape pair
+    ///
+    /// Stores the search directions of the final simplex and the support hints.
+    /// The next query re-evaluates the supports along those directions at the
+    /// shapes' current positions, so for small motions it starts next to the
+    /// answer. A default constructed cache starts cold.
+    struct gjk_cache
+    {
+        int count = 0;                      ///< Number of cached simplex directions
+        vector3 directions[4];              ///< Search direction of each simplex vertex
+        std::uint32_t hint_a = 0;           ///< Support hint of the first shape
+        std::uint32_t hint_b = 0;           ///< Support hint of the second shape
+    };
+
+    /// Result of a convex distance or penetration query
+    struct convex_contact
+    {
+        bool intersecting = false;          ///< Shapes overlap or touch
+        double distance = 0.0;              ///< Separation distance, or negative penetration depth
+        vector3 normal;                     ///< Unit direction from the first shape to the second
+        vector3 point_a;                    ///< Closest (or deepest) point on the first shape
+        vector3 point_b;                    ///< Closest (or deepest) point on the second shape
+        int iterations = 0;                 ///< GJK iterations used
+    };
+
+    namespace detail
+    {
+        /// GJK iteration limit
+        constexpr int gjk_max_iterations = 64;
+
+        /// EPA iteration limit
+        constexpr int epa_max_iterations = 128;
+
+        /// Relative GJK progress tolerance on the squared distance
+        constexpr double gjk_tolerance = 1e-10;
+
+        /// Relative squared distance treated as touching
+        constexpr double gjk_touch_tolerance = 1e-24;
+
+        /// Relative EPA convergence tolerance
+        constexpr double epa_tolerance = 1e-8;
+
+        /// Minkowski difference vertex
+        struct gjk_vertex
+        {
+            vector3 w;                      ///< Difference point (a - b)
+            vector3 a;                      ///< Support point on the first shape
+            vector3 b;                      ///< Support point on the second shape
+            vector3 direction;              ///< Search direction that produced the vertex
+        };
+
+        /// GJK simplex with the barycentric weights of its closest point
+        struct gjk_simplex
+        {
+            gjk_vertex vertices[4];
+            double weights[4] = {};
+            int count = 0;
+
+            /// Combine the vertices with the current weights
+            vector3 point_a() const
+            {
+                vector3 p{ 0.0, 0.0, 0.0 };
+                for (int i = 0; i < count; ++i)
+                    p += vertices[i].a * weights[i];
+                return p;
+            }
+
+            /// Combine the vertices with the current weights
+            vector3 point_b() const
+            {
+                vector3 p{ 0.0, 0.0, 0.0 };
+                for (int i = 0; i < count; ++i)
+                    p += vertices[i].b * weights[i];
+                return p;
+            }
+        };
+
+        /// Support mapping of the Minkowski difference A - B
+        template <typename TShapeA, typename TShapeB>
+        struct minkowski_difference
+        {
+            const TShapeA& shape_a;
+            const TShapeB& shape_b;
+            std::uint32_t hint_a;
+            std::uint32_t hint_b;
+
+            gjk_vertex support(const vector3& p_direction)
+            {
+                gjk_vertex v;
+                v.direction = p_direction;
+                v.a = shape_a.support(p_direction, hint_a);
+                v.b = shape_b.support(-p_direction, hint_b);
+                v.w = v.a - v.b;
+                return v;
+            }
+        };
+
+        /// Reduce a simplex to a single vertex
+        inline void simplex_keep(gjk_simplex& p_s, const int p_i)
+        {
+            p_s.vertices[0] = p_s.vertices[p_i];
+            p_s.weights[0] = 1.0;
+            p_s.count = 1;
+        }
+
+        /// Reduce a simplex to an edge with weights
+        inline void simplex_keep(gjk_simplex& p_s, const int p_i, const int p_j, const double p_wi, const double p_wj)
+        {
+            const gjk_vertex vi = p_s.vertices[p_i];
+            const gjk_vertex vj = p_s.vertices[p_j];
+            p_s.vertices[0] = vi;
+            p_s.vertices[1] = vj;
+            p_s.weights[0] = p_wi;
+            p_s.weights[1] = p_wj;
+            p_s.count = 2;
+        }
+
+        /// Closest point of the segment simplex to the origin
+        inline void simplex_segment(gjk_simplex& p_s)
+        {
+            const vector3& a = p_s.vertices[0].w;
+            const vector3 ab = p_s.vertices[1].w - a;
+            const double len2 = ab.length2();
+            const double t = len2 > 0.0 ? -a.dot(ab) / len2 : 0.0;
+            if (t <= 0.0)
+                simplex_keep(p_s, 0);
+            else if (t >= 1.0)
+                simplex_keep(p_s, 1);
+            else
+                simplex_keep(p_s, 0, 1, 1.0 - t, t);
+        }
+
+        /// Closest point of a triangle of simplex vertices to the origin (Ericson's region tests)
+        /// @return                     Squared distance of the closest point
+        inline double simplex_triangle(gjk_simplex& p_s, const int p_ia, const int p_ib, const int p_ic)
+        {
+            const gjk_vertex va = p_s.vertices[p_ia];
+            const gjk_vertex vb = p_s.vertices[p_ib];
+            const gjk_vertex vc = p_s.vertices[p_ic];
+            const vector3& a = va.w;
+            const vector3& b = vb.w;
+            const vector3& c = vc.w;
+            const vector3 ab = b - a;
+            const vector3 ac = c - a;
+
+            auto finish = [&](const int p_count, const gjk_vertex* p_v, const double* p_w)
+            {
+                for (int i = 0; i < p_count; ++i)
+                {
+                    p_s.vertices[i] = p_v[i];
+                    p_s.weights[i] = p_w[i];
+                }
+                p_s.count = p_count;
+                vector3 p{ 0.0, 0.0, 0.0 };
+                for (int i = 0; i < p_count; ++i)
+                    p += p_v[i].w * p_w[i];
+                return p.length2();
+            };
+
+            const double d1 = -ab.dot(a);
+            const double d2 = -ac.dot(a);
+            if (d1 <= 0.0 && d2 <= 0.0)
+            {
+                const double w[] = { 1.0 };
+                return finish(1, &va, w);
+            }
+
+            const double d3 = -ab.dot(b);
+            const double d4 = -ac.dot(b);
+            if (d3 >= 0.0 && d4 <= d3)
+            {
+                const double w[] = { 1.0 };
+                return finish(1, &vb, w);
+            }
+
+            const double vc_area = d1 * d4 - d3 * d2;
+            if (vc_area <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+            {
+                const double t = d1 / (d1 - d3);
+                const gjk_vertex v[] = { va, vb };
+                const double w[] = { 1.0 - t, t };
+                return finish(2, v, w);
+            }
+
+            const double d5 = -ab.dot(c);
+            const double d6 = -ac.dot(c);
+            if (d6 >= 0.0 && d5 <= d6)
+            {
+                const double w[] = { 1.0 };
+                return finish(1, &vc, w);
+            }
+
+            const double vb_area = d5 * d2 - d1 * d6;
+            if (vb_area <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+            {
+                const double t = d2 / (d2 - d6);
+                const gjk_vertex v[] = { va, vc };
+                const double w[] = { 1.0 - t, t };
+                return finish(2, v, w);
+            }
+
+            const double va_area = d3 * d6 - d5 * d4;
+            if (va_area <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+            {
+                const double t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+                const gjk_vertex v[] = { vb, vc };
+                const double w[] = { 1.0 - t, t };
+                return finish(2, v, w);
+            }
+
+            const double sum = va_area + vb_area + vc_area;
+            if (!(sum > 0.0))
+            {
+                // Degenerate triangle: use the best edge
+                double best = std::numeric_limits<double>::infinity();
+                gjk_simplex best_s;
+                const gjk_vertex verts[] = { va, vb, vc };
+                for (int e = 0; e < 3; ++e)
+                {
+                    gjk_simplex edge;
+                    edge.vertices[0] = verts[e];
+                    edge.vertices[1] = verts[(e + 1) % 3];
+                    edge.count = 2;
+                    simplex_segment(edge);
+                    vector3 p{ 0.0, 0.0, 0.0 };
+                    for (int i = 0; i < edge.count; ++i)
+                        p += edge.vertices[i].w * edge.weights[i];
+                    if (p.length2() < best)
+                    {
+                        best = p.length2();
+                        best_s = edge;
+                    }
+                }
+                p_s = best_s;
+                return best;
+            }
+
+            const double v = vb_area / sum;
+            const double w = vc_area / sum;
+            const gjk_vertex verts[] = { va, vb, vc };
+            const double weights[] = { 1.0 - v - w, v, w };
+            return finish(3, verts, weights);
+        }
+
+        /// Closest point of the tetrahedron simplex to the origin
+        /// @return                     False if the origin is inside the tetrahedron
+        inline bool simplex_tetrahedron(gjk_simplex& p_s)
+        {
+            static constexpr int faces[4][4] = { { 0, 1, 2, 3 }, { 0, 2, 3, 1 }, { 0, 3, 1, 2 }, { 1, 3, 2, 0 } };
+            const vector3& a = p_s.vertices[0].w;
+            const double volume = (p_s.vertices[1].w - a).cross(p_s.vertices[2].w - a).dot(p_s.vertices[3].w - a);
+            double edge = 0.0;
+            for (int i = 1; i < 4; ++i)
+                edge = std::max(edge, (p_s.vertices[i].w - a).length());
+            const bool degenerate = std::abs(volume) <= 1e-12 * edge * edge * edge;
+
+            // Check each face the origin lies in front of
+            const gjk_simplex original = p_s;
+            double best = std::numeric_limits<double>::infinity();
+            gjk_simplex best_s;
+            bool outside = false;
+            for (const auto& f : faces)
+            {
+                const vector3& p0 = original.vertices[f[0]].w;
+                const vector3 n = (original.vertices[f[1]].w - p0).cross(original.vertices[f[2]].w - p0);
+                const double origin_side = -n.dot(p0);
+                const double opposite_side = n.dot(original.vertices[f[3]].w - p0);
+                if (!degenerate && origin_side * opposite_side >= 0.0)
+                    continue;
+
+                outside = true;
+                gjk_simplex face = original;
+                const double d2 = simplex_triangle(face, f[0], f[1], f[2]);
+                if (d2 < best)
+                {
+                    best = d2;
+                    best_s = face;
+                }
+            }
+
+            if (!outside)
+            {
+                // Origin enclosed: weights are unused for intersecting shapes
+                for (int i = 0; i < 4; ++i)
+                    p_s.weights[i] = 0.25;
+                return false;
+            }
+
+            p_s = best_s;
+            return true;
+        }
+
+        /// Closest point of a simplex to the origin, reducing it to the supporting vertices
+        /// @return                     Closest point (zero if the origin is enclosed)
+        inline vector3 simplex_solve(gjk_simplex& p_s)
+        {
+            switch (p_s.count)
+            {
+            case 1:
+                p_s.weights[0] = 1.0;
+                break;
+            case 2:
+                simplex_segment(p_s);
+                break;
+            case 3:
+                simplex_triangle(p_s, 0, 1, 2);
+                break;
+            default:
+                if (!simplex_tetrahedron(p_s))
+                    return vector3{ 0.0, 0.0, 0.0 };
+                break;
+            }
+
+            vector3 p{ 0.0, 0.0, 0.0 };
+            for (int i = 0; i < p_s.count; ++i)
+                p += p_s.vertices[i].w * p_s.weights[i];
+            return p;
+        }
+
+        /// Run GJK on a Minkowski difference
+        /// @return                     True if the origin is enclosed (shapes intersect)
+        template <typename TShapeA, typename TShapeB>
+        bool gjk_run(minkowski_difference<TShapeA, TShapeB>& p_m, gjk_simplex& p_s, vector3& p_v, int& p_iterations, const gjk_cache* p_cache)
+        {
+            // Seed the simplex from the cached directions or an arbitrary direction
+            p_s.count = 0;
+            if (p_cache && p_cache->count > 0)
+            {
+                for (int i = 0; i < p_cache->count; ++i)
+                    p_s.vertices[p_s.count++] = p_m.support(p_cache->directions[i]);
+            }
+            else
+            {
+                p_s.vertices[p_s.count++] = p_m.support(vector3{ 1.0, 0.0, 0.0 });
+            }
+
+            p_v = simplex_solve(p_s);
+            double scale2 = 0.0;
+            for (int i = 0; i < p_s.count; ++i)
+                scale2 = std::max(scale2, p_s.vertices[i].w.length2());
+
+            for (p_iterations = 0; p_iterations < gjk_max_iterations; ++p_iterations)
+            {
+                const double vv = p_v.length2();
+                if (p_s.count == 4 || vv <= gjk_touch_tolerance * scale2)
+                    return true;
+
+                const gjk_vertex w = p_m.support(-p_v);
+                scale2 = std::max(scale2, w.w.length2());
+
+                // Stop when the new support point makes no progress toward the origin
+                if (vv - p_v.dot(w.w) <= gjk_tolerance * vv)
+                    return false;
+
+                bool duplicate = false;
+                for (int i = 0; i < p_s.count; ++i)
+                    duplicate = duplicate || p_s.vertices[i].w == w.w;
+                if (duplicate)
+                    return false;
+
+                // Accept the new simplex only if it moves closer
+                gjk_simplex next = p_s;
+                next.vertices[next.count++] = w;
+                const vector3 v = simplex_solve(next);
+                if (next.count != 4 && v.length2() >= vv)
+                    return false;
+
+                p_s = next;
+                p_v = v;
+            }
+
+            return p_v.length2() <= gjk_touch_tolerance * scale2;
+        }
+
+        /// Store the final simplex and hints in a warm-start cache
+        template <typename TShapeA, typename TShapeB>
+        void gjk_store(const minkowski_difference<TShapeA, TShapeB>& p_m, const gjk_simplex& p_s, gjk_cache* p_cache)
+        {
+            if (!p_cache)
+                return;
+
+            p_cache->count = p_s.count;
+            for (int i = 0; i < p_s.count; ++i)
+                p_cache->directions[i] = p_s.vertices[i].direction;
+            p_cache->hint_a = p_m.hint_a;
+            p_cache->hint_b = p_m.hint_b;
+        }
+
+        /// EPA polytope face
+        struct epa_face
+        {
+            std::uint32_t index[3];
+            vector3 normal;
+            double distance;
+            bool alive;
+        };
+
+        /// Make a face with an outward unit normal (zero area faces get infinite distance)
+        inline epa_face epa_make_face(const std::vector<gjk_vertex>& p_vertices, const std::uint32_t p_a, const std::uint32_t p_b, const std::uint32_t p_c)
+        {
+            epa_face f{ { p_a, p_b, p_c }, vector3{ 0.0, 0.0, 0.0 }, std::numeric_limits<double>::infinity(), true };
+            const vector3& a = p_vertices[p_a].w;
+            const vector3 n = (p_vertices[p_b].w - a).cross(p_vertices[p_c].w - a);
+            const double length = n.length();
+            if (length > 0.0)
+            {
+                f.normal = n / length;
+                f.distance = f.normal.dot(a);
+            }
+            return f;
+        }
+
+        /// Grow a GJK simplex that touches the origin into a tetrahedron
+        template <typename TShapeA, typename TShapeB>
+        bool epa_seed(minkowski_difference<TShapeA, TShapeB>& p_m, gjk_simplex& p_s)
+        {
+            static const vector3 axes[] = {
+                vector3{ 1.0, 0.0, 0.0 }, vector3{ -1.0, 0.0, 0.0 },
+                vector3{ 0.0, 1.0, 0.0 }, vector3{ 0.0, -1.0, 0.0 },
+                vector3{ 0.0, 0.0, 1.0 }, vector3{ 0.0, 0.0, -1.0 }
+            };
+
+            double scale = 0.0;
+            for (int i = 0; i < p_s.count; ++i)
+                scale = std::max(scale, p_s.vertices[i].w.length());
+            const double eps = 1e-10 * std::max(scale, 1e-300);
+
+            if (p_s.count == 1)
+            {
+                for (const auto& d : axes)
+                {
+                    const gjk_vertex v = p_m.support(d);
+                    if ((v.w - p_s.vertices[0].w).length() > eps)
+                    {
+                        p_s.vertices[p_s.count++] = v;
+                        break;
+                    }
+                }
+            }
+
+            if (p_s.count == 2)
+            {
+                const vector3 line = p_s.vertices[1].w - p_s.vertices[0].w;
+                const vector3 e1 = line.cross(std::abs(line.x) < std::abs(line.y) ? vector3{ 1.0, 0.0, 0.0 } : vector3{ 0.0, 1.0, 0.0 });
+                const vector3 e2 = line.cross(e1);
+                for (const auto& d : { e1, e2, -e1, -e2 })
+                {
+                    const gjk_vertex v = p_m.support(d);
+                    if ((v.w - p_s.vertices[0].w).cross(line).length() > eps * line.length())
+                    {
+                        p_s.vertices[p_s.count++] = v;
+                        break;
+                    }
+                }
+            }
+
+            if (p_s.count == 3)
+            {
+                const vector3& a = p_s.vertices[0].w;
+                const vector3 n = (p_s.vertices[1].w - a).cross(p_s.vertices[2].w - a);
+                const gjk_vertex v1 = p_m.support(n);
+                const gjk_vertex v2 = p_m.support(-n);
+                const double d1 = std::abs(n.dot(v1.w - a));
+                const double d2 = std::abs(n.dot(v2.w - a));
+                if (std::max(d1, d2) > eps * n.length())
+                    p_s.vertices[p_s.count++] = d1 >= d2 ? v1 : v2;
+            }
+
+            return p_s.count == 4;
+        }
+
+        /// Expand a tetrahedron enclosing the origin to find the penetration
+        template <typename TShapeA, typename TShapeB>
+        bool epa_run(minkowski_difference<TShapeA, TShapeB>& p_m, const gjk_simplex& p_s, convex_contact& p_result)
+        {
+            std::vector<gjk_vertex> vertices(p_s.vertices, p_s.vertices + 4);
+            std::vector<epa_face> faces;
+            static constexpr std::uint32_t tetra[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+            for (const auto& t : tetra)
+            {
+                // Orient each face away from the opposite vertex
+                epa_face f = epa_make_face(vertices, t[0], t[1], t[2]);
+                if (f.normal.dot(vertices[t[3]].w - vertices[t[0]].w) > 0.0)
+                    f = epa_make_face(vertices, t[0], t[2], t[1]);
+                faces.push_back(f);
+            }
+
+            std::vector<std::uint32_t> edges;
+            epa_face* closest = nullptr;
+            for (int iteration = 0; iteration < epa_max_iterations; ++iteration)
+            {
+                closest = nullptr;
+                for (auto& f : faces)
+                {
+                    if (f.alive && (!closest || f.distance < closest->distance))
+                        closest = &f;
+                }
+                if (!closest || closest->distance == std::numeric_limits<double>::infinity())
+                    return false;
+
+                // Converged when the support point along the face normal is no further out
+                const gjk_vertex w = p_m.support(closest->normal);
+                const double gain = w.w.dot(closest->normal) - closest->distance;
+                if (gain <= epa_tolerance * std::max(1.0, std::abs(closest->distance)))
+                    break;
+
+                // Remove the faces visible from the new point and collect the horizon edges
+                const std::uint32_t index = static_cast<std::uint32_t>(vertices.size());
+                vertices.push_back(w);
+                edges.clear();
+                for (auto& f : faces)
+                {
+                    if (!f.alive || f.normal.dot(w.w - vertices[f.index[0]].w) <= 0.0)
+                        continue;
+
+                    f.alive = false;
+                    for (int e = 0; e < 3; ++e)
+                    {
+                        const std::uint32_t a = f.index[e];
+                        const std::uint32_t b = f.index[(e + 1) % 3];
+                        bool shared = false;
+                        for (std::size_t k = 0; k < edges.size(); k += 2)
+                        {
+                            if (edges[k] == b && edges[k + 1] == a)
+                            {
+                                edges.erase(edges.begin() + static_cast<std::ptrdiff_t>(k), edges.begin() + static_cast<std::ptrdiff_t>(k) + 2);
+                                shared = true;
+                                break;
+                            }
+                        }
+                        if (!shared)
+                        {
+                            edges.push_back(a);
+                            edges.push_back(b);
+                        }
+                    }
+                }
+
+                faces.erase(std::remove_if(faces.begin(), faces.end(), [](const epa_face& p_f) { return !p_f.alive; }), faces.end());
+                for (std::size_t k = 0; k < edges.size(); k += 2)
+                    faces.push_back(epa_make_face(vertices, edges[k], edges[k + 1], index));
+                closest = nullptr;
+            }
+
+            if (!closest)
+            {
+                for (auto& f : faces)
+                {
+                    if (!closest || f.distance < closest->distance)
+                        closest = &f;
+                }
+            }
+
+            // Barycentric coordinates of the origin's projection on the closest face
+            const vector3& a = vertices[closest->index[0]].w;
+            const vector3& b = vertices[closest->index[1]].w;
+            const vector3& c = vertices[closest->index[2]].w;
+            const vector3 p = closest->normal * closest->distance;
+            const vector3 n = (b - a).cross(c - a);
+            const double area = n.length2();
+            const double u = (c - b).cross(p - b).dot(n) / area;
+            const double v = (a - c).cross(p - c).dot(n) / area;
+            const double t = 1.0 - u - v;
+
+            p_result.intersecting = true;
+            p_result.distance = -closest->distance;
+            p_result.normal = closest->normal;
+            p_result.point_a = vertices[closest->index[0]].a * u + vertices[closest->index[1]].a * v + vertices[closest->index[2]].a * t;
+            p_result.point_b = vertices[closest->index[0]].b * u + vertices[closest->index[1]].b * v + vertices[closest->index[2]].b * t;
+            return true;
+        }
+    }
+
+    /// Calculate the distance between two convex shapes (GJK)
+    ///
+    /// Overlapping shapes report intersecting with zero distance; use
+    /// gjk_epa() to also measure the penetration.
+    /// @param p_a                  First shape (support policy)
+    /// @param p_b                  Second shape (support policy)
+    /// @param p_cache              Optional warm-start cache, updated on return
+    /// @return                     Distance, closest points and normal from the first shape to the second
+    template <typename TShapeA, typename TShapeB>
+    convex_contact gjk_distance(const TShapeA& p_a, const TShapeB& p_b, gjk_cache* p_cache = nullptr)
+    {
+        MESH_PROFILE_COUNT("gjk.distance", 1);
+        detail::minkowski_difference<TShapeA, TShapeB> m{ p_a, p_b, p_cache ? p_cache->hint_a : 0u, p_cache ? p_cache->hint_b : 0u };
+        detail::gjk_simplex s;
+        vector3 v;
+
+        convex_contact result;
+        result.intersecting = detail::gjk_run(m, s, v, result.iterations, p_cache);
+        detail::gjk_store(m, s, p_cache);
+        result.point_a = s.point_a();
+        result.point_b = s.point_b();
+        if (!result.intersecting)
+        {
+            result.distance = v.length();
+            result.normal = -v / result.distance;
+        }
+        return result;
+    }
+
+    /// Calculate the signed distance between two convex shapes (GJK, then EPA when overlapping)
+    ///
+    /// For overlapping shapes distance is the negative penetration depth and
+    /// moving the second shape by -distance along normal separates them.
+    /// @param p_a                  First shape (support policy)
+    /// @param p_b                  Second shape (support policy)
+    /// @param p_cache              Optional warm-start cache, updated on return
+    /// @return                     Signed distance, witness points and normal from the first shape to the second
+    template <typename TShapeA, typename TShapeB>
+    convex_contact gjk_epa(const TShapeA& p_a, const TShapeB& p_b, gjk_cache* p_cache = nullptr)
+    {
+        MESH_PROFILE_COUNT("gjk.epa", 1);
+        detail::minkowski_difference<TShapeA, TShapeB> m{ p_a, p_b, p_cache ? p_cache->hint_a : 0u, p_cache ? p_cache->hint_b : 0u };
+        detail::gjk_simplex s;
+        vector3 v;
+
+        convex_contact result;
+        result.intersecting = detail::gjk_run(m, s, v, result.iterations, p_cache);
+        detail::gjk_store(m, s, p_cache);
+        result.point_a = s.point_a();
+        result.point_b = s.point_b();
+        if (!result.intersecting)
+        {
+            result.distance = v.length();
+            result.normal = -v / result.distance;
+            return result;
+        }
+
+        // Touching shapes whose difference has no volume keep a zero depth
+        detail::gjk_simplex tetra = s;
+        if (detail::epa_seed(m, tetra))
+            detail::epa_run(m, tetra, result);
+        return result;
+    }
+}
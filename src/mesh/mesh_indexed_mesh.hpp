@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mesh_aabb3.hpp"
+#include "mesh_triangle3.hpp"
+
+namespace mesh
+{
+    /// Indexed triangle mesh
+    struct indexed_mesh
+    {
+        /// Vertex positions
+        std::vector<vector3> vertices;
+
+        /// Triangle vertex indices (three per triangle)
+        std::vector<std::uint32_t> indices;
+
+        /// Get the number of vertices
+        /// @return                     Vertex count
+        std::size_t vertex_count() const
+        {
+            return vertices.size();
+        }
+
+        /// Get the number of triangles
+        /// @return                     Triangle count
+        std::size_t triangle_count() const
+        {
+            return indices.size() / 3;
+        }
+
+        /// Get a triangle
+        /// @param p_index              Triangle index
+        /// @return                     Triangle
+        triangle3 triangle(const std::size_t p_index) const
+        {
+            return triangle3{
+                vertices[indices[p_index * 3]],
+                vertices[indices[p_index * 3 + 1]],
+                vertices[indices[p_index * 3 + 2]]
+            };
+        }
+
+        /// Add a vertex
+        /// @param p_vertex             Vertex position
+        /// @return                     Index of the new vertex
+        std::uint32_t add_vertex(const vector3& p_vertex)
+        {
+            vertices.push_back(p_vertex);
+            return static_cast<std::uint32_t>(vertices.size() - 1);
+        }
+
+        /// Add a triangle
+        /// @param p_index1             First vertex index
+        /// @param p_index2             Second vertex index
+        /// @param p_index3             Third vertex index
+        void add_triangle(const std::uint32_t p_index1, const std::uint32_t p_index2, const std::uint32_t p_index3)
+        {
+            indices.push_back(p_index1);
+            indices.push_back(p_index2);
+            indices.push_back(p_index3);
+        }
+
+        /// Calculate the bounds of all vertices
+        /// @return                     Bounding box (empty if there are no vertices)
+        aabb3 bounds() const
+        {
+            aabb3 box = aabb3::empty();
+            for (const auto& v : vertices)
+                box.expand(v);
+            return box;
+        }
+
+        /// Remove all vertices and triangles
+        void clear()
+        {
+            vertices.clear();
+            indices.clear();
+        }
+    };
+
+    /// Value marking a boundary edge in edge adjacency
+    constexpr std::uint32_t no_neighbor = UINT32_MAX;
+
+    /// Find the triangle across each triangle edge
+    ///
+    /// Edge e of triangle t runs from corner e to corner (e + 1) % 3. Edges
+    /// shared by exactly two triangles are linked; boundary and non-manifold
+    /// edges get no_neighbor.
+    /// @param p_mesh               Mesh to analyze
+    /// @return                     Neighbour triangle of each edge (three per triangle)
+    inline std::vector<std::uint32_t> compute_edge_adjacency(const indexed_mesh& p_mesh)
+    {
+        // Sort half-edges by their undirected key so shared edges are adjacent
+        struct half_edge
+        {
+            std::uint64_t key;
+            std::uint32_t edge;
+        };
+
+        std::vector<half_edge> edges(p_mesh.indices.size());
+        for (std::size_t i = 0; i < p_mesh.indices.size(); ++i)
+        {
+            const std::uint32_t a = p_mesh.indices[i];
+            const std::uint32_t b = p_mesh.indices[i - i % 3 + (i + 1) % 3];
+            edges[i] = half_edge{ (static_cast<std::uint64_t>(std::min(a, b)) << 32) | std::max(a, b), static_cast<std::uint32_t>(i) };
+        }
+        std::sort(edges.begin(), edges.end(), [](const half_edge& p_a, const half_edge& p_b)
+        {
+            return p_a.key < p_b.key || (p_a.key == p_b.key && p_a.edge < p_b.edge);
+        });
+
+        std::vector<std::uint32_t> neighbors(p_mesh.indices.size(), no_neighbor);
+        for (std::size_t i = 0; i < edges.size();)
+        {
+            std::size_t j = i + 1;
+            while (j < edges.size() && edges[j].key == edges[i].key)
+                ++j;
+            if (j - i == 2)
+            {
+                neighbors[edges[i].edge] = edges[i + 1].edge / 3;
+                neighbors[edges[i + 1].edge] = edges[i].edge / 3;
+            }
+            i = j;
+        }
+        return neighbors;
+    }
+}
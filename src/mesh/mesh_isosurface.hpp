@@ -0,0 +1,600 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+#include "mesh_sdf.hpp"
+
+namespace mesh
+{
+    /// Isosurface extraction method
+    enum class isosurface_method
+    {
+        marching_cubes,     ///< Vertices on grid edges, up to five triangles per cell
+        dual_contouring     ///< One QEF-placed vertex per cell, one quad per crossing edge
+    };
+
+    /// Isosurface extraction options
+    struct isosurface_options
+    {
+        /// Field value of the surface (samples below it are inside)
+        double iso_value = 0.0;
+
+        /// Extraction method
+        isosurface_method method = isosurface_method::marching_cubes;
+
+        /// Number of sample layers processed per parallel slab
+        std::size_t slab_size = 8;
+
+        /// Dual contouring pull towards the mass point, keeping flat and degenerate QEFs stable
+        double qef_regularization = 0.05;
+    };
+
+    namespace detail
+    {
+        /// Marching cubes triangle table
+        ///
+        /// Corner c of a cell is at offset (c & 1, (c >> 1) & 1, (c >> 2) & 1). Edge
+        /// axis * 4 + n runs along axis from the corner whose other two bits are n.
+        /// Each case lists up to five triangles as edge triples ending with -1.
+        struct marching_cubes_table
+        {
+            std::array<std::array<std::int8_t, 16>, 256> triangles{};
+
+            /// Get the edge connecting two corners that differ in one bit
+            static constexpr int edge(const int p_a, const int p_b)
+            {
+                const int axis = (p_a ^ p_b) == 1 ? 0 : (p_a ^ p_b) == 2 ? 1 : 2;
+                return axis * 4 + ((p_a >> ((axis + 1) % 3)) & 1) + 2 * ((p_a >> ((axis + 2) % 3)) & 1);
+            }
+
+            /// Generate the table
+            ///
+            /// Each cube face contributes iso-line segments running from where its
+            /// boundary (walked counter-clockwise from outside) enters the inside to
+            /// where it next leaves, which always separates inside corners on
+            /// ambiguous faces. Both cells sharing a face make the same choice, so the
+            /// result is watertight. The segments chain into loops that are fan
+            /// triangulated with normals facing the outside.
+            static constexpr marching_cubes_table create()
+            {
+                marching_cubes_table table{};
+                for (int c = 0; c < 256; ++c)
+                {
+                    int next[12] = { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 };
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        for (int side = 0; side < 2; ++side)
+                        {
+                            // Face corners counter-clockwise as seen from outside the cube
+                            const int u = (axis + 1) % 3;
+                            const int v = (axis + 2) % 3;
+                            const int cu[4] = { 0, 1, 1, 0 };
+                            const int cv[4] = { 0, 0, 1, 1 };
+                            int corners[4] = {};
+                            for (int n = 0; n < 4; ++n)
+                            {
+                                const int bu = side ? cu[n] : cv[n];
+                                const int bv = side ? cv[n] : cu[n];
+                                corners[n] = (side << axis) | (bu << u) | (bv << v);
+                            }
+
+                            // Link each entering crossing to the following crossing
+                            int crossings[4] = {};
+                            bool entering[4] = {};
+                            int count = 0;
+                            for (int n = 0; n < 4; ++n)
+                            {
+                                const int p = corners[n];
+                                const int q = corners[(n + 1) % 4];
+                                const bool p_inside = ((c >> p) & 1) != 0;
+                                const bool q_inside = ((c >> q) & 1) != 0;
+                                if (p_inside != q_inside)
+                                {
+                                    crossings[count] = edge(p, q);
+                                    entering[count] = q_inside;
+                                    ++count;
+                                }
+                            }
+                            for (int n = 0; n < count; ++n)
+                            {
+                                if (entering[n])
+                                    next[crossings[n]] = crossings[(n + 1) % count];
+                            }
+                        }
+                    }
+
+                    // Chain the segments into loops and fan triangulate them
+                    bool used[12] = {};
+                    int out = 0;
+                    for (int e = 0; e < 12; ++e)
+                    {
+                        if (next[e] < 0 || used[e])
+                            continue;
+
+                        int loop[12] = {};
+                        int length = 0;
+                        for (int x = e; !used[x]; x = next[x])
+                        {
+                            used[x] = true;
+                            loop[length++] = x;
+                        }
+
+                        for (int n = 1; n + 1 < length; ++n)
+                        {
+                            table.triangles[c][out++] = static_cast<std::int8_t>(loop[0]);
+                            table.triangles[c][out++] = static_cast<std::int8_t>(loop[n]);
+                            table.triangles[c][out++] = static_cast<std::int8_t>(loop[n + 1]);
+                        }
+                    }
+                    table.triangles[c][out] = -1;
+                }
+
+                return table;
+            }
+        };
+
+        /// Marching cubes table generated at compile time
+        constexpr marching_cubes_table marching_cubes = marching_cubes_table::create();
+
+        /// Z slab partition shared by both extraction methods
+        struct isosurface_slabs
+        {
+            std::size_t layers = 0;
+            std::size_t slab_size = 1;
+            std::size_t count = 0;
+
+            isosurface_slabs(const std::size_t p_layers, const std::size_t p_slab_size) :
+                layers(p_layers), slab_size(std::max<std::size_t>(p_slab_size, 1)), count((p_layers + slab_size - 1) / slab_size)
+            {
+            }
+
+            /// Get the first layer of a slab
+            std::size_t begin(const std::size_t p_slab) const
+            {
+                return p_slab * slab_size;
+            }
+
+            /// Get one past the last layer of a slab
+            std::size_t end(const std::size_t p_slab) const
+            {
+                return std::min((p_slab + 1) * slab_size, layers);
+            }
+        };
+
+        /// Convert per-layer counts into starting offsets in place
+        /// @return                     Total count
+        inline std::size_t exclusive_scan(std::vector<std::size_t>& p_counts)
+        {
+            std::size_t total = 0;
+            for (std::size_t& c : p_counts)
+            {
+                const std::size_t n = c;
+                c = total;
+                total += n;
+            }
+            return total;
+        }
+
+        /// Calculate the field gradient at a point by central differences
+        inline vector3 field_gradient(const sdf_grid& p_grid, const vector3& p_point)
+        {
+            const double h = p_grid.cell_size * 0.5;
+            return vector3{
+                p_grid.sample(p_point + vector3{ h, 0.0, 0.0 }) - p_grid.sample(p_point - vector3{ h, 0.0, 0.0 }),
+                p_grid.sample(p_point + vector3{ 0.0, h, 0.0 }) - p_grid.sample(p_point - vector3{ 0.0, h, 0.0 }),
+                p_grid.sample(p_point + vector3{ 0.0, 0.0, h }) - p_grid.sample(p_point - vector3{ 0.0, 0.0, h })
+            };
+        }
+
+        /// Solve a symmetric 3x3 system by Cramer's rule
+        /// @return                     False if the system is singular
+        inline bool solve3(const double p_m[6], const vector3& p_b, vector3& p_x)
+        {
+            // Matrix stored as xx, xy, xz, yy, yz, zz
+            const double a = p_m[0], b = p_m[1], c = p_m[2], d = p_m[3], e = p_m[4], f = p_m[5];
+            const double c00 = d * f - e * e;
+            const double c01 = c * e - b * f;
+            const double c02 = b * e - c * d;
+            const double det = a * c00 + b * c01 + c * c02;
+            if (is_zero_approx(det))
+                return false;
+
+            const double c11 = a * f - c * c;
+            const double c12 = b * c - a * e;
+            const double c22 = a * d - b * b;
+            p_x = vector3{
+                c00 * p_b.x + c01 * p_b.y + c02 * p_b.z,
+                c01 * p_b.x + c11 * p_b.y + c12 * p_b.z,
+                c02 * p_b.x + c12 * p_b.y + c22 * p_b.z
+            } / det;
+            return true;
+        }
+
+        /// Place a dual contouring vertex by minimizing the QEF of the cell's edge crossings
+        /// @param p_grid               Sampled field
+        /// @param p_i                  Cell X index
+        /// @param p_j                  Cell Y index
+        /// @param p_k                  Cell Z index
+        /// @param p_corner             Field values at the cell corners
+        /// @param p_cube               Corners below the iso value as a bit mask
+        /// @param p_options            Extraction options
+        /// @return                     Vertex clamped to the cell
+        inline vector3 dual_contouring_vertex(const sdf_grid& p_grid, const std::size_t p_i, const std::size_t p_j, const std::size_t p_k,
+            const double p_corner[8], const int p_cube, const isosurface_options& p_options)
+        {
+            // Accumulate the QEF from the tangent plane at each edge crossing
+            double ata[6] = {};
+            vector3 atb;
+            vector3 mass;
+            int crossings = 0;
+            const vector3 base = p_grid.position(p_i, p_j, p_k);
+            for (int a = 0; a < 8; ++a)
+            {
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    const int b = a | (1 << axis);
+                    if (b == a || ((p_cube >> a) & 1) == ((p_cube >> b) & 1))
+                        continue;
+
+                    const double t = (p_options.iso_value - p_corner[a]) / (p_corner[b] - p_corner[a]);
+                    const vector3 pa = base + vector3{ static_cast<double>(a & 1), static_cast<double>((a >> 1) & 1), static_cast<double>((a >> 2) & 1) } * p_grid.cell_size;
+                    const vector3 pb = base + vector3{ static_cast<double>(b & 1), static_cast<double>((b >> 1) & 1), static_cast<double>((b >> 2) & 1) } * p_grid.cell_size;
+                    const vector3 point = pa.lerp(pb, t);
+                    const plane3 plane{ field_gradient(p_grid, point).normalized(), point };
+
+                    ata[0] += plane.normal.x * plane.normal.x;
+                    ata[1] += plane.normal.x * plane.normal.y;
+                    ata[2] += plane.normal.x * plane.normal.z;
+                    ata[3] += plane.normal.y * plane.normal.y;
+                    ata[4] += plane.normal.y * plane.normal.z;
+                    ata[5] += plane.normal.z * plane.normal.z;
+                    atb += plane.normal * plane.distance;
+                    mass += point;
+                    ++crossings;
+                }
+            }
+            mass /= static_cast<double>(crossings);
+
+            // Solve relative to the mass point with Tikhonov regularization
+            const double w = p_options.qef_regularization;
+            const double m[6] = { ata[0] + w, ata[1], ata[2], ata[3] + w, ata[4], ata[5] + w };
+            const vector3 rhs = atb - vector3{
+                ata[0] * mass.x + ata[1] * mass.y + ata[2] * mass.z,
+                ata[1] * mass.x + ata[3] * mass.y + ata[4] * mass.z,
+                ata[2] * mass.x + ata[4] * mass.y + ata[5] * mass.z
+            };
+            vector3 offset;
+            vector3 vertex = mass;
+            if (solve3(m, rhs, offset))
+                vertex = mass + offset;
+
+            // Keep the vertex inside its cell
+            const vector3 top = base + vector3{ p_grid.cell_size, p_grid.cell_size, p_grid.cell_size };
+            return vector3{
+                std::min(std::max(vertex.x, base.x), top.x),
+                std::min(std::max(vertex.y, base.y), top.y),
+                std::min(std::max(vertex.z, base.z), top.z)
+            };
+        }
+    }
+
+    /// Extract an isosurface from a dense grid with marching cubes
+    ///
+    /// Vertices are created once per crossing grid edge and shared by every
+    /// cell touching it, so no welding is needed. A counting pass sizes the
+    /// mesh per sample layer, then one task per Z slab writes its vertices and
+    /// triangles straight into place, numbering edges in a two-layer cache so
+    /// memory beyond the output stays proportional to one grid slice per task.
+    /// @param p_grid               Sampled field
+    /// @param p_options            Extraction options
+    /// @return                     Indexed mesh with outward-facing triangles
+    inline indexed_mesh extract_marching_cubes(const sdf_grid& p_grid, const isosurface_options& p_options = isosurface_options{})
+    {
+        MESH_PROFILE_SCOPE("isosurface.marching_cubes", p_grid.values.size());
+        indexed_mesh result;
+        if (p_grid.size_x < 2 || p_grid.size_y < 2 || p_grid.size_z < 2)
+            return result;
+
+        const std::size_t nx = p_grid.size_x, ny = p_grid.size_y, nz = p_grid.size_z;
+        const detail::isosurface_slabs slabs(nz, p_options.slab_size);
+        const double iso = p_options.iso_value;
+
+        // Number the crossing edges starting in a sample layer, optionally creating their vertices
+        auto edge_layer = [&](const std::size_t p_k, std::uint32_t* p_cache, std::size_t p_next, const bool p_write)
+        {
+            for (std::size_t j = 0; j < ny; ++j)
+            {
+                for (std::size_t i = 0; i < nx; ++i)
+                {
+                    const std::size_t idx = p_grid.index(i, j, p_k);
+                    const double v0 = p_grid.values[idx];
+                    const std::size_t ends[3] = {
+                        i + 1 < nx ? p_grid.index(i + 1, j, p_k) : idx,
+                        j + 1 < ny ? p_grid.index(i, j + 1, p_k) : idx,
+                        p_k + 1 < nz ? p_grid.index(i, j, p_k + 1) : idx
+                    };
+
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        const double v1 = p_grid.values[ends[axis]];
+                        if ((v0 < iso) == (v1 < iso))
+                            continue;
+
+                        if (p_cache)
+                            p_cache[(j * nx + i) * 3 + static_cast<std::size_t>(axis)] = static_cast<std::uint32_t>(p_next);
+                        if (p_write)
+                        {
+                            // Interpolate the crossing along the edge
+                            const double t = (iso - v0) / (v1 - v0);
+                            const vector3 offset{ axis == 0 ? 1.0 : 0.0, axis == 1 ? 1.0 : 0.0, axis == 2 ? 1.0 : 0.0 };
+                            result.vertices[p_next] = p_grid.position(i, j, p_k) + offset * (p_grid.cell_size * t);
+                        }
+                        ++p_next;
+                    }
+                }
+            }
+            return p_next;
+        };
+
+        // Triangulate a cell layer from the edge numbers of its lower and upper sample layers
+        // @return                  Number of indices, which are written only if p_indices is set
+        auto cell_layer = [&](const std::size_t p_k, const std::uint32_t* p_lower, const std::uint32_t* p_upper, std::uint32_t* p_indices)
+        {
+            std::size_t count = 0;
+            for (std::size_t j = 0; j + 1 < ny; ++j)
+            {
+                for (std::size_t i = 0; i + 1 < nx; ++i)
+                {
+                    // Classify the cell corners
+                    int cube = 0;
+                    for (int c = 0; c < 8; ++c)
+                    {
+                        if (p_grid.at(i + (c & 1), j + ((c >> 1) & 1), p_k + ((c >> 2) & 1)) < iso)
+                            cube |= 1 << c;
+                    }
+                    if (cube == 0 || cube == 255)
+                        continue;
+
+                    // Emit triangles referencing the shared edge vertices
+                    const auto& tris = detail::marching_cubes.triangles[cube];
+                    for (int n = 0; tris[n] >= 0; ++n, ++count)
+                    {
+                        if (!p_indices)
+                            continue;
+
+                        const int e = tris[n];
+                        const int axis = e / 4;
+                        const int bits = e % 4;
+                        std::size_t o[3] = { 0, 0, 0 };
+                        o[(axis + 1) % 3] = static_cast<std::size_t>(bits & 1);
+                        o[(axis + 2) % 3] = static_cast<std::size_t>((bits >> 1) & 1);
+                        const std::uint32_t* layer = o[2] ? p_upper : p_lower;
+                        p_indices[count] = layer[((j + o[1]) * nx + i + o[0]) * 3 + static_cast<std::size_t>(axis)];
+                    }
+                }
+            }
+            return count;
+        };
+
+        // Count the vertices and indices each layer produces
+        std::vector<std::size_t> vertex_start(nz, 0);
+        std::vector<std::size_t> index_start(nz, 0);
+        parallel_for(slabs.count, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            for (std::size_t k = slabs.begin(p_begin); k < slabs.end(p_end - 1); ++k)
+            {
+                vertex_start[k] = edge_layer(k, nullptr, 0, false);
+                if (k + 1 < nz)
+                    index_start[k] = cell_layer(k, nullptr, nullptr, nullptr);
+            }
+        });
+        result.vertices.resize(detail::exclusive_scan(vertex_start));
+        result.indices.resize(detail::exclusive_scan(index_start));
+
+        // Write each slab's vertices and triangles, numbering the next slab's first layer without writing it
+        parallel_for(slabs.count, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            std::vector<std::uint32_t> edges[2] = { std::vector<std::uint32_t>(nx * ny * 3), std::vector<std::uint32_t>(nx * ny * 3) };
+            for (std::size_t s = p_begin; s < p_end; ++s)
+            {
+                const std::size_t k_begin = slabs.begin(s);
+                const std::size_t k_end = slabs.end(s);
+                edge_layer(k_begin, edges[k_begin & 1].data(), vertex_start[k_begin], true);
+                for (std::size_t k = k_begin; k + 1 < nz && k < k_end; ++k)
+                {
+                    std::uint32_t* lower = edges[k & 1].data();
+                    std::uint32_t* upper = edges[(k + 1) & 1].data();
+                    edge_layer(k + 1, upper, vertex_start[k + 1], k + 1 < k_end);
+                    cell_layer(k, lower, upper, result.indices.data() + index_start[k]);
+                }
+            }
+        });
+
+        return result;
+    }
+
+    /// Extract an isosurface from a dense grid with dual contouring
+    ///
+    /// Each cell with a crossing edge gets one vertex minimizing the quadratic
+    /// error to the plane3 tangent planes at its edge crossings. Every interior
+    /// crossing edge emits a quad joining the four cells around it. A counting
+    /// pass sizes the mesh per cell layer, then one task per Z slab writes its
+    /// vertices and quads straight into place using a two-layer cell cache.
+    /// @param p_grid               Sampled field
+    /// @param p_options            Extraction options
+    /// @return                     Indexed mesh with outward-facing triangles
+    inline indexed_mesh extract_dual_contouring(const sdf_grid& p_grid, const isosurface_options& p_options = isosurface_options{})
+    {
+        MESH_PROFILE_SCOPE("isosurface.dual_contouring", p_grid.values.size());
+        indexed_mesh result;
+        if (p_grid.size_x < 2 || p_grid.size_y < 2 || p_grid.size_z < 2)
+            return result;
+
+        const std::size_t nx = p_grid.size_x, ny = p_grid.size_y, nz = p_grid.size_z;
+        const std::size_t cx = nx - 1, cy = ny - 1, cz = nz - 1;
+        const detail::isosurface_slabs slabs(cz, p_options.slab_size);
+        const double iso = p_options.iso_value;
+
+        // Number the cells of a layer the surface passes through, optionally placing their vertices
+        auto cell_layer = [&](const std::size_t p_k, std::uint32_t* p_cache, std::size_t p_next, const bool p_write)
+        {
+            for (std::size_t j = 0; j < cy; ++j)
+            {
+                for (std::size_t i = 0; i < cx; ++i)
+                {
+                    double corner[8] = {};
+                    int cube = 0;
+                    for (int c = 0; c < 8; ++c)
+                    {
+                        corner[c] = p_grid.at(i + (c & 1), j + ((c >> 1) & 1), p_k + ((c >> 2) & 1));
+                        if (corner[c] < iso)
+                            cube |= 1 << c;
+                    }
+                    if (cube == 0 || cube == 255)
+                        continue;
+
+                    if (p_cache)
+                        p_cache[j * cx + i] = static_cast<std::uint32_t>(p_next);
+                    if (p_write)
+                        result.vertices[p_next] = detail::dual_contouring_vertex(p_grid, i, j, p_k, corner, cube, p_options);
+                    ++p_next;
+                }
+            }
+            return p_next;
+        };
+
+        // Emit a quad around every interior crossing edge starting in a sample layer,
+        // joining cells of the layers below (p_lower) and at (p_upper) the edge
+        // @return                  Number of indices, which are written only if p_indices is set
+        auto quad_layer = [&](const std::size_t p_k, const std::uint32_t* p_lower, const std::uint32_t* p_upper, std::uint32_t* p_indices)
+        {
+            std::size_t count = 0;
+            for (std::size_t j = 0; j < ny; ++j)
+            {
+                for (std::size_t i = 0; i < nx; ++i)
+                {
+                    const double v0 = p_grid.at(i, j, p_k);
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        // The edge needs a neighbor sample and four surrounding cells
+                        double v1 = 0.0;
+                        if (axis == 0)
+                        {
+                            if (i + 1 >= nx || j == 0 || p_k == 0 || j >= cy || p_k >= cz)
+                                continue;
+                            v1 = p_grid.at(i + 1, j, p_k);
+                        }
+                        else if (axis == 1)
+                        {
+                            if (j + 1 >= ny || i == 0 || p_k == 0 || i >= cx || p_k >= cz)
+                                continue;
+                            v1 = p_grid.at(i, j + 1, p_k);
+                        }
+                        else
+                        {
+                            if (p_k + 1 >= nz || i == 0 || j == 0 || i >= cx || j >= cy)
+                                continue;
+                            v1 = p_grid.at(i, j, p_k + 1);
+                        }
+
+                        if ((v0 < iso) == (v1 < iso))
+                            continue;
+
+                        count += 6;
+                        if (!p_indices)
+                            continue;
+
+                        std::uint32_t q[4] = {};
+                        if (axis == 0)
+                        {
+                            q[0] = p_lower[(j - 1) * cx + i];
+                            q[1] = p_lower[j * cx + i];
+                            q[2] = p_upper[j * cx + i];
+                            q[3] = p_upper[(j - 1) * cx + i];
+                        }
+                        else if (axis == 1)
+                        {
+                            q[0] = p_lower[j * cx + i - 1];
+                            q[1] = p_upper[j * cx + i - 1];
+                            q[2] = p_upper[j * cx + i];
+                            q[3] = p_lower[j * cx + i];
+                        }
+                        else
+                        {
+                            q[0] = p_upper[(j - 1) * cx + i - 1];
+                            q[1] = p_upper[(j - 1) * cx + i];
+                            q[2] = p_upper[j * cx + i];
+                            q[3] = p_upper[j * cx + i - 1];
+                        }
+
+                        // Face the quad from inside to outside
+                        if (v0 >= iso)
+                            std::swap(q[1], q[3]);
+
+                        std::uint32_t* out = p_indices + count - 6;
+                        out[0] = q[0];
+                        out[1] = q[1];
+                        out[2] = q[2];
+                        out[3] = q[0];
+                        out[4] = q[2];
+                        out[5] = q[3];
+                    }
+                }
+            }
+            return count;
+        };
+
+        // Count the vertices and indices each layer produces
+        std::vector<std::size_t> vertex_start(cz, 0);
+        std::vector<std::size_t> index_start(cz, 0);
+        parallel_for(slabs.count, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            for (std::size_t k = slabs.begin(p_begin); k < slabs.end(p_end - 1); ++k)
+            {
+                vertex_start[k] = cell_layer(k, nullptr, 0, false);
+                index_start[k] = quad_layer(k, nullptr, nullptr, nullptr);
+            }
+        });
+        result.vertices.resize(detail::exclusive_scan(vertex_start));
+        result.indices.resize(detail::exclusive_scan(index_start));
+
+        // Write each slab's vertices and quads, renumbering the previous slab's last layer without writing it
+        parallel_for(slabs.count, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            std::vector<std::uint32_t> cells[2] = { std::vector<std::uint32_t>(cx * cy), std::vector<std::uint32_t>(cx * cy) };
+            for (std::size_t s = p_begin; s < p_end; ++s)
+            {
+                const std::size_t k_begin = slabs.begin(s);
+                if (k_begin > 0)
+                    cell_layer(k_begin - 1, cells[(k_begin - 1) & 1].data(), vertex_start[k_begin - 1], false);
+                for (std::size_t k = k_begin; k < slabs.end(s); ++k)
+                {
+                    std::uint32_t* lower = cells[(k + 1) & 1].data();
+                    std::uint32_t* upper = cells[k & 1].data();
+                    cell_layer(k, upper, vertex_start[k], true);
+                    quad_layer(k, lower, upper, result.indices.data() + index_start[k]);
+                }
+            }
+        });
+
+        return result;
+    }
+
+    /// Extract an isosurface from a dense grid
+    /// @param p_grid               Sampled field
+    /// @param p_options            Extraction options
+    /// @return                     Indexed mesh with outward-facing triangles
+    inline indexed_mesh extract_isosurface(const sdf_grid& p_grid, const isosurface_options& p_options = isosurface_options{})
+    {
+        return p_options.method == isosurface_method::marching_cubes
+            ? extract_marching_cubes(p_grid, p_options)
+            : extract_dual_contouring(p_grid, p_options);
+    }
+}
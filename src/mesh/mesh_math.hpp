@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <type_traits>
 
 namespace mesh
 {
@@ -63,6 +64,73 @@ namespace mesh
 		return 0;
 	}
 
+	namespace detail
+	{
+		/// Test if the current evaluation is happening at compile time
+		/// @return                     True during constant evaluation
+		constexpr bool is_constant_evaluated() noexcept
+		{
+#if defined(__cpp_lib_is_constant_evaluated)
+			return std::is_constant_evaluated();
+#elif defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+			return __builtin_is_constant_evaluated();
+#else
+			return false;
+#endif
+		}
+
+		/// Calculate a square root using only constant-evaluable operations
+		///
+		/// The value is scaled into [0.25, 1) by exact powers of four, then Newton
+		/// iteration runs down from 1.0 until it stops decreasing, which lands
+		/// within one ulp of the hardware result.
+		/// @param p_value              Value to take the square root of
+		/// @return                     Square root (NaN for negative values)
+		constexpr double sqrt_constexpr(const double p_value)
+		{
+			if (!(p_value >= 0.0))
+				return std::numeric_limits<double>::quiet_NaN();
+			if (p_value == 0.0 || p_value == std::numeric_limits<double>::infinity())
+				return p_value;
+
+			double x = p_value;
+			double scale = 1.0;
+			while (x >= 1.0)
+			{
+				x *= 0.25;
+				scale *= 2.0;
+			}
+			while (x < 0.25)
+			{
+				x *= 4.0;
+				scale *= 0.5;
+			}
+
+			double root = 1.0;
+			for (;;)
+			{
+				const double next = 0.5 * (root + x / root);
+				if (next >= root)
+					break;
+				root = next;
+			}
+			return root * scale;
+		}
+	}
+
+	/// Calculate a square root, usable in constant expressions
+	///
+	/// Compile-time evaluation uses an exactly scaled Newton iteration; at run
+	/// time this is the hardware square root.
+	/// @param p_value              Value to take the square root of
+	/// @return                     Square root
+	constexpr double csqrt(const double p_value)
+	{
+		if (detail::is_constant_evaluated())
+			return detail::sqrt_constexpr(p_value);
+		return std::sqrt(p_value);
+	}
+
 	/// Linear interpolation
 	/// @param p_value1             First value
 	/// @param p_value2             Second value
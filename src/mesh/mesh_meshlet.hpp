@@ -0,0 +1,346 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+#include "mesh_vertex_cache.hpp"
+
+namespace mesh
+{
+    /// Meshlet builder options
+    struct meshlet_options
+    {
+        /// Maximum vertices per meshlet (clamped to 3..256 so local indices fit a byte)
+        std::size_t max_vertices = 64;
+
+        /// Maximum triangles per meshlet
+        std::size_t max_triangles = 124;
+    };
+
+    /// Range of one meshlet in a meshlet set
+    struct meshlet
+    {
+        std::uint32_t vertex_offset = 0;    ///< First entry in meshlet_set::vertices
+        std::uint32_t vertex_count = 0;     ///< Number of vertices
+        std::uint32_t triangle_offset = 0;  ///< First triangle in meshlet_set::triangles (in triangles, not bytes)
+        std::uint32_t triangle_count = 0;   ///< Number of triangles
+    };
+
+    /// Culling bounds of a meshlet
+    struct meshlet_bounds
+    {
+        vector3 center;                     ///< Bounding sphere center
+        double radius = 0.0;                ///< Bounding sphere radius
+        vector3 cone_axis;                  ///< Average facing direction of the triangles
+        double cone_cutoff = 1.0;           ///< Sine of the normal cone half-angle (1 if the cone spans a hemisphere or more)
+
+        /// Check if a sphere-bounded cluster is entirely outside a plane
+        /// @param p_plane              Plane with the outside in front
+        /// @return                     True if every point of the sphere is in front
+        constexpr bool is_outside(const plane3& p_plane) const
+        {
+            return p_plane.distance_to(center) > radius;
+        }
+
+        /// Check if every triangle faces away from a viewpoint
+        ///
+        /// Conservative normal cone test: a true result guarantees all
+        /// triangles are back-facing from p_camera.
+        /// @param p_camera             Viewpoint
+        /// @return                     True if the cluster can be back-face culled
+        bool is_backfacing(const vector3& p_camera) const
+        {
+            const vector3 view = center - p_camera;
+            return view.dot(cone_axis) >= cone_cutoff * view.length() + radius;
+        }
+    };
+
+    /// Triangles partitioned into small clusters
+    struct meshlet_set
+    {
+        /// Meshlet ranges
+        std::vector<meshlet> meshlets;
+
+        /// Mesh vertex index of each meshlet vertex
+        std::vector<std::uint32_t> vertices;
+
+        /// Meshlet-local vertex indices (three per triangle)
+        std::vector<std::uint8_t> triangles;
+
+        /// Culling bounds of each meshlet
+        std::vector<meshlet_bounds> bounds;
+
+        /// Get the mesh vertex index of a meshlet triangle corner
+        /// @param p_meshlet            Meshlet index
+        /// @param p_triangle           Triangle index within the meshlet
+        /// @param p_corner             Corner (0 to 2)
+        /// @return                     Mesh vertex index
+        std::uint32_t vertex_index(const std::size_t p_meshlet, const std::size_t p_triangle, const int p_corner) const
+        {
+            const meshlet& m = meshlets[p_meshlet];
+            return vertices[m.vertex_offset + triangles[(m.triangle_offset + p_triangle) * 3 + static_cast<std::size_t>(p_corner)]];
+        }
+    };
+
+    namespace detail
+    {
+        /// Spread the low 10 bits of a value three bits apart
+        constexpr std::uint32_t morton_spread(std::uint32_t p_v)
+        {
+            p_v &= 0x3FF;
+            p_v = (p_v | (p_v << 16)) & 0x030000FF;
+            p_v = (p_v | (p_v << 8)) & 0x0300F00F;
+            p_v = (p_v | (p_v << 4)) & 0x030C30C3;
+            p_v = (p_v | (p_v << 2)) & 0x09249249;
+            return p_v;
+        }
+
+        /// Compute a meshlet bounding sphere (Ritter) and normal cone
+        inline meshlet_bounds compute_meshlet_bounds(const indexed_mesh& p_mesh, const meshlet_set& p_set, const std::size_t p_meshlet)
+        {
+            meshlet_bounds b;
+            const meshlet& m = p_set.meshlets[p_meshlet];
+            const std::uint32_t* verts = p_set.vertices.data() + m.vertex_offset;
+
+            // Start from the most separated pair along the furthest point chain
+            const vector3& p0 = p_mesh.vertices[verts[0]];
+            auto furthest = [&](const vector3& p_from)
+            {
+                std::uint32_t best = 0;
+                double best_d = -1.0;
+                for (std::uint32_t i = 0; i < m.vertex_count; ++i)
+                {
+                    const double d = (p_mesh.vertices[verts[i]] - p_from).length2();
+                    if (d > best_d)
+                    {
+                        best_d = d;
+                        best = i;
+                    }
+                }
+                return p_mesh.vertices[verts[best]];
+            };
+            const vector3 a = furthest(p0);
+            const vector3 c = furthest(a);
+            b.center = (a + c) * 0.5;
+            b.radius = (c - a).length() * 0.5;
+
+            // Grow the sphere to cover the remaining points
+            for (std::uint32_t i = 0; i < m.vertex_count; ++i)
+            {
+                const vector3& p = p_mesh.vertices[verts[i]];
+                const double d = (p - b.center).length();
+                if (d > b.radius)
+                {
+                    const double r = (b.radius + d) * 0.5;
+                    b.center += (p - b.center) * ((r - b.radius) / d);
+                    b.radius = r;
+                }
+            }
+
+            // Normal cone around the mean of the face plane normals
+            vector3 axis{ 0.0, 0.0, 0.0 };
+            for (std::uint32_t t = 0; t < m.triangle_count; ++t)
+                axis += triangle3{ p_mesh.vertices[p_set.vertex_index(p_meshlet, t, 0)], p_mesh.vertices[p_set.vertex_index(p_meshlet, t, 1)], p_mesh.vertices[p_set.vertex_index(p_meshlet, t, 2)] }.plane().normal;
+            b.cone_axis = axis.normalized();
+
+            double min_dot = 1.0;
+            for (std::uint32_t t = 0; t < m.triangle_count; ++t)
+            {
+                const triangle3 tri{ p_mesh.vertices[p_set.vertex_index(p_meshlet, t, 0)], p_mesh.vertices[p_set.vertex_index(p_meshlet, t, 1)], p_mesh.vertices[p_set.vertex_index(p_meshlet, t, 2)] };
+                if (!tri.is_degenerate())
+                    min_dot = std::min(min_dot, tri.plane().normal.dot(b.cone_axis));
+            }
+            b.cone_cutoff = min_dot <= 0.0 || b.cone_axis.length2() == 0.0 ? 1.0 : std::sqrt(std::max(0.0, 1.0 - min_dot * min_dot));
+            return b;
+        }
+    }
+
+    /// Partition a mesh into meshlets with spatial locality
+    ///
+    /// Meshlets grow greedily: the next triangle is the unassigned triangle
+    /// sharing an edge with the current meshlet that adds the fewest new
+    /// vertices, with ties broken by distance to the meshlet centroid, so
+    /// every meshlet is edge-connected. When a meshlet has no
+    /// remaining neighbours the next seed is taken in Morton order of the
+    /// triangle centroids, so disconnected parts also stay compact. Bounds
+    /// are computed in parallel once the partition is done.
+    /// @param p_mesh               Mesh to partition
+    /// @param p_options            Meshlet size limits
+    /// @return                     Meshlets with their vertices, local triangles and bounds
+    inline meshlet_set build_meshlets(const indexed_mesh& p_mesh, const meshlet_options& p_options = meshlet_options{})
+    {
+        MESH_PROFILE_SCOPE("meshlet.build", p_mesh.triangle_count());
+        meshlet_set set;
+        const std::size_t max_vertices = std::min<std::size_t>(std::max<std::size_t>(p_options.max_vertices, 3), 256);
+        const std::size_t max_triangles = std::max<std::size_t>(p_options.max_triangles, 1);
+        const std::size_t triangle_count = p_mesh.triangle_count();
+        if (triangle_count == 0)
+            return set;
+
+        // Triangle centroids and their Morton order as the seed order
+        std::vector<vector3> centroids(triangle_count);
+        for (std::size_t t = 0; t < triangle_count; ++t)
+        {
+            const triangle3 tri = p_mesh.triangle(t);
+            centroids[t] = (tri.point1 + tri.point2 + tri.point3) / 3.0;
+        }
+
+        aabb3 box = aabb3::empty();
+        for (const auto& c : centroids)
+            box.expand(c);
+        const vector3 extent = box.size();
+        const double scale = 1023.0 / std::max({ extent.x, extent.y, extent.z, std::numeric_limits<double>::min() });
+        std::vector<std::uint32_t> codes(triangle_count);
+        for (std::size_t t = 0; t < triangle_count; ++t)
+        {
+            const vector3 q = (centroids[t] - box.minimum) * scale;
+            codes[t] = detail::morton_spread(static_cast<std::uint32_t>(q.x)) |
+                       (detail::morton_spread(static_cast<std::uint32_t>(q.y)) << 1) |
+                       (detail::morton_spread(static_cast<std::uint32_t>(q.z)) << 2);
+        }
+        std::vector<std::uint32_t> seeds(triangle_count);
+        std::iota(seeds.begin(), seeds.end(), 0u);
+        std::stable_sort(seeds.begin(), seeds.end(), [&](const std::uint32_t p_a, const std::uint32_t p_b)
+        {
+            return codes[p_a] < codes[p_b];
+        });
+
+        const detail::vertex_triangles adjacency{ p_mesh };
+        std::vector<std::uint8_t> used(triangle_count, 0);
+        std::vector<std::uint32_t> owner(triangle_count, no_neighbor);
+        std::vector<std::int32_t> local(p_mesh.vertex_count(), -1);
+        std::size_t next_seed = 0;
+
+        meshlet current;
+        vector3 centroid_sum{ 0.0, 0.0, 0.0 };
+
+        // Close the current meshlet and reset the local vertex map
+        auto finish = [&]()
+        {
+            if (current.triangle_count == 0)
+                return;
+            for (std::uint32_t i = 0; i < current.vertex_count; ++i)
+                local[set.vertices[current.vertex_offset + i]] = -1;
+            set.meshlets.push_back(current);
+            current = meshlet{};
+            current.vertex_offset = static_cast<std::uint32_t>(set.vertices.size());
+            current.triangle_offset = static_cast<std::uint32_t>(set.triangles.size() / 3);
+            centroid_sum = vector3{ 0.0, 0.0, 0.0 };
+        };
+
+        // Number of vertices a triangle would add to the current meshlet
+        auto new_vertices = [&](const std::uint32_t p_t)
+        {
+            int count = 0;
+            for (int c = 0; c < 3; ++c)
+                count += local[p_mesh.indices[p_t * 3 + c]] < 0 ? 1 : 0;
+            return count;
+        };
+
+        // Check if a triangle shares an edge with a triangle of the current meshlet
+        auto shares_edge = [&](const std::uint32_t p_t)
+        {
+            const std::uint32_t id = static_cast<std::uint32_t>(set.meshlets.size());
+            for (int c = 0; c < 3; ++c)
+            {
+                const std::uint32_t a = p_mesh.indices[p_t * 3 + c];
+                const std::uint32_t b = p_mesh.indices[p_t * 3 + (c + 1) % 3];
+                if (local[a] < 0 || local[b] < 0)
+                    continue;
+                for (std::uint32_t n = adjacency.offsets[a]; n < adjacency.offsets[a + 1]; ++n)
+                {
+                    const std::uint32_t other = adjacency.triangles[n];
+                    if (owner[other] == id && (p_mesh.indices[other * 3] == b || p_mesh.indices[other * 3 + 1] == b || p_mesh.indices[other * 3 + 2] == b))
+                        return true;
+                }
+            }
+            return false;
+        };
+
+        // Append a triangle to the current meshlet
+        auto append = [&](const std::uint32_t p_t)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                const std::uint32_t v = p_mesh.indices[p_t * 3 + c];
+                if (local[v] < 0)
+                {
+                    local[v] = static_cast<std::int32_t>(current.vertex_count++);
+                    set.vertices.push_back(v);
+                }
+                set.triangles.push_back(static_cast<std::uint8_t>(local[v]));
+            }
+            ++current.triangle_count;
+            centroid_sum += centroids[p_t];
+            used[p_t] = 1;
+            owner[p_t] = static_cast<std::uint32_t>(set.meshlets.size());
+        };
+
+        for (std::size_t assigned = 0; assigned < triangle_count; ++assigned)
+        {
+            // Find the best unassigned edge neighbour of the current meshlet
+            std::int64_t best = -1;
+            int best_new = 4;
+            double best_distance = 0.0;
+            if (current.triangle_count != 0)
+            {
+                const vector3 center = centroid_sum / static_cast<double>(current.triangle_count);
+                for (std::uint32_t i = 0; i < current.vertex_count; ++i)
+                {
+                    const std::uint32_t v = set.vertices[current.vertex_offset + i];
+                    for (std::uint32_t n = adjacency.offsets[v]; n < adjacency.offsets[v + 1]; ++n)
+                    {
+                        const std::uint32_t t = adjacency.triangles[n];
+                        if (used[t])
+                            continue;
+
+                        const int added = new_vertices(t);
+                        if (added > best_new || !shares_edge(t))
+                            continue;
+                        const double distance = (centroids[t] - center).length2();
+                        if (added < best_new || (added == best_new && distance < best_distance))
+                        {
+                            best = t;
+                            best_new = added;
+                            best_distance = distance;
+                        }
+                    }
+                }
+            }
+
+            // Start a new meshlet when the best candidate does not fit or none exists
+            if (best >= 0 && (current.vertex_count + static_cast<std::size_t>(best_new) > max_vertices || current.triangle_count + 1 > max_triangles))
+            {
+                finish();
+                best = -1;
+            }
+            if (best < 0)
+            {
+                // Seeds never join a meshlet they are not connected to
+                finish();
+                while (used[seeds[next_seed]])
+                    ++next_seed;
+                best = seeds[next_seed];
+            }
+
+            append(static_cast<std::uint32_t>(best));
+        }
+        finish();
+
+        // Bounds of each meshlet are independent
+        set.bounds.resize(set.meshlets.size());
+        parallel_for(set.meshlets.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            for (std::size_t m = p_begin; m < p_end; ++m)
+                set.bounds[m] = detail::compute_meshlet_bounds(p_mesh, set, m);
+        }, 64);
+        return set;
+    }
+}
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mesh
+{
+    namespace detail
+    {
+        /// Thread count override (zero uses the hardware thread count)
+        inline std::atomic<unsigned int>& thread_count_override()
+        {
+            static std::atomic<unsigned int> value{ 0 };
+            return value;
+        }
+    }
+
+    /// Set the number of worker threads used by parallel algorithms
+    /// @param p_count              Number of threads, or zero to use the hardware thread count
+    inline void set_thread_count(const unsigned int p_count)
+    {
+        detail::thread_count_override() = p_count;
+    }
+
+    /// Get the number of worker threads used by parallel algorithms
+    /// @return                     Number of threads (at least one)
+    inline unsigned int thread_count()
+    {
+        const unsigned int requested = detail::thread_count_override();
+        const unsigned int count = requested != 0 ? requested : std::thread::hardware_concurrency();
+        return count == 0 ? 1 : count;
+    }
+
+    namespace detail
+    {
+        /// Flag set on threads currently running parallel_for work
+        inline bool& in_parallel_region()
+        {
+            thread_local bool value = false;
+            return value;
+        }
+
+        /// Persistent workers shared by every parallel_for
+        ///
+        /// Threads are started on first use and grown to the largest helper count
+        /// requested, then sleep between jobs. One job runs at a time; the caller
+        /// of run() takes part in it and returns once every helper that joined
+        /// has finished.
+        class thread_pool
+        {
+        public:
+            /// Get the process-wide pool
+            static thread_pool& instance()
+            {
+                static thread_pool pool;
+                return pool;
+            }
+
+            thread_pool() = default;
+            thread_pool(const thread_pool&) = delete;
+            thread_pool& operator=(const thread_pool&) = delete;
+
+            ~thread_pool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stop = true;
+                }
+                m_wake.notify_all();
+                for (auto& t : m_threads)
+                    t.join();
+            }
+
+            /// Run a job on the calling thread and up to p_helpers pool threads
+            /// @param p_helpers            Number of pool threads wanted
+            /// @param p_job                Job run by every participating thread
+            /// @param p_context            Argument passed to the job
+            /// @return                     False if the pool is busy with another caller's job
+            bool run(const std::size_t p_helpers, void (*p_job)(void*), void* p_context)
+            {
+                std::unique_lock<std::mutex> submit(m_submit_mutex, std::try_to_lock);
+                if (!submit.owns_lock())
+                    return false;
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    while (m_threads.size() < p_helpers)
+                        m_threads.emplace_back([this]() { work(); });
+                    m_job = p_job;
+                    m_context = p_context;
+                    m_wanted = p_helpers;
+                    ++m_generation;
+                }
+                m_wake.notify_all();
+                p_job(p_context);
+
+                // Stop late helpers from joining, then wait for those that did
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wanted = 0;
+                m_done.wait(lock, [&]() { return m_active == 0; });
+                return true;
+            }
+
+        private:
+            void work()
+            {
+                in_parallel_region() = true;
+                std::uint64_t seen = 0;
+                std::unique_lock<std::mutex> lock(m_mutex);
+                for (;;)
+                {
+                    m_wake.wait(lock, [&]() { return m_stop || (m_generation != seen && m_wanted > 0); });
+                    if (m_stop)
+                        return;
+
+                    seen = m_generation;
+                    --m_wanted;
+                    ++m_active;
+                    void (*job)(void*) = m_job;
+                    void* context = m_context;
+                    lock.unlock();
+                    job(context);
+                    lock.lock();
+                    if (--m_active == 0)
+                        m_done.notify_all();
+                }
+            }
+
+            std::mutex m_submit_mutex;
+            std::mutex m_mutex;
+            std::condition_variable m_wake;
+            std::condition_variable m_done;
+            std::vector<std::thread> m_threads;
+            void (*m_job)(void*) = nullptr;
+            void* m_context = nullptr;
+            std::size_t m_wanted = 0;
+            std::size_t m_active = 0;
+            std::uint64_t m_generation = 0;
+            bool m_stop = false;
+        };
+    }
+
+    /// Run a function over the range [0, count) split into chunks across threads
+    ///
+    /// Chunks of p_grain items are handed out dynamically so uneven work balances
+    /// across threads. The work runs on a persistent pool, so a call costs a
+    /// wake-up and a join of the sleeping workers (a few microseconds) rather
+    /// than thread creation; ranges of a single chunk still run inline, so
+    /// callers in hot loops should size p_grain to make small inputs one chunk.
+    /// Nested calls, and calls made while another thread is using the pool, run
+    /// inline on the calling thread. The first exception thrown by any chunk is
+    /// rethrown on the calling thread.
+    /// @param p_count              Number of items
+    /// @param p_func               Function called as p_func(begin, end) for each chunk
+    /// @param p_grain              Number of items per chunk
+    template <typename TFunc>
+    void parallel_for(const std::size_t p_count, TFunc&& p_func, const std::size_t p_grain = 1)
+    {
+        if (p_count == 0)
+            return;
+
+        // Run small ranges and nested calls inline
+        const std::size_t grain = std::max<std::size_t>(p_grain, 1);
+        const std::size_t chunks = (p_count + grain - 1) / grain;
+        const std::size_t threads = std::min<std::size_t>(thread_count(), chunks);
+        if (threads <= 1 || detail::in_parallel_region())
+        {
+            p_func(std::size_t{ 0 }, p_count);
+            return;
+        }
+
+        struct job_state
+        {
+            TFunc& func;
+            std::size_t count;
+            std::size_t grain;
+            std::size_t chunks;
+            std::atomic<std::size_t> next{ 0 };
+            std::exception_ptr error{};
+            std::mutex error_mutex{};
+        };
+        job_state state{ p_func, p_count, grain, chunks };
+
+        // Every participating thread pulls chunks until the range is exhausted
+        auto job = [](void* p_context)
+        {
+            job_state& s = *static_cast<job_state*>(p_context);
+            try
+            {
+                for (;;)
+                {
+                    const std::size_t chunk = s.next.fetch_add(1);
+                    if (chunk >= s.chunks)
+                        break;
+
+                    const std::size_t begin = chunk * s.grain;
+                    s.func(begin, std::min(begin + s.grain, s.count));
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(s.error_mutex);
+                if (!s.error)
+                    s.error = std::current_exception();
+                s.next = s.chunks;
+            }
+        };
+
+        detail::in_parallel_region() = true;
+        const bool pooled = detail::thread_pool::instance().run(threads - 1, job, &state);
+        if (!pooled)
+            job(&state);
+        detail::in_parallel_region() = false;
+
+        if (state.error)
+            std::rethrow_exception(state.error);
+    }
+
+    /// Blocking first-in first-out queue with a fixed capacity
+    ///
+    /// Links the stages of a producer/consumer pipeline. Producers block while
+    /// the queue is full so a fast stage cannot run arbitrarily far ahead of a
+    /// slow one, which bounds the memory held between stages.
+    template <typename T>
+    class bounded_queue
+    {
+    public:
+        /// Construct a queue
+        /// @param p_capacity           Maximum number of queued items (at least one)
+        explicit bounded_queue(const std::size_t p_capacity)
+            : m_capacity(std::max<std::size_t>(p_capacity, 1))
+        {
+        }
+
+        /// Add an item, waiting while the queue is full
+        /// @param p_item               Item to add
+        /// @return                     False if the queue was closed and the item dropped
+        bool push(T p_item)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_not_full.wait(lock, [&]() { return m_closed || m_items.size() < m_capacity; });
+            if (m_closed)
+                return false;
+
+            m_items.push_back(std::move(p_item));
+            m_not_empty.notify_one();
+            return true;
+        }
+
+        /// Remove the oldest item, waiting while the queue is empty
+        /// @param p_item               Receives the item
+        /// @return                     False once the queue is closed and drained
+        bool pop(T& p_item)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_not_empty.wait(lock, [&]() { return m_closed || !m_items.empty(); });
+            if (m_items.empty())
+                return false;
+
+            p_item = std::move(m_items.front());
+            m_items.pop_front();
+            m_not_full.notify_one();
+            return true;
+        }
+
+        /// Close the queue, waking all waiting threads
+        ///
+        /// Items already queued can still be popped; further pushes fail.
+        void close()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            m_not_full.notify_all();
+            m_not_empty.notify_all();
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_not_full;
+        std::condition_variable m_not_empty;
+        std::deque<T> m_items;
+        std::size_t m_capacity;
+        bool m_closed = false;
+    };
+}
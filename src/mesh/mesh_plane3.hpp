@@ -36,11 +36,10 @@ namespace mesh
         /// @param p_point1             First point
         /// @param p_point2             Second point
         /// @param p_point3             Third point
-        explicit plane3(const vector3& p_point1, const vector3& p_point2, const vector3& p_point3)
+        constexpr explicit plane3(const vector3& p_point1, const vector3& p_point2, const vector3& p_point3)
+			: normal((p_point2 - p_point1).cross(p_point3 - p_point1).normalized()), distance(normal.dot(p_point1))
 		{
-            normal = (p_point2 - p_point1).cross(p_point3 - p_point1).normalized();
-            distance = normal.dot(p_point1);
-        }
+		}
 
         /// Check if plane is approximately equal to another plane
         /// @param p_p                  Plane to compare with
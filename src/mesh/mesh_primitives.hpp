@@ -0,0 +1,274 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "mesh_indexed_mesh.hpp"
+
+namespace mesh
+{
+    /// Fixed-size triangle mesh that can be built in constant expressions
+    ///
+    /// Primitive generators return these so constant geometry is baked into the
+    /// binary instead of being generated at startup.
+    /// @tparam V                   Number of vertices
+    /// @tparam T                   Number of triangles
+    template <std::size_t V, std::size_t T>
+    struct static_mesh
+    {
+        /// Vertex positions
+        std::array<vector3, V> vertices;
+
+        /// Triangle vertex indices (three per triangle)
+        std::array<std::uint32_t, T * 3> indices{};
+
+        /// Get the number of vertices
+        /// @return                     Vertex count
+        static constexpr std::size_t vertex_count()
+        {
+            return V;
+        }
+
+        /// Get the number of triangles
+        /// @return                     Triangle count
+        static constexpr std::size_t triangle_count()
+        {
+            return T;
+        }
+
+        /// Get a triangle
+        /// @param p_index              Triangle index
+        /// @return                     Triangle
+        constexpr triangle3 triangle(const std::size_t p_index) const
+        {
+            return triangle3{ vertices[indices[p_index * 3]], vertices[indices[p_index * 3 + 1]], vertices[indices[p_index * 3 + 2]] };
+        }
+
+        /// Copy into a dynamic mesh
+        /// @return                     Indexed mesh
+        indexed_mesh to_mesh() const
+        {
+            indexed_mesh mesh;
+            mesh.vertices.assign(vertices.begin(), vertices.end());
+            mesh.indices.assign(indices.begin(), indices.end());
+            return mesh;
+        }
+    };
+
+    namespace detail
+    {
+        /// Set the three indices of a triangle
+        template <std::size_t V, std::size_t T>
+        constexpr void set_triangle(static_mesh<V, T>& p_mesh, const std::size_t p_index, const std::uint32_t p_a, const std::uint32_t p_b, const std::uint32_t p_c)
+        {
+            p_mesh.indices[p_index * 3] = p_a;
+            p_mesh.indices[p_index * 3 + 1] = p_b;
+            p_mesh.indices[p_index * 3 + 2] = p_c;
+        }
+
+        /// Number of vertices of an icosphere
+        constexpr std::size_t icosphere_vertices(const int p_subdivisions)
+        {
+            std::size_t faces = 20;
+            for (int i = 0; i < p_subdivisions; ++i)
+                faces *= 4;
+            return faces / 2 + 2;
+        }
+
+        /// Number of triangles of an icosphere
+        constexpr std::size_t icosphere_triangles(const int p_subdivisions)
+        {
+            return (icosphere_vertices(p_subdivisions) - 2) * 2;
+        }
+    }
+
+    /// Build an axis-aligned box centered on the origin
+    /// @param p_half_extents       Half the box size along each axis
+    /// @return                     Box with outward-facing triangles
+    constexpr static_mesh<8, 12> make_box(const vector3& p_half_extents)
+    {
+        static_mesh<8, 12> mesh;
+        for (std::uint32_t i = 0; i < 8; ++i)
+        {
+            mesh.vertices[i] = vector3{
+                (i & 1) ? p_half_extents.x : -p_half_extents.x,
+                (i & 2) ? p_half_extents.y : -p_half_extents.y,
+                (i & 4) ? p_half_extents.z : -p_half_extents.z
+            };
+        }
+
+        constexpr std::uint32_t faces[12][3] = {
+            { 0, 4, 6 }, { 0, 6, 2 },   // -X
+            { 1, 3, 7 }, { 1, 7, 5 },   // +X
+            { 0, 1, 5 }, { 0, 5, 4 },   // -Y
+            { 2, 6, 7 }, { 2, 7, 3 },   // +Y
+            { 0, 2, 3 }, { 0, 3, 1 },   // -Z
+            { 4, 5, 7 }, { 4, 7, 6 }    // +Z
+        };
+        for (std::size_t t = 0; t < 12; ++t)
+            detail::set_triangle(mesh, t, faces[t][0], faces[t][1], faces[t][2]);
+        return mesh;
+    }
+
+    /// Build a regular octahedron centered on the origin
+    /// @param p_radius             Distance from the center to each vertex
+    /// @return                     Octahedron with outward-facing triangles
+    constexpr static_mesh<6, 8> make_octahedron(const double p_radius)
+    {
+        static_mesh<6, 8> mesh;
+        mesh.vertices[0] = vector3{ p_radius, 0.0, 0.0 };
+        mesh.vertices[1] = vector3{ -p_radius, 0.0, 0.0 };
+        mesh.vertices[2] = vector3{ 0.0, p_radius, 0.0 };
+        mesh.vertices[3] = vector3{ 0.0, -p_radius, 0.0 };
+        mesh.vertices[4] = vector3{ 0.0, 0.0, p_radius };
+        mesh.vertices[5] = vector3{ 0.0, 0.0, -p_radius };
+
+        constexpr std::uint32_t faces[8][3] = {
+            { 0, 2, 4 }, { 2, 1, 4 }, { 1, 3, 4 }, { 3, 0, 4 },
+            { 2, 0, 5 }, { 1, 2, 5 }, { 3, 1, 5 }, { 0, 3, 5 }
+        };
+        for (std::size_t t = 0; t < 8; ++t)
+            detail::set_triangle(mesh, t, faces[t][0], faces[t][1], faces[t][2]);
+        return mesh;
+    }
+
+    /// Build a regular icosahedron centered on the origin
+    /// @param p_radius             Distance from the center to each vertex
+    /// @return                     Icosahedron with outward-facing triangles
+    constexpr static_mesh<12, 20> make_icosahedron(const double p_radius)
+    {
+        // Vertices lie on three orthogonal golden rectangles
+        const double t = (1.0 + csqrt(5.0)) * 0.5;
+        const vector3 points[12] = {
+            vector3{ -1.0, t, 0.0 }, vector3{ 1.0, t, 0.0 }, vector3{ -1.0, -t, 0.0 }, vector3{ 1.0, -t, 0.0 },
+            vector3{ 0.0, -1.0, t }, vector3{ 0.0, 1.0, t }, vector3{ 0.0, -1.0, -t }, vector3{ 0.0, 1.0, -t },
+            vector3{ t, 0.0, -1.0 }, vector3{ t, 0.0, 1.0 }, vector3{ -t, 0.0, -1.0 }, vector3{ -t, 0.0, 1.0 }
+        };
+
+        static_mesh<12, 20> mesh;
+        for (std::size_t i = 0; i < 12; ++i)
+            mesh.vertices[i] = points[i].normalized() * p_radius;
+
+        constexpr std::uint32_t faces[20][3] = {
+            { 0, 11, 5 }, { 0, 5, 1 }, { 0, 1, 7 }, { 0, 7, 10 }, { 0, 10, 11 },
+            { 1, 5, 9 }, { 5, 11, 4 }, { 11, 10, 2 }, { 10, 7, 6 }, { 7, 1, 8 },
+            { 3, 9, 4 }, { 3, 4, 2 }, { 3, 2, 6 }, { 3, 6, 8 }, { 3, 8, 9 },
+            { 4, 9, 5 }, { 2, 4, 11 }, { 6, 2, 10 }, { 8, 6, 7 }, { 9, 8, 1 }
+        };
+        for (std::size_t f = 0; f < 20; ++f)
+            detail::set_triangle(mesh, f, faces[f][0], faces[f][1], faces[f][2]);
+        return mesh;
+    }
+
+    /// Build a geodesic sphere by repeatedly subdividing an icosahedron
+    ///
+    /// Each level splits every triangle into four, projecting edge midpoints
+    /// onto the sphere. Shared midpoints are found with a small open-addressing
+    /// table so the result is watertight. Keep the level low when evaluating at
+    /// compile time; compilers bound the work of constant evaluation.
+    /// @tparam Subdivisions        Number of subdivision levels
+    /// @param p_radius             Sphere radius
+    /// @return                     Sphere with outward-facing triangles
+    template <int Subdivisions>
+    constexpr static_mesh<detail::icosphere_vertices(Subdivisions), detail::icosphere_triangles(Subdivisions)> make_icosphere(const double p_radius)
+    {
+        constexpr std::size_t vertex_total = detail::icosphere_vertices(Subdivisions);
+        constexpr std::size_t triangle_total = detail::icosphere_triangles(Subdivisions);
+        constexpr std::size_t table_size = [] {
+            std::size_t size = 1;
+            while (size < triangle_total * 3)
+                size <<= 1;
+            return size;
+        }();
+
+        static_mesh<vertex_total, triangle_total> mesh;
+        const static_mesh<12, 20> base = make_icosahedron(p_radius);
+        for (std::size_t i = 0; i < 12; ++i)
+            mesh.vertices[i] = base.vertices[i];
+        for (std::size_t i = 0; i < 60; ++i)
+            mesh.indices[i] = base.indices[i];
+
+        std::size_t vertices = 12;
+        std::size_t triangles = 20;
+        std::array<std::uint32_t, triangle_total * 3> source{};
+        std::array<std::uint64_t, table_size> keys{};
+        std::array<std::uint32_t, table_size> values{};
+        for (int level = 0; level < Subdivisions; ++level)
+        {
+            for (std::size_t i = 0; i < triangles * 3; ++i)
+                source[i] = mesh.indices[i];
+            for (std::size_t i = 0; i < table_size; ++i)
+                keys[i] = 0;
+
+            // Find or create the vertex at the middle of an edge
+            auto midpoint = [&](const std::uint32_t p_a, const std::uint32_t p_b)
+            {
+                const std::uint64_t key = ((static_cast<std::uint64_t>(p_a < p_b ? p_a : p_b) << 32) | (p_a < p_b ? p_b : p_a)) + 1;
+                std::size_t slot = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 40) & (table_size - 1);
+                while (keys[slot] != 0 && keys[slot] != key)
+                    slot = (slot + 1) & (table_size - 1);
+                if (keys[slot] == 0)
+                {
+                    keys[slot] = key;
+                    values[slot] = static_cast<std::uint32_t>(vertices);
+                    mesh.vertices[vertices++] = (mesh.vertices[p_a] + mesh.vertices[p_b]).normalized() * p_radius;
+                }
+                return values[slot];
+            };
+
+            const std::size_t count = triangles;
+            triangles = 0;
+            for (std::size_t t = 0; t < count; ++t)
+            {
+                const std::uint32_t a = source[t * 3];
+                const std::uint32_t b = source[t * 3 + 1];
+                const std::uint32_t c = source[t * 3 + 2];
+                const std::uint32_t ab = midpoint(a, b);
+                const std::uint32_t bc = midpoint(b, c);
+                const std::uint32_t ca = midpoint(c, a);
+                detail::set_triangle(mesh, triangles++, a, ab, ca);
+                detail::set_triangle(mesh, triangles++, b, bc, ab);
+                detail::set_triangle(mesh, triangles++, c, ca, bc);
+                detail::set_triangle(mesh, triangles++, ab, bc, ca);
+            }
+        }
+        return mesh;
+    }
+
+    /// Build a flat grid in the XY plane centered on the origin
+    /// @tparam X                   Number of cells along X
+    /// @tparam Y                   Number of cells along Y
+    /// @param p_size_x             Grid width
+    /// @param p_size_y             Grid height
+    /// @return                     Grid with triangles facing +Z
+    template <std::size_t X, std::size_t Y>
+    constexpr static_mesh<(X + 1) * (Y + 1), X * Y * 2> make_grid(const double p_size_x, const double p_size_y)
+    {
+        static_mesh<(X + 1) * (Y + 1), X * Y * 2> mesh;
+        for (std::size_t y = 0; y <= Y; ++y)
+        {
+            for (std::size_t x = 0; x <= X; ++x)
+            {
+                mesh.vertices[y * (X + 1) + x] = vector3{
+                    (static_cast<double>(x) / X - 0.5) * p_size_x,
+                    (static_cast<double>(y) / Y - 0.5) * p_size_y,
+                    0.0
+                };
+            }
+        }
+
+        std::size_t t = 0;
+        for (std::size_t y = 0; y < Y; ++y)
+        {
+            for (std::size_t x = 0; x < X; ++x)
+            {
+                const std::uint32_t a = static_cast<std::uint32_t>(y * (X + 1) + x);
+                const std::uint32_t row = static_cast<std::uint32_t>(X + 1);
+                detail::set_triangle(mesh, t++, a, a + 1, a + row + 1);
+                detail::set_triangle(mesh, t++, a, a + row + 1, a + row);
+            }
+        }
+        return mesh;
+    }
+}
@@ -0,0 +1,398 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Instrumentation is compiled out unless MESH_ENABLE_PROFILING is defined.
+// Define it the same way in every translation unit of a program.
+#if defined(MESH_ENABLE_PROFILING)
+#define MESH_PROFILE_CONCAT_IMPL(p_a, p_b) p_a##p_b
+#define MESH_PROFILE_CONCAT(p_a, p_b) MESH_PROFILE_CONCAT_IMPL(p_a, p_b)
+
+/// Time the enclosing scope as one call of a stage processing p_elements items
+#define MESH_PROFILE_SCOPE(p_name, p_elements) \
+    static const ::mesh::detail::profile_site MESH_PROFILE_CONCAT(mesh_profile_site_, __LINE__)(p_name); \
+    const ::mesh::detail::profile_scope MESH_PROFILE_CONCAT(mesh_profile_scope_, __LINE__)(MESH_PROFILE_CONCAT(mesh_profile_site_, __LINE__), (p_elements))
+
+/// Count one call of a stage processing p_elements items, without timing it
+#define MESH_PROFILE_COUNT(p_name, p_elements) \
+    do \
+    { \
+        static const ::mesh::detail::profile_site mesh_profile_site(p_name); \
+        ::mesh::detail::profile_count(mesh_profile_site, (p_elements)); \
+    } while (false)
+#else
+#define MESH_PROFILE_SCOPE(p_name, p_elements) ((void)0)
+#define MESH_PROFILE_COUNT(p_name, p_elements) ((void)0)
+#endif
+
+namespace mesh
+{
+    /// Accumulated measurements of one instrumented stage
+    struct profile_entry
+    {
+        std::string name;                   ///< Stage name
+        std::uint64_t calls = 0;            ///< Number of calls
+        std::uint64_t elements = 0;         ///< Items processed (triangles, queries, cells, ...)
+        std::uint64_t nanoseconds = 0;      ///< Wall time summed over calls and threads (timed stages only)
+        std::uint64_t cycles = 0;           ///< CPU cycles (hardware counters only)
+        std::uint64_t cache_misses = 0;     ///< Last level cache misses (hardware counters only)
+    };
+
+    /// Maximum number of distinct stage names
+    constexpr std::size_t max_profile_sites = 256;
+
+    namespace detail
+    {
+        /// Counters of one stage on one thread
+        ///
+        /// Only the owning thread writes, so updates are a relaxed load and store
+        /// rather than a locked read-modify-write; the atomics only make
+        /// concurrent aggregation well defined.
+        struct profile_counters
+        {
+            std::atomic<std::uint64_t> calls{ 0 };
+            std::atomic<std::uint64_t> elements{ 0 };
+            std::atomic<std::uint64_t> nanoseconds{ 0 };
+            std::atomic<std::uint64_t> cycles{ 0 };
+            std::atomic<std::uint64_t> cache_misses{ 0 };
+        };
+
+        /// Add to a counter owned by the calling thread
+        inline void profile_add(std::atomic<std::uint64_t>& p_counter, const std::uint64_t p_value)
+        {
+            p_counter.store(p_counter.load(std::memory_order_relaxed) + p_value, std::memory_order_relaxed);
+        }
+
+        /// Hardware counter group of one thread (cycles and cache misses)
+        class profile_hardware
+        {
+        public:
+            profile_hardware() = default;
+            profile_hardware(const profile_hardware&) = delete;
+            profile_hardware& operator=(const profile_hardware&) = delete;
+
+            ~profile_hardware()
+            {
+                close();
+            }
+
+            /// Open the counters for the calling thread
+            /// @return                     True if both counters are available
+            bool open()
+            {
+                if (m_tried)
+                    return m_leader >= 0;
+                m_tried = true;
+#if defined(__linux__)
+                m_leader = open_counter(PERF_COUNT_HW_CPU_CYCLES, -1);
+                if (m_leader >= 0)
+                    m_member = open_counter(PERF_COUNT_HW_CACHE_MISSES, m_leader);
+                if (m_member < 0)
+                    close();
+#endif
+                return m_leader >= 0;
+            }
+
+            /// Read the current counter values
+            /// @param p_cycles             Cycle count
+            /// @param p_cache_misses       Cache miss count
+            /// @return                     True if the counters were read
+            bool read(std::uint64_t& p_cycles, std::uint64_t& p_cache_misses) const
+            {
+#if defined(__linux__)
+                if (m_leader < 0)
+                    return false;
+                std::uint64_t values[3] = {};
+                if (::read(m_leader, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[0] != 2)
+                    return false;
+                p_cycles = values[1];
+                p_cache_misses = values[2];
+                return true;
+#else
+                (void)p_cycles;
+                (void)p_cache_misses;
+                return false;
+#endif
+            }
+
+        private:
+#if defined(__linux__)
+            static int open_counter(const std::uint64_t p_config, const int p_group)
+            {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.size = sizeof(attr);
+                attr.config = p_config;
+                attr.read_format = PERF_FORMAT_GROUP;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, p_group, 0));
+            }
+#endif
+
+            void close()
+            {
+#if defined(__linux__)
+                if (m_member >= 0)
+                    ::close(m_member);
+                if (m_leader >= 0)
+                    ::close(m_leader);
+#endif
+                m_member = -1;
+                m_leader = -1;
+            }
+
+            int m_leader = -1;      ///< Group leader counting cycles
+            int m_member = -1;      ///< Group member counting cache misses
+            bool m_tried = false;   ///< Whether opening was attempted
+        };
+
+        class profile_buffer;
+
+        /// Process-wide list of stage names and thread buffers
+        struct profile_registry
+        {
+            std::mutex mutex;
+            std::vector<std::string> names;                         ///< Stage name per site id
+            std::vector<profile_buffer*> buffers;                   ///< Buffers of running threads
+            profile_counters retired[max_profile_sites];            ///< Totals of exited threads
+            std::atomic<bool> hardware{ false };                    ///< Whether to read hardware counters
+        };
+
+        inline profile_registry& profile_registry_instance()
+        {
+            static profile_registry registry;
+            return registry;
+        }
+
+        /// Counters of every stage on one thread
+        ///
+        /// Registered on first use by a thread and folded into the retired totals
+        /// when the thread exits.
+        class profile_buffer
+        {
+        public:
+            profile_buffer()
+            {
+                profile_registry& registry = profile_registry_instance();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                registry.buffers.push_back(this);
+            }
+
+            profile_buffer(const profile_buffer&) = delete;
+            profile_buffer& operator=(const profile_buffer&) = delete;
+
+            ~profile_buffer()
+            {
+                profile_registry& registry = profile_registry_instance();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                for (std::size_t i = 0; i < max_profile_sites; ++i)
+                {
+                    registry.retired[i].calls += counters[i].calls.load(std::memory_order_relaxed);
+                    registry.retired[i].elements += counters[i].elements.load(std::memory_order_relaxed);
+                    registry.retired[i].nanoseconds += counters[i].nanoseconds.load(std::memory_order_relaxed);
+                    registry.retired[i].cycles += counters[i].cycles.load(std::memory_order_relaxed);
+                    registry.retired[i].cache_misses += counters[i].cache_misses.load(std::memory_order_relaxed);
+                }
+                registry.buffers.erase(std::find(registry.buffers.begin(), registry.buffers.end(), this));
+            }
+
+            profile_counters counters[max_profile_sites];
+            profile_hardware hardware;
+        };
+
+        /// Get the calling thread's buffer
+        inline profile_buffer& profile_local()
+        {
+            thread_local profile_buffer buffer;
+            return buffer;
+        }
+
+        /// Instrumentation point, identified by its stage name
+        ///
+        /// Sites with the same name share counters. Names beyond
+        /// max_profile_sites are ignored.
+        class profile_site
+        {
+        public:
+            explicit profile_site(const char* p_name)
+            {
+                profile_registry& registry = profile_registry_instance();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                const auto found = std::find(registry.names.begin(), registry.names.end(), p_name);
+                m_id = static_cast<std::size_t>(found - registry.names.begin());
+                if (found == registry.names.end() && m_id < max_profile_sites)
+                    registry.names.emplace_back(p_name);
+            }
+
+            /// Get the counters of the calling thread
+            /// @return                     Counters, or null if the site is ignored
+            profile_counters* local() const
+            {
+                return m_id < max_profile_sites ? &profile_local().counters[m_id] : nullptr;
+            }
+
+        private:
+            std::size_t m_id = max_profile_sites;
+        };
+
+        /// Count a call of a site without timing it
+        inline void profile_count(const profile_site& p_site, const std::uint64_t p_elements)
+        {
+            if (profile_counters* counters = p_site.local())
+            {
+                profile_add(counters->calls, 1);
+                profile_add(counters->elements, p_elements);
+            }
+        }
+
+        /// Scoped timer adding its duration to a site
+        class profile_scope
+        {
+        public:
+            profile_scope(const profile_site& p_site, const std::uint64_t p_elements)
+                : m_counters(p_site.local())
+            {
+                if (!m_counters)
+                    return;
+                profile_add(m_counters->calls, 1);
+                profile_add(m_counters->elements, p_elements);
+                if (profile_registry_instance().hardware.load(std::memory_order_relaxed))
+                {
+                    profile_hardware& hardware = profile_local().hardware;
+                    m_hardware = hardware.open() && hardware.read(m_cycles, m_cache_misses);
+                }
+                m_start = std::chrono::steady_clock::now();
+            }
+
+            profile_scope(const profile_scope&) = delete;
+            profile_scope& operator=(const profile_scope&) = delete;
+
+            ~profile_scope()
+            {
+                if (!m_counters)
+                    return;
+                const auto elapsed = std::chrono::steady_clock::now() - m_start;
+                profile_add(m_counters->nanoseconds, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+
+                std::uint64_t cycles = 0;
+                std::uint64_t cache_misses = 0;
+                if (m_hardware && profile_local().hardware.read(cycles, cache_misses))
+                {
+                    profile_add(m_counters->cycles, cycles - m_cycles);
+                    profile_add(m_counters->cache_misses, cache_misses - m_cache_misses);
+                }
+            }
+
+        private:
+            profile_counters* m_counters;
+            std::chrono::steady_clock::time_point m_start;
+            std::uint64_t m_cycles = 0;
+            std::uint64_t m_cache_misses = 0;
+            bool m_hardware = false;
+        };
+    }
+
+    /// Enable or disable hardware counters for timed stages
+    ///
+    /// Uses perf_event_open on Linux, counting user-space cycles and cache misses
+    /// of each thread. Availability depends on the kernel's perf_event_paranoid
+    /// setting and on the machine exposing a PMU; when unavailable, timed stages
+    /// still record wall time.
+    /// @param p_enable             Whether to read hardware counters
+    /// @return                     True if the counters are available on the calling thread
+    inline bool enable_profile_hardware_counters(const bool p_enable)
+    {
+        detail::profile_registry_instance().hardware = p_enable;
+        return p_enable && detail::profile_local().hardware.open();
+    }
+
+    /// Aggregate the counters of all threads
+    ///
+    /// Safe to call while instrumented code runs; counts from scopes still in
+    /// progress are not included.
+    /// @return                     Measurements of every stage that was called, sorted by name
+    inline std::vector<profile_entry> profile_report()
+    {
+        detail::profile_registry& registry = detail::profile_registry_instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::vector<profile_entry> entries;
+        for (std::size_t i = 0; i < registry.names.size(); ++i)
+        {
+            profile_entry entry;
+            entry.name = registry.names[i];
+            auto add = [&](const detail::profile_counters& p_counters)
+            {
+                entry.calls += p_counters.calls.load(std::memory_order_relaxed);
+                entry.elements += p_counters.elements.load(std::memory_order_relaxed);
+                entry.nanoseconds += p_counters.nanoseconds.load(std::memory_order_relaxed);
+                entry.cycles += p_counters.cycles.load(std::memory_order_relaxed);
+                entry.cache_misses += p_counters.cache_misses.load(std::memory_order_relaxed);
+            };
+            add(registry.retired[i]);
+            for (const detail::profile_buffer* buffer : registry.buffers)
+                add(buffer->counters[i]);
+            if (entry.calls != 0)
+                entries.push_back(std::move(entry));
+        }
+        std::sort(entries.begin(), entries.end(), [](const profile_entry& p_a, const profile_entry& p_b) { return p_a.name < p_b.name; });
+        return entries;
+    }
+
+    /// Reset the counters of all threads
+    ///
+    /// Updates racing with the reset may be lost.
+    inline void profile_reset()
+    {
+        detail::profile_registry& registry = detail::profile_registry_instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto clear = [](detail::profile_counters& p_counters)
+        {
+            p_counters.calls = 0;
+            p_counters.elements = 0;
+            p_counters.nanoseconds = 0;
+            p_counters.cycles = 0;
+            p_counters.cache_misses = 0;
+        };
+        for (std::size_t i = 0; i < max_profile_sites; ++i)
+        {
+            clear(registry.retired[i]);
+            for (detail::profile_buffer* buffer : registry.buffers)
+                clear(buffer->counters[i]);
+        }
+    }
+
+    /// Format measurements as a text table
+    /// @param p_entries            Measurements
+    /// @return                     One line per stage with calls, elements, time and hardware counters
+    inline std::string format_profile_report(const std::vector<profile_entry>& p_entries)
+    {
+        std::string text = "stage                            calls     elements      time ms   ns/element       cycles  cache misses\n";
+        char line[256];
+        for (const profile_entry& e : p_entries)
+        {
+            const double per_element = e.elements != 0 ? static_cast<double>(e.nanoseconds) / static_cast<double>(e.elements) : 0.0;
+            std::snprintf(line, sizeof(line), "%-28s %9llu %12llu %12.3f %12.2f %12llu %13llu\n", e.name.c_str(),
+                static_cast<unsigned long long>(e.calls), static_cast<unsigned long long>(e.elements), static_cast<double>(e.nanoseconds) * 1e-6,
+                per_element, static_cast<unsigned long long>(e.cycles), static_cast<unsigned long long>(e.cache_misses));
+            text += line;
+        }
+        return text;
+    }
+}
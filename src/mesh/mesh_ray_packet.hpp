@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "mesh_aabb3.hpp"
+#include "mesh_plane3.hpp"
+#include "mesh_triangle3.hpp"
+
+namespace mesh
+{
+    /// Ray packet lane mask (bit i set for lane i)
+    using ray_mask = std::uint32_t;
+
+    /// Count the active lanes in a ray mask
+    /// @param p_mask               Mask to count
+    /// @return                     Number of set bits
+    constexpr int mask_count(ray_mask p_mask)
+    {
+        int count = 0;
+        for (; p_mask; p_mask &= p_mask - 1)
+            ++count;
+        return count;
+    }
+
+    /// Packet of N coherent rays stored in structure-of-arrays form
+    ///
+    /// The lane loops are written branch-free over fixed-size aligned arrays so the
+    /// compiler vectorizes them for the target instruction set (SSE/AVX/AVX-512/NEON).
+    /// @tparam N                   Number of rays (4, 8 or 16)
+    template <std::size_t N>
+    struct ray_packet
+    {
+        static_assert(N == 4 || N == 8 || N == 16, "ray_packet supports 4, 8 or 16 lanes");
+
+        /// Number of lanes
+        static constexpr std::size_t size = N;
+
+        /// Mask with every lane active
+        static constexpr ray_mask all = static_cast<ray_mask>((std::uint64_t{ 1 } << N) - 1);
+
+        alignas(64) double origin_x[N] = {};        ///< Origin X components
+        alignas(64) double origin_y[N] = {};        ///< Origin Y components
+        alignas(64) double origin_z[N] = {};        ///< Origin Z components
+        alignas(64) double direction_x[N] = {};     ///< Direction X components
+        alignas(64) double direction_y[N] = {};     ///< Direction Y components
+        alignas(64) double direction_z[N] = {};     ///< Direction Z components
+        alignas(64) double inv_direction_x[N] = {}; ///< Reciprocal direction X components
+        alignas(64) double inv_direction_y[N] = {}; ///< Reciprocal direction Y components
+        alignas(64) double inv_direction_z[N] = {}; ///< Reciprocal direction Z components
+        alignas(64) double max_distance[N] = {};    ///< Maximum distance along each ray
+
+        /// Set a ray lane
+        /// @param p_lane               Lane index
+        /// @param p_origin             Ray origin
+        /// @param p_direction          Ray direction
+        /// @param p_max_distance       Maximum distance along the ray
+        void set(const std::size_t p_lane, const vector3& p_origin, const vector3& p_direction, const double p_max_distance = std::numeric_limits<double>::infinity())
+        {
+            origin_x[p_lane] = p_origin.x;
+            origin_y[p_lane] = p_origin.y;
+            origin_z[p_lane] = p_origin.z;
+            direction_x[p_lane] = p_direction.x;
+            direction_y[p_lane] = p_direction.y;
+            direction_z[p_lane] = p_direction.z;
+            inv_direction_x[p_lane] = 1.0 / p_direction.x;
+            inv_direction_y[p_lane] = 1.0 / p_direction.y;
+            inv_direction_z[p_lane] = 1.0 / p_direction.z;
+            max_distance[p_lane] = p_max_distance;
+        }
+
+        /// Get a ray lane origin
+        /// @param p_lane               Lane index
+        /// @return                     Ray origin
+        vector3 origin(const std::size_t p_lane) const
+        {
+            return vector3{ origin_x[p_lane], origin_y[p_lane], origin_z[p_lane] };
+        }
+
+        /// Get a ray lane direction
+        /// @param p_lane               Lane index
+        /// @return                     Ray direction
+        vector3 direction(const std::size_t p_lane) const
+        {
+            return vector3{ direction_x[p_lane], direction_y[p_lane], direction_z[p_lane] };
+        }
+
+        /// Check if all active rays share the same direction signs
+        ///
+        /// Coherent packets visit box children in the same order for every lane.
+        /// @param p_active             Active lanes
+        /// @return                     True if coherent
+        bool is_coherent(const ray_mask p_active = all) const
+        {
+            int signs = -1;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (!(p_active & (ray_mask{ 1 } << i)))
+                    continue;
+
+                const int s = (direction_x[i] < 0.0 ? 1 : 0) | (direction_y[i] < 0.0 ? 2 : 0) | (direction_z[i] < 0.0 ? 4 : 0);
+                if (signs >= 0 && s != signs)
+                    return false;
+                signs = s;
+            }
+
+            return true;
+        }
+
+        /// Intersect packet with plane
+        /// @param p_plane              Plane to intersect
+        /// @param p_distances          Optional per-lane hit distances
+        /// @param p_active             Active lanes
+        /// @return                     Hit mask
+        ray_mask intersect_plane(const plane3& p_plane, double* p_distances = nullptr, const ray_mask p_active = all) const
+        {
+            alignas(64) double dist[N];
+            alignas(64) std::uint8_t hit[N];
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                const double den = p_plane.normal.x * direction_x[i] + p_plane.normal.y * direction_y[i] + p_plane.normal.z * direction_z[i];
+                const double num = p_plane.distance - (p_plane.normal.x * origin_x[i] + p_plane.normal.y * origin_y[i] + p_plane.normal.z * origin_z[i]);
+                const bool valid = cabs(den) >= std::numeric_limits<double>::epsilon();
+                dist[i] = valid ? num / den : 0.0;
+                hit[i] = valid && dist[i] >= std::numeric_limits<double>::epsilon() && dist[i] <= max_distance[i];
+            }
+
+            return finish(dist, hit, p_distances, p_active);
+        }
+
+        /// Intersect packet with box
+        /// @param p_box                Box to intersect
+        /// @param p_distances          Optional per-lane entry distances
+        /// @param p_active             Active lanes
+        /// @return                     Hit mask
+        ray_mask intersect_aabb(const aabb3& p_box, double* p_distances = nullptr, const ray_mask p_active = all) const
+        {
+            alignas(64) double dist[N];
+            alignas(64) std::uint8_t hit[N];
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                const double tx1 = (p_box.minimum.x - origin_x[i]) * inv_direction_x[i];
+                const double tx2 = (p_box.maximum.x - origin_x[i]) * inv_direction_x[i];
+                const double ty1 = (p_box.minimum.y - origin_y[i]) * inv_direction_y[i];
+                const double ty2 = (p_box.maximum.y - origin_y[i]) * inv_direction_y[i];
+                const double tz1 = (p_box.minimum.z - origin_z[i]) * inv_direction_z[i];
+                const double tz2 = (p_box.maximum.z - origin_z[i]) * inv_direction_z[i];
+                const double t_near = std::max(std::max(detail::slab_near(tx1, tx2), detail::slab_near(ty1, ty2)), std::max(detail::slab_near(tz1, tz2), 0.0));
+                const double t_far = std::min(std::min(detail::slab_far(tx1, tx2), detail::slab_far(ty1, ty2)), std::min(detail::slab_far(tz1, tz2), max_distance[i]));
+                dist[i] = t_near;
+                hit[i] = t_near <= t_far;
+            }
+
+            return finish(dist, hit, p_distances, p_active);
+        }
+
+        /// Intersect packet with triangle (Moller-Trumbore)
+        /// @param p_triangle           Triangle to intersect
+        /// @param p_distances          Optional per-lane hit distances
+        /// @param p_active             Active lanes
+        /// @return                     Hit mask
+        ray_mask intersect_triangle(const triangle3& p_triangle, double* p_distances = nullptr, const ray_mask p_active = all) const
+        {
+            const vector3 edge1 = p_triangle.point2 - p_triangle.point1;
+            const vector3 edge2 = p_triangle.point3 - p_triangle.point1;
+
+            alignas(64) double dist[N];
+            alignas(64) std::uint8_t hit[N];
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                // p = direction x edge2
+                const double px = direction_y[i] * edge2.z - direction_z[i] * edge2.y;
+                const double py = direction_z[i] * edge2.x - direction_x[i] * edge2.z;
+                const double pz = direction_x[i] * edge2.y - direction_y[i] * edge2.x;
+                const double det = edge1.x * px + edge1.y * py + edge1.z * pz;
+                const bool valid = cabs(det) >= std::numeric_limits<double>::epsilon();
+                const double inv_det = valid ? 1.0 / det : 0.0;
+
+                // s = origin - point1, q = s x edge1
+                const double sx = origin_x[i] - p_triangle.point1.x;
+                const double sy = origin_y[i] - p_triangle.point1.y;
+                const double sz = origin_z[i] - p_triangle.point1.z;
+                const double u = (sx * px + sy * py + sz * pz) * inv_det;
+                const double qx = sy * edge1.z - sz * edge1.y;
+                const double qy = sz * edge1.x - sx * edge1.z;
+                const double qz = sx * edge1.y - sy * edge1.x;
+                const double v = (direction_x[i] * qx + direction_y[i] * qy + direction_z[i] * qz) * inv_det;
+                const double t = (edge2.x * qx + edge2.y * qy + edge2.z * qz) * inv_det;
+
+                dist[i] = t;
+                hit[i] = valid && u >= 0.0 && v >= 0.0 && u + v <= 1.0 &&
+                    t >= std::numeric_limits<double>::epsilon() && t <= max_distance[i];
+            }
+
+            return finish(dist, hit, p_distances, p_active);
+        }
+
+    private:
+        /// Pack lane results into a mask and copy out the hit distances
+        static ray_mask finish(const double* p_dist, const std::uint8_t* p_hit, double* p_distances, const ray_mask p_active)
+        {
+            ray_mask mask = 0;
+            for (std::size_t i = 0; i < N; ++i)
+                mask |= static_cast<ray_mask>(p_hit[i] ? 1 : 0) << i;
+            mask &= p_active;
+
+            if (p_distances)
+            {
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    if (mask & (ray_mask{ 1 } << i))
+                        p_distances[i] = p_dist[i];
+                }
+            }
+
+            return mask;
+        }
+    };
+
+    /// Closest-hit results for a ray packet
+    /// @tparam N                   Number of rays
+    template <std::size_t N>
+    struct ray_packet_hit
+    {
+        ray_mask mask = 0;                  ///< Lanes that hit something
+        double distance[N] = {};            ///< Hit distance per lane
+        std::size_t index[N] = {};          ///< Hit primitive index per lane
+    };
+
+    /// Find the closest triangle hit for every lane of a ray packet
+    ///
+    /// Each hit shortens the lane's maximum distance so later triangles are culled.
+    /// Every triangle is tested against the whole packet, so lane coherence does
+    /// not matter here. mesh_bvh::intersect_rays() traverses a hierarchy with
+    /// coherent packets and falls back to single rays otherwise.
+    /// @param p_packet             Ray packet (maximum distances are updated)
+    /// @param p_triangles          Triangles to intersect
+    /// @param p_count              Number of triangles
+    /// @param p_hit                Closest-hit results
+    /// @param p_active             Active lanes
+    /// @return                     Hit mask
+    template <std::size_t N>
+    ray_mask intersect_triangles(ray_packet<N>& p_packet, const triangle3* p_triangles, const std::size_t p_count, ray_packet_hit<N>& p_hit, const ray_mask p_active = ray_packet<N>::all)
+    {
+        // Trace the whole packet against each triangle
+        alignas(64) double dist[N];
+        for (std::size_t i = 0; i < p_count; ++i)
+        {
+            ray_mask hits = p_packet.intersect_triangle(p_triangles[i], dist, p_active);
+            for (; hits; hits &= hits - 1)
+            {
+                std::size_t lane = 0;
+                while (!(hits & (ray_mask{ 1 } << lane)))
+                    ++lane;
+
+                p_packet.max_distance[lane] = dist[lane];
+                p_hit.distance[lane] = dist[lane];
+                p_hit.index[lane] = i;
+                p_hit.mask |= ray_mask{ 1 } << lane;
+            }
+        }
+
+        return p_hit.mask & p_active;
+    }
+}
@@ -0,0 +1,944 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "mesh_bvh.hpp"
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+
+namespace mesh
+{
+    /// Isotropic remeshing options
+    struct remesh_options
+    {
+        /// Target edge length (zero uses the mean edge length of the input)
+        double target_edge_length = 0.0;
+
+        /// Number of split, collapse, flip and smoothing rounds
+        int iterations = 5;
+
+        /// Fraction of the tangential relaxation step applied per round (0 to 1)
+        double smoothing = 0.5;
+
+        /// Project smoothed vertices back to the input surface
+        bool project = true;
+    };
+
+    /// Operation counts of an isotropic remeshing run
+    struct remesh_result
+    {
+        bool ok = false;                ///< False if the input has out-of-range indices (the mesh is left unchanged)
+        std::size_t splits = 0;         ///< Edges split
+        std::size_t collapses = 0;      ///< Edges collapsed
+        std::size_t flips = 0;          ///< Edges flipped
+    };
+
+    namespace detail
+    {
+        /// Edge queued for an operation, identified by its endpoints
+        struct remesh_candidate
+        {
+            std::uint32_t a;                ///< First endpoint
+            std::uint32_t b;                ///< Second endpoint
+            std::uint32_t edge;             ///< Half-edge joining the endpoints when queued (a hint, rechecked before use)
+            double key;                     ///< Priority (lower runs first)
+        };
+
+        /// Validated operation of one round
+        struct remesh_operation
+        {
+            std::uint32_t edge = no_neighbor;   ///< Half-edge to operate on (the removed vertex first for collapses)
+            std::uint32_t region = 0;           ///< Number of reserved vertices (zero if invalid)
+            std::uint32_t vertices = 0;         ///< Number of vertices added
+            std::uint32_t triangles = 0;        ///< Number of triangles added
+            std::uint32_t first_vertex = 0;     ///< First added vertex
+            std::uint32_t first_triangle = 0;   ///< First added triangle
+            bool validated = false;             ///< True if the fields below are up to date
+            bool committed = false;             ///< True if every region vertex was reserved
+            vector3 position;                   ///< Position of the added or merged vertex
+        };
+
+        /// Per-thread scratch buffers of fan walks
+        struct remesh_scratch
+        {
+            std::vector<std::uint32_t> fan;
+            std::vector<std::uint32_t> neighbors1;
+            std::vector<std::uint32_t> neighbors2;
+            std::vector<std::uint32_t> common;
+        };
+
+        /// Half-edge mesh applying split, collapse and flip batches in parallel
+        ///
+        /// Half-edge h is edge h % 3 of triangle h / 3, running from corner h % 3
+        /// to the next corner, as in compute_edge_adjacency(). Each round
+        /// validates a window of queued edges in parallel, and every valid
+        /// operation reserves the vertices it reads or writes by an atomic
+        /// minimum of its queue position. Operations holding all of their
+        /// vertices touch disjoint parts of the mesh and run in parallel; the
+        /// rest retry in the next round. The first valid operation always
+        /// wins, and the result does not depend on the thread count.
+        class remesher
+        {
+        public:
+            enum class operation
+            {
+                split,
+                collapse,
+                flip
+            };
+
+            /// Build the half-edge mesh
+            /// @param p_mesh               Mesh with in-range indices
+            remesher(const indexed_mesh& p_mesh)
+                : m_positions(p_mesh.vertices), m_flags(p_mesh.vertex_count(), 0), m_out(p_mesh.vertex_count(), no_neighbor)
+            {
+                // Degenerate triangles have no fan position
+                m_indices.reserve(p_mesh.indices.size());
+                for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+                {
+                    const std::uint32_t* tri = p_mesh.indices.data() + t * 3;
+                    if (tri[0] != tri[1] && tri[1] != tri[2] && tri[2] != tri[0])
+                        m_indices.insert(m_indices.end(), tri, tri + 3);
+                }
+
+                // Twins must run the opposite way; inconsistent winding leaves a boundary
+                indexed_mesh topology;
+                topology.indices = m_indices;
+                const std::vector<std::uint32_t> neighbors = compute_edge_adjacency(topology);
+                m_twins.assign(m_indices.size(), no_neighbor);
+                for (std::uint32_t h = 0; h < m_indices.size(); ++h)
+                {
+                    if (neighbors[h] == no_neighbor)
+                        continue;
+                    for (std::uint32_t k = neighbors[h] * 3; k < neighbors[h] * 3 + 3; ++k)
+                    {
+                        if (m_indices[k] == m_indices[next(h)] && m_indices[next(k)] == m_indices[h])
+                            m_twins[h] = k;
+                    }
+                }
+
+                // Vertices whose fan misses some of their triangles are not manifold
+                std::vector<std::uint32_t> counts(m_positions.size(), 0);
+                for (std::uint32_t h = 0; h < m_indices.size(); ++h)
+                {
+                    m_out[m_indices[h]] = h;
+                    ++counts[m_indices[h]];
+                }
+                remesh_scratch scratch;
+                for (std::uint32_t v = 0; v < m_positions.size(); ++v)
+                {
+                    bool open = false;
+                    if (m_out[v] == no_neighbor)
+                        m_flags[v] = dead;
+                    else if (!fan(v, scratch.fan, open) || scratch.fan.size() != counts[v])
+                        m_flags[v] = locked;
+                    else if (open)
+                        m_flags[v] = boundary;
+                }
+            }
+
+            /// Calculate the mean edge length
+            /// @return                     Mean length (zero without edges)
+            double mean_edge_length() const
+            {
+                double sum = 0.0;
+                std::size_t count = 0;
+                for (std::uint32_t h = 0; h < m_indices.size(); ++h)
+                {
+                    if (m_twins[h] != no_neighbor && m_twins[h] < h)
+                        continue;
+                    sum += (m_positions[m_indices[next(h)]] - m_positions[m_indices[h]]).length();
+                    ++count;
+                }
+                return count != 0 ? sum / static_cast<double>(count) : 0.0;
+            }
+
+            /// Set the target edge length
+            /// @param p_length             Target length
+            void set_target(const double p_length)
+            {
+                m_high2 = p_length * p_length * (16.0 / 9.0);
+                m_low2 = p_length * p_length * (16.0 / 25.0);
+            }
+
+            /// Queue every edge an operation applies to
+            /// @param p_operation          Operation
+            /// @return                     Candidates in priority order
+            std::vector<remesh_candidate> scan(const operation p_operation) const
+            {
+                std::vector<double> keys(m_indices.size());
+                std::vector<std::uint8_t> selected(m_indices.size(), 0);
+                parallel_for(m_indices.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+                {
+                    for (std::size_t i = p_begin; i < p_end; ++i)
+                    {
+                        const std::uint32_t h = static_cast<std::uint32_t>(i);
+                        const std::uint32_t t = m_twins[h];
+                        if (m_indices[h] == no_neighbor || (t != no_neighbor && t < h))
+                            continue;
+                        const std::uint32_t a = m_indices[h];
+                        const std::uint32_t b = m_indices[next(h)];
+                        if ((m_flags[a] | m_flags[b]) & locked)
+                            continue;
+
+                        // Longest edges split first, shortest collapse first
+                        const double length2 = (m_positions[b] - m_positions[a]).length2();
+                        if (p_operation == operation::split && length2 > m_high2)
+                            keys[h] = -length2;
+                        else if (p_operation == operation::collapse && length2 < m_low2)
+                            keys[h] = length2;
+                        else if (p_operation == operation::flip && t != no_neighbor)
+                            keys[h] = static_cast<double>(h);
+                        else
+                            continue;
+                        selected[h] = 1;
+                    }
+                }, 4096);
+
+                std::vector<remesh_candidate> candidates;
+                for (std::uint32_t h = 0; h < m_indices.size(); ++h)
+                {
+                    if (selected[h])
+                        candidates.push_back(remesh_candidate{ m_indices[h], m_indices[next(h)], h, keys[h] });
+                }
+                std::sort(candidates.begin(), candidates.end(), [](const remesh_candidate& p_a, const remesh_candidate& p_b)
+                {
+                    return p_a.key < p_b.key || (p_a.key == p_b.key && p_a.edge < p_b.edge);
+                });
+                return candidates;
+            }
+
+            /// Apply an operation to queued edges in conflict-free parallel rounds
+            /// @param p_operation          Operation
+            /// @param p_candidates         Candidates in priority order
+            /// @return                     Number of operations applied
+            std::size_t process(const operation p_operation, const std::vector<remesh_candidate>& p_candidates)
+            {
+                std::size_t applied = 0;
+                std::size_t next_candidate = 0;
+                std::vector<remesh_candidate> work;
+                std::vector<remesh_operation> ops;
+                std::vector<std::uint32_t> regions(window * max_region);
+                for (;;)
+                {
+                    while (work.size() < window && next_candidate < p_candidates.size())
+                    {
+                        work.push_back(p_candidates[next_candidate++]);
+                        ops.emplace_back();
+                    }
+                    if (work.empty())
+                        break;
+
+                    // Validate and reserve: the lowest queue position wins each vertex
+                    reserve_vertices(m_positions.size());
+                    parallel_for(work.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+                    {
+                        remesh_scratch scratch;
+                        for (std::size_t i = p_begin; i < p_end; ++i)
+                        {
+                            std::uint32_t* region = regions.data() + i * max_region;
+                            if (!ops[i].validated)
+                            {
+                                ops[i] = remesh_operation();
+                                ops[i].region = validate(p_operation, work[i], ops[i], region, scratch);
+                                ops[i].validated = true;
+                            }
+                            for (std::uint32_t r = 0; r < ops[i].region; ++r)
+                            {
+                                std::atomic<std::uint32_t>& owner = m_reserved[region[r]];
+                                std::uint32_t current = owner.load(std::memory_order_relaxed);
+                                while (i < current && !owner.compare_exchange_weak(current, static_cast<std::uint32_t>(i), std::memory_order_relaxed))
+                                {
+                                }
+                            }
+                        }
+                    }, 256);
+
+                    parallel_for(work.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+                    {
+                        for (std::size_t i = p_begin; i < p_end; ++i)
+                        {
+                            const std::uint32_t* region = regions.data() + i * max_region;
+                            bool owned = ops[i].region != 0;
+                            for (std::uint32_t r = 0; owned && r < ops[i].region; ++r)
+                                owned = m_reserved[region[r]].load(std::memory_order_relaxed) == i;
+                            ops[i].committed = owned;
+                        }
+                    }, 1024);
+
+                    // Allocate added elements in queue order so numbering is deterministic
+                    std::uint32_t vertex_count = static_cast<std::uint32_t>(m_positions.size());
+                    std::uint32_t triangle_count = static_cast<std::uint32_t>(m_indices.size() / 3);
+                    for (auto& op : ops)
+                    {
+                        if (!op.committed)
+                            continue;
+                        op.first_vertex = vertex_count;
+                        op.first_triangle = triangle_count;
+                        vertex_count += op.vertices;
+                        triangle_count += op.triangles;
+                    }
+                    m_positions.resize(vertex_count);
+                    m_flags.resize(vertex_count, 0);
+                    m_out.resize(vertex_count, no_neighbor);
+                    m_touched.resize(vertex_count, 0);
+                    m_indices.resize(std::size_t{ triangle_count } * 3, no_neighbor);
+                    m_twins.resize(std::size_t{ triangle_count } * 3, no_neighbor);
+
+                    // Committed regions are disjoint, so they run in parallel and stamp their vertices
+                    ++m_round;
+                    parallel_for(work.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+                    {
+                        remesh_scratch scratch;
+                        for (std::size_t i = p_begin; i < p_end; ++i)
+                        {
+                            if (!ops[i].committed)
+                                continue;
+                            if (p_operation == operation::split)
+                                execute_split(ops[i]);
+                            else if (p_operation == operation::collapse)
+                                execute_collapse(ops[i], scratch);
+                            else
+                                execute_flip(ops[i]);
+                            const std::uint32_t* region = regions.data() + i * max_region;
+                            for (std::uint32_t r = 0; r < ops[i].region; ++r)
+                                m_touched[region[r]] = m_round;
+                        }
+                    }, 256);
+
+                    // Release reservations and keep valid operations that lost a vertex;
+                    // only those next to a committed operation need validating again
+                    std::size_t kept = 0;
+                    for (std::size_t i = 0; i < work.size(); ++i)
+                    {
+                        const std::uint32_t* region = regions.data() + i * max_region;
+                        bool touched = false;
+                        for (std::uint32_t r = 0; r < ops[i].region; ++r)
+                        {
+                            m_reserved[region[r]].store(no_neighbor, std::memory_order_relaxed);
+                            touched = touched || m_touched[region[r]] == m_round;
+                        }
+                        if (ops[i].committed)
+                        {
+                            ++applied;
+                            continue;
+                        }
+                        if (ops[i].region == 0)
+                            continue;
+                        work[kept] = work[i];
+                        ops[kept] = ops[i];
+                        ops[kept].validated = !touched;
+                        if (kept != i)
+                            std::copy(region, region + ops[i].region, regions.data() + kept * max_region);
+                        ++kept;
+                    }
+                    work.resize(kept);
+                    ops.resize(kept);
+                }
+                return applied;
+            }
+
+            /// Move vertices towards the centroid of their neighbours within the tangent plane
+            /// @param p_amount             Fraction of the step to apply
+            /// @param p_surface            Surface to project moved vertices onto (null to skip)
+            void smooth(const double p_amount, const mesh_bvh* p_surface)
+            {
+                std::vector<vector3> moved(m_positions);
+                parallel_for(m_positions.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+                {
+                    remesh_scratch scratch;
+                    for (std::size_t i = p_begin; i < p_end; ++i)
+                    {
+                        const std::uint32_t v = static_cast<std::uint32_t>(i);
+                        bool open = false;
+                        if ((m_flags[v] & (dead | locked | boundary)) || !fan(v, scratch.fan, open) || open)
+                            continue;
+
+                        const vector3& p = m_positions[v];
+                        vector3 centroid;
+                        vector3 normal;
+                        for (const std::uint32_t h : scratch.fan)
+                        {
+                            const vector3& p1 = m_positions[m_indices[next(h)]];
+                            const vector3& p2 = m_positions[m_indices[prev(h)]];
+                            centroid += p1;
+                            normal += (p1 - p).cross(p2 - p);
+                        }
+                        vector3 offset = centroid / static_cast<double>(scratch.fan.size()) - p;
+                        const double normal2 = normal.length2();
+                        if (normal2 > 0.0)
+                            offset -= normal * (offset.dot(normal) / normal2);
+                        moved[v] = p + offset * p_amount;
+                    }
+                }, 1024);
+
+                if (p_surface != nullptr && !p_surface->empty())
+                {
+                    std::vector<std::uint32_t> movable;
+                    std::vector<vector3> points;
+                    for (std::uint32_t v = 0; v < m_positions.size(); ++v)
+                    {
+                        if (!(m_flags[v] & (dead | locked | boundary)))
+                        {
+                            movable.push_back(v);
+                            points.push_back(moved[v]);
+                        }
+                    }
+                    std::vector<bvh_closest_hit> hits(points.size());
+                    p_surface->closest_points(points.data(), points.size(), hits.data());
+                    for (std::size_t i = 0; i < movable.size(); ++i)
+                    {
+                        if (hits[i].hit)
+                            moved[movable[i]] = hits[i].point;
+                    }
+                }
+                m_positions.swap(moved);
+            }
+
+            /// Remove dead triangles and vertices
+            void compact()
+            {
+                std::vector<std::uint32_t> triangle_map(m_indices.size() / 3, no_neighbor);
+                std::vector<std::uint32_t> vertex_map(m_positions.size(), no_neighbor);
+                std::uint32_t triangles = 0;
+                std::uint32_t vertices = 0;
+                for (std::size_t t = 0; t < triangle_map.size(); ++t)
+                {
+                    if (m_indices[t * 3] == no_neighbor)
+                        continue;
+                    triangle_map[t] = triangles++;
+                    for (std::size_t c = t * 3; c < t * 3 + 3; ++c)
+                    {
+                        if (vertex_map[m_indices[c]] == no_neighbor)
+                            vertex_map[m_indices[c]] = vertices++;
+                    }
+                }
+
+                std::vector<vector3> positions(vertices);
+                std::vector<std::uint8_t> flags(vertices);
+                for (std::size_t v = 0; v < vertex_map.size(); ++v)
+                {
+                    if (vertex_map[v] != no_neighbor)
+                    {
+                        positions[vertex_map[v]] = m_positions[v];
+                        flags[vertex_map[v]] = m_flags[v];
+                    }
+                }
+
+                std::vector<std::uint32_t> indices(std::size_t{ triangles } * 3);
+                std::vector<std::uint32_t> twins(std::size_t{ triangles } * 3, no_neighbor);
+                std::vector<std::uint32_t> out(vertices);
+                for (std::uint32_t h = 0; h < m_indices.size(); ++h)
+                {
+                    const std::uint32_t t = triangle_map[h / 3];
+                    if (t == no_neighbor)
+                        continue;
+                    const std::uint32_t n = t * 3 + h % 3;
+                    indices[n] = vertex_map[m_indices[h]];
+                    if (m_twins[h] != no_neighbor)
+                        twins[n] = triangle_map[m_twins[h] / 3] * 3 + m_twins[h] % 3;
+                    out[indices[n]] = n;
+                }
+
+                m_positions.swap(positions);
+                m_flags.swap(flags);
+                m_indices.swap(indices);
+                m_twins.swap(twins);
+                m_out.swap(out);
+            }
+
+            /// Write the mesh back, dropping dead and unreferenced vertices
+            /// @param p_mesh               Receives the remeshed vertices and triangles
+            void extract(indexed_mesh& p_mesh)
+            {
+                compact();
+                p_mesh.vertices = m_positions;
+                p_mesh.indices = m_indices;
+            }
+
+        private:
+            static constexpr std::uint8_t boundary = 1;     ///< Vertex on an open fan (kept in place)
+            static constexpr std::uint8_t locked = 2;       ///< Non-manifold vertex (no operation touches it)
+            static constexpr std::uint8_t dead = 4;         ///< Removed vertex
+            static constexpr std::size_t window = 4096;     ///< Candidates validated per round
+            static constexpr std::size_t max_region = 40;   ///< Most vertices one operation may reserve
+
+            static std::uint32_t next(const std::uint32_t p_h)
+            {
+                return p_h - p_h % 3 + (p_h + 1) % 3;
+            }
+
+            static std::uint32_t prev(const std::uint32_t p_h)
+            {
+                return p_h - p_h % 3 + (p_h + 2) % 3;
+            }
+
+            /// Link two half-edges as twins (either may be no_neighbor)
+            void link(const std::uint32_t p_a, const std::uint32_t p_b)
+            {
+                if (p_a != no_neighbor)
+                    m_twins[p_a] = p_b;
+                if (p_b != no_neighbor)
+                    m_twins[p_b] = p_a;
+            }
+
+            /// Grow the reservation table to cover a vertex count
+            void reserve_vertices(const std::size_t p_count)
+            {
+                if (p_count <= m_reserved_size)
+                    return;
+                const std::size_t size = std::max(p_count, m_reserved_size * 2);
+                m_reserved.reset(new std::atomic<std::uint32_t>[size]);
+                for (std::size_t i = 0; i < size; ++i)
+                    m_reserved[i].store(no_neighbor, std::memory_order_relaxed);
+                m_reserved_size = size;
+            }
+
+            /// Collect the outgoing half-edges of a vertex
+            /// @param p_vertex             Vertex
+            /// @param p_fan                Receives one outgoing half-edge per incident triangle
+            /// @param p_open               Set if the fan ends at a boundary
+            /// @return                     False if the walk does not terminate
+            bool fan(const std::uint32_t p_vertex, std::vector<std::uint32_t>& p_fan, bool& p_open) const
+            {
+                p_fan.clear();
+                p_open = false;
+                const std::uint32_t start = m_out[p_vertex];
+                std::uint32_t h = start;
+                for (;;)
+                {
+                    p_fan.push_back(h);
+                    const std::uint32_t t = m_twins[prev(h)];
+                    if (t == start)
+                        return true;
+                    if (t == no_neighbor || p_fan.size() > m_indices.size())
+                        break;
+                    h = t;
+                }
+                if (p_fan.size() > m_indices.size())
+                    return false;
+
+                // Walk the other way from the start
+                p_open = true;
+                for (std::uint32_t t = m_twins[start]; t != no_neighbor; t = m_twins[h])
+                {
+                    h = next(t);
+                    p_fan.push_back(h);
+                    if (p_fan.size() > m_indices.size())
+                        return false;
+                }
+                return true;
+            }
+
+            /// Collect the sorted neighbours of a vertex
+            bool neighbors(const std::uint32_t p_vertex, std::vector<std::uint32_t>& p_neighbors, remesh_scratch& p_scratch) const
+            {
+                bool open = false;
+                if (!fan(p_vertex, p_scratch.fan, open))
+                    return false;
+                p_neighbors.clear();
+                for (const std::uint32_t h : p_scratch.fan)
+                {
+                    p_neighbors.push_back(m_indices[next(h)]);
+                    p_neighbors.push_back(m_indices[prev(h)]);
+                }
+                std::sort(p_neighbors.begin(), p_neighbors.end());
+                p_neighbors.erase(std::unique(p_neighbors.begin(), p_neighbors.end()), p_neighbors.end());
+                return true;
+            }
+
+            /// Count the neighbours of a vertex
+            std::size_t valence(const std::uint32_t p_vertex, remesh_scratch& p_scratch) const
+            {
+                bool open = false;
+                fan(p_vertex, p_scratch.fan, open);
+                return p_scratch.fan.size() + (open ? 1 : 0);
+            }
+
+            /// Find a half-edge joining the endpoints of a candidate
+            std::uint32_t find_edge(const remesh_candidate& p_candidate, remesh_scratch& p_scratch) const
+            {
+                const std::uint32_t a = p_candidate.a;
+                const std::uint32_t b = p_candidate.b;
+                if ((m_flags[a] | m_flags[b]) & dead)
+                    return no_neighbor;
+                const std::uint32_t hint = p_candidate.edge;
+                if (hint < m_indices.size() && m_indices[hint] == a && m_indices[next(hint)] == b)
+                    return hint;
+
+                bool open = false;
+                if (!fan(a, p_scratch.fan, open))
+                    return no_neighbor;
+                for (const std::uint32_t h : p_scratch.fan)
+                {
+                    if (m_indices[next(h)] == b)
+                        return h;
+                    if (m_indices[prev(h)] == b)
+                        return prev(h);
+                }
+                return no_neighbor;
+            }
+
+            /// Check an operation and collect the vertices it reserves
+            /// @return                     Number of reserved vertices (zero if the operation does not apply)
+            std::uint32_t validate(const operation p_operation, const remesh_candidate& p_candidate, remesh_operation& p_op, std::uint32_t* p_region, remesh_scratch& p_scratch) const
+            {
+                const std::uint32_t e = find_edge(p_candidate, p_scratch);
+                if (e == no_neighbor)
+                    return 0;
+                const std::uint32_t a = m_indices[e];
+                const std::uint32_t b = m_indices[next(e)];
+                if ((m_flags[a] | m_flags[b]) & locked)
+                    return 0;
+
+                if (p_operation == operation::split)
+                    return validate_split(e, p_op, p_region);
+                if (p_operation == operation::flip)
+                    return validate_flip(e, p_op, p_region, p_scratch);
+
+                // Remove whichever endpoint allows it
+                const std::uint32_t region = validate_collapse(e, a, p_op, p_region, p_scratch);
+                return region != 0 ? region : validate_collapse(e, b, p_op, p_region, p_scratch);
+            }
+
+            std::uint32_t validate_split(const std::uint32_t p_edge, remesh_operation& p_op, std::uint32_t* p_region) const
+            {
+                const std::uint32_t a = m_indices[p_edge];
+                const std::uint32_t b = m_indices[next(p_edge)];
+                if ((m_positions[b] - m_positions[a]).length2() <= m_high2)
+                    return 0;
+
+                const std::uint32_t twin = m_twins[p_edge];
+                p_op.edge = p_edge;
+                p_op.position = (m_positions[a] + m_positions[b]) * 0.5;
+                p_op.vertices = 1;
+                p_op.triangles = twin != no_neighbor ? 2 : 1;
+                p_region[0] = a;
+                p_region[1] = b;
+                p_region[2] = m_indices[prev(p_edge)];
+                if (twin == no_neighbor)
+                    return 3;
+                p_region[3] = m_indices[prev(twin)];
+                return 4;
+            }
+
+            std::uint32_t validate_flip(const std::uint32_t p_edge, remesh_operation& p_op, std::uint32_t* p_region, remesh_scratch& p_scratch) const
+            {
+                const std::uint32_t twin = m_twins[p_edge];
+                if (twin == no_neighbor)
+                    return 0;
+                const std::uint32_t a = m_indices[p_edge];
+                const std::uint32_t b = m_indices[next(p_edge)];
+                const std::uint32_t c = m_indices[prev(p_edge)];
+                const std::uint32_t d = m_indices[prev(twin)];
+                if (c == d || ((m_flags[c] | m_flags[d]) & locked))
+                    return 0;
+
+                // The new diagonal must not exist yet
+                if (!neighbors(c, p_scratch.neighbors1, p_scratch) || std::binary_search(p_scratch.neighbors1.begin(), p_scratch.neighbors1.end(), d))
+                    return 0;
+
+                // Flip only if it moves valences closer to 6 (4 on the boundary)
+                const std::uint32_t quad[4] = { a, b, c, d };
+                const int change[4] = { -1, -1, 1, 1 };
+                int before = 0;
+                int after = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    const int target = (m_flags[quad[i]] & boundary) ? 4 : 6;
+                    const int current = static_cast<int>(valence(quad[i], p_scratch));
+                    if (change[i] < 0 && current <= target / 2)
+                        return 0;
+                    before += std::abs(current - target);
+                    after += std::abs(current + change[i] - target);
+                }
+                if (after >= before)
+                    return 0;
+
+                // Both new triangles must face the same way as the quad
+                const vector3& pa = m_positions[a];
+                const vector3& pb = m_positions[b];
+                const vector3& pc = m_positions[c];
+                const vector3& pd = m_positions[d];
+                const vector3 normal = (pb - pa).cross(pc - pa) + (pa - pb).cross(pd - pb);
+                if ((pa - pc).cross(pd - pc).dot(normal) <= 0.0 || (pb - pd).cross(pc - pd).dot(normal) <= 0.0)
+                    return 0;
+
+                p_op.edge = p_edge;
+                std::copy(quad, quad + 4, p_region);
+                return 4;
+            }
+
+            std::uint32_t validate_collapse(const std::uint32_t p_edge, const std::uint32_t p_removed, remesh_operation& p_op, std::uint32_t* p_region, remesh_scratch& p_scratch) const
+            {
+                // Interior vertices only, so both sides of the edge exist
+                if (m_flags[p_removed] & boundary)
+                    return 0;
+                const std::uint32_t h = m_indices[p_edge] == p_removed ? p_edge : m_twins[p_edge];
+                if (h == no_neighbor || m_twins[h] == no_neighbor)
+                    return 0;
+                const std::uint32_t twin = m_twins[h];
+                const std::uint32_t r = p_removed;
+                const std::uint32_t k = m_indices[next(h)];
+                const std::uint32_t c = m_indices[prev(h)];
+                const std::uint32_t d = m_indices[prev(twin)];
+                if (c == d || (m_positions[k] - m_positions[r]).length2() >= m_low2)
+                    return 0;
+
+                // Link condition: the endpoints share exactly the two opposite vertices
+                std::vector<std::uint32_t>& ring_r = p_scratch.neighbors1;
+                std::vector<std::uint32_t>& ring_k = p_scratch.neighbors2;
+                if (!neighbors(r, ring_r, p_scratch) || !neighbors(k, ring_k, p_scratch))
+                    return 0;
+                if (ring_r.size() + ring_k.size() > max_region || (ring_r.size() == 3 && ring_k.size() == 3))
+                    return 0;
+                p_scratch.common.clear();
+                std::set_intersection(ring_r.begin(), ring_r.end(), ring_k.begin(), ring_k.end(), std::back_inserter(p_scratch.common));
+                if (p_scratch.common.size() != 2)
+                    return 0;
+                for (const std::uint32_t v : { c, d })
+                {
+                    if (valence(v, p_scratch) <= ((m_flags[v] & boundary) ? 2u : 3u))
+                        return 0;
+                }
+
+                // Merged vertex stays on the boundary if the kept vertex is there
+                const vector3 position = (m_flags[k] & boundary) ? m_positions[k] : (m_positions[r] + m_positions[k]) * 0.5;
+                for (const std::vector<std::uint32_t>* ring : { &ring_r, &ring_k })
+                {
+                    for (const std::uint32_t v : *ring)
+                    {
+                        if (v != r && v != k && (m_positions[v] - position).length2() >= m_high2)
+                            return 0;
+                    }
+                }
+
+                // No remaining triangle may flip over
+                bool open = false;
+                for (const std::uint32_t v : { r, k })
+                {
+                    fan(v, p_scratch.fan, open);
+                    for (const std::uint32_t f : p_scratch.fan)
+                    {
+                        if (f / 3 == h / 3 || f / 3 == twin / 3)
+                            continue;
+                        const vector3& p1 = m_positions[m_indices[next(f)]];
+                        const vector3& p2 = m_positions[m_indices[prev(f)]];
+                        const vector3& p0 = m_positions[v];
+                        if ((p1 - position).cross(p2 - position).dot((p1 - p0).cross(p2 - p0)) <= 0.0)
+                            return 0;
+                    }
+                }
+
+                p_op.edge = h;
+                p_op.position = position;
+                const std::uint32_t* end = std::set_union(ring_r.begin(), ring_r.end(), ring_k.begin(), ring_k.end(), p_region);
+                return static_cast<std::uint32_t>(end - p_region);
+            }
+
+            /// Split an edge at its midpoint, splitting both adjacent triangles
+            void execute_split(const remesh_operation& p_op)
+            {
+                const std::uint32_t h = p_op.edge;
+                const std::uint32_t g = m_twins[h];
+                const std::uint32_t b = m_indices[next(h)];
+                const std::uint32_t c = m_indices[prev(h)];
+                const std::uint32_t m = p_op.first_vertex;
+                m_positions[m] = p_op.position;
+                m_flags[m] = g == no_neighbor ? boundary : 0;
+
+                // (a, b, c) becomes (a, m, c) and (m, b, c)
+                const std::uint32_t e = p_op.first_triangle * 3;
+                const std::uint32_t outer_bc = m_twins[next(h)];
+                m_indices[next(h)] = m;
+                m_indices[e] = m;
+                m_indices[e + 1] = b;
+                m_indices[e + 2] = c;
+                link(e + 1, outer_bc);
+                link(next(h), e + 2);
+                m_out[m] = e;
+                m_out[b] = e + 1;
+                if (g == no_neighbor)
+                    return;
+
+                // (b, a, d) becomes (m, a, d) and (b, m, d)
+                const std::uint32_t d = m_indices[prev(g)];
+                const std::uint32_t f = e + 3;
+                const std::uint32_t outer_db = m_twins[prev(g)];
+                m_indices[g] = m;
+                m_indices[f] = b;
+                m_indices[f + 1] = m;
+                m_indices[f + 2] = d;
+                link(f + 2, outer_db);
+                link(prev(g), f + 1);
+                link(e, f);
+            }
+
+            /// Merge the first vertex of an edge into the second
+            void execute_collapse(const remesh_operation& p_op, remesh_scratch& p_scratch)
+            {
+                const std::uint32_t h = p_op.edge;
+                const std::uint32_t g = m_twins[h];
+                const std::uint32_t r = m_indices[h];
+                const std::uint32_t k = m_indices[next(h)];
+                const std::uint32_t c = m_indices[prev(h)];
+                const std::uint32_t d = m_indices[prev(g)];
+                bool open = false;
+                fan(r, p_scratch.fan, open);
+
+                // Close the gaps left by the two removed triangles
+                const std::uint32_t outer_kc = m_twins[next(h)];
+                const std::uint32_t outer_cr = m_twins[prev(h)];
+                const std::uint32_t outer_rd = m_twins[next(g)];
+                const std::uint32_t outer_dk = m_twins[prev(g)];
+                link(outer_kc, outer_cr);
+                link(outer_rd, outer_dk);
+
+                std::uint32_t survivor = no_neighbor;
+                for (const std::uint32_t f : p_scratch.fan)
+                {
+                    if (f / 3 == h / 3 || f / 3 == g / 3)
+                        continue;
+                    m_indices[f] = k;
+                    survivor = f;
+                }
+                for (const std::uint32_t t : { h / 3, g / 3 })
+                {
+                    for (std::uint32_t i = t * 3; i < t * 3 + 3; ++i)
+                    {
+                        m_indices[i] = no_neighbor;
+                        m_twins[i] = no_neighbor;
+                    }
+                }
+
+                m_positions[k] = p_op.position;
+                m_out[k] = survivor;
+                m_out[c] = outer_kc != no_neighbor ? outer_kc : next(outer_cr);
+                m_out[d] = outer_rd != no_neighbor ? outer_rd : next(outer_dk);
+                m_out[r] = no_neighbor;
+                m_flags[r] = dead;
+            }
+
+            /// Replace the diagonal of the quad around an edge with the other diagonal
+            void execute_flip(const remesh_operation& p_op)
+            {
+                const std::uint32_t h = p_op.edge;
+                const std::uint32_t g = m_twins[h];
+                const std::uint32_t a = m_indices[h];
+                const std::uint32_t b = m_indices[next(h)];
+                const std::uint32_t c = m_indices[prev(h)];
+                const std::uint32_t d = m_indices[prev(g)];
+                const std::uint32_t outer_bc = m_twins[next(h)];
+                const std::uint32_t outer_ca = m_twins[prev(h)];
+                const std::uint32_t outer_ad = m_twins[next(g)];
+                const std::uint32_t outer_db = m_twins[prev(g)];
+
+                // (a, b, c) and (b, a, d) become (c, a, d) and (d, b, c)
+                m_indices[h] = c;
+                m_indices[next(h)] = a;
+                m_indices[prev(h)] = d;
+                m_indices[g] = d;
+                m_indices[next(g)] = b;
+                m_indices[prev(g)] = c;
+                link(h, outer_ca);
+                link(next(h), outer_ad);
+                link(prev(h), prev(g));
+                link(g, outer_db);
+                link(next(g), outer_bc);
+                m_out[a] = next(h);
+                m_out[b] = next(g);
+                m_out[c] = h;
+                m_out[d] = g;
+            }
+
+            std::vector<vector3> m_positions;               ///< Vertex positions
+            std::vector<std::uint8_t> m_flags;              ///< Vertex flags
+            std::vector<std::uint32_t> m_out;               ///< One outgoing half-edge per vertex
+            std::vector<std::uint32_t> m_indices;           ///< Triangle vertex indices (no_neighbor for removed triangles)
+            std::vector<std::uint32_t> m_twins;             ///< Opposite half-edge (no_neighbor on boundaries)
+            std::unique_ptr<std::atomic<std::uint32_t>[]> m_reserved;   ///< Reserving candidate of each vertex
+            std::size_t m_reserved_size = 0;                ///< Entries in m_reserved
+            std::vector<std::uint32_t> m_touched;           ///< Last round that changed each vertex
+            std::uint32_t m_round = 0;                      ///< Current round
+            double m_high2 = 0.0;                           ///< Squared length above which edges split
+            double m_low2 = 0.0;                            ///< Squared length below which edges collapse
+        };
+    }
+
+    /// Remesh a surface towards uniform edge lengths and regular valences
+    ///
+    /// Implements Botsch and Kobbelt, "A Remeshing Approach to Multiresolution
+    /// Modeling": each iteration splits edges longer than 4/3 of the target,
+    /// collapses edges shorter than 4/5 of it, flips edges that bring vertex
+    /// valences closer to 6, and relaxes vertices tangentially before
+    /// projecting them back to the input surface through a BVH.
+    ///
+    /// Edge operations run in parallel batches; operations whose
+    /// neighbourhoods overlap are serialized by deterministic vertex
+    /// reservations, so the output does not depend on the thread count.
+    /// Boundary vertices never move and are never removed, though boundary
+    /// edges are split. Non-manifold vertices and their edges are left alone.
+    /// Sharp creases are not detected and get rounded by the relaxation.
+    /// Degenerate triangles and unreferenced vertices are dropped.
+    /// @param p_mesh               Mesh to remesh in place
+    /// @param p_options            Remeshing options
+    /// @return                     Operation counts
+    inline remesh_result remesh_isotropic(indexed_mesh& p_mesh, const remesh_options& p_options = remesh_options{})
+    {
+        MESH_PROFILE_SCOPE("remesh.isotropic", p_mesh.triangle_count());
+        remesh_result result;
+        for (const std::uint32_t i : p_mesh.indices)
+        {
+            if (i >= p_mesh.vertex_count())
+                return result;
+        }
+        result.ok = true;
+
+        detail::remesher remesher(p_mesh);
+        const double target = p_options.target_edge_length > 0.0 ? p_options.target_edge_length : remesher.mean_edge_length();
+        if (target <= 0.0)
+            return result;
+        remesher.set_target(target);
+
+        mesh_bvh surface;
+        if (p_options.project)
+            surface.build(p_mesh);
+
+        using operation = detail::remesher::operation;
+        for (int iteration = 0; iteration < p_options.iterations; ++iteration)
+        {
+            // Splitting may leave long edges across the split triangles, so repeat
+            for (int pass = 0; pass < 32; ++pass)
+            {
+                MESH_PROFILE_SCOPE("remesh.split", 0);
+                const std::vector<detail::remesh_candidate> candidates = remesher.scan(operation::split);
+                if (candidates.empty())
+                    break;
+                result.splits += remesher.process(operation::split, candidates);
+            }
+            {
+                MESH_PROFILE_SCOPE("remesh.collapse", 0);
+                result.collapses += remesher.process(operation::collapse, remesher.scan(operation::collapse));
+            }
+            {
+                MESH_PROFILE_SCOPE("remesh.flip", 0);
+                result.flips += remesher.process(operation::flip, remesher.scan(operation::flip));
+            }
+            {
+                MESH_PROFILE_SCOPE("remesh.smooth", 0);
+                remesher.compact();
+                remesher.smooth(p_options.smoothing, p_options.project ? &surface : nullptr);
+            }
+        }
+        remesher.extract(p_mesh);
+        return result;
+    }
+}
@@ -0,0 +1,730 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mesh_bvh.hpp"
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+
+namespace mesh
+{
+    /// Method used to decide which distance samples are inside the mesh
+    enum class sdf_sign_method
+    {
+        ray_parity,         ///< Count surface crossings along +X (fast, needs a closed mesh)
+        winding_number      ///< Generalized winding number (robust to holes, slower)
+    };
+
+    /// Signed distance field build options
+    struct sdf_options
+    {
+        /// Spacing between samples
+        double cell_size = 1.0;
+
+        /// Number of samples of padding added around the mesh bounds
+        std::size_t padding = 2;
+
+        /// Half-width in cells of the narrow band where distances are computed exactly
+        double band = 3.0;
+
+        /// Method used to decide the sign of samples
+        sdf_sign_method sign = sdf_sign_method::ray_parity;
+
+        /// Number of sweep rounds propagating closest triangles outside the band (dense grids only)
+        int sweeps = 2;
+    };
+
+    /// Dense signed distance grid (negative inside)
+    struct sdf_grid
+    {
+        vector3 origin;                 ///< Position of sample (0, 0, 0)
+        double cell_size = 1.0;         ///< Spacing between samples
+        std::size_t size_x = 0;         ///< Number of samples along X
+        std::size_t size_y = 0;         ///< Number of samples along Y
+        std::size_t size_z = 0;         ///< Number of samples along Z
+        std::vector<double> values;     ///< Samples ordered X fastest, then Y, then Z
+
+        /// Default constructor
+        sdf_grid() = default;
+
+        /// Construct a grid filled with a value
+        /// @param p_origin             Position of sample (0, 0, 0)
+        /// @param p_cell_size          Spacing between samples
+        /// @param p_size_x             Number of samples along X
+        /// @param p_size_y             Number of samples along Y
+        /// @param p_size_z             Number of samples along Z
+        /// @param p_value              Initial sample value
+        explicit sdf_grid(const vector3& p_origin, const double p_cell_size, const std::size_t p_size_x, const std::size_t p_size_y, const std::size_t p_size_z, const double p_value = 0.0)
+            : origin(p_origin), cell_size(p_cell_size), size_x(p_size_x), size_y(p_size_y), size_z(p_size_z), values(p_size_x * p_size_y * p_size_z, p_value)
+        {
+        }
+
+        /// Get the linear index of a sample
+        std::size_t index(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k) const
+        {
+            return (p_k * size_y + p_j) * size_x + p_i;
+        }
+
+        /// Get a sample value
+        double at(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k) const
+        {
+            return values[index(p_i, p_j, p_k)];
+        }
+
+        /// Get a sample value for writing
+        double& at(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k)
+        {
+            return values[index(p_i, p_j, p_k)];
+        }
+
+        /// Get the position of a sample
+        vector3 position(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k) const
+        {
+            return origin + vector3{ static_cast<double>(p_i), static_cast<double>(p_j), static_cast<double>(p_k) } * cell_size;
+        }
+
+        /// Sample the field with trilinear interpolation (clamped to the grid)
+        /// @param p_point              Point to sample
+        /// @return                     Interpolated distance
+        double sample(const vector3& p_point) const;
+    };
+
+    /// Sparse-block signed distance grid (negative inside)
+    ///
+    /// Only blocks touching the narrow band store samples. Every other block is a
+    /// tile holding plus or minus the background distance.
+    struct sparse_sdf_grid
+    {
+        /// Samples per block edge
+        static constexpr std::size_t block_size = 8;
+
+        /// Samples per block
+        static constexpr std::size_t block_samples = block_size * block_size * block_size;
+
+        /// Block table entry for a tile outside the surface
+        static constexpr std::int32_t outside_tile = -1;
+
+        /// Block table entry for a tile inside the surface
+        static constexpr std::int32_t inside_tile = -2;
+
+        vector3 origin;                     ///< Position of sample (0, 0, 0)
+        double cell_size = 1.0;             ///< Spacing between samples
+        std::size_t size_x = 0;             ///< Number of samples along X
+        std::size_t size_y = 0;             ///< Number of samples along Y
+        std::size_t size_z = 0;             ///< Number of samples along Z
+        std::size_t blocks_x = 0;           ///< Number of blocks along X
+        std::size_t blocks_y = 0;           ///< Number of blocks along Y
+        std::size_t blocks_z = 0;           ///< Number of blocks along Z
+        double background = 0.0;            ///< Magnitude of tile values
+        std::vector<std::int32_t> block_table;  ///< Allocated block index or tile code per block
+        std::vector<double> block_values;   ///< Samples of allocated blocks (block_samples each)
+
+        /// Get the number of allocated blocks
+        std::size_t block_count() const
+        {
+            return block_values.size() / block_samples;
+        }
+
+        /// Get the block table index of a block
+        std::size_t block_index(const std::size_t p_bx, const std::size_t p_by, const std::size_t p_bz) const
+        {
+            return (p_bz * blocks_y + p_by) * blocks_x + p_bx;
+        }
+
+        /// Get a sample value
+        double at(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k) const
+        {
+            const std::int32_t block = block_table[block_index(p_i / block_size, p_j / block_size, p_k / block_size)];
+            if (block == outside_tile)
+                return background;
+            if (block == inside_tile)
+                return -background;
+
+            const std::size_t local = ((p_k % block_size) * block_size + (p_j % block_size)) * block_size + (p_i % block_size);
+            return block_values[static_cast<std::size_t>(block) * block_samples + local];
+        }
+
+        /// Get the position of a sample
+        vector3 position(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k) const
+        {
+            return origin + vector3{ static_cast<double>(p_i), static_cast<double>(p_j), static_cast<double>(p_k) } * cell_size;
+        }
+
+        /// Sample the field with trilinear interpolation (clamped to the grid)
+        /// @param p_point              Point to sample
+        /// @return                     Interpolated distance
+        double sample(const vector3& p_point) const;
+    };
+
+    namespace detail
+    {
+        /// Trilinear interpolation over any grid exposing origin, cell_size, sizes and at()
+        template <typename TGrid>
+        double sample_trilinear(const TGrid& p_grid, const vector3& p_point)
+        {
+            if (p_grid.size_x == 0 || p_grid.size_y == 0 || p_grid.size_z == 0)
+                return std::numeric_limits<double>::infinity();
+
+            // Convert to clamped sample coordinates
+            const vector3 local = (p_point - p_grid.origin) / p_grid.cell_size;
+            const double fx = std::min(std::max(local.x, 0.0), static_cast<double>(p_grid.size_x - 1));
+            const double fy = std::min(std::max(local.y, 0.0), static_cast<double>(p_grid.size_y - 1));
+            const double fz = std::min(std::max(local.z, 0.0), static_cast<double>(p_grid.size_z - 1));
+            const std::size_t i0 = static_cast<std::size_t>(fx);
+            const std::size_t j0 = static_cast<std::size_t>(fy);
+            const std::size_t k0 = static_cast<std::size_t>(fz);
+            const std::size_t i1 = std::min(i0 + 1, p_grid.size_x - 1);
+            const std::size_t j1 = std::min(j0 + 1, p_grid.size_y - 1);
+            const std::size_t k1 = std::min(k0 + 1, p_grid.size_z - 1);
+            const double tx = fx - static_cast<double>(i0);
+            const double ty = fy - static_cast<double>(j0);
+            const double tz = fz - static_cast<double>(k0);
+
+            // Interpolate along X, then Y, then Z
+            const double c00 = lerp(p_grid.at(i0, j0, k0), p_grid.at(i1, j0, k0), tx);
+            const double c10 = lerp(p_grid.at(i0, j1, k0), p_grid.at(i1, j1, k0), tx);
+            const double c01 = lerp(p_grid.at(i0, j0, k1), p_grid.at(i1, j0, k1), tx);
+            const double c11 = lerp(p_grid.at(i0, j1, k1), p_grid.at(i1, j1, k1), tx);
+            return lerp(lerp(c00, c10, ty), lerp(c01, c11, ty), tz);
+        }
+
+        /// Sample layout shared by the dense and sparse builders
+        struct sdf_layout
+        {
+            vector3 origin;
+            double cell_size = 1.0;
+            std::size_t size_x = 0;
+            std::size_t size_y = 0;
+            std::size_t size_z = 0;
+
+            /// Calculate the layout covering a mesh
+            static sdf_layout create(const indexed_mesh& p_mesh, const sdf_options& p_options)
+            {
+                sdf_layout layout;
+                layout.cell_size = p_options.cell_size;
+                if (p_mesh.triangle_count() == 0)
+                    return layout;
+
+                const aabb3 bounds = p_mesh.bounds();
+                const double pad = static_cast<double>(p_options.padding) * p_options.cell_size;
+                const vector3 size = bounds.size();
+                layout.origin = bounds.minimum - vector3{ pad, pad, pad };
+                layout.size_x = static_cast<std::size_t>(std::ceil(size.x / p_options.cell_size)) + 1 + p_options.padding * 2;
+                layout.size_y = static_cast<std::size_t>(std::ceil(size.y / p_options.cell_size)) + 1 + p_options.padding * 2;
+                layout.size_z = static_cast<std::size_t>(std::ceil(size.z / p_options.cell_size)) + 1 + p_options.padding * 2;
+                return layout;
+            }
+
+            /// Calculate the inclusive sample range along one axis covered by an interval
+            /// @return                     False if the interval covers no samples
+            static bool range(const double p_min, const double p_max, const double p_origin, const double p_cell_size, const std::size_t p_size, std::size_t& p_lo, std::size_t& p_hi)
+            {
+                const double lo = std::max(std::ceil((p_min - p_origin) / p_cell_size), 0.0);
+                const double hi = std::min(std::floor((p_max - p_origin) / p_cell_size), static_cast<double>(p_size) - 1.0);
+                if (hi < lo)
+                    return false;
+
+                p_lo = static_cast<std::size_t>(lo);
+                p_hi = static_cast<std::size_t>(hi);
+                return true;
+            }
+        };
+
+        /// Orientation with simulation-of-simplicity tie breaking (Bridson)
+        inline int sos_orientation(const double p_x1, const double p_y1, const double p_x2, const double p_y2, double& p_twice_signed_area)
+        {
+            p_twice_signed_area = p_y1 * p_x2 - p_x1 * p_y2;
+            if (p_twice_signed_area > 0.0)
+                return 1;
+            if (p_twice_signed_area < 0.0)
+                return -1;
+            if (p_y2 > p_y1)
+                return 1;
+            if (p_y2 < p_y1)
+                return -1;
+            if (p_x1 > p_x2)
+                return 1;
+            if (p_x1 < p_x2)
+                return -1;
+            return 0;
+        }
+
+        /// Calculate where a +X ray through (y, z) crosses a triangle
+        ///
+        /// The tie breaking guarantees a ray through a shared edge or vertex crosses
+        /// a closed surface exactly once.
+        /// @return                     True if the ray line crosses the triangle
+        inline bool row_crossing(const triangle3& p_triangle, const double p_y, const double p_z, double& p_x)
+        {
+            const double y1 = p_triangle.point1.y - p_y, z1 = p_triangle.point1.z - p_z;
+            const double y2 = p_triangle.point2.y - p_y, z2 = p_triangle.point2.z - p_z;
+            const double y3 = p_triangle.point3.y - p_y, z3 = p_triangle.point3.z - p_z;
+
+            double a = 0.0, b = 0.0, c = 0.0;
+            const int sign_a = sos_orientation(y2, z2, y3, z3, a);
+            if (sign_a == 0)
+                return false;
+            if (sos_orientation(y3, z3, y1, z1, b) != sign_a)
+                return false;
+            if (sos_orientation(y1, z1, y2, z2, c) != sign_a)
+                return false;
+
+            const double sum = a + b + c;
+            p_x = (a * p_triangle.point1.x + b * p_triangle.point2.x + c * p_triangle.point3.x) / sum;
+            return true;
+        }
+
+        /// Triangles binned by YZ sample blocks for ray parity queries
+        struct sdf_row_bins
+        {
+            std::size_t bins_y = 0;
+            std::size_t bins_z = 0;
+            std::vector<std::size_t> offsets;
+            std::vector<std::uint32_t> triangles;
+
+            /// Bin triangles by the YZ sample blocks their projection covers
+            sdf_row_bins(const indexed_mesh& p_mesh, const sdf_layout& p_layout, const std::size_t p_bin_size)
+                : bins_y((p_layout.size_y + p_bin_size - 1) / p_bin_size), bins_z((p_layout.size_z + p_bin_size - 1) / p_bin_size)
+            {
+                offsets.assign(bins_y * bins_z + 1, 0);
+
+                // Count then fill (counting sort by bin)
+                for (int pass = 0; pass < 2; ++pass)
+                {
+                    for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+                    {
+                        aabb3 box = aabb3::empty();
+                        const triangle3 tri = p_mesh.triangle(t);
+                        box.expand(tri.point1);
+                        box.expand(tri.point2);
+                        box.expand(tri.point3);
+
+                        std::size_t j0 = 0, j1 = 0, k0 = 0, k1 = 0;
+                        if (!sdf_layout::range(box.minimum.y, box.maximum.y, p_layout.origin.y, p_layout.cell_size, p_layout.size_y, j0, j1) ||
+                            !sdf_layout::range(box.minimum.z, box.maximum.z, p_layout.origin.z, p_layout.cell_size, p_layout.size_z, k0, k1))
+                            continue;
+
+                        for (std::size_t bz = k0 / p_bin_size; bz <= k1 / p_bin_size; ++bz)
+                        {
+                            for (std::size_t by = j0 / p_bin_size; by <= j1 / p_bin_size; ++by)
+                            {
+                                const std::size_t bin = bz * bins_y + by;
+                                if (pass == 0)
+                                    ++offsets[bin + 1];
+                                else
+                                    triangles[offsets[bin]++] = static_cast<std::uint32_t>(t);
+                            }
+                        }
+                    }
+
+                    if (pass == 0)
+                    {
+                        for (std::size_t i = 1; i < offsets.size(); ++i)
+                            offsets[i] += offsets[i - 1];
+                        triangles.resize(offsets.back());
+                    }
+                    else
+                    {
+                        // Filling advanced each offset to the start of the next bin
+                        for (std::size_t i = offsets.size() - 1; i > 0; --i)
+                            offsets[i] = offsets[i - 1];
+                        offsets[0] = 0;
+                    }
+                }
+            }
+
+            /// Collect the sorted X crossings of the sample row (j, k)
+            void crossings(const indexed_mesh& p_mesh, const sdf_layout& p_layout, const std::size_t p_bin_size, const std::size_t p_j, const std::size_t p_k, std::vector<double>& p_xs) const
+            {
+                p_xs.clear();
+                const std::size_t bin = (p_k / p_bin_size) * bins_y + p_j / p_bin_size;
+                const double y = p_layout.origin.y + static_cast<double>(p_j) * p_layout.cell_size;
+                const double z = p_layout.origin.z + static_cast<double>(p_k) * p_layout.cell_size;
+                for (std::size_t n = offsets[bin]; n < offsets[bin + 1]; ++n)
+                {
+                    double x = 0.0;
+                    if (row_crossing(p_mesh.triangle(triangles[n]), y, z, x))
+                        p_xs.push_back(x);
+                }
+                std::sort(p_xs.begin(), p_xs.end());
+            }
+        };
+
+        /// Get the band-grown bounding box of a triangle
+        inline aabb3 triangle_bounds(const triangle3& p_triangle, const double p_margin)
+        {
+            aabb3 box = aabb3::empty();
+            box.expand(p_triangle.point1);
+            box.expand(p_triangle.point2);
+            box.expand(p_triangle.point3);
+            return box.grown(p_margin);
+        }
+    }
+
+    inline double sdf_grid::sample(const vector3& p_point) const
+    {
+        return detail::sample_trilinear(*this, p_point);
+    }
+
+    inline double sparse_sdf_grid::sample(const vector3& p_point) const
+    {
+        return detail::sample_trilinear(*this, p_point);
+    }
+
+    /// Build a dense signed distance field from a triangle mesh
+    ///
+    /// Distances are exact within the narrow band. Outside it, the closest
+    /// triangle is propagated by axis-split fast sweeping and the distance to it
+    /// is evaluated exactly. Z slabs, grid rows and sign queries run in parallel.
+    /// @param p_mesh               Closed triangle mesh with outward-facing winding
+    /// @param p_options            Build options
+    /// @return                     Dense signed distance grid
+    inline sdf_grid build_sdf(const indexed_mesh& p_mesh, const sdf_options& p_options = sdf_options{})
+    {
+        MESH_PROFILE_SCOPE("sdf.build", p_mesh.triangle_count());
+        const detail::sdf_layout layout = detail::sdf_layout::create(p_mesh, p_options);
+        sdf_grid grid{ layout.origin, layout.cell_size, layout.size_x, layout.size_y, layout.size_z, std::numeric_limits<double>::infinity() };
+        if (grid.values.empty())
+            return grid;
+
+        const std::size_t nx = layout.size_x, ny = layout.size_y, nz = layout.size_z;
+        const std::size_t slab = sparse_sdf_grid::block_size;
+        const std::size_t slabs = (nz + slab - 1) / slab;
+        const double margin = p_options.band * p_options.cell_size;
+        std::vector<std::int32_t> closest(grid.values.size(), -1);
+
+        // Bin triangles by the Z slabs their band covers
+        std::vector<std::vector<std::uint32_t>> slab_triangles(slabs);
+        for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+        {
+            const aabb3 box = detail::triangle_bounds(p_mesh.triangle(t), margin);
+            std::size_t k0 = 0, k1 = 0;
+            if (!detail::sdf_layout::range(box.minimum.z, box.maximum.z, layout.origin.z, layout.cell_size, nz, k0, k1))
+                continue;
+            for (std::size_t s = k0 / slab; s <= k1 / slab; ++s)
+                slab_triangles[s].push_back(static_cast<std::uint32_t>(t));
+        }
+
+        // Exact squared distances within the band, one slab per task
+        parallel_for(slabs, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            for (std::size_t s = p_begin; s < p_end; ++s)
+            {
+                const std::size_t slab_lo = s * slab;
+                const std::size_t slab_hi = std::min(slab_lo + slab, nz) - 1;
+                for (const std::uint32_t t : slab_triangles[s])
+                {
+                    const triangle3 tri = p_mesh.triangle(t);
+                    const aabb3 box = detail::triangle_bounds(tri, margin);
+                    std::size_t i0 = 0, i1 = 0, j0 = 0, j1 = 0, k0 = 0, k1 = 0;
+                    if (!detail::sdf_layout::range(box.minimum.x, box.maximum.x, layout.origin.x, layout.cell_size, nx, i0, i1) ||
+                        !detail::sdf_layout::range(box.minimum.y, box.maximum.y, layout.origin.y, layout.cell_size, ny, j0, j1) ||
+                        !detail::sdf_layout::range(box.minimum.z, box.maximum.z, layout.origin.z, layout.cell_size, nz, k0, k1))
+                        continue;
+
+                    k0 = std::max(k0, slab_lo);
+                    k1 = std::min(k1, slab_hi);
+                    for (std::size_t k = k0; k <= k1; ++k)
+                    {
+                        for (std::size_t j = j0; j <= j1; ++j)
+                        {
+                            for (std::size_t i = i0; i <= i1; ++i)
+                            {
+                                const std::size_t idx = grid.index(i, j, k);
+                                const double d2 = tri.distance2_to(grid.position(i, j, k));
+                                if (d2 < grid.values[idx])
+                                {
+                                    grid.values[idx] = d2;
+                                    closest[idx] = static_cast<std::int32_t>(t);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        });
+
+        // Propagate closest triangles along one axis in both directions
+        auto sweep_line = [&](const std::size_t p_start, const std::size_t p_stride, const std::size_t p_count)
+        {
+            for (int dir = 0; dir < 2; ++dir)
+            {
+                for (std::size_t n = 1; n < p_count; ++n)
+                {
+                    const std::size_t cur = dir == 0 ? p_start + n * p_stride : p_start + (p_count - 1 - n) * p_stride;
+                    const std::size_t prev = dir == 0 ? cur - p_stride : cur + p_stride;
+                    const std::int32_t candidate = closest[prev];
+                    if (candidate < 0 || candidate == closest[cur])
+                        continue;
+
+                    const std::size_t i = cur % nx;
+                    const std::size_t j = (cur / nx) % ny;
+                    const std::size_t k = cur / (nx * ny);
+                    const double d2 = p_mesh.triangle(static_cast<std::size_t>(candidate)).distance2_to(grid.position(i, j, k));
+                    if (d2 < grid.values[cur])
+                    {
+                        grid.values[cur] = d2;
+                        closest[cur] = candidate;
+                    }
+                }
+            }
+        };
+
+        // Axis-split fast sweeping: every line along an axis is independent
+        for (int round = 0; round < p_options.sweeps; ++round)
+        {
+            parallel_for(ny * nz, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t r = p_begin; r < p_end; ++r)
+                    sweep_line(r * nx, 1, nx);
+            }, 64);
+            parallel_for(nx * nz, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t r = p_begin; r < p_end; ++r)
+                    sweep_line((r / nx) * nx * ny + r % nx, nx, ny);
+            }, 64);
+            parallel_for(nx * ny, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t r = p_begin; r < p_end; ++r)
+                    sweep_line(r, nx * ny, nz);
+            }, 64);
+        }
+
+        // Convert squared distances and apply the sign
+        if (p_options.sign == sdf_sign_method::ray_parity)
+        {
+            const detail::sdf_row_bins bins{ p_mesh, layout, slab };
+            parallel_for(ny * nz, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                std::vector<double> xs;
+                for (std::size_t r = p_begin; r < p_end; ++r)
+                {
+                    const std::size_t j = r % ny;
+                    const std::size_t k = r / ny;
+                    bins.crossings(p_mesh, layout, slab, j, k, xs);
+
+                    std::size_t crossed = 0;
+                    for (std::size_t i = 0; i < nx; ++i)
+                    {
+                        const double x = layout.origin.x + static_cast<double>(i) * layout.cell_size;
+                        while (crossed < xs.size() && xs[crossed] < x)
+                            ++crossed;
+
+                        double& value = grid.at(i, j, k);
+                        value = std::sqrt(value);
+                        if (crossed % 2 == 1)
+                            value = -value;
+                    }
+                }
+            }, 16);
+        }
+        else
+        {
+            const mesh_bvh bvh(p_mesh);
+            parallel_for(grid.values.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t idx = p_begin; idx < p_end; ++idx)
+                {
+                    const vector3 p = grid.position(idx % nx, (idx / nx) % ny, idx / (nx * ny));
+                    const double d = std::sqrt(grid.values[idx]);
+                    grid.values[idx] = bvh.contains(p) ? -d : d;
+                }
+            }, 256);
+        }
+
+        return grid;
+    }
+
+    /// Build a sparse-block signed distance field from a triangle mesh
+    ///
+    /// Blocks within the narrow band store exact distances clamped to the band.
+    /// Every other block becomes a tile whose sign is taken at its first sample.
+    /// Blocks are computed in parallel.
+    /// @param p_mesh               Closed triangle mesh with outward-facing winding
+    /// @param p_options            Build options
+    /// @return                     Sparse signed distance grid
+    inline sparse_sdf_grid build_sparse_sdf(const indexed_mesh& p_mesh, const sdf_options& p_options = sdf_options{})
+    {
+        MESH_PROFILE_SCOPE("sdf.build_sparse", p_mesh.triangle_count());
+        using grid_t = sparse_sdf_grid;
+        const std::size_t bs = grid_t::block_size;
+        const detail::sdf_layout layout = detail::sdf_layout::create(p_mesh, p_options);
+
+        grid_t grid;
+        grid.origin = layout.origin;
+        grid.cell_size = layout.cell_size;
+        grid.size_x = layout.size_x;
+        grid.size_y = layout.size_y;
+        grid.size_z = layout.size_z;
+        grid.blocks_x = (layout.size_x + bs - 1) / bs;
+        grid.blocks_y = (layout.size_y + bs - 1) / bs;
+        grid.blocks_z = (layout.size_z + bs - 1) / bs;
+        grid.background = p_options.band * p_options.cell_size;
+        grid.block_table.assign(grid.blocks_x * grid.blocks_y * grid.blocks_z, grid_t::outside_tile);
+        if (grid.block_table.empty())
+            return grid;
+
+        // Hierarchy for winding number signs
+        mesh_bvh bvh;
+        if (p_options.sign == sdf_sign_method::winding_number)
+            bvh.build(p_mesh);
+
+        // Count the triangles whose band touches each block, allocating touched blocks
+        const double margin = p_options.band * p_options.cell_size;
+        std::vector<std::size_t> offsets(grid.block_table.size() + 1, 0);
+        std::vector<std::uint32_t> block_triangles;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+            {
+                const aabb3 box = detail::triangle_bounds(p_mesh.triangle(t), margin);
+                std::size_t i0 = 0, i1 = 0, j0 = 0, j1 = 0, k0 = 0, k1 = 0;
+                if (!detail::sdf_layout::range(box.minimum.x, box.maximum.x, layout.origin.x, layout.cell_size, layout.size_x, i0, i1) ||
+                    !detail::sdf_layout::range(box.minimum.y, box.maximum.y, layout.origin.y, layout.cell_size, layout.size_y, j0, j1) ||
+                    !detail::sdf_layout::range(box.minimum.z, box.maximum.z, layout.origin.z, layout.cell_size, layout.size_z, k0, k1))
+                    continue;
+
+                for (std::size_t bz = k0 / bs; bz <= k1 / bs; ++bz)
+                {
+                    for (std::size_t by = j0 / bs; by <= j1 / bs; ++by)
+                    {
+                        for (std::size_t bx = i0 / bs; bx <= i1 / bs; ++bx)
+                        {
+                            const std::size_t b = grid.block_index(bx, by, bz);
+                            if (pass == 0)
+                                ++offsets[b + 1];
+                            else
+                                block_triangles[offsets[b]++] = static_cast<std::uint32_t>(t);
+                        }
+                    }
+                }
+            }
+
+            if (pass == 0)
+            {
+                for (std::size_t b = 1; b < offsets.size(); ++b)
+                    offsets[b] += offsets[b - 1];
+                block_triangles.resize(offsets.back());
+            }
+            else
+            {
+                for (std::size_t b = offsets.size() - 1; b > 0; --b)
+                    offsets[b] = offsets[b - 1];
+                offsets[0] = 0;
+            }
+        }
+
+        // Allocate the touched blocks
+        std::vector<std::size_t> active;
+        for (std::size_t b = 0; b < grid.block_table.size(); ++b)
+        {
+            if (offsets[b + 1] > offsets[b])
+            {
+                grid.block_table[b] = static_cast<std::int32_t>(active.size());
+                active.push_back(b);
+            }
+        }
+        grid.block_values.assign(active.size() * grid_t::block_samples, grid.background);
+
+        // Exact unsigned distances per active block
+        const detail::sdf_row_bins bins{ p_mesh, layout, bs };
+        parallel_for(active.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            std::vector<double> xs;
+            for (std::size_t a = p_begin; a < p_end; ++a)
+            {
+                const std::size_t b = active[a];
+                const std::size_t bx = b % grid.blocks_x;
+                const std::size_t by = (b / grid.blocks_x) % grid.blocks_y;
+                const std::size_t bz = b / (grid.blocks_x * grid.blocks_y);
+                double* values = grid.block_values.data() + a * grid_t::block_samples;
+
+                for (std::size_t lk = 0; lk < bs; ++lk)
+                {
+                    for (std::size_t lj = 0; lj < bs; ++lj)
+                    {
+                        const std::size_t j = by * bs + lj;
+                        const std::size_t k = bz * bs + lk;
+                        if (j >= layout.size_y || k >= layout.size_z)
+                            continue;
+
+                        if (p_options.sign == sdf_sign_method::ray_parity)
+                            bins.crossings(p_mesh, layout, bs, j, k, xs);
+
+                        std::size_t crossed = 0;
+                        for (std::size_t li = 0; li < bs; ++li)
+                        {
+                            const std::size_t i = bx * bs + li;
+                            if (i >= layout.size_x)
+                                break;
+
+                            // Closest triangle among those touching the block
+                            const vector3 p = grid.position(i, j, k);
+                            double d2 = grid.background * grid.background;
+                            for (std::size_t n = offsets[b]; n < offsets[b + 1]; ++n)
+                                d2 = std::min(d2, p_mesh.triangle(block_triangles[n]).distance2_to(p));
+
+                            bool inside = false;
+                            if (p_options.sign == sdf_sign_method::ray_parity)
+                            {
+                                while (crossed < xs.size() && xs[crossed] < p.x)
+                                    ++crossed;
+                                inside = crossed % 2 == 1;
+                            }
+                            else
+                            {
+                                inside = bvh.contains(p);
+                            }
+
+                            const double d = std::sqrt(d2);
+                            values[(lk * bs + lj) * bs + li] = inside ? -d : d;
+                        }
+                    }
+                }
+            }
+        });
+
+        // Classify the remaining tiles by the sign at their first sample
+        parallel_for(grid.blocks_y * grid.blocks_z, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            std::vector<double> xs;
+            for (std::size_t r = p_begin; r < p_end; ++r)
+            {
+                const std::size_t by = r % grid.blocks_y;
+                const std::size_t bz = r / grid.blocks_y;
+                const std::size_t j = by * bs;
+                const std::size_t k = bz * bs;
+                if (p_options.sign == sdf_sign_method::ray_parity)
+                    bins.crossings(p_mesh, layout, bs, j, k, xs);
+
+                std::size_t crossed = 0;
+                for (std::size_t bx = 0; bx < grid.blocks_x; ++bx)
+                {
+                    const vector3 p = grid.position(bx * bs, j, k);
+                    bool inside = false;
+                    if (p_options.sign == sdf_sign_method::ray_parity)
+                    {
+                        while (crossed < xs.size() && xs[crossed] < p.x)
+                            ++crossed;
+                        inside = crossed % 2 == 1;
+                    }
+
+                    std::int32_t& entry = grid.block_table[grid.block_index(bx, by, bz)];
+                    if (entry >= 0)
+                        continue;
+
+                    if (p_options.sign == sdf_sign_method::winding_number)
+                        inside = bvh.contains(p);
+                    entry = inside ? grid_t::inside_tile : grid_t::outside_tile;
+                }
+            }
+        });
+
+        return grid;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+
+namespace mesh
+{
+    /// Sparse matrix in compressed sparse row (CSR) form
+    ///
+    /// The entries of row i are offsets[i] to offsets[i + 1] of columns and
+    /// values, with columns sorted ascending and no duplicates.
+    struct sparse_matrix
+    {
+        std::size_t rows = 0;                   ///< Number of rows
+        std::size_t cols = 0;                   ///< Number of columns
+        std::vector<std::uint32_t> offsets;     ///< First entry of each row (rows + 1 entries)
+        std::vector<std::uint32_t> columns;     ///< Column of each entry
+        std::vector<double> values;             ///< Value of each entry
+
+        /// Get the number of stored entries
+        /// @return                     Entry count
+        std::size_t nonzeros() const
+        {
+            return values.size();
+        }
+
+        /// Get an entry
+        /// @param p_row                Row
+        /// @param p_column             Column
+        /// @return                     Value (zero if the entry is not stored)
+        double at(const std::size_t p_row, const std::size_t p_column) const
+        {
+            const auto begin = columns.begin() + offsets[p_row];
+            const auto end = columns.begin() + offsets[p_row + 1];
+            const auto it = std::lower_bound(begin, end, static_cast<std::uint32_t>(p_column));
+            return it != end && *it == p_column ? values[static_cast<std::size_t>(it - columns.begin())] : 0.0;
+        }
+
+        /// Get the diagonal entries
+        /// @return                     Diagonal (min(rows, cols) entries)
+        std::vector<double> diagonal() const
+        {
+            std::vector<double> result(std::min(rows, cols));
+            for (std::size_t i = 0; i < result.size(); ++i)
+                result[i] = at(i, i);
+            return result;
+        }
+
+        /// Multiply by a vector in parallel (y = A x)
+        ///
+        /// Works for any value type with addition and scaling by double, so a
+        /// vector3 array applies the matrix to all three coordinates at once.
+        /// @param p_x                  Input (cols entries)
+        /// @param p_y                  Output (rows entries, must not alias p_x)
+        template <typename T>
+        void multiply(const T* p_x, T* p_y) const
+        {
+            MESH_PROFILE_SCOPE("sparse_matrix.multiply", values.size());
+            parallel_for(rows, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t i = p_begin; i < p_end; ++i)
+                {
+                    T sum = T();
+                    for (std::uint32_t k = offsets[i]; k < offsets[i + 1]; ++k)
+                        sum += p_x[columns[k]] * values[k];
+                    p_y[i] = sum;
+                }
+            }, 2048);
+        }
+    };
+}
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+#include "mesh_sparse_matrix.hpp"
+#include "mesh_vector3.hpp"
+
+namespace mesh
+{
+    /// Preconditioner of the conjugate gradient solver
+    enum class sparse_preconditioner
+    {
+        none,                   ///< Plain conjugate gradients
+        jacobi,                 ///< Inverse diagonal (cheap, fully parallel)
+        incomplete_cholesky     ///< Zero fill-in incomplete Cholesky (fewer iterations, serial triangular solves)
+    };
+
+    /// Conjugate gradient solve options
+    struct sparse_solve_options
+    {
+        /// Stop when the residual norm falls below this fraction of the right-hand side norm
+        double tolerance = 1e-10;
+
+        /// Maximum number of iterations
+        int max_iterations = 1000;
+    };
+
+    /// Result of a conjugate gradient solve
+    struct sparse_solve_result
+    {
+        bool converged = false;         ///< True if the tolerance was reached
+        int iterations = 0;             ///< Iterations run
+        double residual = 0.0;          ///< Final residual norm relative to the right-hand side norm
+    };
+
+    namespace detail
+    {
+        /// Entries per chunk of parallel reductions (fixed so sums do not depend on the thread count)
+        constexpr std::size_t reduction_chunk = 4096;
+
+        /// Smallest number of entries per task of the solver's vector kernels
+        ///
+        /// Dot products and vector updates stream a few bytes per flop, so a
+        /// task shorter than this costs less than handing it to a worker and
+        /// vectors below it run inline on the calling thread.
+        constexpr std::size_t vector_grain = 8 * reduction_chunk;
+
+        /// Dot product of two vectors, summed in parallel chunks
+        inline double parallel_dot(const double* p_a, const double* p_b, const std::size_t p_count)
+        {
+            const std::size_t chunks = (p_count + reduction_chunk - 1) / reduction_chunk;
+            std::vector<double> partial(chunks, 0.0);
+            parallel_for(chunks, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t c = p_begin; c < p_end; ++c)
+                {
+                    double sum = 0.0;
+                    const std::size_t end = std::min(p_count, (c + 1) * reduction_chunk);
+                    for (std::size_t i = c * reduction_chunk; i < end; ++i)
+                        sum += p_a[i] * p_b[i];
+                    partial[c] = sum;
+                }
+            }, vector_grain / reduction_chunk);
+            double sum = 0.0;
+            for (const double s : partial)
+                sum += s;
+            return sum;
+        }
+    }
+
+    /// Preconditioned conjugate gradient solver for sparse symmetric positive definite systems
+    ///
+    /// setup() copies the matrix, analyses its pattern and factors the
+    /// preconditioner once; any number of solves then reuse it. When only
+    /// the values change (a new time step or stiffness with the same mesh),
+    /// update() skips the pattern analysis and refactors in place. solve()
+    /// starts from the passed solution, so the previous frame's answer makes
+    /// a warm start.
+    ///
+    /// Sparse products, dot products and vector updates run in parallel with
+    /// sums reduced in fixed chunks, so results do not depend on the thread
+    /// count. The incomplete Cholesky triangular solves are serial.
+    class sparse_solver
+    {
+    public:
+        /// Construct a solver without a matrix
+        sparse_solver() = default;
+
+        /// Set the matrix and factor the preconditioner
+        ///
+        /// The matrix must be square and symmetric with both halves stored,
+        /// and every diagonal entry must be positive. Incomplete Cholesky adds
+        /// a growing diagonal shift when the plain factorization breaks down.
+        /// @param p_matrix             System matrix
+        /// @param p_preconditioner     Preconditioner to build
+        /// @return                     False if the matrix is not square or has a non-positive diagonal entry
+        bool setup(const sparse_matrix& p_matrix, const sparse_preconditioner p_preconditioner = sparse_preconditioner::incomplete_cholesky)
+        {
+            MESH_PROFILE_SCOPE("sparse_solver.setup", p_matrix.nonzeros());
+            m_ready = false;
+            m_preconditioner = p_preconditioner;
+            m_matrix = p_matrix;
+            if (m_matrix.rows != m_matrix.cols)
+                return false;
+
+            // Lower triangle pattern, diagonal last in each row
+            const std::size_t n = m_matrix.rows;
+            m_diagonal.assign(n, 0);
+            m_lower_offsets.assign(n + 1, 0);
+            m_lower_columns.clear();
+            m_lower_source.clear();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                bool has_diagonal = false;
+                for (std::uint32_t k = m_matrix.offsets[i]; k < m_matrix.offsets[i + 1] && m_matrix.columns[k] <= i; ++k)
+                {
+                    m_lower_columns.push_back(m_matrix.columns[k]);
+                    m_lower_source.push_back(k);
+                    if (m_matrix.columns[k] == i)
+                    {
+                        m_diagonal[i] = k;
+                        has_diagonal = true;
+                    }
+                }
+                if (!has_diagonal)
+                    return false;
+                m_lower_offsets[i + 1] = static_cast<std::uint32_t>(m_lower_columns.size());
+            }
+            return factor();
+        }
+
+        /// Replace the matrix values, keeping the pattern analysis
+        /// @param p_matrix             System matrix with the same pattern as the one passed to setup()
+        /// @return                     False if the pattern differs or a diagonal entry is not positive
+        bool update(const sparse_matrix& p_matrix)
+        {
+            MESH_PROFILE_SCOPE("sparse_solver.update", p_matrix.nonzeros());
+            if (p_matrix.rows != m_matrix.rows || p_matrix.offsets != m_matrix.offsets || p_matrix.columns != m_matrix.columns)
+            {
+                m_ready = false;
+                return false;
+            }
+            m_matrix.values = p_matrix.values;
+            return factor();
+        }
+
+        /// Solve A x = b
+        /// @param p_b                  Right-hand side (rows entries)
+        /// @param p_x                  Initial guess on input, solution on output (rows entries)
+        /// @param p_options            Solve options
+        /// @return                     Convergence information (not converged if setup failed)
+        sparse_solve_result solve(const double* p_b, double* p_x, const sparse_solve_options& p_options = sparse_solve_options{}) const
+        {
+            MESH_PROFILE_SCOPE("sparse_solver.solve", m_matrix.rows);
+            sparse_solve_result result;
+            if (!m_ready)
+                return result;
+
+            const std::size_t n = m_matrix.rows;
+            std::vector<double> r(n);
+            std::vector<double> z(n);
+            std::vector<double> p(n);
+            std::vector<double> q(n);
+
+            // r = b - A x
+            m_matrix.multiply(p_x, q.data());
+            parallel_for(n, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t i = p_begin; i < p_end; ++i)
+                    r[i] = p_b[i] - q[i];
+            }, detail::vector_grain);
+
+            const double b_norm = std::sqrt(detail::parallel_dot(p_b, p_b, n));
+            double r_norm = std::sqrt(detail::parallel_dot(r.data(), r.data(), n));
+            if (b_norm == 0.0)
+            {
+                std::fill(p_x, p_x + n, 0.0);
+                result.converged = true;
+                return result;
+            }
+            result.residual = r_norm / b_norm;
+            if (result.residual <= p_options.tolerance)
+            {
+                result.converged = true;
+                return result;
+            }
+
+            precondition(r.data(), z.data());
+            p = z;
+            double rz = detail::parallel_dot(r.data(), z.data(), n);
+            while (result.iterations < p_options.max_iterations)
+            {
+                ++result.iterations;
+                m_matrix.multiply(p.data(), q.data());
+                const double pq = detail::parallel_dot(p.data(), q.data(), n);
+                if (pq <= 0.0)
+                    break;
+                const double alpha = rz / pq;
+                parallel_for(n, [&](const std::size_t p_begin, const std::size_t p_end)
+                {
+                    for (std::size_t i = p_begin; i < p_end; ++i)
+                    {
+                        p_x[i] += alpha * p[i];
+                        r[i] -= alpha * q[i];
+                    }
+                }, detail::vector_grain);
+
+                r_norm = std::sqrt(detail::parallel_dot(r.data(), r.data(), n));
+                result.residual = r_norm / b_norm;
+                if (result.residual <= p_options.tolerance)
+                {
+                    result.converged = true;
+                    break;
+                }
+
+                precondition(r.data(), z.data());
+                const double rz_next = detail::parallel_dot(r.data(), z.data(), n);
+                const double beta = rz_next / rz;
+                rz = rz_next;
+                parallel_for(n, [&](const std::size_t p_begin, const std::size_t p_end)
+                {
+                    for (std::size_t i = p_begin; i < p_end; ++i)
+                        p[i] = z[i] + beta * p[i];
+                }, detail::vector_grain);
+            }
+            return result;
+        }
+
+        /// Solve A x = b for each coordinate of a vector right-hand side
+        ///
+        /// The three coordinates share the factored preconditioner; the
+        /// result reports the slowest of the three solves.
+        /// @param p_b                  Right-hand side (rows entries)
+        /// @param p_x                  Initial guess on input, solution on output (rows entries)
+        /// @param p_options            Solve options
+        /// @return                     Convergence information
+        sparse_solve_result solve(const vector3* p_b, vector3* p_x, const sparse_solve_options& p_options = sparse_solve_options{}) const
+        {
+            const std::size_t n = m_matrix.rows;
+            std::vector<double> b(n);
+            std::vector<double> x(n);
+            sparse_solve_result result;
+            result.converged = true;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                double vector3::*coordinate = axis == 0 ? &vector3::x : (axis == 1 ? &vector3::y : &vector3::z);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    b[i] = p_b[i].*coordinate;
+                    x[i] = p_x[i].*coordinate;
+                }
+                const sparse_solve_result r = solve(b.data(), x.data(), p_options);
+                for (std::size_t i = 0; i < n; ++i)
+                    p_x[i].*coordinate = x[i];
+                result.converged = result.converged && r.converged;
+                result.iterations = std::max(result.iterations, r.iterations);
+                result.residual = std::max(result.residual, r.residual);
+            }
+            return result;
+        }
+
+        /// Check if the solver holds a factored matrix
+        /// @return                     True if solve() can run
+        bool ready() const
+        {
+            return m_ready;
+        }
+
+        /// Get the diagonal shift the incomplete Cholesky factorization needed
+        /// @return                     Relative shift added to the diagonal (zero if none)
+        double shift() const
+        {
+            return m_shift;
+        }
+
+    private:
+        /// Factor the preconditioner from the current matrix values
+        bool factor()
+        {
+            m_ready = false;
+            m_shift = 0.0;
+            const std::size_t n = m_matrix.rows;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (!(m_matrix.values[m_diagonal[i]] > 0.0))
+                    return false;
+            }
+
+            if (m_preconditioner == sparse_preconditioner::jacobi)
+            {
+                m_inverse_diagonal.resize(n);
+                for (std::size_t i = 0; i < n; ++i)
+                    m_inverse_diagonal[i] = 1.0 / m_matrix.values[m_diagonal[i]];
+            }
+            else if (m_preconditioner == sparse_preconditioner::incomplete_cholesky)
+            {
+                // Manteuffel shift: scale the diagonal up until no pivot breaks down
+                m_lower_values.resize(m_lower_columns.size());
+                for (double shift = 0.0; !factor_cholesky(shift); shift = shift == 0.0 ? 1e-3 : shift * 2.0)
+                {
+                    if (shift > 1e3)
+                        return false;
+                }
+            }
+            m_ready = true;
+            return true;
+        }
+
+        /// Zero fill-in incomplete Cholesky factorization L L^T of A + shift * diag(A)
+        bool factor_cholesky(const double p_shift)
+        {
+            MESH_PROFILE_SCOPE("sparse_solver.factor", m_lower_columns.size());
+            m_shift = p_shift;
+            const std::size_t n = m_matrix.rows;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const std::uint32_t begin = m_lower_offsets[i];
+                const std::uint32_t last = m_lower_offsets[i + 1] - 1;
+                double diagonal = m_matrix.values[m_lower_source[last]] * (1.0 + p_shift);
+                for (std::uint32_t k = begin; k < last; ++k)
+                {
+                    // L_ij = (A_ij - sum over m < j of L_im L_jm) / L_jj, on the pattern of A
+                    const std::uint32_t j = m_lower_columns[k];
+                    double value = m_matrix.values[m_lower_source[k]];
+                    std::uint32_t a = begin;
+                    std::uint32_t b = m_lower_offsets[j];
+                    const std::uint32_t b_last = m_lower_offsets[j + 1] - 1;
+                    while (a < k && b < b_last)
+                    {
+                        if (m_lower_columns[a] < m_lower_columns[b])
+                            ++a;
+                        else if (m_lower_columns[a] > m_lower_columns[b])
+                            ++b;
+                        else
+                            value -= m_lower_values[a++] * m_lower_values[b++];
+                    }
+                    value /= m_lower_values[b_last];
+                    m_lower_values[k] = value;
+                    diagonal -= value * value;
+                }
+                if (!(diagonal > 0.0))
+                    return false;
+                m_lower_values[last] = std::sqrt(diagonal);
+            }
+            return true;
+        }
+
+        /// Apply the preconditioner (z = M^-1 r)
+        void precondition(const double* p_r, double* p_z) const
+        {
+            const std::size_t n = m_matrix.rows;
+            if (m_preconditioner == sparse_preconditioner::jacobi)
+            {
+                parallel_for(n, [&](const std::size_t p_begin, const std::size_t p_end)
+                {
+                    for (std::size_t i = p_begin; i < p_end; ++i)
+                        p_z[i] = p_r[i] * m_inverse_diagonal[i];
+                }, detail::vector_grain);
+            }
+            else if (m_preconditioner == sparse_preconditioner::incomplete_cholesky)
+            {
+                // Forward substitution with L, then backward with L^T by columns
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    double value = p_r[i];
+                    const std::uint32_t last = m_lower_offsets[i + 1] - 1;
+                    for (std::uint32_t k = m_lower_offsets[i]; k < last; ++k)
+                        value -= m_lower_values[k] * p_z[m_lower_columns[k]];
+                    p_z[i] = value / m_lower_values[last];
+                }
+                for (std::size_t i = n; i-- > 0;)
+                {
+                    const std::uint32_t last = m_lower_offsets[i + 1] - 1;
+                    p_z[i] /= m_lower_values[last];
+                    for (std::uint32_t k = m_lower_offsets[i]; k < last; ++k)
+                        p_z[m_lower_columns[k]] -= m_lower_values[k] * p_z[i];
+                }
+            }
+            else
+                std::copy(p_r, p_r + n, p_z);
+        }
+
+        sparse_matrix m_matrix;                         ///< System matrix
+        sparse_preconditioner m_preconditioner = sparse_preconditioner::incomplete_cholesky;
+        bool m_ready = false;                           ///< True after a successful factorization
+        double m_shift = 0.0;                           ///< Diagonal shift of the incomplete Cholesky factor
+        std::vector<std::uint32_t> m_diagonal;          ///< Entry of each diagonal value in m_matrix
+        std::vector<double> m_inverse_diagonal;         ///< Jacobi preconditioner
+        std::vector<std::uint32_t> m_lower_offsets;     ///< First lower triangle entry of each row (diagonal last)
+        std::vector<std::uint32_t> m_lower_columns;     ///< Column of each lower triangle entry
+        std::vector<std::uint32_t> m_lower_source;      ///< Entry of each lower triangle value in m_matrix
+        std::vector<double> m_lower_values;             ///< Incomplete Cholesky factor
+    };
+}
@@ -0,0 +1,368 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+#include "mesh_vector3.hpp"
+
+namespace mesh
+{
+    /// Uniform-grid spatial hash for dynamic point sets
+    ///
+    /// Points are hashed by integer cell coordinates into a power-of-two bucket
+    /// table and rebuilt with a counting sort, so the points of each bucket sit
+    /// next to each other, in input order within the bucket. Storage is grouped
+    /// by bucket, not sorted by cell: neighbouring cells generally land in
+    /// unrelated buckets. Rebuilding is linear in the number of points and is
+    /// cheap enough to run every frame for moving particles. Distinct cells may
+    /// share a bucket; radius queries filter by distance so collisions only
+    /// cost extra distance tests. Cell coordinates are clamped, so huge and
+    /// non-finite positions hash to the outermost cells instead of overflowing.
+    class spatial_hash
+    {
+    public:
+        /// Construct a spatial hash
+        /// @param p_cell_size          Cell edge length (usually the query radius)
+        explicit spatial_hash(const double p_cell_size = 1.0)
+            : m_cell_size(p_cell_size), m_inv_cell_size(1.0 / p_cell_size)
+        {
+        }
+
+        /// Rebuild the hash from a set of points
+        ///
+        /// Hashing, counting and scattering all run in parallel. Points within a
+        /// bucket keep their input order so the result is deterministic.
+        /// @param p_points             Point positions
+        /// @param p_count              Number of points
+        /// @param p_table_size         Bucket count (rounded up to a power of two), or zero to match the point count
+        void build(const vector3* p_points, const std::size_t p_count, const std::size_t p_table_size = 0)
+        {
+            MESH_PROFILE_SCOPE("spatial_hash.build", p_count);
+            // Size the bucket table
+            std::size_t table_size = 1;
+            const std::size_t requested = p_table_size != 0 ? p_table_size : p_count;
+            while (table_size < requested)
+                table_size <<= 1;
+            if (table_size != m_table_size || !m_counts)
+            {
+                m_table_size = table_size;
+                m_counts.reset(new std::atomic<std::uint32_t>[table_size]);
+            }
+            m_bucket_start.resize(table_size + 1);
+            m_points.resize(p_count);
+            m_indices.resize(p_count);
+            m_buckets.resize(p_count);
+
+            parallel_for(table_size, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t b = p_begin; b < p_end; ++b)
+                    m_counts[b].store(0, std::memory_order_relaxed);
+            }, grain_size);
+
+            // Hash every point and count the bucket sizes
+            parallel_for(p_count, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t i = p_begin; i < p_end; ++i)
+                {
+                    const std::uint32_t bucket = bucket_of(p_points[i]);
+                    m_buckets[i] = bucket;
+                    m_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+                }
+            }, grain_size);
+
+            // Exclusive prefix sum: sum blocks in parallel, scan the block sums, then scan each block
+            const std::size_t blocks = std::max<std::size_t>(1, std::min<std::size_t>(thread_count() * 4, table_size / grain_size));
+            const std::size_t block_size = (table_size + blocks - 1) / blocks;
+            std::vector<std::uint32_t> block_start(blocks + 1, 0);
+            parallel_for(blocks, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t k = p_begin; k < p_end; ++k)
+                {
+                    std::uint32_t sum = 0;
+                    const std::size_t end = std::min(table_size, (k + 1) * block_size);
+                    for (std::size_t b = k * block_size; b < end; ++b)
+                        sum += m_counts[b].load(std::memory_order_relaxed);
+                    block_start[k + 1] = sum;
+                }
+            });
+            for (std::size_t k = 0; k < blocks; ++k)
+                block_start[k + 1] += block_start[k];
+            parallel_for(blocks, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t k = p_begin; k < p_end; ++k)
+                {
+                    std::uint32_t sum = block_start[k];
+                    const std::size_t end = std::min(table_size, (k + 1) * block_size);
+                    for (std::size_t b = k * block_size; b < end; ++b)
+                    {
+                        const std::uint32_t count = m_counts[b].load(std::memory_order_relaxed);
+                        m_bucket_start[b] = sum;
+                        m_counts[b].store(sum, std::memory_order_relaxed);
+                        sum += count;
+                    }
+                }
+            });
+            m_bucket_start[table_size] = static_cast<std::uint32_t>(p_count);
+
+            // Scatter the points to their bucket slots (counters now hold the write cursors)
+            parallel_for(p_count, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t i = p_begin; i < p_end; ++i)
+                {
+                    const std::uint32_t slot = m_counts[m_buckets[i]].fetch_add(1, std::memory_order_relaxed);
+                    m_indices[slot] = static_cast<std::uint32_t>(i);
+                }
+            }, grain_size);
+
+            // Restore input order within each bucket and gather the positions
+            parallel_for(table_size, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t b = p_begin; b < p_end; ++b)
+                {
+                    const std::uint32_t begin = m_bucket_start[b];
+                    const std::uint32_t end = m_bucket_start[b + 1];
+                    if (end - begin > 1)
+                        std::sort(m_indices.begin() + begin, m_indices.begin() + end);
+                    for (std::uint32_t s = begin; s < end; ++s)
+                        m_points[s] = p_points[m_indices[s]];
+                }
+            }, grain_size);
+        }
+
+        /// Rebuild the hash from a set of points
+        /// @param p_points             Point positions
+        /// @param p_table_size         Bucket count (rounded up to a power of two), or zero to match the point count
+        void build(const std::vector<vector3>& p_points, const std::size_t p_table_size = 0)
+        {
+            build(p_points.data(), p_points.size(), p_table_size);
+        }
+
+        /// Visit every point within a radius of a position
+        /// @param p_center             Query position
+        /// @param p_radius             Query radius (inclusive)
+        /// @param p_func               Function called as p_func(index, position, distance2) for each point
+        template <typename TFunc>
+        void query_radius(const vector3& p_center, const double p_radius, TFunc&& p_func) const
+        {
+            const double radius2 = p_radius * p_radius;
+            for_each_bucket(p_center - vector3{ p_radius, p_radius, p_radius }, p_center + vector3{ p_radius, p_radius, p_radius },
+                [&](const std::uint32_t p_begin, const std::uint32_t p_end)
+                {
+                    for (std::uint32_t s = p_begin; s < p_end; ++s)
+                    {
+                        const double d2 = (m_points[s] - p_center).length2();
+                        if (d2 <= radius2)
+                            p_func(m_indices[s], m_points[s], d2);
+                    }
+                });
+        }
+
+        /// Collect the indices of every point within a radius of a position
+        /// @param p_center             Query position
+        /// @param p_radius             Query radius (inclusive)
+        /// @param p_result             Receives the point indices (appended)
+        void query_radius(const vector3& p_center, const double p_radius, std::vector<std::uint32_t>& p_result) const
+        {
+            query_radius(p_center, p_radius, [&](const std::uint32_t p_index, const vector3&, const double)
+            {
+                p_result.push_back(p_index);
+            });
+        }
+
+        /// Visit the 3x3x3 block of cells around a position
+        ///
+        /// Each bucket is visited once as a contiguous range of the bucket-ordered
+        /// arrays returned by points() and indices(). Buckets may hold points from
+        /// colliding cells outside the block, so callers must filter by distance.
+        /// @param p_position           Query position
+        /// @param p_func               Function called as p_func(begin, end) for each non-empty bucket
+        template <typename TFunc>
+        void for_each_neighbor_cell(const vector3& p_position, TFunc&& p_func) const
+        {
+            for_each_bucket(p_position - vector3{ m_cell_size, m_cell_size, m_cell_size }, p_position + vector3{ m_cell_size, m_cell_size, m_cell_size }, p_func);
+        }
+
+        /// Find the neighbours of many positions in parallel
+        ///
+        /// Results are stored in compressed rows: the neighbours of query q are
+        /// p_neighbors[p_offsets[q]] to p_neighbors[p_offsets[q + 1]], in bucket order.
+        /// @param p_queries            Query positions
+        /// @param p_count              Number of queries
+        /// @param p_radius             Query radius (inclusive)
+        /// @param p_offsets            Receives p_count + 1 row offsets
+        /// @param p_neighbors          Receives the neighbour point indices
+        void find_neighbors(const vector3* p_queries, const std::size_t p_count, const double p_radius, std::vector<std::size_t>& p_offsets, std::vector<std::uint32_t>& p_neighbors) const
+        {
+            // Count the neighbours of each query, then fill the rows
+            p_offsets.assign(p_count + 1, 0);
+            parallel_for(p_count, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t q = p_begin; q < p_end; ++q)
+                {
+                    std::size_t count = 0;
+                    query_radius(p_queries[q], p_radius, [&](const std::uint32_t, const vector3&, const double) { ++count; });
+                    p_offsets[q + 1] = count;
+                }
+            }, query_grain_size);
+
+            for (std::size_t q = 0; q < p_count; ++q)
+                p_offsets[q + 1] += p_offsets[q];
+            p_neighbors.resize(p_offsets[p_count]);
+
+            parallel_for(p_count, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t q = p_begin; q < p_end; ++q)
+                {
+                    std::size_t next = p_offsets[q];
+                    query_radius(p_queries[q], p_radius, [&](const std::uint32_t p_index, const vector3&, const double) { p_neighbors[next++] = p_index; });
+                }
+            }, query_grain_size);
+        }
+
+        /// Get the cell edge length
+        double cell_size() const
+        {
+            return m_cell_size;
+        }
+
+        /// Get the number of buckets
+        std::size_t table_size() const
+        {
+            return m_table_size;
+        }
+
+        /// Get the number of points
+        std::size_t size() const
+        {
+            return m_points.size();
+        }
+
+        /// Get the point positions in bucket order
+        const std::vector<vector3>& points() const
+        {
+            return m_points;
+        }
+
+        /// Get the original point index of each entry in bucket order
+        const std::vector<std::uint32_t>& indices() const
+        {
+            return m_indices;
+        }
+
+        /// Get the integer cell coordinate of a position component
+        ///
+        /// Coordinates are clamped to +-cell_limit; NaN maps to -cell_limit.
+        /// @param p_value              Position component
+        /// @return                     Cell coordinate
+        std::int64_t cell_coordinate(const double p_value) const
+        {
+            double cell = std::floor(p_value * m_inv_cell_size);
+            if (!(cell > -cell_limit))
+                cell = -cell_limit;
+            if (cell > cell_limit)
+                cell = cell_limit;
+            return static_cast<std::int64_t>(cell);
+        }
+
+        /// Get the bucket holding a cell
+        /// @param p_x                  Cell X coordinate
+        /// @param p_y                  Cell Y coordinate
+        /// @param p_z                  Cell Z coordinate
+        /// @return                     Bucket index
+        std::uint32_t bucket_of(const std::int64_t p_x, const std::int64_t p_y, const std::int64_t p_z) const
+        {
+            // Large-prime spatial hash (Teschner et al.) with a final avalanche step
+            std::uint64_t h = static_cast<std::uint64_t>(p_x) * 73856093u ^
+                              static_cast<std::uint64_t>(p_y) * 19349663u ^
+                              static_cast<std::uint64_t>(p_z) * 83492791u;
+            h ^= h >> 29;
+            h *= 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 32;
+            return static_cast<std::uint32_t>(h & (m_table_size - 1));
+        }
+
+        /// Get the bucket holding a position
+        /// @param p_position           Position
+        /// @return                     Bucket index
+        std::uint32_t bucket_of(const vector3& p_position) const
+        {
+            return bucket_of(cell_coordinate(p_position.x), cell_coordinate(p_position.y), cell_coordinate(p_position.z));
+        }
+
+        /// Largest cell coordinate magnitude (2^52: cell spans stay exact in doubles and int64)
+        static constexpr double cell_limit = 4503599627370496.0;
+
+    private:
+        /// Items per parallel chunk for per-point and per-bucket passes
+        static constexpr std::size_t grain_size = 16384;
+
+        /// Queries per parallel chunk
+        static constexpr std::size_t query_grain_size = 256;
+
+        /// Visit each distinct non-empty bucket covering the cells of a box once
+        template <typename TFunc>
+        void for_each_bucket(const vector3& p_minimum, const vector3& p_maximum, TFunc&& p_func) const
+        {
+            if (m_points.empty())
+                return;
+
+            const std::int64_t x0 = cell_coordinate(p_minimum.x), x1 = cell_coordinate(p_maximum.x);
+            const std::int64_t y0 = cell_coordinate(p_minimum.y), y1 = cell_coordinate(p_maximum.y);
+            const std::int64_t z0 = cell_coordinate(p_minimum.z), z1 = cell_coordinate(p_maximum.z);
+            const double cells = static_cast<double>(x1 - x0 + 1) * static_cast<double>(y1 - y0 + 1) * static_cast<double>(z1 - z0 + 1);
+
+            // Boxes covering more cells than buckets visit the whole table
+            if (cells >= static_cast<double>(m_table_size))
+            {
+                for (std::size_t b = 0; b < m_table_size; ++b)
+                {
+                    if (m_bucket_start[b] != m_bucket_start[b + 1])
+                        p_func(m_bucket_start[b], m_bucket_start[b + 1]);
+                }
+                return;
+            }
+
+            // Gather the buckets, then drop duplicates caused by hash collisions
+            std::array<std::uint32_t, 64> local;
+            std::vector<std::uint32_t> heap;
+            std::uint32_t* buckets = local.data();
+            if (cells > static_cast<double>(local.size()))
+            {
+                heap.resize(static_cast<std::size_t>(cells));
+                buckets = heap.data();
+            }
+
+            std::size_t count = 0;
+            for (std::int64_t z = z0; z <= z1; ++z)
+                for (std::int64_t y = y0; y <= y1; ++y)
+                    for (std::int64_t x = x0; x <= x1; ++x)
+                        buckets[count++] = bucket_of(x, y, z);
+
+            std::sort(buckets, buckets + count);
+            count = static_cast<std::size_t>(std::unique(buckets, buckets + count) - buckets);
+            for (std::size_t n = 0; n < count; ++n)
+            {
+                const std::uint32_t b = buckets[n];
+                if (m_bucket_start[b] != m_bucket_start[b + 1])
+                    p_func(m_bucket_start[b], m_bucket_start[b + 1]);
+            }
+        }
+
+        double m_cell_size;                                     ///< Cell edge length
+        double m_inv_cell_size;                                 ///< Reciprocal cell edge length
+        std::size_t m_table_size = 0;                           ///< Bucket count (power of two)
+        std::unique_ptr<std::atomic<std::uint32_t>[]> m_counts; ///< Bucket counters reused across builds
+        std::vector<std::uint32_t> m_bucket_start;              ///< First entry of each bucket (table size + 1)
+        std::vector<std::uint32_t> m_buckets;                   ///< Bucket of each input point
+        std::vector<vector3> m_points;                          ///< Positions in bucket order
+        std::vector<std::uint32_t> m_indices;                   ///< Original index of each entry
+    };
+}
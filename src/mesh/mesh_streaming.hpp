@@ -0,0 +1,801 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "mesh_cache.hpp"
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+
+namespace mesh
+{
+    /// Options for out-of-core streaming processing
+    struct streaming_options
+    {
+        /// Edge length of the cubic chunks the input is split into (positive and finite)
+        double chunk_size = 64.0;
+
+        /// Weld tolerance (zero welds exactly equal positions only)
+        double weld_tolerance = 0.0;
+
+        /// Vertex clustering cell size (zero disables simplification)
+        double cluster_size = 0.0;
+
+        /// Compute area-weighted vertex normals
+        bool compute_normals = true;
+
+        /// Maximum number of chunks loaded, processing or waiting to be written
+        std::size_t max_chunks_in_flight = 4;
+
+        /// Number of triangles requested from the source per read
+        std::size_t read_batch = 65536;
+
+        /// Number of triangles buffered per chunk before spilling to disk
+        std::size_t spill_batch = 1024;
+
+        /// Directory for spill files (empty uses the system temporary directory)
+        std::string temp_directory;
+    };
+
+    /// Processed chunk handed to a streaming sink
+    ///
+    /// Chunks arrive in increasing index order. Vertex ids are global: the
+    /// chunk's new vertices take ids first_vertex onwards and indices may also
+    /// refer to vertices shared with earlier chunks.
+    struct streamed_chunk
+    {
+        /// Chunk index
+        std::size_t index = 0;
+
+        /// Bounds of the chunk's input triangles
+        aabb3 bounds = aabb3::empty();
+
+        /// Global id of the first new vertex
+        std::uint32_t first_vertex = 0;
+
+        /// New vertex positions
+        std::vector<vector3> vertices;
+
+        /// New vertex normals (empty unless normals are computed)
+        std::vector<vector3> normals;
+
+        /// Triangle vertex ids (three per triangle)
+        std::vector<std::uint32_t> indices;
+    };
+
+    /// Outcome of streaming processing
+    struct streaming_result
+    {
+        /// True if all spill file reads and writes succeeded
+        bool ok = false;
+
+        /// Number of non-empty chunks
+        std::size_t chunks = 0;
+
+        /// Number of triangles read from the source
+        std::size_t input_triangles = 0;
+
+        /// Largest number of input triangles in one chunk
+        std::size_t max_chunk_triangles = 0;
+
+        /// Number of vertices shared between chunks or on open edges
+        std::size_t boundary_vertices = 0;
+
+        /// Number of vertices written
+        std::size_t output_vertices = 0;
+
+        /// Number of triangles written
+        std::size_t output_triangles = 0;
+    };
+
+    /// Triangle source reading from indexed vertex and index arrays
+    ///
+    /// Works over an in-memory mesh or a memory-mapped mesh cache, where the
+    /// operating system pages the data in as it is read.
+    class indexed_triangle_source
+    {
+    public:
+        /// Construct a source over raw arrays
+        /// @param p_vertices           Vertex positions
+        /// @param p_indices            Triangle vertex indices
+        /// @param p_triangle_count     Number of triangles
+        indexed_triangle_source(const vector3* p_vertices, const std::uint32_t* p_indices, const std::size_t p_triangle_count)
+            : m_vertices(p_vertices), m_indices(p_indices), m_triangle_count(p_triangle_count)
+        {
+        }
+
+        /// Construct a source over a mesh
+        /// @param p_mesh               Mesh to read (must outlive the source)
+        explicit indexed_triangle_source(const indexed_mesh& p_mesh)
+            : indexed_triangle_source(p_mesh.vertices.data(), p_mesh.indices.data(), p_mesh.triangle_count())
+        {
+        }
+
+        /// Construct a source over a mesh cache
+        /// @param p_cache              Open cache to read (must outlive the source)
+        explicit indexed_triangle_source(const mesh_cache& p_cache)
+            : indexed_triangle_source(p_cache.positions(), p_cache.indices(), p_cache.triangle_count())
+        {
+        }
+
+        /// Read the next triangles
+        /// @param p_buffer             Receives the triangles
+        /// @param p_capacity           Maximum number of triangles to read
+        /// @return                     Number of triangles read (zero at the end)
+        std::size_t read(triangle3* p_buffer, const std::size_t p_capacity)
+        {
+            const std::size_t count = std::min(p_capacity, m_triangle_count - m_next);
+            for (std::size_t i = 0; i < count; ++i, ++m_next)
+            {
+                const std::uint32_t* tri = m_indices + m_next * 3;
+                p_buffer[i] = triangle3{ m_vertices[tri[0]], m_vertices[tri[1]], m_vertices[tri[2]] };
+            }
+            return count;
+        }
+
+    private:
+        const vector3* m_vertices;
+        const std::uint32_t* m_indices;
+        std::size_t m_triangle_count;
+        std::size_t m_next = 0;
+    };
+
+    /// Streaming sink collecting every chunk into one mesh
+    struct indexed_mesh_sink
+    {
+        /// Mesh receiving vertices and triangles
+        indexed_mesh& mesh;
+
+        /// Optional vector receiving vertex normals
+        std::vector<vector3>* normals = nullptr;
+
+        /// Append a chunk
+        /// @param p_chunk              Processed chunk
+        void operator()(const streamed_chunk& p_chunk)
+        {
+            mesh.vertices.insert(mesh.vertices.end(), p_chunk.vertices.begin(), p_chunk.vertices.end());
+            mesh.indices.insert(mesh.indices.end(), p_chunk.indices.begin(), p_chunk.indices.end());
+            if (normals)
+                normals->insert(normals->end(), p_chunk.normals.begin(), p_chunk.normals.end());
+        }
+    };
+
+    namespace detail
+    {
+        /// Integer coordinates of a grid cell
+        using streaming_cell = std::array<std::int64_t, 3>;
+
+        /// Largest cell coordinate magnitude (2^52, as in spatial_hash)
+        constexpr double streaming_cell_limit = 4503599627370496.0;
+
+        /// Convert a scaled position component to a cell coordinate
+        ///
+        /// Coordinates are clamped to +-streaming_cell_limit; NaN maps to -streaming_cell_limit.
+        /// @param p_value              Position component divided by the cell size
+        /// @return                     Cell coordinate
+        inline std::int64_t streaming_cell_coordinate(const double p_value)
+        {
+            double cell = std::floor(p_value);
+            if (!(cell > -streaming_cell_limit))
+                cell = -streaming_cell_limit;
+            if (cell > streaming_cell_limit)
+                cell = streaming_cell_limit;
+            return static_cast<std::int64_t>(cell);
+        }
+
+        /// Find the grid cell holding a point
+        /// @param p_point              Point
+        /// @param p_inv_size           Reciprocal of the cell size
+        /// @return                     Cell coordinates
+        inline streaming_cell streaming_cell_of(const vector3& p_point, const double p_inv_size)
+        {
+            return streaming_cell{
+                streaming_cell_coordinate(p_point.x * p_inv_size),
+                streaming_cell_coordinate(p_point.y * p_inv_size),
+                streaming_cell_coordinate(p_point.z * p_inv_size)
+            };
+        }
+
+        /// Check that every corner coordinate of a triangle is finite
+        inline bool streaming_is_finite(const triangle3& p_triangle)
+        {
+            const vector3 points[3] = { p_triangle.point1, p_triangle.point2, p_triangle.point3 };
+            for (const vector3& p : points)
+            {
+                if (!std::isfinite(p.x) || !std::isfinite(p.y) || !std::isfinite(p.z))
+                    return false;
+            }
+            return true;
+        }
+
+        /// Shared vertex with its normal accumulated over every chunk
+        struct streaming_boundary_vertex
+        {
+            vector3 position;
+            vector3 normal;
+        };
+
+        /// Welded chunk geometry
+        struct streaming_chunk_mesh
+        {
+            indexed_mesh mesh;
+            std::vector<std::uint8_t> locked;
+        };
+
+        /// Processed chunk before global vertex ids are assigned
+        struct streaming_chunk_output
+        {
+            indexed_mesh mesh;
+            std::vector<vector3> normals;
+            std::vector<std::uint32_t> boundary;
+            aabb3 bounds = aabb3::empty();
+            std::size_t input_triangles = 0;
+        };
+
+        /// Weld a chunk and lock the vertices on its open edges
+        ///
+        /// Positions are snapped to the weld grid so every chunk welds a shared
+        /// vertex to the same position. Vertices on edges without a partner in
+        /// the chunk are either on the input's border or shared with another
+        /// chunk; both stay fixed so chunk seams line up.
+        /// @param p_triangles          Chunk triangles
+        /// @param p_tolerance          Weld tolerance
+        /// @return                     Welded mesh with locked vertex flags
+        inline streaming_chunk_mesh streaming_weld(const std::vector<triangle3>& p_triangles, const double p_tolerance)
+        {
+            MESH_PROFILE_SCOPE("streaming.weld", p_triangles.size());
+            // Snap every corner, normalising negative zero
+            std::vector<vector3> corners(p_triangles.size() * 3);
+            for (std::size_t t = 0; t < p_triangles.size(); ++t)
+            {
+                const vector3 points[3] = { p_triangles[t].point1, p_triangles[t].point2, p_triangles[t].point3 };
+                for (int c = 0; c < 3; ++c)
+                {
+                    const vector3& p = points[c];
+                    corners[t * 3 + c] = p_tolerance > 0.0
+                        ? vector3{ (std::floor(p.x / p_tolerance) + 0.5) * p_tolerance, (std::floor(p.y / p_tolerance) + 0.5) * p_tolerance, (std::floor(p.z / p_tolerance) + 0.5) * p_tolerance }
+                        : vector3{ p.x + 0.0, p.y + 0.0, p.z + 0.0 };
+                }
+            }
+
+            // Sort corners by position and merge equal runs
+            std::vector<std::uint32_t> order(corners.size());
+            for (std::size_t i = 0; i < order.size(); ++i)
+                order[i] = static_cast<std::uint32_t>(i);
+            std::sort(order.begin(), order.end(), [&](const std::uint32_t p_a, const std::uint32_t p_b)
+            {
+                return corners[p_a] < corners[p_b] || (corners[p_a] == corners[p_b] && p_a < p_b);
+            });
+
+            streaming_chunk_mesh result;
+            std::vector<std::uint32_t> corner_vertex(corners.size());
+            for (std::size_t i = 0; i < order.size(); ++i)
+            {
+                if (i == 0 || !(corners[order[i]] == corners[order[i - 1]]))
+                    result.mesh.add_vertex(corners[order[i]]);
+                corner_vertex[order[i]] = static_cast<std::uint32_t>(result.mesh.vertices.size() - 1);
+            }
+
+            // Keep triangles with three distinct vertices
+            for (std::size_t t = 0; t < p_triangles.size(); ++t)
+            {
+                const std::uint32_t a = corner_vertex[t * 3];
+                const std::uint32_t b = corner_vertex[t * 3 + 1];
+                const std::uint32_t c = corner_vertex[t * 3 + 2];
+                if (a != b && b != c && c != a)
+                    result.mesh.add_triangle(a, b, c);
+            }
+
+            // Lock both ends of every open edge
+            result.locked.assign(result.mesh.vertices.size(), 0);
+            const std::vector<std::uint32_t> adjacency = compute_edge_adjacency(result.mesh);
+            for (std::size_t i = 0; i < adjacency.size(); ++i)
+            {
+                if (adjacency[i] != no_neighbor)
+                    continue;
+                result.locked[result.mesh.indices[i]] = 1;
+                result.locked[result.mesh.indices[i - i % 3 + (i + 1) % 3]] = 1;
+            }
+            return result;
+        }
+
+        /// Add each triangle's area-weighted normal to its vertices
+        /// @param p_mesh               Mesh
+        /// @param p_normals            Per-vertex normal sums to add to
+        inline void streaming_accumulate_normals(const indexed_mesh& p_mesh, std::vector<vector3>& p_normals)
+        {
+            for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+            {
+                const vector3 n = p_mesh.triangle(t).normal();
+                for (int c = 0; c < 3; ++c)
+                    p_normals[p_mesh.indices[t * 3 + c]] += n;
+            }
+        }
+
+        /// Simplify a chunk by clustering its unlocked vertices on a global grid
+        ///
+        /// Each cell's unlocked vertices collapse to their mean while locked
+        /// vertices keep their own position, so the chunk boundary is unchanged.
+        /// @param p_chunk              Welded chunk
+        /// @param p_cell_size          Clustering cell size
+        /// @return                     Simplified mesh and its locked vertex flags
+        inline streaming_chunk_mesh streaming_cluster(const streaming_chunk_mesh& p_chunk, const double p_cell_size)
+        {
+            MESH_PROFILE_SCOPE("streaming.cluster", p_chunk.mesh.triangle_count());
+            const std::vector<vector3>& vertices = p_chunk.mesh.vertices;
+            const double inv_size = 1.0 / p_cell_size;
+            std::vector<streaming_cell> cells(vertices.size());
+            std::vector<std::uint32_t> order;
+            order.reserve(vertices.size());
+            for (std::size_t i = 0; i < vertices.size(); ++i)
+            {
+                cells[i] = streaming_cell_of(vertices[i], inv_size);
+                order.push_back(static_cast<std::uint32_t>(i));
+            }
+
+            // Group unlocked vertices by cell, leaving locked vertices alone
+            std::sort(order.begin(), order.end(), [&](const std::uint32_t p_a, const std::uint32_t p_b)
+            {
+                if (p_chunk.locked[p_a] != p_chunk.locked[p_b])
+                    return p_chunk.locked[p_a] < p_chunk.locked[p_b];
+                if (!p_chunk.locked[p_a] && cells[p_a] != cells[p_b])
+                    return cells[p_a] < cells[p_b];
+                return p_a < p_b;
+            });
+
+            std::vector<std::uint32_t> cluster(vertices.size());
+            std::vector<vector3> sums;
+            std::vector<std::size_t> counts;
+            std::vector<std::uint8_t> cluster_locked;
+            for (std::size_t i = 0; i < order.size(); ++i)
+            {
+                const std::uint32_t v = order[i];
+                const bool locked = p_chunk.locked[v] != 0;
+                if (i == 0 || locked || p_chunk.locked[order[i - 1]] || cells[v] != cells[order[i - 1]])
+                {
+                    sums.push_back(vector3{ 0.0, 0.0, 0.0 });
+                    counts.push_back(0);
+                    cluster_locked.push_back(locked ? 1 : 0);
+                }
+                cluster[v] = static_cast<std::uint32_t>(sums.size() - 1);
+                sums.back() += vertices[v];
+                ++counts.back();
+            }
+
+            // Rebuild triangles, dropping collapsed ones and unused clusters
+            streaming_chunk_mesh result;
+            std::vector<std::uint32_t> remap(sums.size(), no_neighbor);
+            for (std::size_t t = 0; t < p_chunk.mesh.triangle_count(); ++t)
+            {
+                const std::uint32_t a = cluster[p_chunk.mesh.indices[t * 3]];
+                const std::uint32_t b = cluster[p_chunk.mesh.indices[t * 3 + 1]];
+                const std::uint32_t c = cluster[p_chunk.mesh.indices[t * 3 + 2]];
+                if (a == b || b == c || c == a)
+                    continue;
+
+                for (const std::uint32_t k : { a, b, c })
+                {
+                    if (remap[k] != no_neighbor)
+                        continue;
+                    remap[k] = result.mesh.add_vertex(sums[k] / static_cast<double>(counts[k]));
+                    result.locked.push_back(cluster_locked[k]);
+                }
+                result.mesh.add_triangle(remap[a], remap[b], remap[c]);
+            }
+            return result;
+        }
+
+        /// Process one chunk: weld, simplify and compute normals
+        /// @param p_triangles          Chunk triangles
+        /// @param p_boundary           Shared vertices sorted by position
+        /// @param p_options            Streaming options
+        /// @return                     Processed chunk
+        inline streaming_chunk_output streaming_process(const std::vector<triangle3>& p_triangles,
+                                                        const std::vector<streaming_boundary_vertex>& p_boundary,
+                                                        const streaming_options& p_options)
+        {
+            streaming_chunk_mesh chunk = streaming_weld(p_triangles, p_options.weld_tolerance);
+            if (p_options.cluster_size > 0.0)
+                chunk = streaming_cluster(chunk, p_options.cluster_size);
+
+            streaming_chunk_output output;
+            output.input_triangles = p_triangles.size();
+            for (const auto& t : p_triangles)
+            {
+                output.bounds.expand(t.point1);
+                output.bounds.expand(t.point2);
+                output.bounds.expand(t.point3);
+            }
+
+            // Find the shared entry of every locked vertex
+            output.boundary.assign(chunk.mesh.vertices.size(), no_neighbor);
+            for (std::size_t i = 0; i < chunk.mesh.vertices.size(); ++i)
+            {
+                if (!chunk.locked[i])
+                    continue;
+                const auto it = std::lower_bound(p_boundary.begin(), p_boundary.end(), chunk.mesh.vertices[i],
+                    [](const streaming_boundary_vertex& p_entry, const vector3& p_position)
+                    {
+                        return p_entry.position < p_position;
+                    });
+                if (it != p_boundary.end() && it->position == chunk.mesh.vertices[i])
+                    output.boundary[i] = static_cast<std::uint32_t>(it - p_boundary.begin());
+            }
+
+            // Shared vertices take the normal summed over every chunk
+            if (p_options.compute_normals)
+            {
+                output.normals.assign(chunk.mesh.vertices.size(), vector3{ 0.0, 0.0, 0.0 });
+                streaming_accumulate_normals(chunk.mesh, output.normals);
+                for (std::size_t i = 0; i < output.normals.size(); ++i)
+                {
+                    if (output.boundary[i] != no_neighbor)
+                        output.normals[i] = p_boundary[output.boundary[i]].normal;
+                    output.normals[i] = output.normals[i].normalized();
+                }
+            }
+
+            output.mesh = std::move(chunk.mesh);
+            return output;
+        }
+
+        /// Chunk spilled to disk during partitioning
+        struct streaming_spill
+        {
+            std::string path;
+            std::vector<triangle3> buffer;
+            std::size_t count = 0;
+        };
+
+        /// Append triangles to a spill file
+        /// @param p_path               File path
+        /// @param p_triangles          Triangles to append
+        /// @return                     True on success
+        inline bool streaming_append(const std::string& p_path, const std::vector<triangle3>& p_triangles)
+        {
+            std::ofstream file(p_path, std::ios::binary | std::ios::app);
+            file.write(reinterpret_cast<const char*>(p_triangles.data()), static_cast<std::streamsize>(p_triangles.size() * sizeof(triangle3)));
+            return static_cast<bool>(file);
+        }
+
+        /// Load a spill file
+        /// @param p_path               File path
+        /// @param p_count              Number of triangles in the file
+        /// @param p_triangles          Receives the triangles
+        /// @return                     True on success
+        inline bool streaming_load(const std::string& p_path, const std::size_t p_count, std::vector<triangle3>& p_triangles)
+        {
+            p_triangles.resize(p_count);
+            std::ifstream file(p_path, std::ios::binary);
+            file.read(reinterpret_cast<char*>(p_triangles.data()), static_cast<std::streamsize>(p_count * sizeof(triangle3)));
+            return static_cast<bool>(file);
+        }
+
+        /// Temporary spill directory removed on destruction
+        struct streaming_directory
+        {
+            std::filesystem::path path;
+
+            explicit streaming_directory(const std::string& p_parent)
+            {
+                std::error_code error;
+                const std::filesystem::path parent = p_parent.empty() ? std::filesystem::temp_directory_path(error) : std::filesystem::path(p_parent);
+                std::random_device device;
+                for (int attempt = 0; attempt < 16 && path.empty(); ++attempt)
+                {
+                    const std::filesystem::path candidate = parent / ("mesh_stream_" + std::to_string(device()));
+                    if (std::filesystem::create_directories(candidate, error))
+                        path = candidate;
+                }
+            }
+
+            ~streaming_directory()
+            {
+                std::error_code error;
+                if (!path.empty())
+                    std::filesystem::remove_all(path, error);
+            }
+
+            streaming_directory(const streaming_directory&) = delete;
+            streaming_directory& operator=(const streaming_directory&) = delete;
+        };
+    }
+
+    /// Process a mesh too large for memory in spatial chunks
+    ///
+    /// Triangles are read from the source in batches and partitioned by their
+    /// centroid into cubic chunks, which are spilled to temporary files. Each
+    /// chunk is then loaded, welded, optionally simplified by vertex clustering
+    /// and given vertex normals, then handed to the sink in chunk order.
+    /// Triangles with non-finite coordinates are read but dropped, and a
+    /// chunk_size that is not positive and finite fails the whole run.
+    ///
+    /// Chunks stitch consistently: vertices on a chunk's open edges are found in
+    /// a first pass over the spill files, never move during simplification and
+    /// take normals summed over every chunk using them, so each shared vertex is
+    /// written once and referenced by all its chunks. This assumes a manifold
+    /// input; chunks meeting only at a non-manifold vertex may separate there.
+    ///
+    /// Partitioning overlaps reading the source with writing spill files, and
+    /// processing runs a loader thread, worker threads and the writing calling
+    /// thread concurrently. Memory holds the per-chunk spill buffers, the shared
+    /// vertex table and at most max_chunks_in_flight chunks.
+    ///
+    /// The source provides std::size_t read(triangle3* buffer, std::size_t capacity)
+    /// returning zero at the end; the sink is called with each streamed_chunk.
+    /// @param p_source             Triangle source
+    /// @param p_sink               Chunk sink
+    /// @param p_options            Streaming options
+    /// @return                     Processing outcome and statistics
+    template <typename TSource, typename TSink>
+    streaming_result process_streaming(TSource& p_source, TSink&& p_sink, const streaming_options& p_options = streaming_options{})
+    {
+        MESH_PROFILE_SCOPE("streaming.process", 0);
+        streaming_result result;
+        if (!(p_options.chunk_size > 0.0) || !std::isfinite(p_options.chunk_size))
+            return result;
+
+        detail::streaming_directory directory(p_options.temp_directory);
+        if (directory.path.empty())
+            return result;
+
+        // Partition: the calling thread reads while a spill thread bins and writes
+        const double inv_chunk = 1.0 / p_options.chunk_size;
+        const std::size_t spill_batch = std::max<std::size_t>(p_options.spill_batch, 1);
+        std::map<detail::streaming_cell, detail::streaming_spill> spills;
+        std::atomic<bool> failed{ false };
+        bounded_queue<std::vector<triangle3>> batches(2);
+        std::thread spiller([&]()
+        {
+            std::vector<triangle3> batch;
+            while (batches.pop(batch))
+            {
+                for (const auto& t : batch)
+                {
+                    if (!detail::streaming_is_finite(t))
+                        continue;
+
+                    const vector3 centroid = (t.point1 + t.point2 + t.point3) / 3.0;
+                    detail::streaming_spill& spill = spills[detail::streaming_cell_of(centroid, inv_chunk)];
+                    if (spill.path.empty())
+                        spill.path = (directory.path / ("chunk_" + std::to_string(spills.size()) + ".bin")).string();
+                    spill.buffer.push_back(t);
+                    ++spill.count;
+                    if (spill.buffer.size() >= spill_batch)
+                    {
+                        if (!detail::streaming_append(spill.path, spill.buffer))
+                            failed = true;
+                        spill.buffer.clear();
+                    }
+                }
+            }
+            for (auto& entry : spills)
+            {
+                if (!entry.second.buffer.empty() && !detail::streaming_append(entry.second.path, entry.second.buffer))
+                    failed = true;
+                entry.second.buffer = std::vector<triangle3>{};
+            }
+        });
+
+        const std::size_t read_batch = std::max<std::size_t>(p_options.read_batch, 1);
+        for (;;)
+        {
+            std::vector<triangle3> batch(read_batch);
+            batch.resize(p_source.read(batch.data(), batch.size()));
+            if (batch.empty())
+                break;
+            result.input_triangles += batch.size();
+            batches.push(std::move(batch));
+        }
+        batches.close();
+        spiller.join();
+        if (failed)
+            return result;
+
+        std::vector<const detail::streaming_spill*> chunks;
+        for (const auto& entry : spills)
+        {
+            chunks.push_back(&entry.second);
+            result.max_chunk_triangles = std::max(result.max_chunk_triangles, entry.second.count);
+        }
+        result.chunks = chunks.size();
+
+        // Find the vertices on every chunk's open edges with their normal sums
+        std::vector<detail::streaming_boundary_vertex> boundary;
+        std::mutex boundary_mutex;
+        parallel_for(chunks.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            std::vector<triangle3> triangles;
+            for (std::size_t c = p_begin; c < p_end; ++c)
+            {
+                if (!detail::streaming_load(chunks[c]->path, chunks[c]->count, triangles))
+                {
+                    failed = true;
+                    continue;
+                }
+
+                const detail::streaming_chunk_mesh chunk = detail::streaming_weld(triangles, p_options.weld_tolerance);
+                std::vector<vector3> normals(chunk.mesh.vertices.size(), vector3{ 0.0, 0.0, 0.0 });
+                if (p_options.compute_normals)
+                    detail::streaming_accumulate_normals(chunk.mesh, normals);
+
+                std::lock_guard<std::mutex> lock(boundary_mutex);
+                for (std::size_t i = 0; i < chunk.mesh.vertices.size(); ++i)
+                {
+                    if (chunk.locked[i])
+                        boundary.push_back(detail::streaming_boundary_vertex{ chunk.mesh.vertices[i], normals[i] });
+                }
+            }
+        });
+        if (failed)
+            return result;
+
+        // Sort by position then by normal so the sums are independent of chunk timing
+        std::sort(boundary.begin(), boundary.end(), [](const detail::streaming_boundary_vertex& p_a, const detail::streaming_boundary_vertex& p_b)
+        {
+            return p_a.position < p_b.position ||
+                (p_a.position == p_b.position && p_a.normal < p_b.normal);
+        });
+        std::size_t shared = 0;
+        for (std::size_t i = 0; i < boundary.size(); ++i)
+        {
+            if (shared != 0 && boundary[shared - 1].position == boundary[i].position)
+                boundary[shared - 1].normal += boundary[i].normal;
+            else
+                boundary[shared++] = boundary[i];
+        }
+        boundary.resize(shared);
+        result.boundary_vertices = shared;
+
+        // Process: a loader thread feeds workers while this thread writes in order
+        const std::size_t in_flight = std::max<std::size_t>(p_options.max_chunks_in_flight, 1);
+        const std::size_t worker_count = std::max<std::size_t>(1, std::min<std::size_t>(thread_count(), in_flight));
+        bounded_queue<std::pair<std::size_t, std::vector<triangle3>>> loaded(in_flight);
+        std::mutex done_mutex;
+        std::condition_variable done_changed;
+        std::map<std::size_t, detail::streaming_chunk_output> done;
+        std::size_t written = 0;
+        std::exception_ptr error;
+
+        std::thread loader([&]()
+        {
+            for (std::size_t c = 0; c < chunks.size(); ++c)
+            {
+                {
+                    // Wait until the chunk fits within the in-flight limit
+                    std::unique_lock<std::mutex> lock(done_mutex);
+                    done_changed.wait(lock, [&]() { return c < written + in_flight || failed; });
+                    if (failed)
+                        break;
+                }
+
+                std::vector<triangle3> triangles;
+                if (!detail::streaming_load(chunks[c]->path, chunks[c]->count, triangles))
+                {
+                    std::lock_guard<std::mutex> lock(done_mutex);
+                    failed = true;
+                    done_changed.notify_all();
+                    break;
+                }
+                if (!loaded.push(std::make_pair(c, std::move(triangles))))
+                    break;
+            }
+            loaded.close();
+        });
+
+        std::vector<std::thread> workers;
+        for (std::size_t w = 0; w < worker_count; ++w)
+        {
+            workers.emplace_back([&]()
+            {
+                std::pair<std::size_t, std::vector<triangle3>> item;
+                while (loaded.pop(item))
+                {
+                    try
+                    {
+                        detail::streaming_chunk_output output = detail::streaming_process(item.second, boundary, p_options);
+                        std::lock_guard<std::mutex> lock(done_mutex);
+                        done.emplace(item.first, std::move(output));
+                        done_changed.notify_all();
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(done_mutex);
+                        if (!error)
+                            error = std::current_exception();
+                        failed = true;
+                        done_changed.notify_all();
+                    }
+                }
+            });
+        }
+
+        // Assign global vertex ids, writing each shared vertex once
+        std::vector<std::uint32_t> boundary_id(boundary.size(), no_neighbor);
+        std::uint32_t next_vertex = 0;
+        try
+        {
+            for (std::size_t c = 0; c < chunks.size(); ++c)
+            {
+                detail::streaming_chunk_output output;
+                {
+                    std::unique_lock<std::mutex> lock(done_mutex);
+                    done_changed.wait(lock, [&]() { return done.count(c) != 0 || failed; });
+                    if (failed)
+                        break;
+                    output = std::move(done[c]);
+                    done.erase(c);
+                }
+
+                streamed_chunk chunk;
+                chunk.index = c;
+                chunk.bounds = output.bounds;
+                chunk.first_vertex = next_vertex;
+                std::vector<std::uint32_t> global(output.mesh.vertices.size());
+                for (std::size_t i = 0; i < global.size(); ++i)
+                {
+                    const std::uint32_t shared_index = output.boundary[i];
+                    if (shared_index != no_neighbor && boundary_id[shared_index] != no_neighbor)
+                    {
+                        global[i] = boundary_id[shared_index];
+                        continue;
+                    }
+
+                    global[i] = next_vertex++;
+                    if (shared_index != no_neighbor)
+                        boundary_id[shared_index] = global[i];
+                    chunk.vertices.push_back(output.mesh.vertices[i]);
+                    if (p_options.compute_normals)
+                        chunk.normals.push_back(output.normals[i]);
+                }
+                chunk.indices.reserve(output.mesh.indices.size());
+                for (const std::uint32_t index : output.mesh.indices)
+                    chunk.indices.push_back(global[index]);
+
+                result.output_vertices += chunk.vertices.size();
+                result.output_triangles += chunk.indices.size() / 3;
+                p_sink(chunk);
+
+                std::lock_guard<std::mutex> lock(done_mutex);
+                ++written;
+                done_changed.notify_all();
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (!error)
+                error = std::current_exception();
+            failed = true;
+            done_changed.notify_all();
+        }
+
+        // Unblock and join every stage before reporting
+        loaded.close();
+        loader.join();
+        for (auto& w : workers)
+            w.join();
+        if (error)
+            std::rethrow_exception(error);
+
+        result.ok = !failed;
+        return result;
+    }
+}
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+#include "mesh_aabb3.hpp"
+#include "mesh_profile.hpp"
+
+namespace mesh
+{
+    /// Pair of overlapping broad-phase objects (first < second)
+    struct broad_phase_pair
+    {
+        std::uint32_t first = 0;    ///< Lower object handle
+        std::uint32_t second = 0;   ///< Higher object handle
+
+        /// Pair equality operator
+        friend constexpr bool operator==(const broad_phase_pair& p_a, const broad_phase_pair& p_b)
+        {
+            return p_a.first == p_b.first && p_a.second == p_b.second;
+        }
+
+        /// Pair less than operator
+        friend constexpr bool operator<(const broad_phase_pair& p_a, const broad_phase_pair& p_b)
+        {
+            return p_a.first == p_b.first ? p_a.second < p_b.second : p_a.first < p_b.first;
+        }
+    };
+
+    /// Incremental sweep-and-prune broad phase
+    ///
+    /// Keeps the box end points of every object sorted along each axis. Moving
+    /// objects are re-sorted with insertion sort, which is close to linear when
+    /// objects move little between frames, and every swap of a minimum past a
+    /// maximum (or the reverse) adds or removes one overlapping pair. Callers
+    /// receive only the pairs that changed since the previous update.
+    class sweep_and_prune
+    {
+    public:
+        /// Object handle
+        using handle = std::uint32_t;
+
+        /// Insert an object
+        /// @param p_box                Object bounds
+        /// @return                     Object handle
+        handle insert(const aabb3& p_box)
+        {
+            handle h = 0;
+            insert(&p_box, 1, &h);
+            return h;
+        }
+
+        /// Insert many objects at once
+        ///
+        /// New objects are tested against the sorted objects near them, found by
+        /// a binary search on the X axis widened by the largest object extent,
+        /// and against the objects inserted since the last update. Their end
+        /// points are merged into the axes by the next update, so an insert costs
+        /// time proportional to the batch and its neighborhood, not the world.
+        /// @param p_boxes              Object bounds
+        /// @param p_count              Number of objects
+        /// @param p_handles            Optional output handles (p_count entries)
+        void insert(const aabb3* p_boxes, const std::size_t p_count, handle* p_handles = nullptr)
+        {
+            if (p_count == 0)
+                return;
+
+            // Allocate handles, reusing removed ones first
+            std::vector<handle> created(p_count);
+            for (std::size_t i = 0; i < p_count; ++i)
+            {
+                handle h = 0;
+                if (!m_free.empty())
+                {
+                    h = m_free.back();
+                    m_free.pop_back();
+                }
+                else
+                {
+                    h = static_cast<handle>(m_boxes.size());
+                    m_boxes.emplace_back();
+                    m_alive.push_back(0);
+                    m_partners.emplace_back();
+                }
+
+                m_boxes[h] = p_boxes[i];
+                m_alive[h] = 1;
+                created[i] = h;
+                if (p_handles)
+                    p_handles[i] = h;
+            }
+
+            // Test the new objects against the sorted and pending ones that can reach them
+            for (const handle h : created)
+            {
+                add_window_pairs(h, m_axes[0]);
+                add_window_pairs(h, m_pending);
+            }
+
+            // Sweep the batch against itself along X
+            std::sort(created.begin(), created.end(), [this](const handle p_a, const handle p_b)
+            {
+                return m_boxes[p_a].minimum.x < m_boxes[p_b].minimum.x;
+            });
+            std::vector<handle> active;
+            std::vector<endpoint> minimums;
+            minimums.reserve(created.size());
+            for (const handle h : created)
+            {
+                const aabb3& box = m_boxes[h];
+                active.erase(std::remove_if(active.begin(), active.end(), [&](const handle p_other)
+                {
+                    return m_boxes[p_other].maximum.x < box.minimum.x;
+                }), active.end());
+                for (const handle other : active)
+                {
+                    if (box.intersects(m_boxes[other]))
+                        add_pair(h, other);
+                }
+                active.push_back(h);
+                minimums.push_back(endpoint{ box.minimum.x, h << 1 });
+                m_max_extent = std::max(m_max_extent, box.maximum.x - box.minimum.x);
+            }
+
+            // Queue the batch for the next update
+            merge_endpoints(m_pending, minimums);
+        }
+
+        /// Remove an object
+        /// @param p_handle             Object handle
+        void remove(const handle p_handle)
+        {
+            remove(&p_handle, 1);
+        }
+
+        /// Remove many objects at once
+        ///
+        /// Pairs of removed objects are dropped immediately; their end points
+        /// are compacted away by the next update, so a removal costs only its
+        /// object's pairs. Handles that are not alive (already removed, or
+        /// removed twice in the batch) are ignored.
+        /// @param p_handles            Object handles
+        /// @param p_count              Number of objects
+        void remove(const handle* p_handles, const std::size_t p_count)
+        {
+            for (std::size_t i = 0; i < p_count; ++i)
+            {
+                const handle h = p_handles[i];
+                if (h >= m_alive.size() || !m_alive[h])
+                    continue;
+
+                // Handles are only reused after the next update so their pair changes stay distinct
+                m_alive[h] = 0;
+                m_released.push_back(h);
+                m_compact = true;
+                while (!m_partners[h].empty())
+                    remove_pair(pair_key(h, m_partners[h].back()));
+            }
+        }
+
+        /// Set the bounds of an object (applied by the next update)
+        ///
+        /// Handles that are not alive are ignored.
+        /// @param p_handle             Object handle
+        /// @param p_box                New bounds
+        void set_bounds(const handle p_handle, const aabb3& p_box)
+        {
+            if (p_handle < m_alive.size() && m_alive[p_handle])
+                m_boxes[p_handle] = p_box;
+        }
+
+        /// Get the bounds of an object
+        /// @param p_handle             Object handle
+        /// @return                     Object bounds
+        const aabb3& bounds(const handle p_handle) const
+        {
+            return m_boxes[p_handle];
+        }
+
+        /// Re-sort the end points after objects moved and report changed pairs
+        ///
+        /// Objects inserted since the previous update are merged into the sorted
+        /// axes first. Pairs created and removed by inserts and removals since
+        /// the previous update are reported as well.
+        /// @param p_added              Receives pairs that started overlapping
+        /// @param p_removed            Receives pairs that stopped overlapping
+        void update(std::vector<broad_phase_pair>& p_added, std::vector<broad_phase_pair>& p_removed)
+        {
+            MESH_PROFILE_SCOPE("sweep_prune.update", m_axes[0].size() / 2);
+            compact();
+            merge_pending();
+            m_max_extent = 0.0;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                std::vector<endpoint>& points = m_axes[axis];
+
+                // Refresh end point values from the current bounds
+                for (endpoint& e : points)
+                {
+                    const aabb3& box = m_boxes[e.data >> 1];
+                    e.value = component((e.data & 1) ? box.maximum : box.minimum, axis);
+                    if (axis == 0)
+                        m_max_extent = std::max(m_max_extent, box.maximum.x - box.minimum.x);
+                }
+
+                // Insertion sort, turning each swap into a pair event
+                for (std::size_t i = 1; i < points.size(); ++i)
+                {
+                    const endpoint moving = points[i];
+                    std::size_t j = i;
+                    while (j > 0 && endpoint_less(moving, points[j - 1]))
+                    {
+                        const endpoint& passed = points[j - 1];
+                        const handle a = moving.data >> 1;
+                        const handle b = passed.data >> 1;
+                        const bool moving_max = (moving.data & 1) != 0;
+                        const bool passed_max = (passed.data & 1) != 0;
+                        if (!moving_max && passed_max)
+                        {
+                            // A minimum moved below a maximum: the boxes may now overlap
+                            if (m_boxes[a].intersects(m_boxes[b]))
+                                add_pair(a, b);
+                        }
+                        else if (moving_max && !passed_max)
+                        {
+                            // A maximum moved below a minimum: the boxes are now separated
+                            remove_pair(pair_key(a, b));
+                        }
+
+                        points[j] = points[j - 1];
+                        --j;
+                    }
+                    points[j] = moving;
+                }
+            }
+
+            // Report the net changes since the last update
+            for (const std::uint64_t key : m_added)
+                p_added.push_back(make_pair(key));
+            for (const std::uint64_t key : m_removed)
+                p_removed.push_back(make_pair(key));
+            m_added.clear();
+            m_removed.clear();
+
+            m_free.insert(m_free.end(), m_released.begin(), m_released.end());
+            m_released.clear();
+        }
+
+        /// Get the number of objects
+        std::size_t size() const
+        {
+            return m_boxes.size() - m_free.size() - m_released.size();
+        }
+
+        /// Get the number of overlapping pairs
+        std::size_t pair_count() const
+        {
+            return m_pairs.size();
+        }
+
+        /// Check if two objects currently overlap
+        bool contains_pair(const handle p_a, const handle p_b) const
+        {
+            return m_pairs.count(pair_key(p_a, p_b)) != 0;
+        }
+
+        /// Get all overlapping pairs sorted by handle
+        std::vector<broad_phase_pair> pairs() const
+        {
+            std::vector<broad_phase_pair> result;
+            result.reserve(m_pairs.size());
+            for (const std::uint64_t key : m_pairs)
+                result.push_back(make_pair(key));
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+    private:
+        /// Box end point on one axis
+        struct endpoint
+        {
+            double value;           ///< Coordinate
+            std::uint32_t data;     ///< Handle shifted left by one, low bit set for maximum
+        };
+
+        /// End point ordering; minimums sort before maximums at equal values so touching boxes overlap
+        static bool endpoint_less(const endpoint& p_a, const endpoint& p_b)
+        {
+            if (p_a.value != p_b.value)
+                return p_a.value < p_b.value;
+            return (p_a.data & 1) < (p_b.data & 1);
+        }
+
+        /// Get a vector component by axis index
+        static double component(const vector3& p_v, const int p_axis)
+        {
+            return p_axis == 0 ? p_v.x : p_axis == 1 ? p_v.y : p_v.z;
+        }
+
+        /// Make the key of an unordered pair
+        static std::uint64_t pair_key(const handle p_a, const handle p_b)
+        {
+            const handle lo = std::min(p_a, p_b);
+            const handle hi = std::max(p_a, p_b);
+            return (static_cast<std::uint64_t>(lo) << 32) | hi;
+        }
+
+        /// Make a pair from its key
+        static broad_phase_pair make_pair(const std::uint64_t p_key)
+        {
+            return broad_phase_pair{ static_cast<std::uint32_t>(p_key >> 32), static_cast<std::uint32_t>(p_key & 0xFFFFFFFFu) };
+        }
+
+        /// Record a pair as overlapping
+        void add_pair(const handle p_a, const handle p_b)
+        {
+            const std::uint64_t key = pair_key(p_a, p_b);
+            if (!m_pairs.insert(key).second)
+                return;
+
+            m_partners[p_a].push_back(p_b);
+            m_partners[p_b].push_back(p_a);
+            if (m_removed.erase(key) == 0)
+                m_added.insert(key);
+        }
+
+        /// Record a pair as no longer overlapping
+        void remove_pair(const std::uint64_t p_key)
+        {
+            if (m_pairs.erase(p_key) == 0)
+                return;
+
+            const handle a = static_cast<handle>(p_key >> 32);
+            const handle b = static_cast<handle>(p_key & 0xFFFFFFFFu);
+            drop_partner(a, b);
+            drop_partner(b, a);
+            if (m_added.erase(p_key) == 0)
+                m_removed.insert(p_key);
+        }
+
+        /// Remove one entry from an object's partner list
+        void drop_partner(const handle p_object, const handle p_partner)
+        {
+            std::vector<handle>& partners = m_partners[p_object];
+            const auto it = std::find(partners.begin(), partners.end(), p_partner);
+            *it = partners.back();
+            partners.pop_back();
+        }
+
+        /// Record the pairs between an object and the objects whose minimum X lies in its search window
+        /// @param p_handle             New object
+        /// @param p_points             X end points sorted by value
+        void add_window_pairs(const handle p_handle, const std::vector<endpoint>& p_points)
+        {
+            const aabb3& box = m_boxes[p_handle];
+            const auto first = std::lower_bound(p_points.begin(), p_points.end(), box.minimum.x - m_max_extent, [](const endpoint& p_e, const double p_value)
+            {
+                return p_e.value < p_value;
+            });
+            for (auto it = first; it != p_points.end() && it->value <= box.maximum.x; ++it)
+            {
+                const handle other = it->data >> 1;
+                if (!(it->data & 1) && m_alive[other] && box.intersects(m_boxes[other]))
+                    add_pair(p_handle, other);
+            }
+        }
+
+        /// Sort a batch of end points and merge it into a sorted list from the back
+        static void merge_endpoints(std::vector<endpoint>& p_points, std::vector<endpoint>& p_batch)
+        {
+            std::sort(p_batch.begin(), p_batch.end(), endpoint_less);
+            std::size_t old_end = p_points.size();
+            std::size_t batch_end = p_batch.size();
+            p_points.resize(p_points.size() + p_batch.size());
+            for (std::size_t out = p_points.size(); batch_end > 0;)
+            {
+                if (old_end > 0 && endpoint_less(p_batch[batch_end - 1], p_points[old_end - 1]))
+                    p_points[--out] = p_points[--old_end];
+                else
+                    p_points[--out] = p_batch[--batch_end];
+            }
+        }
+
+        /// Merge the end points of objects inserted since the last update into each axis
+        void merge_pending()
+        {
+            if (m_pending.empty())
+                return;
+
+            std::vector<endpoint> batch;
+            batch.reserve(m_pending.size() * 2);
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                batch.clear();
+                for (const endpoint& e : m_pending)
+                {
+                    const handle h = e.data >> 1;
+                    if (!m_alive[h])
+                        continue;
+
+                    batch.push_back(endpoint{ component(m_boxes[h].minimum, axis), h << 1 });
+                    batch.push_back(endpoint{ component(m_boxes[h].maximum, axis), (h << 1) | 1 });
+                }
+                merge_endpoints(m_axes[axis], batch);
+            }
+            m_pending.clear();
+        }
+
+        /// Drop the end points of removed objects
+        void compact()
+        {
+            if (!m_compact)
+                return;
+
+            for (auto& points : m_axes)
+            {
+                points.erase(std::remove_if(points.begin(), points.end(), [this](const endpoint& p_e)
+                {
+                    return !m_alive[p_e.data >> 1];
+                }), points.end());
+            }
+            m_compact = false;
+        }
+
+        std::vector<aabb3> m_boxes;                 ///< Bounds per handle
+        std::vector<std::uint8_t> m_alive;          ///< Handle in use flags
+        std::vector<handle> m_free;                 ///< Removed handles available for reuse
+        std::vector<handle> m_released;             ///< Handles removed since the last update
+        std::vector<std::vector<handle>> m_partners;///< Overlapping objects per handle
+        std::vector<endpoint> m_axes[3];            ///< Sorted end points per axis
+        std::vector<endpoint> m_pending;            ///< X minimums of objects inserted since the last update
+        bool m_compact = false;                     ///< End points of removed objects remain
+        double m_max_extent = 0.0;                  ///< Largest X extent of any sorted object
+        std::unordered_set<std::uint64_t> m_pairs;  ///< Current overlapping pairs
+        std::unordered_set<std::uint64_t> m_added;  ///< Pairs added since the last update
+        std::unordered_set<std::uint64_t> m_removed;///< Pairs removed since the last update
+    };
+}
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "mesh_bvh.hpp"
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+#include "mesh_transform3.hpp"
+
+namespace mesh
+{
+    /// Placement of a shared bottom-level hierarchy in the scene
+    struct tlas_instance
+    {
+        const mesh_bvh* bvh = nullptr;  ///< Shared bottom-level hierarchy (object space)
+        transform3 transform;           ///< Object to world transform
+        transform3 inverse;             ///< World to object transform
+        aabb3 bounds;                   ///< World bounds (empty for singular transforms)
+    };
+
+    /// Result of a ray query against instances
+    struct tlas_ray_hit
+    {
+        bool hit = false;               ///< True if the ray hit a triangle
+        double distance = std::numeric_limits<double>::infinity();     ///< Distance along the ray (in units of the direction length)
+        std::uint32_t instance = 0;     ///< Instance hit
+        std::uint32_t triangle = 0;     ///< Mesh triangle index within the instance's mesh
+    };
+
+    /// Two-level acceleration structure over transformed instances
+    ///
+    /// The top level is a small SAH hierarchy over instance world bounds. Its
+    /// leaves point to shared mesh_bvh hierarchies, so a part used by many
+    /// instances is stored once. Rays are moved into object space when they
+    /// reach an instance; an affine transform keeps the ray parameter, so
+    /// distances compare directly across instances. Changing transforms only
+    /// needs the top level rebuilt. Bottom-level hierarchies must outlive the
+    /// structure and must not be rebuilt or refitted without calling build().
+    class mesh_tlas
+    {
+    public:
+        /// Add an instance
+        ///
+        /// Takes effect at the next build().
+        /// @param p_bvh                Shared bottom-level hierarchy
+        /// @param p_transform          Object to world transform
+        /// @return                     Instance index
+        std::uint32_t add_instance(const mesh_bvh& p_bvh, const transform3& p_transform = transform3())
+        {
+            m_instances.push_back(tlas_instance());
+            m_instances.back().bvh = &p_bvh;
+            set_transform(static_cast<std::uint32_t>(m_instances.size() - 1), p_transform);
+            return static_cast<std::uint32_t>(m_instances.size() - 1);
+        }
+
+        /// Move an instance
+        ///
+        /// Takes effect at the next build(). Instances with a singular transform
+        /// are never hit.
+        /// @param p_instance           Instance index
+        /// @param p_transform          Object to world transform
+        void set_transform(const std::uint32_t p_instance, const transform3& p_transform)
+        {
+            tlas_instance& instance = m_instances[p_instance];
+            instance.transform = p_transform;
+            if (p_transform.determinant() == 0.0 || instance.bvh->empty())
+            {
+                instance.inverse = transform3();
+                instance.bounds = aabb3::empty();
+                return;
+            }
+            instance.inverse = p_transform.inverse();
+            instance.bounds = world_bounds(*instance.bvh, p_transform);
+        }
+
+        /// Remove every instance
+        void clear()
+        {
+            m_instances.clear();
+            m_nodes.clear();
+            m_order.clear();
+        }
+
+        /// Get the instances
+        const std::vector<tlas_instance>& instances() const
+        {
+            return m_instances;
+        }
+
+        /// Get the top-level nodes (the root is node zero, leaves index instance_order())
+        const std::vector<bvh_node>& nodes() const
+        {
+            return m_nodes;
+        }
+
+        /// Get the instance index of each leaf entry
+        const std::vector<std::uint32_t>& instance_order() const
+        {
+            return m_order;
+        }
+
+        /// Rebuild the top level from the current instance bounds
+        ///
+        /// Bottom-level hierarchies are not touched.
+        void build()
+        {
+            MESH_PROFILE_SCOPE("tlas.build", m_instances.size());
+            m_nodes.clear();
+            m_order.clear();
+            std::vector<vector3> centroids(m_instances.size());
+            for (std::uint32_t i = 0; i < m_instances.size(); ++i)
+            {
+                if (m_instances[i].bounds.is_empty())
+                    continue;
+                centroids[i] = m_instances[i].bounds.center();
+                m_order.push_back(i);
+            }
+            if (m_order.empty())
+                return;
+
+            m_nodes.reserve(m_order.size() * 2);
+            m_nodes.push_back(bvh_node{});
+            subdivide(0, 0, static_cast<std::uint32_t>(m_order.size()), 0, centroids);
+        }
+
+        /// Find the first triangle hit by a ray
+        /// @param p_origin             Ray origin
+        /// @param p_direction          Ray direction
+        /// @param p_max_distance       Maximum hit distance (in units of the direction length)
+        /// @return                     Closest hit (hit is false on a miss)
+        tlas_ray_hit intersect_ray(const vector3& p_origin, const vector3& p_direction, const double p_max_distance = std::numeric_limits<double>::infinity()) const
+        {
+            tlas_ray_hit result;
+            result.distance = p_max_distance;
+            if (m_nodes.empty())
+                return result;
+
+            const vector3 inv{ 1.0 / p_direction.x, 1.0 / p_direction.y, 1.0 / p_direction.z };
+            std::uint32_t stack[stack_size];
+            std::size_t top = 0;
+            stack[top++] = 0;
+            while (top != 0)
+            {
+                const bvh_node& node = m_nodes[stack[--top]];
+                if (!node.bounds.intersect_ray_inv(p_origin, inv, result.distance))
+                    continue;
+
+                if (node.is_leaf())
+                {
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                    {
+                        // Descend into object space
+                        const tlas_instance& instance = m_instances[m_order[i]];
+                        const bvh_ray_hit hit = instance.bvh->intersect_ray(instance.inverse.transform_point(p_origin), instance.inverse.transform_direction(p_direction), result.distance);
+                        if (hit.hit)
+                        {
+                            result.hit = true;
+                            result.distance = hit.distance;
+                            result.instance = m_order[i];
+                            result.triangle = hit.triangle;
+                        }
+                    }
+                    continue;
+                }
+
+                // Visit the child on the near side of the ray first
+                const bool left_first = p_direction.dot(m_nodes[node.first + 1].bounds.center() - m_nodes[node.first].bounds.center()) >= 0.0;
+                stack[top++] = left_first ? node.first + 1 : node.first;
+                stack[top++] = left_first ? node.first : node.first + 1;
+            }
+            return result;
+        }
+
+        /// Intersect a batch of rays in parallel
+        /// @param p_origins            Ray origins
+        /// @param p_directions         Ray directions
+        /// @param p_count              Number of rays
+        /// @param p_results            Receives one hit per ray
+        /// @param p_max_distance       Maximum hit distance (in units of the direction length)
+        void intersect_rays(const vector3* p_origins, const vector3* p_directions, const std::size_t p_count, tlas_ray_hit* p_results, const double p_max_distance = std::numeric_limits<double>::infinity()) const
+        {
+            MESH_PROFILE_SCOPE("tlas.intersect_rays", p_count);
+            parallel_for(p_count, [&](const std::size_t p_begin, const std::size_t p_end)
+            {
+                for (std::size_t i = p_begin; i < p_end; ++i)
+                    p_results[i] = intersect_ray(p_origins[i], p_directions[i], p_max_distance);
+            }, 256);
+        }
+
+    private:
+        /// Deepest level split, keeping traversal stacks within stack_size entries
+        static constexpr std::uint32_t max_depth = 60;
+
+        /// Traversal stack capacity
+        static constexpr std::size_t stack_size = 64;
+
+        /// Number of bins per axis when evaluating the surface area heuristic
+        static constexpr std::uint32_t bin_count = 16;
+
+        /// Bound a transformed hierarchy
+        ///
+        /// Transforming a few nodes below the root gives tighter bounds than
+        /// transforming the root box when the instance is rotated.
+        static aabb3 world_bounds(const mesh_bvh& p_bvh, const transform3& p_transform)
+        {
+            const std::vector<bvh_node>& nodes = p_bvh.nodes();
+            std::uint32_t frontier[8] = { 0 };
+            std::size_t count = 1;
+            for (bool split = true; split;)
+            {
+                split = false;
+                for (std::size_t i = 0, level = count; i < level && count < 8; ++i)
+                {
+                    if (nodes[frontier[i]].is_leaf())
+                        continue;
+                    const std::uint32_t first = nodes[frontier[i]].first;
+                    frontier[i] = first;
+                    frontier[count++] = first + 1;
+                    split = true;
+                }
+            }
+
+            aabb3 bounds = aabb3::empty();
+            for (std::size_t i = 0; i < count; ++i)
+                bounds.expand(p_transform.transform_box(nodes[frontier[i]].bounds));
+            return bounds;
+        }
+
+        /// Split a node's instances with the binned surface area heuristic
+        void subdivide(const std::uint32_t p_node, const std::uint32_t p_begin, const std::uint32_t p_end, const std::uint32_t p_depth, const std::vector<vector3>& p_centroids)
+        {
+            aabb3 bounds = aabb3::empty();
+            aabb3 centroid_bounds = aabb3::empty();
+            for (std::uint32_t i = p_begin; i < p_end; ++i)
+            {
+                bounds.expand(m_instances[m_order[i]].bounds);
+                centroid_bounds.expand(p_centroids[m_order[i]]);
+            }
+            m_nodes[p_node].bounds = bounds;
+            m_nodes[p_node].first = p_begin;
+            m_nodes[p_node].count = p_end - p_begin;
+
+            const std::uint32_t count = p_end - p_begin;
+            if (count <= 1 || p_depth >= max_depth)
+                return;
+
+            // Sweep the bins of every axis for the cheapest split
+            struct bin
+            {
+                aabb3 bounds = aabb3::empty();
+                std::uint32_t count = 0;
+            };
+
+            double best_cost = std::numeric_limits<double>::infinity();
+            int best_axis = -1;
+            std::uint32_t best_split = 0;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const double lo = component(centroid_bounds.minimum, axis);
+                const double hi = component(centroid_bounds.maximum, axis);
+                if (!(hi > lo))
+                    continue;
+
+                bin bins[bin_count];
+                const double scale = bin_count / (hi - lo);
+                for (std::uint32_t i = p_begin; i < p_end; ++i)
+                {
+                    bin& b = bins[bin_of(component(p_centroids[m_order[i]], axis), lo, scale)];
+                    b.bounds.expand(m_instances[m_order[i]].bounds);
+                    ++b.count;
+                }
+
+                double right_cost[bin_count] = {};
+                aabb3 box = aabb3::empty();
+                std::uint32_t n = 0;
+                for (std::uint32_t s = bin_count - 1; s > 0; --s)
+                {
+                    box.expand(bins[s].bounds);
+                    n += bins[s].count;
+                    right_cost[s] = n == 0 ? 0.0 : box.surface_area() * n;
+                }
+                box = aabb3::empty();
+                n = 0;
+                for (std::uint32_t s = 1; s < bin_count; ++s)
+                {
+                    box.expand(bins[s - 1].bounds);
+                    n += bins[s - 1].count;
+                    if (n == 0 || n == count)
+                        continue;
+
+                    const double cost = box.surface_area() * n + right_cost[s];
+                    if (cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_split = s;
+                    }
+                }
+            }
+
+            // Instances sharing a centroid stay together in one leaf
+            if (best_axis < 0)
+                return;
+
+            const double lo = component(centroid_bounds.minimum, best_axis);
+            const double scale = bin_count / (component(centroid_bounds.maximum, best_axis) - lo);
+            const auto middle = std::partition(m_order.begin() + p_begin, m_order.begin() + p_end, [&](const std::uint32_t p_i)
+            {
+                return bin_of(component(p_centroids[p_i], best_axis), lo, scale) < best_split;
+            });
+            const std::uint32_t split = static_cast<std::uint32_t>(middle - m_order.begin());
+
+            const std::uint32_t left = static_cast<std::uint32_t>(m_nodes.size());
+            m_nodes.push_back(bvh_node{});
+            m_nodes.push_back(bvh_node{});
+            m_nodes[p_node].first = left;
+            m_nodes[p_node].count = 0;
+            subdivide(left, p_begin, split, p_depth + 1, p_centroids);
+            subdivide(left + 1, split, p_end, p_depth + 1, p_centroids);
+        }
+
+        /// Get a component of a vector by axis
+        static double component(const vector3& p_v, const int p_axis)
+        {
+            return p_axis == 0 ? p_v.x : p_axis == 1 ? p_v.y : p_v.z;
+        }
+
+        /// Get the bin of a centroid coordinate
+        static std::uint32_t bin_of(const double p_value, const double p_lo, const double p_scale)
+        {
+            return std::min(static_cast<std::uint32_t>(std::max((p_value - p_lo) * p_scale, 0.0)), bin_count - 1);
+        }
+
+        std::vector<tlas_instance> m_instances;
+        std::vector<bvh_node> m_nodes;
+        std::vector<std::uint32_t> m_order;
+    };
+}
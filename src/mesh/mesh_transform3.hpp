@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cmath>
+
+#include "mesh_aabb3.hpp"
+
+namespace mesh
+{
+    /// 3D affine transform
+    ///
+    /// Maps a point p to x_axis * p.x + y_axis * p.y + z_axis * p.z + origin,
+    /// i.e. the columns of the linear part are the images of the unit axes.
+    struct transform3
+    {
+        vector3 x_axis; ///< Image of the X axis
+        vector3 y_axis; ///< Image of the Y axis
+        vector3 z_axis; ///< Image of the Z axis
+        vector3 origin; ///< Translation
+
+        /// Construct the identity transform
+		constexpr transform3()
+			: x_axis(1.0, 0.0, 0.0), y_axis(0.0, 1.0, 0.0), z_axis(0.0, 0.0, 1.0), origin(0.0, 0.0, 0.0)
+		{
+		}
+
+        /// Construct a transform from its axes and translation
+        /// @param p_x_axis             Image of the X axis
+        /// @param p_y_axis             Image of the Y axis
+        /// @param p_z_axis             Image of the Z axis
+        /// @param p_origin             Translation
+		constexpr explicit transform3(const vector3& p_x_axis, const vector3& p_y_axis, const vector3& p_z_axis, const vector3& p_origin = vector3{})
+			: x_axis(p_x_axis), y_axis(p_y_axis), z_axis(p_z_axis), origin(p_origin)
+		{
+		}
+
+        /// Construct a translation
+        /// @param p_offset             Translation
+        /// @return                     Transform
+        static constexpr transform3 translation(const vector3& p_offset)
+		{
+			return transform3{ vector3{ 1.0, 0.0, 0.0 }, vector3{ 0.0, 1.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 }, p_offset };
+		}
+
+        /// Construct a scale about the origin
+        /// @param p_scale              Scale per axis
+        /// @return                     Transform
+        static constexpr transform3 scaling(const vector3& p_scale)
+		{
+			return transform3{ vector3{ p_scale.x, 0.0, 0.0 }, vector3{ 0.0, p_scale.y, 0.0 }, vector3{ 0.0, 0.0, p_scale.z } };
+		}
+
+        /// Construct a rotation about an axis through the origin
+        /// @param p_axis               Rotation axis (need not be normalized)
+        /// @param p_angle              Angle in radians, counter-clockwise looking down the axis
+        /// @return                     Transform
+        static transform3 rotation(const vector3& p_axis, const double p_angle)
+		{
+			const vector3 a = p_axis.normalized();
+			const double c = std::cos(p_angle);
+			const double s = std::sin(p_angle);
+			const double t = 1.0 - c;
+			return transform3{
+				vector3{ t * a.x * a.x + c, t * a.x * a.y + s * a.z, t * a.x * a.z - s * a.y },
+				vector3{ t * a.x * a.y - s * a.z, t * a.y * a.y + c, t * a.y * a.z + s * a.x },
+				vector3{ t * a.x * a.z + s * a.y, t * a.y * a.z - s * a.x, t * a.z * a.z + c }
+			};
+		}
+
+        /// Calculate the determinant of the linear part
+        /// @return                     Determinant (negative if the transform mirrors)
+        constexpr double determinant() const
+		{
+			return x_axis.dot(y_axis.cross(z_axis));
+		}
+
+        /// Transform a point
+        /// @param p_point              Point
+        /// @return                     Transformed point
+        constexpr vector3 transform_point(const vector3& p_point) const
+		{
+			return x_axis * p_point.x + y_axis * p_point.y + z_axis * p_point.z + origin;
+		}
+
+        /// Transform a direction, ignoring the translation
+        /// @param p_direction          Direction
+        /// @return                     Transformed direction
+        constexpr vector3 transform_direction(const vector3& p_direction) const
+		{
+			return x_axis * p_direction.x + y_axis * p_direction.y + z_axis * p_direction.z;
+		}
+
+        /// Transform a surface normal with the inverse transpose
+        ///
+        /// Uses the cofactor matrix, so the result is not normalized but keeps
+        /// pointing out of the surface when the transform mirrors.
+        /// @param p_normal             Normal
+        /// @return                     Transformed normal
+        constexpr vector3 transform_normal(const vector3& p_normal) const
+		{
+			const vector3 n = y_axis.cross(z_axis) * p_normal.x + z_axis.cross(x_axis) * p_normal.y + x_axis.cross(y_axis) * p_normal.z;
+			return determinant() < 0.0 ? -n : n;
+		}
+
+        /// Transform a box, returning the bounds of the transformed box
+        /// @param p_box                Box
+        /// @return                     Axis-aligned bounds (empty if the box is empty)
+        constexpr aabb3 transform_box(const aabb3& p_box) const
+		{
+			if (p_box.is_empty())
+				return p_box;
+
+			// Arvo: the center moves, the half size spreads by the absolute matrix
+			const vector3 center = transform_point(p_box.center());
+			const vector3 half = p_box.size() * 0.5;
+			const vector3 extent{
+				cabs(x_axis.x) * half.x + cabs(y_axis.x) * half.y + cabs(z_axis.x) * half.z,
+				cabs(x_axis.y) * half.x + cabs(y_axis.y) * half.y + cabs(z_axis.y) * half.z,
+				cabs(x_axis.z) * half.x + cabs(y_axis.z) * half.y + cabs(z_axis.z) * half.z
+			};
+			return aabb3{ center - extent, center + extent };
+		}
+
+        /// Calculate the inverse transform
+        ///
+        /// The transform must be invertible (non-zero determinant).
+        /// @return                     Inverse transform
+        constexpr transform3 inverse() const
+		{
+			// Rows of the inverse linear part are the cofactor columns over the determinant
+			const double inv_det = 1.0 / determinant();
+			const vector3 r0 = y_axis.cross(z_axis) * inv_det;
+			const vector3 r1 = z_axis.cross(x_axis) * inv_det;
+			const vector3 r2 = x_axis.cross(y_axis) * inv_det;
+			const transform3 linear{ vector3{ r0.x, r1.x, r2.x }, vector3{ r0.y, r1.y, r2.y }, vector3{ r0.z, r1.z, r2.z } };
+			return transform3{ linear.x_axis, linear.y_axis, linear.z_axis, -linear.transform_direction(origin) };
+		}
+
+        /// Check if transform is approximately equal to another transform
+        /// @param p_t                  Transform to compare with
+        /// @return                     True if equal
+        constexpr bool is_equal_approx(const transform3& p_t) const
+		{
+			return x_axis.is_equal_approx(p_t.x_axis) &&
+				y_axis.is_equal_approx(p_t.y_axis) &&
+				z_axis.is_equal_approx(p_t.z_axis) &&
+				origin.is_equal_approx(p_t.origin);
+		}
+
+        /// Compose transforms
+        /// @param p_a                  Outer transform
+        /// @param p_b                  Inner transform (applied first)
+        /// @return                     Transform applying p_b then p_a
+        friend constexpr transform3 operator*(const transform3& p_a, const transform3& p_b)
+		{
+			return transform3{
+				p_a.transform_direction(p_b.x_axis),
+				p_a.transform_direction(p_b.y_axis),
+				p_a.transform_direction(p_b.z_axis),
+				p_a.transform_point(p_b.origin)
+			};
+		}
+
+        /// Transform equality operator
+        /// @param p_a                  First transform
+        /// @param p_b                  Second transform
+        /// @return                     True if equal
+        friend constexpr bool operator==(const transform3& p_a, const transform3& p_b)
+		{
+			return p_a.x_axis == p_b.x_axis && p_a.y_axis == p_b.y_axis && p_a.z_axis == p_b.z_axis && p_a.origin == p_b.origin;
+		}
+
+        /// Transform inequality operator
+        /// @param p_a                  First transform
+        /// @param p_b                  Second transform
+        /// @return                     True if not equal
+        friend constexpr bool operator!=(const transform3& p_a, const transform3& p_b)
+		{
+			return !(p_a == p_b);
+		}
+    };
+}
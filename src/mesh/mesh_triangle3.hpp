@@ -0,0 +1,606 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "mesh_plane3.hpp"
+
+namespace mesh
+{
+    namespace detail
+    {
+        /// Snap a signed distance to zero when it is within tolerance
+        /// @param p_value              Signed distance
+        /// @return                     Snapped signed distance
+        constexpr double snap_zero(const double p_value)
+        {
+            return is_zero_approx(p_value) ? 0.0 : p_value;
+        }
+
+        /// Get the index of the largest absolute component of a vector
+        /// @param p_v                  Vector to test
+        /// @return                     0 for x, 1 for y, 2 for z
+        constexpr int dominant_axis(const vector3& p_v)
+        {
+            const double ax = cabs(p_v.x);
+            const double ay = cabs(p_v.y);
+            const double az = cabs(p_v.z);
+            if (ax >= ay && ax >= az)
+                return 0;
+            return ay >= az ? 1 : 2;
+        }
+
+        /// Project a point onto the 2D plane perpendicular to an axis
+        /// @param p_v                  Point to project
+        /// @param p_axis               Axis to drop
+        /// @param p_u                  Output first coordinate
+        /// @param p_w                  Output second coordinate
+        constexpr void project_axis(const vector3& p_v, const int p_axis, double& p_u, double& p_w)
+        {
+            p_u = p_axis == 0 ? p_v.y : p_v.x;
+            p_w = p_axis == 2 ? p_v.y : p_v.z;
+        }
+
+        /// Calculate the 2D orientation of three points
+        /// @return                     Twice the signed area of the triangle
+        constexpr double orient2(const double p_ax, const double p_ay, const double p_bx, const double p_by, const double p_cx, const double p_cy)
+        {
+            return (p_bx - p_ax) * (p_cy - p_ay) - (p_by - p_ay) * (p_cx - p_ax);
+        }
+
+        /// Test if two 2D segments intersect (including touching)
+        constexpr bool segments_intersect2(
+            const double p_ax, const double p_ay, const double p_bx, const double p_by,
+            const double p_cx, const double p_cy, const double p_dx, const double p_dy)
+        {
+            const int o1 = get_sign(orient2(p_ax, p_ay, p_bx, p_by, p_cx, p_cy));
+            const int o2 = get_sign(orient2(p_ax, p_ay, p_bx, p_by, p_dx, p_dy));
+            const int o3 = get_sign(orient2(p_cx, p_cy, p_dx, p_dy, p_ax, p_ay));
+            const int o4 = get_sign(orient2(p_cx, p_cy, p_dx, p_dy, p_bx, p_by));
+
+            // Collinear segments only intersect if their extents overlap
+            if (o1 == 0 && o2 == 0)
+            {
+                const bool x_overlap = std::max(p_ax, p_bx) >= std::min(p_cx, p_dx) && std::max(p_cx, p_dx) >= std::min(p_ax, p_bx);
+                const bool y_overlap = std::max(p_ay, p_by) >= std::min(p_cy, p_dy) && std::max(p_cy, p_dy) >= std::min(p_ay, p_by);
+                return x_overlap && y_overlap;
+            }
+
+            // Otherwise each segment must straddle the other
+            return o1 != o2 && o3 != o4;
+        }
+
+        /// Test if a 2D point is inside (or on the boundary of) a 2D triangle
+        constexpr bool point_in_triangle2(
+            const double p_px, const double p_py,
+            const double p_ax, const double p_ay, const double p_bx, const double p_by, const double p_cx, const double p_cy)
+        {
+            const int s1 = get_sign(orient2(p_ax, p_ay, p_bx, p_by, p_px, p_py));
+            const int s2 = get_sign(orient2(p_bx, p_by, p_cx, p_cy, p_px, p_py));
+            const int s3 = get_sign(orient2(p_cx, p_cy, p_ax, p_ay, p_px, p_py));
+            const bool has_neg = s1 < 0 || s2 < 0 || s3 < 0;
+            const bool has_pos = s1 > 0 || s2 > 0 || s3 > 0;
+            return !(has_neg && has_pos);
+        }
+    }
+
+    /// 3D Triangle
+    struct triangle3
+    {
+        vector3 point1; ///< First point
+        vector3 point2; ///< Second point
+        vector3 point3; ///< Third point
+
+        /// Default constructor
+        triangle3() = default;
+
+        /// Construct a triangle from three points
+        /// @param p_point1             First point
+        /// @param p_point2             Second point
+        /// @param p_point3             Third point
+        constexpr explicit triangle3(const vector3& p_point1, const vector3& p_point2, const vector3& p_point3)
+            : point1(p_point1), point2(p_point2), point3(p_point3)
+        {
+        }
+
+        /// Calculate the unnormalized triangle normal (length is twice the area)
+        /// @return                     Unnormalized normal
+        constexpr vector3 normal() const
+        {
+            return (point2 - point1).cross(point3 - point1);
+        }
+
+        /// Calculate the triangle plane
+        /// @return                     Triangle plane
+        constexpr plane3 plane() const
+        {
+            return plane3{ point1, point2, point3 };
+        }
+
+        /// Check if triangle is degenerate (zero area)
+        /// @return                     True if degenerate
+        constexpr bool is_degenerate() const
+        {
+            return normal().is_zero_approx();
+        }
+
+        /// Calculate the closest point on the triangle to a point
+        /// @param p_point              Point to test
+        /// @return                     Closest point on the triangle
+        constexpr vector3 closest_point(const vector3& p_point) const
+        {
+            // Check if the point is in the vertex region outside point1
+            const vector3 ab = point2 - point1;
+            const vector3 ac = point3 - point1;
+            const vector3 ap = p_point - point1;
+            const double d1 = ab.dot(ap);
+            const double d2 = ac.dot(ap);
+            if (d1 <= 0.0 && d2 <= 0.0)
+                return point1;
+
+            // Check if the point is in the vertex region outside point2
+            const vector3 bp = p_point - point2;
+            const double d3 = ab.dot(bp);
+            const double d4 = ac.dot(bp);
+            if (d3 >= 0.0 && d4 <= d3)
+                return point2;
+
+            // Check if the point is in the edge region of point1-point2
+            const double vc = d1 * d4 - d3 * d2;
+            if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+                return point1 + ab * (d1 / (d1 - d3));
+
+            // Check if the point is in the vertex region outside point3
+            const vector3 cp = p_point - point3;
+            const double d5 = ab.dot(cp);
+            const double d6 = ac.dot(cp);
+            if (d6 >= 0.0 && d5 <= d6)
+                return point3;
+
+            // Check if the point is in the edge region of point1-point3
+            const double vb = d5 * d2 - d1 * d6;
+            if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+                return point1 + ac * (d2 / (d2 - d6));
+
+            // Check if the point is in the edge region of point2-point3
+            const double va = d3 * d6 - d5 * d4;
+            if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+                return point2 + (point3 - point2) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+            // Otherwise the point projects inside the face
+            const double denom = 1.0 / (va + vb + vc);
+            return point1 + ab * (vb * denom) + ac * (vc * denom);
+        }
+
+        /// Calculate squared distance from triangle to point
+        /// @param p_point              Point to measure
+        /// @return                     Squared distance
+        constexpr double distance2_to(const vector3& p_point) const
+        {
+            return (closest_point(p_point) - p_point).length2();
+        }
+
+        /// Calculate the signed solid angle the triangle subtends at a point
+        ///
+        /// Summed over a closed, outward-facing mesh this is 4*pi for inside points
+        /// and zero for outside points (Van Oosterom and Strackee).
+        /// @param p_point              Point to measure from
+        /// @return                     Solid angle in steradians
+        double solid_angle(const vector3& p_point) const
+        {
+            const vector3 a = point1 - p_point;
+            const vector3 b = point2 - p_point;
+            const vector3 c = point3 - p_point;
+            const double la = a.length();
+            const double lb = b.length();
+            const double lc = c.length();
+            const double det = a.dot(b.cross(c));
+            const double div = la * lb * lc + a.dot(b) * lc + b.dot(c) * la + c.dot(a) * lb;
+            return 2.0 * std::atan2(det, div);
+        }
+
+        /// Intersect ray with triangle (Moller-Trumbore)
+        /// @param p_origin             Ray origin
+        /// @param p_direction          Ray direction
+        /// @param p_point              Optional intersection point
+        /// @param p_distance           Optional distance along the ray in units of p_direction
+        /// @return                     True if intersection
+        constexpr bool intersect_ray(const vector3& p_origin, const vector3& p_direction, vector3* p_point = nullptr, double* p_distance = nullptr) const
+        {
+            // Calculate the determinant
+            const vector3 edge1 = point2 - point1;
+            const vector3 edge2 = point3 - point1;
+            const vector3 p = p_direction.cross(edge2);
+            const double det = edge1.dot(p);
+            if (is_zero_approx(det))
+                return false;
+
+            // Calculate the barycentric coordinates
+            const double inv_det = 1.0 / det;
+            const vector3 s = p_origin - point1;
+            const double u = s.dot(p) * inv_det;
+            if (u < 0.0 || u > 1.0)
+                return false;
+
+            const vector3 q = s.cross(edge1);
+            const double v = p_direction.dot(q) * inv_det;
+            if (v < 0.0 || u + v > 1.0)
+                return false;
+
+            // Calculate the distance along the ray to the intersection point
+            const double dist = edge2.dot(q) * inv_det;
+            if (dist < std::numeric_limits<double>::epsilon())
+                return false;
+
+            // Save the optional results
+            if (p_point)
+                *p_point = p_origin + p_direction * dist;
+            if (p_distance)
+                *p_distance = dist;
+
+            return true;
+        }
+
+        /// Intersect segment with triangle
+        /// @param p_point1             Segment start point
+        /// @param p_point2             Segment end point
+        /// @param p_point              Optional intersection point
+        /// @return                     True if intersection
+        constexpr bool intersect_segment(const vector3& p_point1, const vector3& p_point2, vector3* p_point = nullptr) const
+        {
+            const vector3 n = normal();
+            return intersect_segment(n, n.dot(point1), p_point1, p_point2, p_point);
+        }
+
+        /// Intersect segment with triangle using a precomputed (unnormalized) plane
+        /// @param p_normal             Triangle normal as returned by normal()
+        /// @param p_distance           Plane offset normal().dot(point1)
+        /// @param p_point1             Segment start point
+        /// @param p_point2             Segment end point
+        /// @param p_point              Optional intersection point
+        /// @return                     True if intersection
+        constexpr bool intersect_segment(const vector3& p_normal, const double p_distance, const vector3& p_point1, const vector3& p_point2, vector3* p_point = nullptr) const
+        {
+            // Reject if both points are strictly on the same side of the plane
+            const double dist1 = detail::snap_zero(p_normal.dot(p_point1) - p_distance);
+            const double dist2 = detail::snap_zero(p_normal.dot(p_point2) - p_distance);
+            if (dist1 * dist2 > 0.0)
+                return false;
+
+            // Handle a segment lying in the triangle plane
+            if (dist1 == 0.0 && dist2 == 0.0)
+                return intersect_coplanar_segment(p_normal, p_point1, p_point2, p_point);
+
+            // Calculate the plane crossing point
+            const double t = dist1 / (dist1 - dist2);
+            const vector3 point = p_point1.lerp(p_point2, t);
+
+            // The crossing point must be on the inner side of all three edges
+            const double e1 = (point2 - point1).cross(point - point1).dot(p_normal);
+            const double e2 = (point3 - point2).cross(point - point2).dot(p_normal);
+            const double e3 = (point1 - point3).cross(point - point3).dot(p_normal);
+            if (get_sign(e1) < 0 || get_sign(e2) < 0 || get_sign(e3) < 0)
+                return false;
+
+            // Save the optional intersection point
+            if (p_point)
+                *p_point = point;
+
+            return true;
+        }
+
+        /// Intersect triangle with triangle (Moller interval overlap test)
+        /// @param p_t                  Triangle to test
+        /// @return                     True if the triangles intersect or touch
+        constexpr bool intersect_triangle(const triangle3& p_t) const
+        {
+            const vector3 n = normal();
+            return intersect_triangle(n, n.dot(point1), p_t);
+        }
+
+        /// Intersect triangle with triangle using a precomputed (unnormalized) plane
+        /// @param p_normal             Triangle normal as returned by normal()
+        /// @param p_distance           Plane offset normal().dot(point1)
+        /// @param p_t                  Triangle to test
+        /// @return                     True if the triangles intersect or touch
+        constexpr bool intersect_triangle(const vector3& p_normal, const double p_distance, const triangle3& p_t) const
+        {
+            // Signed distances of the other triangle to this plane
+            return intersect_triangle(p_normal,
+                detail::snap_zero(p_normal.dot(p_t.point1) - p_distance),
+                detail::snap_zero(p_normal.dot(p_t.point2) - p_distance),
+                detail::snap_zero(p_normal.dot(p_t.point3) - p_distance),
+                p_t);
+        }
+
+        /// Intersect triangle with triangle using precomputed distances to this plane
+        /// @param p_normal             Triangle normal as returned by normal()
+        /// @param p_du0                Snapped signed distance of p_t.point1 to the plane
+        /// @param p_du1                Snapped signed distance of p_t.point2 to the plane
+        /// @param p_du2                Snapped signed distance of p_t.point3 to the plane
+        /// @param p_t                  Triangle to test
+        /// @return                     True if the triangles intersect or touch
+        constexpr bool intersect_triangle(const vector3& p_normal, const double p_du0, const double p_du1, const double p_du2, const triangle3& p_t) const
+        {
+            const double du0du1 = p_du0 * p_du1;
+            const double du0du2 = p_du0 * p_du2;
+            if (du0du1 > 0.0 && du0du2 > 0.0)
+                return false;
+
+            // Signed distances of this triangle to the other plane
+            const vector3 n2 = p_t.normal();
+            const double d2 = n2.dot(p_t.point1);
+            const double dv0 = detail::snap_zero(n2.dot(point1) - d2);
+            const double dv1 = detail::snap_zero(n2.dot(point2) - d2);
+            const double dv2 = detail::snap_zero(n2.dot(point3) - d2);
+            const double dv0dv1 = dv0 * dv1;
+            const double dv0dv2 = dv0 * dv2;
+            if (dv0dv1 > 0.0 && dv0dv2 > 0.0)
+                return false;
+
+            // Project onto the dominant axis of the intersection line direction
+            const int axis = detail::dominant_axis(p_normal.cross(n2));
+            const double vp0 = component(point1, axis);
+            const double vp1 = component(point2, axis);
+            const double vp2 = component(point3, axis);
+            const double up0 = component(p_t.point1, axis);
+            const double up1 = component(p_t.point2, axis);
+            const double up2 = component(p_t.point3, axis);
+
+            // Calculate the interval of each triangle on the intersection line
+            double a0 = 0.0, a1 = 0.0, b0 = 0.0, b1 = 0.0;
+            if (!compute_interval(vp0, vp1, vp2, dv0, dv1, dv2, dv0dv1, dv0dv2, a0, a1) ||
+                !compute_interval(up0, up1, up2, p_du0, p_du1, p_du2, du0du1, du0du2, b0, b1))
+                return intersect_coplanar_triangle(p_normal, p_t);
+
+            if (a0 > a1)
+                std::swap(a0, a1);
+            if (b0 > b1)
+                std::swap(b0, b1);
+
+            // The triangles intersect if the intervals overlap
+            return !(a1 < b0 || b1 < a0);
+        }
+
+        /// Triangle equality operator
+        /// @param p_a                  First triangle to compare
+        /// @param p_b                  Second triangle to compare
+        /// @return                     True if equal
+        friend constexpr bool operator==(const triangle3& p_a, const triangle3& p_b)
+        {
+            return p_a.point1 == p_b.point1 && p_a.point2 == p_b.point2 && p_a.point3 == p_b.point3;
+        }
+
+        /// Triangle inequality operator
+        /// @param p_a                  First triangle to compare
+        /// @param p_b                  Second triangle to compare
+        /// @return                     True if not equal
+        friend constexpr bool operator!=(const triangle3& p_a, const triangle3& p_b)
+        {
+            return !(p_a == p_b);
+        }
+
+    private:
+        /// Get a vector component by axis index
+        static constexpr double component(const vector3& p_v, const int p_axis)
+        {
+            return p_axis == 0 ? p_v.x : p_axis == 1 ? p_v.y : p_v.z;
+        }
+
+        /// Calculate the interval a triangle covers on the plane intersection line
+        /// @return                     False if the triangle is coplanar
+        static constexpr bool compute_interval(
+            const double p_vv0, const double p_vv1, const double p_vv2,
+            const double p_d0, const double p_d1, const double p_d2,
+            const double p_d0d1, const double p_d0d2,
+            double& p_isect0, double& p_isect1)
+        {
+            if (p_d0d1 > 0.0)
+            {
+                // Point 2 is alone on its side
+                p_isect0 = p_vv2 + (p_vv0 - p_vv2) * p_d2 / (p_d2 - p_d0);
+                p_isect1 = p_vv2 + (p_vv1 - p_vv2) * p_d2 / (p_d2 - p_d1);
+            }
+            else if (p_d0d2 > 0.0)
+            {
+                // Point 1 is alone on its side
+                p_isect0 = p_vv1 + (p_vv0 - p_vv1) * p_d1 / (p_d1 - p_d0);
+                p_isect1 = p_vv1 + (p_vv2 - p_vv1) * p_d1 / (p_d1 - p_d2);
+            }
+            else if (p_d1 * p_d2 > 0.0 || p_d0 != 0.0)
+            {
+                // Point 0 is alone on its side
+                p_isect0 = p_vv0 + (p_vv1 - p_vv0) * p_d0 / (p_d0 - p_d1);
+                p_isect1 = p_vv0 + (p_vv2 - p_vv0) * p_d0 / (p_d0 - p_d2);
+            }
+            else if (p_d1 != 0.0)
+            {
+                p_isect0 = p_vv1 + (p_vv0 - p_vv1) * p_d1 / (p_d1 - p_d0);
+                p_isect1 = p_vv1 + (p_vv2 - p_vv1) * p_d1 / (p_d1 - p_d2);
+            }
+            else if (p_d2 != 0.0)
+            {
+                p_isect0 = p_vv2 + (p_vv0 - p_vv2) * p_d2 / (p_d2 - p_d0);
+                p_isect1 = p_vv2 + (p_vv1 - p_vv2) * p_d2 / (p_d2 - p_d1);
+            }
+            else
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+        /// Intersect a segment lying in the triangle plane
+        constexpr bool intersect_coplanar_segment(const vector3& p_normal, const vector3& p_point1, const vector3& p_point2, vector3* p_point) const
+        {
+            const int axis = detail::dominant_axis(p_normal);
+            double ax = 0.0, ay = 0.0, bx = 0.0, by = 0.0, cx = 0.0, cy = 0.0, px = 0.0, py = 0.0, qx = 0.0, qy = 0.0;
+            detail::project_axis(point1, axis, ax, ay);
+            detail::project_axis(point2, axis, bx, by);
+            detail::project_axis(point3, axis, cx, cy);
+            detail::project_axis(p_point1, axis, px, py);
+            detail::project_axis(p_point2, axis, qx, qy);
+
+            // Report the segment start point when it lies inside the triangle
+            if (detail::point_in_triangle2(px, py, ax, ay, bx, by, cx, cy))
+            {
+                if (p_point)
+                    *p_point = p_point1;
+                return true;
+            }
+            if (detail::point_in_triangle2(qx, qy, ax, ay, bx, by, cx, cy))
+            {
+                if (p_point)
+                    *p_point = p_point2;
+                return true;
+            }
+
+            // Otherwise the segment must cross an edge
+            const bool hit =
+                detail::segments_intersect2(px, py, qx, qy, ax, ay, bx, by) ||
+                detail::segments_intersect2(px, py, qx, qy, bx, by, cx, cy) ||
+                detail::segments_intersect2(px, py, qx, qy, cx, cy, ax, ay);
+            if (hit && p_point)
+                *p_point = p_point1.lerp(p_point2, 0.5);
+            return hit;
+        }
+
+        /// Intersect two triangles lying in the same plane
+        constexpr bool intersect_coplanar_triangle(const vector3& p_normal, const triangle3& p_t) const
+        {
+            const int axis = detail::dominant_axis(p_normal);
+            double v[6] = {};
+            double u[6] = {};
+            detail::project_axis(point1, axis, v[0], v[1]);
+            detail::project_axis(point2, axis, v[2], v[3]);
+            detail::project_axis(point3, axis, v[4], v[5]);
+            detail::project_axis(p_t.point1, axis, u[0], u[1]);
+            detail::project_axis(p_t.point2, axis, u[2], u[3]);
+            detail::project_axis(p_t.point3, axis, u[4], u[5]);
+
+            // Test all edges of this triangle against all edges of the other
+            for (int i = 0; i < 3; ++i)
+            {
+                const int i1 = i * 2;
+                const int i2 = ((i + 1) % 3) * 2;
+                for (int j = 0; j < 3; ++j)
+                {
+                    const int j1 = j * 2;
+                    const int j2 = ((j + 1) % 3) * 2;
+                    if (detail::segments_intersect2(v[i1], v[i1 + 1], v[i2], v[i2 + 1], u[j1], u[j1 + 1], u[j2], u[j2 + 1]))
+                        return true;
+                }
+            }
+
+            // Finally test if either triangle is entirely inside the other
+            return detail::point_in_triangle2(v[0], v[1], u[0], u[1], u[2], u[3], u[4], u[5]) ||
+                detail::point_in_triangle2(u[0], u[1], v[0], v[1], v[2], v[3], v[4], v[5]);
+        }
+    };
+
+    /// Intersect one triangle against a packed list of triangles
+    /// @param p_triangle           Triangle to test
+    /// @param p_triangles          Packed list of candidate triangles
+    /// @param p_count              Number of candidate triangles
+    /// @param p_results            Optional per-candidate results (p_count entries)
+    /// @return                     Number of intersecting candidates
+    inline std::size_t intersect_triangles(const triangle3& p_triangle, const triangle3* p_triangles, const std::size_t p_count, bool* p_results = nullptr)
+    {
+        // The plane of the query triangle is shared by all candidates
+        const vector3 normal = p_triangle.normal();
+        const plane3 plane{ normal, normal.dot(p_triangle.point1) };
+
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < p_count; ++i)
+        {
+            const triangle3& t = p_triangles[i];
+
+            // The distances also drive the early-out when the candidate is strictly on one side of the plane
+            const double d1 = detail::snap_zero(plane.distance_to(t.point1));
+            const double d2 = detail::snap_zero(plane.distance_to(t.point2));
+            const double d3 = detail::snap_zero(plane.distance_to(t.point3));
+            const bool hit = p_triangle.intersect_triangle(plane.normal, d1, d2, d3, t);
+
+            if (p_results)
+                p_results[i] = hit;
+            if (hit)
+                ++hits;
+        }
+
+        return hits;
+    }
+
+    /// Intersect one triangle against a packed list of segments
+    /// @param p_triangle           Triangle to test
+    /// @param p_points             Packed segment end points (2 * p_count entries)
+    /// @param p_count              Number of segments
+    /// @param p_results            Optional per-segment results (p_count entries)
+    /// @return                     Number of intersecting segments
+    inline std::size_t intersect_segments(const triangle3& p_triangle, const vector3* p_points, const std::size_t p_count, bool* p_results = nullptr)
+    {
+        // The plane of the query triangle is shared by all segments
+        const vector3 normal = p_triangle.normal();
+        const plane3 plane{ normal, normal.dot(p_triangle.point1) };
+
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < p_count; ++i)
+        {
+            const vector3& p1 = p_points[i * 2];
+            const vector3& p2 = p_points[i * 2 + 1];
+
+            // Early-out when the segment is strictly on one side of the plane
+            const double d1 = detail::snap_zero(plane.distance_to(p1));
+            const double d2 = detail::snap_zero(plane.distance_to(p2));
+            const bool hit = !(d1 * d2 > 0.0) &&
+                p_triangle.intersect_segment(plane.normal, plane.distance, p1, p2);
+
+            if (p_results)
+                p_results[i] = hit;
+            if (hit)
+                ++hits;
+        }
+
+        return hits;
+    }
+
+    /// Find the closest of a packed list of triangles to a point
+    ///
+    /// Only triangles closer than the incoming distance are considered, so the
+    /// kernel can be called on successive lists while narrowing the search.
+    /// @param p_triangles          Packed list of candidate triangles
+    /// @param p_count              Number of candidate triangles
+    /// @param p_point              Point to measure
+    /// @param p_distance2          Squared search distance, updated to the closest found
+    /// @param p_closest            Optional closest point on the closest triangle
+    /// @return                     Index of the closest triangle, or p_count if none was closer
+    inline std::size_t closest_triangle(const triangle3* p_triangles, const std::size_t p_count, const vector3& p_point, double& p_distance2, vector3* p_closest = nullptr)
+    {
+        std::size_t best = p_count;
+        for (std::size_t i = 0; i < p_count; ++i)
+        {
+            const vector3 closest = p_triangles[i].closest_point(p_point);
+            const double d2 = (closest - p_point).length2();
+            if (d2 <= p_distance2)
+            {
+                p_distance2 = d2;
+                best = i;
+                if (p_closest)
+                    *p_closest = closest;
+            }
+        }
+
+        return best;
+    }
+
+    /// Find the closest point on a triangle to each of a packed list of points
+    /// @param p_triangle           Triangle to measure
+    /// @param p_points             Packed list of points
+    /// @param p_count              Number of points
+    /// @param p_results            Closest point per input point (p_count entries)
+    inline void closest_points(const triangle3& p_triangle, const vector3* p_points, const std::size_t p_count, vector3* p_results)
+    {
+        for (std::size_t i = 0; i < p_count; ++i)
+            p_results[i] = p_triangle.closest_point(p_points[i]);
+    }
+}
@@ -0,0 +1,609 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_parallel.hpp"
+#include "mesh_profile.hpp"
+#include "mesh_sparse_solver.hpp"
+#include "mesh_vector2.hpp"
+
+namespace mesh
+{
+    /// UV unwrapping options
+    struct unwrap_options
+    {
+        /// Largest angle in radians between a triangle normal and the average normal of its chart
+        double max_chart_angle = 1.0471975511965976;
+
+        /// Atlas width and height in texels
+        std::uint32_t resolution = 1024;
+
+        /// Texels kept free around every chart
+        std::uint32_t padding = 2;
+    };
+
+    /// Packed texture atlas of a mesh
+    struct uv_atlas
+    {
+        std::vector<vector2> uvs;               ///< Texture coordinate of each triangle corner (three per triangle, in [0, 1])
+        std::vector<std::uint32_t> charts;      ///< Chart of each triangle
+        std::size_t chart_count = 0;            ///< Number of charts
+        double texels_per_unit = 0.0;           ///< Scale from surface length to texels
+        double utilization = 0.0;               ///< Fraction of the atlas covered by charts
+        bool ok = false;                        ///< False if the charts did not fit the atlas at any scale (uvs then stay in chart space)
+    };
+
+    /// Placement of a rectangle by skyline_packer
+    struct packed_rect
+    {
+        std::uint32_t x = 0;                    ///< Left edge
+        std::uint32_t y = 0;                    ///< Bottom edge
+        bool rotated = false;                   ///< True if placed rotated by 90 degrees (width and height swapped)
+    };
+
+    /// Skyline bottom-left rectangle packer
+    ///
+    /// Keeps the upper outline of the packed rectangles as a list of
+    /// horizontal segments and places each rectangle, in either orientation,
+    /// where its top edge ends lowest. Inserting is linear in the number of
+    /// segments, which stays small for atlas-sized inputs.
+    class skyline_packer
+    {
+    public:
+        /// Construct an empty packer
+        /// @param p_width              Bin width
+        /// @param p_height             Bin height
+        skyline_packer(const std::uint32_t p_width, const std::uint32_t p_height)
+            : m_width(p_width), m_height(p_height)
+        {
+            m_skyline.push_back(segment{ 0, 0, p_width });
+        }
+
+        /// Place a rectangle
+        /// @param p_width              Rectangle width
+        /// @param p_height             Rectangle height
+        /// @param p_result             Receives the placement
+        /// @return                     False if the rectangle does not fit
+        bool insert(const std::uint32_t p_width, const std::uint32_t p_height, packed_rect& p_result)
+        {
+            std::size_t best = m_skyline.size();
+            std::uint32_t best_top = UINT32_MAX;
+            std::uint32_t best_y = 0;
+            bool best_rotated = false;
+            for (std::size_t i = 0; i < m_skyline.size(); ++i)
+            {
+                for (const bool rotated : { false, true })
+                {
+                    const std::uint32_t w = rotated ? p_height : p_width;
+                    const std::uint32_t h = rotated ? p_width : p_height;
+                    std::uint32_t y = 0;
+                    if (!fit(i, w, h, y) || y + h >= best_top)
+                        continue;
+                    best = i;
+                    best_top = y + h;
+                    best_y = y;
+                    best_rotated = rotated;
+                }
+            }
+            if (best == m_skyline.size())
+                return false;
+
+            p_result.x = m_skyline[best].x;
+            p_result.y = best_y;
+            p_result.rotated = best_rotated;
+            const std::uint32_t w = best_rotated ? p_height : p_width;
+            m_used += std::uint64_t{ p_width } * p_height;
+
+            // Raise the skyline over the rectangle and trim the segments it covers
+            m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t>(best), segment{ p_result.x, best_top, w });
+            const std::uint32_t right = p_result.x + w;
+            std::size_t i = best + 1;
+            while (i < m_skyline.size() && m_skyline[i].x < right)
+            {
+                const std::uint32_t end = m_skyline[i].x + m_skyline[i].width;
+                if (end <= right)
+                {
+                    m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i));
+                    continue;
+                }
+                m_skyline[i].width = end - right;
+                m_skyline[i].x = right;
+                break;
+            }
+            for (std::size_t j = 0; j + 1 < m_skyline.size();)
+            {
+                if (m_skyline[j].y == m_skyline[j + 1].y)
+                {
+                    m_skyline[j].width += m_skyline[j + 1].width;
+                    m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(j + 1));
+                }
+                else
+                    ++j;
+            }
+            return true;
+        }
+
+        /// Get the fraction of the bin covered by placed rectangles
+        /// @return                     Covered fraction
+        double occupancy() const
+        {
+            return static_cast<double>(m_used) / (static_cast<double>(m_width) * static_cast<double>(m_height));
+        }
+
+    private:
+        struct segment
+        {
+            std::uint32_t x;
+            std::uint32_t y;
+            std::uint32_t width;
+        };
+
+        /// Find the height a rectangle rests at when its left edge is at a segment
+        bool fit(const std::size_t p_segment, const std::uint32_t p_width, const std::uint32_t p_height, std::uint32_t& p_y) const
+        {
+            const std::uint32_t x = m_skyline[p_segment].x;
+            if (p_width > m_width - x)
+                return false;
+            std::uint32_t y = 0;
+            std::uint32_t covered = 0;
+            for (std::size_t i = p_segment; covered < p_width; ++i)
+            {
+                y = std::max(y, m_skyline[i].y);
+                if (p_height > m_height - y)
+                    return false;
+                covered += m_skyline[i].width;
+            }
+            p_y = y;
+            return true;
+        }
+
+        std::uint32_t m_width;                  ///< Bin width
+        std::uint32_t m_height;                 ///< Bin height
+        std::uint64_t m_used = 0;               ///< Area of placed rectangles
+        std::vector<segment> m_skyline;         ///< Upper outline from left to right
+    };
+
+    /// Split a mesh into charts of similar normal direction
+    ///
+    /// Charts grow best-first across shared edges from seed triangles in
+    /// index order, accepting a triangle while its normal stays within the
+    /// angle limit of the chart's area-weighted average normal. Charts are
+    /// therefore connected and close to height fields over their average
+    /// plane, which keeps their parameterization free of fold-overs.
+    /// @param p_mesh               Mesh
+    /// @param p_charts             Receives the chart of each triangle
+    /// @param p_max_angle          Largest angle in radians between a triangle normal and its chart normal
+    /// @return                     Number of charts
+    inline std::size_t segment_charts(const indexed_mesh& p_mesh, std::vector<std::uint32_t>& p_charts, const double p_max_angle)
+    {
+        MESH_PROFILE_SCOPE("uv.segment", p_mesh.triangle_count());
+        const std::size_t count = p_mesh.triangle_count();
+        const std::vector<std::uint32_t> neighbors = compute_edge_adjacency(p_mesh);
+        std::vector<vector3> normals(count);
+        parallel_for(count, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            for (std::size_t t = p_begin; t < p_end; ++t)
+                normals[t] = p_mesh.triangle(t).normal();
+        }, 4096);
+
+        const double min_cosine = std::cos(p_max_angle);
+        p_charts.assign(count, no_neighbor);
+        std::uint32_t charts = 0;
+        using item = std::pair<double, std::uint32_t>;
+        std::priority_queue<item, std::vector<item>, std::greater<item>> front;
+        for (std::size_t seed = 0; seed < count; ++seed)
+        {
+            if (p_charts[seed] != no_neighbor)
+                continue;
+
+            // Grow from the seed, cheapest normal deviation first
+            const std::uint32_t chart = charts++;
+            vector3 sum;
+            front.push(item(0.0, static_cast<std::uint32_t>(seed)));
+            while (!front.empty())
+            {
+                const std::uint32_t t = front.top().second;
+                front.pop();
+                if (p_charts[t] != no_neighbor)
+                    continue;
+                const double length = normals[t].length();
+                if (t != seed && (length == 0.0 || normals[t].dot(sum.normalized()) < min_cosine * length))
+                    continue;
+
+                p_charts[t] = chart;
+                sum += normals[t];
+                const vector3 direction = sum.normalized();
+                for (std::size_t e = t * 3; e < t * 3 + 3; ++e)
+                {
+                    const std::uint32_t n = neighbors[e];
+                    if (n != no_neighbor && p_charts[n] == no_neighbor)
+                    {
+                        const double length = normals[n].length();
+                        front.push(item(length > 0.0 ? 1.0 - normals[n].dot(direction) / length : 2.0, n));
+                    }
+                }
+            }
+        }
+        return charts;
+    }
+
+    namespace detail
+    {
+        /// Lay a triangle flat with its first corner at the origin and its first edge along X
+        inline void flatten_triangle(const vector3& p_a, const vector3& p_b, const vector3& p_c, vector2* p_result)
+        {
+            const vector3 ab = p_b - p_a;
+            const vector3 ac = p_c - p_a;
+            const double length = ab.length();
+            p_result[0] = vector2(0.0, 0.0);
+            p_result[1] = vector2(length, 0.0);
+            if (length == 0.0)
+            {
+                p_result[2] = vector2(ac.length(), 0.0);
+                return;
+            }
+            const double x = ab.dot(ac) / length;
+            p_result[2] = vector2(x, ab.cross(ac).length() / length);
+        }
+
+        /// Least squares conformal map of one chart (Levy et al.)
+        ///
+        /// The conformality residual of each triangle is linear in the UVs, so
+        /// the energy is a sparse least squares problem. Pinning two distant
+        /// vertices makes its normal equations positive definite; they are
+        /// solved by conjugate gradients warm-started from a planar projection.
+        inline void conformal_map(const indexed_mesh& p_mesh, const std::uint32_t* p_triangles, const std::size_t p_count, vector2* p_uvs)
+        {
+            // Chart-local vertex numbering
+            std::vector<std::uint32_t> vertices;
+            vertices.reserve(p_count * 3);
+            for (std::size_t i = 0; i < p_count; ++i)
+            {
+                const std::uint32_t* tri = p_mesh.indices.data() + std::size_t{ p_triangles[i] } * 3;
+                vertices.insert(vertices.end(), tri, tri + 3);
+            }
+            std::sort(vertices.begin(), vertices.end());
+            vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+            auto local = [&](const std::uint32_t p_vertex)
+            {
+                return static_cast<std::uint32_t>(std::lower_bound(vertices.begin(), vertices.end(), p_vertex) - vertices.begin());
+            };
+            const std::size_t n = vertices.size();
+
+            // Planar projection onto the chart plane, the fallback and initial guess
+            vector3 normal;
+            for (std::size_t i = 0; i < p_count; ++i)
+                normal += p_mesh.triangle(p_triangles[i]).normal();
+            normal = normal.normalized();
+            const vector3 axis = std::abs(normal.x) < 0.5 ? vector3(1.0, 0.0, 0.0) : vector3(0.0, 1.0, 0.0);
+            const vector3 tangent = normal.cross(axis).normalized();
+            const vector3 bitangent = normal.cross(tangent);
+            std::vector<vector2> uv(n);
+            for (std::size_t v = 0; v < n; ++v)
+                uv[v] = vector2(p_mesh.vertices[vertices[v]].dot(tangent), p_mesh.vertices[vertices[v]].dot(bitangent));
+
+            // Pin two far apart vertices at their projected positions
+            auto farthest = [&](const std::size_t p_from)
+            {
+                std::size_t best = p_from;
+                double best_d = 0.0;
+                for (std::size_t v = 0; v < n; ++v)
+                {
+                    const double d = (p_mesh.vertices[vertices[v]] - p_mesh.vertices[vertices[p_from]]).length2();
+                    if (d > best_d)
+                    {
+                        best_d = d;
+                        best = v;
+                    }
+                }
+                return best;
+            };
+            const std::size_t pin1 = farthest(0);
+            const std::size_t pin2 = farthest(pin1);
+            if (n > 3 && pin1 != pin2)
+            {
+                // Free vertex v has u at slot[v] and v at slot[v] + 1; keeping the coupled
+                // pair adjacent more than halves the incomplete Cholesky CG iterations
+                std::vector<std::uint32_t> slot(n);
+                std::uint32_t free_count = 0;
+                for (std::size_t v = 0; v < n; ++v)
+                    slot[v] = v == pin1 || v == pin2 ? no_neighbor : 2 * free_count++;
+                const std::size_t size = std::size_t{ free_count } * 2;
+
+                struct triplet
+                {
+                    std::uint32_t row;
+                    std::uint32_t column;
+                    double value;
+                };
+                std::vector<triplet> triplets;
+                triplets.reserve(p_count * 72);
+                std::vector<double> rhs(size, 0.0);
+                for (std::size_t i = 0; i < p_count; ++i)
+                {
+                    const std::uint32_t* tri = p_mesh.indices.data() + std::size_t{ p_triangles[i] } * 3;
+                    vector2 flat[3];
+                    flatten_triangle(p_mesh.vertices[tri[0]], p_mesh.vertices[tri[1]], p_mesh.vertices[tri[2]], flat);
+                    const double area = 0.5 * flat[1].x * flat[2].y;
+                    if (!(area > 0.0))
+                        continue;
+
+                    // Residuals u_x - v_y and u_y + v_x scaled by the square root of the area
+                    const double scale = 0.5 / std::sqrt(area);
+                    std::uint32_t var[6];
+                    double value[6];
+                    double rows[2][6];
+                    for (int j = 0; j < 3; ++j)
+                    {
+                        const std::uint32_t v = local(tri[j]);
+                        const vector2 e = flat[(j + 2) % 3] - flat[(j + 1) % 3];
+                        var[j] = slot[v];
+                        var[j + 3] = slot[v] == no_neighbor ? no_neighbor : slot[v] + 1;
+                        value[j] = uv[v].x;
+                        value[j + 3] = uv[v].y;
+                        rows[0][j] = -e.y * scale;
+                        rows[0][j + 3] = -e.x * scale;
+                        rows[1][j] = e.x * scale;
+                        rows[1][j + 3] = -e.y * scale;
+                    }
+                    for (const auto& row : rows)
+                    {
+                        double pinned = 0.0;
+                        for (int a = 0; a < 6; ++a)
+                        {
+                            if (var[a] == no_neighbor)
+                                pinned += row[a] * value[a];
+                        }
+                        for (int a = 0; a < 6; ++a)
+                        {
+                            if (var[a] == no_neighbor)
+                                continue;
+                            rhs[var[a]] -= row[a] * pinned;
+                            for (int b = 0; b < 6; ++b)
+                            {
+                                if (var[b] != no_neighbor)
+                                    triplets.push_back(triplet{ var[a], var[b], row[a] * row[b] });
+                            }
+                        }
+                    }
+                }
+
+                // Merge the triplets into the normal equations
+                std::sort(triplets.begin(), triplets.end(), [](const triplet& p_a, const triplet& p_b)
+                {
+                    return p_a.row < p_b.row || (p_a.row == p_b.row && p_a.column < p_b.column);
+                });
+                sparse_matrix system;
+                system.rows = size;
+                system.cols = size;
+                system.offsets.assign(size + 1, 0);
+                for (std::size_t i = 0; i < triplets.size(); ++i)
+                {
+                    if (i != 0 && triplets[i].row == triplets[i - 1].row && triplets[i].column == triplets[i - 1].column)
+                    {
+                        system.values.back() += triplets[i].value;
+                        continue;
+                    }
+                    system.columns.push_back(triplets[i].column);
+                    system.values.push_back(triplets[i].value);
+                    ++system.offsets[triplets[i].row + 1];
+                }
+                std::partial_sum(system.offsets.begin(), system.offsets.end(), system.offsets.begin());
+
+                std::vector<double> x(size);
+                for (std::size_t v = 0; v < n; ++v)
+                {
+                    if (slot[v] != no_neighbor)
+                    {
+                        x[slot[v]] = uv[v].x;
+                        x[slot[v] + 1] = uv[v].y;
+                    }
+                }
+                sparse_solver solver;
+                sparse_solve_options options;
+                options.max_iterations = 2000;
+                if (solver.setup(system) && solver.solve(rhs.data(), x.data(), options).converged)
+                {
+                    for (std::size_t v = 0; v < n; ++v)
+                    {
+                        if (slot[v] != no_neighbor)
+                            uv[v] = vector2(x[slot[v]], x[slot[v] + 1]);
+                    }
+                }
+            }
+
+            // Keep the winding and match the surface area
+            double area_2d = 0.0;
+            double area_3d = 0.0;
+            for (std::size_t i = 0; i < p_count; ++i)
+            {
+                const std::uint32_t* tri = p_mesh.indices.data() + std::size_t{ p_triangles[i] } * 3;
+                const vector2 a = uv[local(tri[0])];
+                const vector2 b = uv[local(tri[1])];
+                const vector2 c = uv[local(tri[2])];
+                area_2d += 0.5 * ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x));
+                area_3d += 0.5 * p_mesh.triangle(p_triangles[i]).normal().length();
+            }
+            const double scale = std::abs(area_2d) > 0.0 ? std::sqrt(area_3d / std::abs(area_2d)) : 1.0;
+            for (auto& p : uv)
+                p = vector2(area_2d < 0.0 ? -p.x * scale : p.x * scale, p.y * scale);
+
+            // Align the principal axis with X so bounding rectangles are tight
+            vector2 mean;
+            for (const auto& p : uv)
+                mean += p;
+            mean /= static_cast<double>(n);
+            double sxx = 0.0;
+            double sxy = 0.0;
+            double syy = 0.0;
+            for (const auto& p : uv)
+            {
+                const vector2 d = p - mean;
+                sxx += d.x * d.x;
+                sxy += d.x * d.y;
+                syy += d.y * d.y;
+            }
+            const double angle = 0.5 * std::atan2(2.0 * sxy, sxx - syy);
+            const double c = std::cos(angle);
+            const double s = std::sin(angle);
+            for (auto& p : uv)
+            {
+                const vector2 d = p - mean;
+                p = vector2(c * d.x + s * d.y, c * d.y - s * d.x);
+            }
+
+            // Move the chart to the origin
+            vector2 low(uv[0]);
+            for (const auto& p : uv)
+                low = vector2(std::min(low.x, p.x), std::min(low.y, p.y));
+            for (std::size_t i = 0; i < p_count; ++i)
+            {
+                for (std::size_t c3 = 0; c3 < 3; ++c3)
+                {
+                    const std::uint32_t v = p_mesh.indices[std::size_t{ p_triangles[i] } * 3 + c3];
+                    p_uvs[std::size_t{ p_triangles[i] } * 3 + c3] = uv[local(v)] - low;
+                }
+            }
+        }
+    }
+
+    /// Flatten each chart with a least squares conformal map
+    ///
+    /// Charts are solved independently in parallel. Each chart keeps the
+    /// surface area and winding of its triangles, is rotated so its
+    /// principal axis runs along X, and starts at the origin.
+    /// @param p_mesh               Mesh
+    /// @param p_charts             Chart of each triangle
+    /// @param p_chart_count        Number of charts
+    /// @return                     Texture coordinate of each triangle corner, in surface units
+    inline std::vector<vector2> parameterize_charts(const indexed_mesh& p_mesh, const std::vector<std::uint32_t>& p_charts, const std::size_t p_chart_count)
+    {
+        MESH_PROFILE_SCOPE("uv.parameterize", p_mesh.triangle_count());
+
+        // Bucket the triangles by chart
+        std::vector<std::uint32_t> offsets(p_chart_count + 1, 0);
+        for (const std::uint32_t c : p_charts)
+            ++offsets[c + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<std::uint32_t> triangles(p_charts.size());
+        std::vector<std::uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (std::size_t t = 0; t < p_charts.size(); ++t)
+            triangles[cursor[p_charts[t]]++] = static_cast<std::uint32_t>(t);
+
+        std::vector<vector2> uvs(p_mesh.indices.size());
+        parallel_for(p_chart_count, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            for (std::size_t c = p_begin; c < p_end; ++c)
+            {
+                if (offsets[c + 1] - offsets[c] == 1)
+                {
+                    const std::uint32_t t = triangles[offsets[c]];
+                    detail::flatten_triangle(p_mesh.vertices[p_mesh.indices[t * 3]], p_mesh.vertices[p_mesh.indices[t * 3 + 1]], p_mesh.vertices[p_mesh.indices[t * 3 + 2]], uvs.data() + std::size_t{ t } * 3);
+                }
+                else
+                    detail::conformal_map(p_mesh, triangles.data() + offsets[c], offsets[c + 1] - offsets[c], uvs.data());
+            }
+        });
+        return uvs;
+    }
+
+    /// Unwrap a mesh into a packed texture atlas
+    ///
+    /// Segments the mesh into charts, flattens them in parallel, then packs
+    /// their bounding rectangles with a skyline packer. The scale starts
+    /// from the total chart rectangle area and shrinks until every chart
+    /// fits, so all charts share one texel density. If the charts do not fit
+    /// even at the smallest scale, for example because there are more charts
+    /// than padded texels, the atlas is returned unpacked with ok unset.
+    /// @param p_mesh               Mesh
+    /// @param p_options            Unwrapping options
+    /// @return                     Atlas (empty if the mesh has no triangles)
+    inline uv_atlas unwrap_uv(const indexed_mesh& p_mesh, const unwrap_options& p_options = unwrap_options{})
+    {
+        MESH_PROFILE_SCOPE("uv.unwrap", p_mesh.triangle_count());
+        uv_atlas atlas;
+        atlas.chart_count = segment_charts(p_mesh, atlas.charts, p_options.max_chart_angle);
+        atlas.ok = atlas.chart_count == 0;
+        if (atlas.ok)
+            return atlas;
+        atlas.uvs = parameterize_charts(p_mesh, atlas.charts, atlas.chart_count);
+
+        // Chart extents, largest first
+        std::vector<vector2> extents(atlas.chart_count);
+        for (std::size_t i = 0; i < atlas.uvs.size(); ++i)
+        {
+            vector2& e = extents[atlas.charts[i / 3]];
+            e = vector2(std::max(e.x, atlas.uvs[i].x), std::max(e.y, atlas.uvs[i].y));
+        }
+        double rect_area = 0.0;
+        for (const auto& e : extents)
+            rect_area += e.x * e.y;
+        std::vector<std::uint32_t> order(atlas.chart_count);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](const std::uint32_t p_a, const std::uint32_t p_b)
+        {
+            const double a = std::max(extents[p_a].x, extents[p_a].y);
+            const double b = std::max(extents[p_b].x, extents[p_b].y);
+            return a > b || (a == b && p_a < p_b);
+        });
+
+        // Pack at a shrinking scale until everything fits
+        const std::uint32_t padding = p_options.padding;
+        const std::uint32_t usable = p_options.resolution > 2 * padding ? p_options.resolution - padding : 0;
+        if (usable == 0)
+            return atlas;
+        double scale = rect_area > 0.0 ? usable * std::sqrt(0.8 / rect_area) : 1.0;
+        std::vector<packed_rect> placements(atlas.chart_count);
+        bool fits = false;
+        for (int attempt = 0; attempt < 64; ++attempt, scale *= 0.9)
+        {
+            MESH_PROFILE_SCOPE("uv.pack", atlas.chart_count);
+            skyline_packer packer(usable, usable);
+            fits = true;
+            for (std::size_t i = 0; i < order.size() && fits; ++i)
+            {
+                const vector2& e = extents[order[i]];
+                const std::uint32_t w = static_cast<std::uint32_t>(std::ceil(e.x * scale)) + padding;
+                const std::uint32_t h = static_cast<std::uint32_t>(std::ceil(e.y * scale)) + padding;
+                fits = packer.insert(std::max<std::uint32_t>(w, 1), std::max<std::uint32_t>(h, 1), placements[order[i]]);
+            }
+            if (fits)
+                break;
+        }
+        if (!fits)
+            return atlas;
+
+        // Place the charts and normalize to the atlas
+        const double inv_resolution = 1.0 / p_options.resolution;
+        double covered = 0.0;
+        for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+        {
+            const std::uint32_t chart = atlas.charts[t];
+            const packed_rect& place = placements[chart];
+            for (std::size_t c = t * 3; c < t * 3 + 3; ++c)
+            {
+                vector2 p = atlas.uvs[c] * scale;
+                if (place.rotated)
+                    p = vector2(extents[chart].y * scale - p.y, p.x);
+                atlas.uvs[c] = vector2(p.x + place.x + padding, p.y + place.y + padding) * inv_resolution;
+            }
+            const vector2 a = atlas.uvs[t * 3];
+            const vector2 b = atlas.uvs[t * 3 + 1];
+            const vector2 c = atlas.uvs[t * 3 + 2];
+            covered += 0.5 * std::abs((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x));
+        }
+        atlas.texels_per_unit = scale;
+        atlas.utilization = covered;
+        atlas.ok = true;
+        return atlas;
+    }
+}
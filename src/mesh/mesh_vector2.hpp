@@ -24,9 +24,9 @@ namespace mesh
 
         /// Calculate vector length
         /// @return                     Length
-        double length() const
+        constexpr double length() const
 		{
-			return sqrt(x * x + y * y);
+			return csqrt(x * x + y * y);
 		}
 
         /// Calculate vector dot product
@@ -39,7 +39,7 @@ namespace mesh
 
         /// Calculate normalized vector
         /// @return                     Normalized vector
-        vector2 normalized() const
+        constexpr vector2 normalized() const
         {
             const double l = length();
             if (l == 0.0)
@@ -29,9 +29,9 @@ namespace mesh
 
         /// Calculate vector length
         /// @return                     Length
-        double length() const
+        constexpr double length() const
 		{
-			return sqrt(x * x + y * y + z * z);
+			return csqrt(x * x + y * y + z * z);
 		}
 
         /// Calculate vector dot product
@@ -56,7 +56,7 @@ namespace mesh
 
         /// Calculate normalized vector
         /// @return                     Normalized vector
-        vector3 normalized() const
+        constexpr vector3 normalized() const
 		{
             const double l = length();
             if (l == 0.0)
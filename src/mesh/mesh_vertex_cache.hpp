@@ -0,0 +1,336 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_profile.hpp"
+
+namespace mesh
+{
+    /// Post-transform vertex cache statistics of an index buffer
+    struct vertex_cache_statistics
+    {
+        std::size_t transformed = 0;    ///< Vertices transformed (cache misses)
+        double acmr = 0.0;              ///< Average cache miss ratio (transformed per triangle, 0.5 to 3)
+        double atvr = 0.0;              ///< Average transformed vertex ratio (transformed per vertex, 1 is ideal)
+    };
+
+    /// Statistics before and after an index buffer optimization pass
+    struct vertex_cache_report
+    {
+        vertex_cache_statistics before; ///< Statistics of the input order
+        vertex_cache_statistics after;  ///< Statistics of the optimized order
+    };
+
+    namespace detail
+    {
+        /// Vertex to triangle adjacency in compressed rows
+        struct vertex_triangles
+        {
+            std::vector<std::uint32_t> offsets;
+            std::vector<std::uint32_t> triangles;
+
+            explicit vertex_triangles(const indexed_mesh& p_mesh)
+                : offsets(p_mesh.vertex_count() + 1, 0), triangles(p_mesh.indices.size())
+            {
+                for (const std::uint32_t v : p_mesh.indices)
+                    ++offsets[v + 1];
+                std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+                std::vector<std::uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+                for (std::size_t i = 0; i < p_mesh.indices.size(); ++i)
+                    triangles[cursor[p_mesh.indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+            }
+        };
+
+        /// Count the cache misses of a triangle range with a FIFO cache that starts empty
+        inline std::size_t simulate_fifo(const std::uint32_t* p_indices, const std::size_t p_triangles, const std::size_t p_cache_size, std::vector<std::size_t>& p_stamp, std::size_t& p_time)
+        {
+            // A vertex is cached if it missed within the last cache-size misses
+            std::size_t misses = 0;
+            const std::size_t start = p_time;
+            for (std::size_t i = 0; i < p_triangles * 3; ++i)
+            {
+                const std::uint32_t v = p_indices[i];
+                if (p_stamp[v] <= start || p_time - p_stamp[v] >= p_cache_size)
+                {
+                    p_stamp[v] = ++p_time;
+                    ++misses;
+                }
+            }
+            return misses;
+        }
+    }
+
+    /// Simulate a FIFO post-transform vertex cache over an index buffer
+    /// @param p_mesh               Mesh to analyze
+    /// @param p_cache_size         Cache size in vertices
+    /// @return                     Cache statistics
+    inline vertex_cache_statistics analyze_vertex_cache(const indexed_mesh& p_mesh, const std::size_t p_cache_size = 16)
+    {
+        vertex_cache_statistics stats;
+        std::vector<std::size_t> stamp(p_mesh.vertex_count(), 0);
+        std::size_t time = 0;
+        stats.transformed = detail::simulate_fifo(p_mesh.indices.data(), p_mesh.triangle_count(), p_cache_size, stamp, time);
+        if (p_mesh.triangle_count() != 0)
+            stats.acmr = static_cast<double>(stats.transformed) / static_cast<double>(p_mesh.triangle_count());
+        if (p_mesh.vertex_count() != 0)
+            stats.atvr = static_cast<double>(stats.transformed) / static_cast<double>(p_mesh.vertex_count());
+        return stats;
+    }
+
+    /// Reorder triangles for post-transform vertex cache locality (Tipsify)
+    ///
+    /// Implements Sander, Nehab and Barczak, "Fast Triangle Reordering for
+    /// Vertex Locality and Reduced Overdraw": triangles are emitted as fans
+    /// around a current vertex, and the next fan vertex is the neighbour that
+    /// will still be in the cache after its remaining triangles are emitted.
+    /// Runs in linear time. Triangle winding is preserved.
+    /// @param p_mesh               Mesh whose indices are reordered
+    /// @param p_cache_size         Target cache size in vertices
+    /// @param p_clusters           Optional output of the first triangle of each cluster (fans broken by a dead end), for optimize_overdraw()
+    /// @return                     Cache statistics before and after
+    inline vertex_cache_report optimize_vertex_cache(indexed_mesh& p_mesh, const std::size_t p_cache_size = 16, std::vector<std::uint32_t>* p_clusters = nullptr)
+    {
+        MESH_PROFILE_SCOPE("vertex_cache.optimize", p_mesh.triangle_count());
+        vertex_cache_report report;
+        report.before = analyze_vertex_cache(p_mesh, p_cache_size);
+        if (p_clusters)
+            p_clusters->clear();
+
+        const std::size_t vertex_count = p_mesh.vertex_count();
+        const std::size_t triangle_count = p_mesh.triangle_count();
+        const detail::vertex_triangles adjacency{ p_mesh };
+
+        std::vector<std::uint32_t> live(vertex_count);
+        for (std::size_t v = 0; v < vertex_count; ++v)
+            live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+        std::vector<std::size_t> cache_time(vertex_count, 0);
+        std::vector<std::uint8_t> emitted(triangle_count, 0);
+        std::vector<std::uint32_t> dead_end;
+        std::vector<std::uint32_t> candidates;
+        std::vector<std::uint32_t> output;
+        output.reserve(p_mesh.indices.size());
+
+        const std::size_t k = p_cache_size;
+        std::size_t time = k + 1;
+        std::size_t cursor = 0;
+        std::int64_t fan = vertex_count != 0 ? 0 : -1;
+        bool cluster_start = true;
+        while (fan >= 0)
+        {
+            // Emit every remaining triangle around the fan vertex
+            candidates.clear();
+            const auto f = static_cast<std::uint32_t>(fan);
+            for (std::uint32_t n = adjacency.offsets[f]; n < adjacency.offsets[f + 1]; ++n)
+            {
+                const std::uint32_t t = adjacency.triangles[n];
+                if (emitted[t])
+                    continue;
+
+                if (cluster_start && p_clusters)
+                    p_clusters->push_back(static_cast<std::uint32_t>(output.size() / 3));
+                cluster_start = false;
+
+                for (int c = 0; c < 3; ++c)
+                {
+                    const std::uint32_t v = p_mesh.indices[t * 3 + c];
+                    output.push_back(v);
+                    dead_end.push_back(v);
+                    candidates.push_back(v);
+                    --live[v];
+                    if (time - cache_time[v] > k)
+                        cache_time[v] = time++;
+                }
+                emitted[t] = 1;
+            }
+
+            // Pick the candidate that stays cached longest once its fan is emitted
+            fan = -1;
+            std::size_t best_priority = 0;
+            bool found = false;
+            for (const std::uint32_t v : candidates)
+            {
+                if (live[v] == 0)
+                    continue;
+
+                std::size_t priority = 0;
+                if (time - cache_time[v] + 2 * live[v] <= k)
+                    priority = time - cache_time[v];
+                if (!found || priority > best_priority)
+                {
+                    found = true;
+                    best_priority = priority;
+                    fan = v;
+                }
+            }
+            if (found)
+                continue;
+
+            // Dead end: fall back to recently used vertices, then to the next unprocessed vertex
+            cluster_start = true;
+            while (!dead_end.empty() && fan < 0)
+            {
+                const std::uint32_t d = dead_end.back();
+                dead_end.pop_back();
+                if (live[d] > 0)
+                    fan = d;
+            }
+            while (fan < 0 && cursor < vertex_count)
+            {
+                if (live[cursor] > 0)
+                    fan = static_cast<std::int64_t>(cursor);
+                ++cursor;
+            }
+        }
+
+        p_mesh.indices.swap(output);
+        report.after = analyze_vertex_cache(p_mesh, p_cache_size);
+        return report;
+    }
+
+    /// Reorder triangle clusters to reduce overdraw
+    ///
+    /// Splits the clusters from optimize_vertex_cache() further wherever a
+    /// cluster prefix already reaches p_threshold times the mesh ACMR with a
+    /// cold cache, then sorts clusters so those facing away from the mesh
+    /// center (outer surfaces, likely to occlude the rest) draw first. The key
+    /// is the dot product of the cluster's offset from the mesh centroid with
+    /// its area-weighted face plane normal.
+    /// @param p_mesh               Mesh whose indices are reordered
+    /// @param p_clusters           First triangle of each cluster (sorted, starting at zero)
+    /// @param p_cache_size         Cache size in vertices
+    /// @param p_threshold          Allowed ACMR growth factor for the extra cluster splits
+    /// @return                     Cache statistics before and after
+    inline vertex_cache_report optimize_overdraw(indexed_mesh& p_mesh, const std::vector<std::uint32_t>& p_clusters, const std::size_t p_cache_size = 16, const double p_threshold = 1.05)
+    {
+        MESH_PROFILE_SCOPE("vertex_cache.overdraw", p_mesh.triangle_count());
+        vertex_cache_report report;
+        report.before = analyze_vertex_cache(p_mesh, p_cache_size);
+        const std::size_t triangle_count = p_mesh.triangle_count();
+        if (triangle_count == 0)
+        {
+            report.after = report.before;
+            return report;
+        }
+
+        // Split the hard clusters at points where a cold-cache prefix is already efficient
+        const double target = report.before.acmr * p_threshold;
+        std::vector<std::uint32_t> starts;
+        std::vector<std::size_t> stamp(p_mesh.vertex_count(), 0);
+        std::size_t time = 0;
+        for (std::size_t c = 0; c < p_clusters.size(); ++c)
+        {
+            const std::size_t end = c + 1 < p_clusters.size() ? p_clusters[c + 1] : triangle_count;
+            std::size_t start = p_clusters[c];
+            starts.push_back(static_cast<std::uint32_t>(start));
+            std::size_t misses = 0;
+            std::size_t cluster_time = ++time;
+            for (std::size_t t = start; t < end; ++t)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    const std::uint32_t v = p_mesh.indices[t * 3 + i];
+                    if (stamp[v] <= cluster_time || time - stamp[v] >= p_cache_size)
+                    {
+                        stamp[v] = ++time;
+                        ++misses;
+                    }
+                }
+
+                if (t + 1 < end && static_cast<double>(misses) <= target * static_cast<double>(t + 1 - start))
+                {
+                    start = t + 1;
+                    starts.push_back(static_cast<std::uint32_t>(start));
+                    misses = 0;
+                    cluster_time = ++time;
+                }
+            }
+        }
+        if (starts.empty() || starts[0] != 0)
+            starts.insert(starts.begin(), 0);
+
+        // Area-weighted centroid and normal of each cluster
+        const std::size_t cluster_count = starts.size();
+        std::vector<vector3> centers(cluster_count, vector3{ 0.0, 0.0, 0.0 });
+        std::vector<vector3> normals(cluster_count, vector3{ 0.0, 0.0, 0.0 });
+        std::vector<double> areas(cluster_count, 0.0);
+        vector3 mesh_center{ 0.0, 0.0, 0.0 };
+        double mesh_area = 0.0;
+        for (std::size_t c = 0; c < cluster_count; ++c)
+        {
+            const std::size_t end = c + 1 < cluster_count ? starts[c + 1] : triangle_count;
+            for (std::size_t t = starts[c]; t < end; ++t)
+            {
+                const triangle3 tri = p_mesh.triangle(t);
+                const double area = tri.normal().length() * 0.5;
+                const vector3 centroid = (tri.point1 + tri.point2 + tri.point3) / 3.0;
+                centers[c] += centroid * area;
+                normals[c] += tri.plane().normal * area;
+                areas[c] += area;
+            }
+            mesh_center += centers[c];
+            mesh_area += areas[c];
+            if (areas[c] > 0.0)
+                centers[c] /= areas[c];
+        }
+        if (mesh_area > 0.0)
+            mesh_center /= mesh_area;
+
+        // Draw clusters facing away from the center first
+        std::vector<double> keys(cluster_count);
+        for (std::size_t c = 0; c < cluster_count; ++c)
+            keys[c] = (centers[c] - mesh_center).dot(normals[c].normalized());
+
+        std::vector<std::uint32_t> order(cluster_count);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](const std::uint32_t p_a, const std::uint32_t p_b)
+        {
+            return keys[p_a] > keys[p_b];
+        });
+
+        std::vector<std::uint32_t> output;
+        output.reserve(p_mesh.indices.size());
+        for (const std::uint32_t c : order)
+        {
+            const std::size_t end = c + 1 < cluster_count ? starts[c + 1] : triangle_count;
+            output.insert(output.end(), p_mesh.indices.begin() + static_cast<std::ptrdiff_t>(starts[c]) * 3, p_mesh.indices.begin() + static_cast<std::ptrdiff_t>(end) * 3);
+        }
+
+        p_mesh.indices.swap(output);
+        report.after = analyze_vertex_cache(p_mesh, p_cache_size);
+        return report;
+    }
+
+    /// Reorder vertices into first-use order for pre-transform fetch locality
+    ///
+    /// Run after the triangle order is final. Vertices not referenced by any
+    /// triangle are dropped.
+    /// @param p_mesh               Mesh whose vertices are reordered and indices remapped
+    /// @return                     New index of each original vertex (UINT32_MAX for dropped vertices), for remapping other vertex attributes
+    inline std::vector<std::uint32_t> optimize_vertex_fetch(indexed_mesh& p_mesh)
+    {
+        MESH_PROFILE_SCOPE("vertex_cache.fetch", p_mesh.vertex_count());
+        constexpr std::uint32_t unused = UINT32_MAX;
+        std::vector<std::uint32_t> remap(p_mesh.vertex_count(), unused);
+        std::vector<vector3> vertices;
+        vertices.reserve(p_mesh.vertex_count());
+        for (std::uint32_t& index : p_mesh.indices)
+        {
+            if (remap[index] == unused)
+            {
+                remap[index] = static_cast<std::uint32_t>(vertices.size());
+                vertices.push_back(p_mesh.vertices[index]);
+            }
+            index = remap[index];
+        }
+
+        p_mesh.vertices.swap(vertices);
+        return remap;
+    }
+}
@@ -0,0 +1,702 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mesh_indexed_mesh.hpp"
+#include "mesh_parallel.hpp"
+#include "mesh_plane3.hpp"
+#include "mesh_profile.hpp"
+#include "mesh_sdf.hpp"
+
+namespace mesh
+{
+    /// Which voxels a voxelization marks as occupied
+    enum class voxel_fill
+    {
+        surface,            ///< Voxels touched by a triangle (conservative)
+        solid               ///< Surface voxels plus voxels whose center is inside (needs a closed mesh)
+    };
+
+    /// Voxelization options
+    struct voxel_options
+    {
+        /// Edge length of a voxel (positive and finite)
+        double voxel_size = 1.0;
+
+        /// Number of empty voxels of padding added around the mesh bounds
+        std::size_t padding = 1;
+
+        /// Which voxels are marked as occupied
+        voxel_fill fill = voxel_fill::surface;
+    };
+
+    namespace detail
+    {
+        /// Count the set bits of a word
+        inline std::size_t popcount64(const std::uint64_t p_value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<std::size_t>(__builtin_popcountll(p_value));
+#else
+            std::uint64_t v = p_value - ((p_value >> 1) & 0x5555555555555555ull);
+            v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+            v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+            return static_cast<std::size_t>((v * 0x0101010101010101ull) >> 56);
+#endif
+        }
+
+        /// Set bits [p_lo, p_hi] of a bit array
+        inline void set_bit_range(std::uint64_t* p_words, const std::size_t p_lo, const std::size_t p_hi)
+        {
+            const std::size_t w0 = p_lo / 64, w1 = p_hi / 64;
+            const std::uint64_t lo_mask = ~0ull << (p_lo % 64);
+            const std::uint64_t hi_mask = ~0ull >> (63 - p_hi % 64);
+            if (w0 == w1)
+            {
+                p_words[w0] |= lo_mask & hi_mask;
+                return;
+            }
+            p_words[w0] |= lo_mask;
+            for (std::size_t w = w0 + 1; w < w1; ++w)
+                p_words[w] = ~0ull;
+            p_words[w1] |= hi_mask;
+        }
+    }
+
+    /// Dense bit-packed voxel grid
+    ///
+    /// Voxel (i, j, k) covers the cube of voxel_size starting at
+    /// origin + (i, j, k) * voxel_size. Each X row starts on a whole word so
+    /// rows can be written from different threads.
+    struct voxel_grid
+    {
+        vector3 origin;                     ///< Minimum corner of voxel (0, 0, 0)
+        double voxel_size = 1.0;            ///< Edge length of a voxel
+        std::size_t size_x = 0;             ///< Number of voxels along X
+        std::size_t size_y = 0;             ///< Number of voxels along Y
+        std::size_t size_z = 0;             ///< Number of voxels along Z
+        std::size_t row_words = 0;          ///< 64-bit words per X row
+        std::vector<std::uint64_t> bits;    ///< Occupancy bits, rows ordered Y fastest, then Z
+
+        /// Default constructor
+        voxel_grid() = default;
+
+        /// Construct an empty grid
+        /// @param p_origin             Minimum corner of voxel (0, 0, 0)
+        /// @param p_voxel_size         Edge length of a voxel
+        /// @param p_size_x             Number of voxels along X
+        /// @param p_size_y             Number of voxels along Y
+        /// @param p_size_z             Number of voxels along Z
+        explicit voxel_grid(const vector3& p_origin, const double p_voxel_size, const std::size_t p_size_x, const std::size_t p_size_y, const std::size_t p_size_z)
+            : origin(p_origin), voxel_size(p_voxel_size), size_x(p_size_x), size_y(p_size_y), size_z(p_size_z), row_words((p_size_x + 63) / 64),
+              bits(row_words * p_size_y * p_size_z, 0)
+        {
+        }
+
+        /// Get the first word of an X row
+        std::uint64_t* row(const std::size_t p_j, const std::size_t p_k)
+        {
+            return bits.data() + (p_k * size_y + p_j) * row_words;
+        }
+
+        /// Check if a voxel is occupied
+        bool get(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k) const
+        {
+            return (bits[(p_k * size_y + p_j) * row_words + p_i / 64] >> (p_i % 64)) & 1;
+        }
+
+        /// Mark a voxel as occupied
+        void set(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k)
+        {
+            bits[(p_k * size_y + p_j) * row_words + p_i / 64] |= 1ull << (p_i % 64);
+        }
+
+        /// Count occupied voxels
+        std::size_t count() const
+        {
+            std::size_t result = 0;
+            for (const std::uint64_t word : bits)
+                result += detail::popcount64(word);
+            return result;
+        }
+
+        /// Calculate the occupied volume
+        double volume() const
+        {
+            return static_cast<double>(count()) * voxel_size * voxel_size * voxel_size;
+        }
+
+        /// Get the box covered by a voxel
+        aabb3 voxel_bounds(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k) const
+        {
+            const vector3 minimum = origin + vector3{ static_cast<double>(p_i), static_cast<double>(p_j), static_cast<double>(p_k) } * voxel_size;
+            return aabb3{ minimum, minimum + vector3{ voxel_size, voxel_size, voxel_size } };
+        }
+    };
+
+    /// Sparse-block bit-packed voxel grid
+    ///
+    /// Only blocks containing surface voxels store bits. Every other block is a
+    /// tile that is either entirely empty or entirely full, so a solid 2048^3
+    /// grid costs a block table plus the blocks along the surface. Sizes are
+    /// rounded up to whole blocks.
+    struct sparse_voxel_grid
+    {
+        /// Voxels per block edge
+        static constexpr std::size_t block_size = 16;
+
+        /// Voxels per block
+        static constexpr std::size_t block_voxels = block_size * block_size * block_size;
+
+        /// 64-bit words per block
+        static constexpr std::size_t block_words = block_voxels / 64;
+
+        /// Block table entry for an empty tile
+        static constexpr std::int32_t empty_tile = -1;
+
+        /// Block table entry for a full tile
+        static constexpr std::int32_t full_tile = -2;
+
+        vector3 origin;                     ///< Minimum corner of voxel (0, 0, 0)
+        double voxel_size = 1.0;            ///< Edge length of a voxel
+        std::size_t size_x = 0;             ///< Number of voxels along X
+        std::size_t size_y = 0;             ///< Number of voxels along Y
+        std::size_t size_z = 0;             ///< Number of voxels along Z
+        std::size_t blocks_x = 0;           ///< Number of blocks along X
+        std::size_t blocks_y = 0;           ///< Number of blocks along Y
+        std::size_t blocks_z = 0;           ///< Number of blocks along Z
+        std::vector<std::int32_t> block_table;  ///< Allocated block index or tile code per block
+        std::vector<std::uint64_t> block_bits;  ///< Bits of allocated blocks (block_words each)
+
+        /// Get the number of allocated blocks
+        std::size_t block_count() const
+        {
+            return block_bits.size() / block_words;
+        }
+
+        /// Get the block table index of a block
+        std::size_t block_index(const std::size_t p_bx, const std::size_t p_by, const std::size_t p_bz) const
+        {
+            return (p_bz * blocks_y + p_by) * blocks_x + p_bx;
+        }
+
+        /// Get the bit index of a voxel within its block
+        static std::size_t local_index(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k)
+        {
+            return ((p_k % block_size) * block_size + (p_j % block_size)) * block_size + (p_i % block_size);
+        }
+
+        /// Check if a voxel is occupied
+        bool get(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k) const
+        {
+            const std::int32_t block = block_table[block_index(p_i / block_size, p_j / block_size, p_k / block_size)];
+            if (block < 0)
+                return block == full_tile;
+
+            const std::size_t local = local_index(p_i, p_j, p_k);
+            return (block_bits[static_cast<std::size_t>(block) * block_words + local / 64] >> (local % 64)) & 1;
+        }
+
+        /// Count occupied voxels
+        std::size_t count() const
+        {
+            std::size_t result = 0;
+            for (const std::int32_t block : block_table)
+                result += block == full_tile ? block_voxels : 0;
+            for (const std::uint64_t word : block_bits)
+                result += detail::popcount64(word);
+            return result;
+        }
+
+        /// Calculate the occupied volume
+        double volume() const
+        {
+            return static_cast<double>(count()) * voxel_size * voxel_size * voxel_size;
+        }
+
+        /// Get the box covered by a voxel
+        aabb3 voxel_bounds(const std::size_t p_i, const std::size_t p_j, const std::size_t p_k) const
+        {
+            const vector3 minimum = origin + vector3{ static_cast<double>(p_i), static_cast<double>(p_j), static_cast<double>(p_k) } * voxel_size;
+            return aabb3{ minimum, minimum + vector3{ voxel_size, voxel_size, voxel_size } };
+        }
+    };
+
+    namespace detail
+    {
+        /// Triangle prepared for repeated separating axis tests against equal boxes
+        ///
+        /// The nine edge cross axes are precomputed as edge functions of the
+        /// triangle projected onto the YZ, ZX and XY planes, offset by the box's
+        /// critical corner (Schwarz and Seidel), so each test is a plane check
+        /// plus nine multiply-adds. Touching counts as overlapping, so the result
+        /// is conservative.
+        struct voxel_triangle
+        {
+            plane3 plane;
+            double plane_radius = 0.0;
+            double edge_a[3][3] = {};
+            double edge_b[3][3] = {};
+            double edge_d[3][3] = {};
+
+            /// Prepare a triangle for boxes of the given half extent
+            /// @param p_triangle           Triangle to test
+            /// @param p_half               Half edge length of the boxes
+            explicit voxel_triangle(const triangle3& p_triangle, const double p_half)
+                : plane(p_triangle.normal(), p_triangle.point1)
+            {
+                // The normal need not be unit length
+                plane_radius = p_half * (std::abs(plane.normal.x) + std::abs(plane.normal.y) + std::abs(plane.normal.z));
+
+                const double points[3][3] = {
+                    { p_triangle.point1.x, p_triangle.point1.y, p_triangle.point1.z },
+                    { p_triangle.point2.x, p_triangle.point2.y, p_triangle.point2.z },
+                    { p_triangle.point3.x, p_triangle.point3.y, p_triangle.point3.z }
+                };
+                const double normal[3] = { plane.normal.x, plane.normal.y, plane.normal.z };
+                for (int p = 0; p < 3; ++p)
+                {
+                    // Dropping axis p leaves (q, r), wound like the normal's sign along p
+                    const int q = (p + 1) % 3;
+                    const int r = (p + 2) % 3;
+                    const double sign = normal[p] >= 0.0 ? 1.0 : -1.0;
+                    for (int e = 0; e < 3; ++e)
+                    {
+                        const double* from = points[e];
+                        const double* to = points[(e + 1) % 3];
+                        edge_a[p][e] = -(to[r] - from[r]) * sign;
+                        edge_b[p][e] = (to[q] - from[q]) * sign;
+                        edge_d[p][e] = -(edge_a[p][e] * from[q] + edge_b[p][e] * from[r]) + p_half * (std::abs(edge_a[p][e]) + std::abs(edge_b[p][e]));
+                    }
+                }
+            }
+
+            /// Test overlap with a box, assuming the bounding boxes already overlap
+            /// @param p_center             Box center
+            /// @return                     True if the triangle touches the box
+            bool overlaps(const vector3& p_center) const
+            {
+                if (std::abs(plane.distance_to(p_center)) > plane_radius)
+                    return false;
+
+                const double center[3] = { p_center.x, p_center.y, p_center.z };
+                for (int p = 0; p < 3; ++p)
+                {
+                    const double cq = center[(p + 1) % 3];
+                    const double cr = center[(p + 2) % 3];
+                    for (int e = 0; e < 3; ++e)
+                    {
+                        if (edge_a[p][e] * cq + edge_b[p][e] * cr + edge_d[p][e] < 0.0)
+                            return false;
+                    }
+                }
+                return true;
+            }
+        };
+
+        /// Voxel layout shared by the dense and sparse builders
+        struct voxel_layout
+        {
+            vector3 origin;
+            double voxel_size = 1.0;
+            std::size_t size_x = 0;
+            std::size_t size_y = 0;
+            std::size_t size_z = 0;
+
+            /// Calculate the layout covering a mesh, rounding sizes up to a multiple
+            ///
+            /// The bounds start half a voxel into the first unpadded voxel and end
+            /// more than the padding from the far side, so the surface never lies
+            /// on a padding voxel's face and the padding stays empty. An empty mesh
+            /// or a voxel size that is not positive and finite gives an empty layout.
+            static voxel_layout create(const indexed_mesh& p_mesh, const voxel_options& p_options, const std::size_t p_multiple)
+            {
+                voxel_layout layout;
+                if (p_mesh.triangle_count() == 0 || !(p_options.voxel_size > 0.0) || !std::isfinite(p_options.voxel_size))
+                    return layout;
+
+                layout.voxel_size = p_options.voxel_size;
+
+                const aabb3 bounds = p_mesh.bounds();
+                const double pad = (static_cast<double>(p_options.padding) + 0.5) * p_options.voxel_size;
+                const vector3 size = bounds.size();
+                auto count = [&](const double p_extent)
+                {
+                    const std::size_t n = static_cast<std::size_t>(std::floor(p_extent / p_options.voxel_size + 0.5)) + 1 + p_options.padding * 2;
+                    return (n + p_multiple - 1) / p_multiple * p_multiple;
+                };
+                layout.origin = bounds.minimum - vector3{ pad, pad, pad };
+                layout.size_x = count(size.x);
+                layout.size_y = count(size.y);
+                layout.size_z = count(size.z);
+                return layout;
+            }
+
+            /// Calculate the inclusive voxel range along one axis touched by an interval
+            /// @return                     False if the interval touches no voxels
+            static bool range(const double p_min, const double p_max, const double p_origin, const double p_voxel_size, const std::size_t p_size, std::size_t& p_lo, std::size_t& p_hi)
+            {
+                const double lo = std::max(std::floor((p_min - p_origin) / p_voxel_size), 0.0);
+                const double hi = std::min(std::floor((p_max - p_origin) / p_voxel_size), static_cast<double>(p_size) - 1.0);
+                if (hi < lo)
+                    return false;
+
+                p_lo = static_cast<std::size_t>(lo);
+                p_hi = static_cast<std::size_t>(hi);
+                return true;
+            }
+
+            /// Get the sample layout of the voxel centers, for ray parity rows
+            sdf_layout centers() const
+            {
+                sdf_layout result;
+                result.origin = origin + vector3{ voxel_size, voxel_size, voxel_size } * 0.5;
+                result.cell_size = voxel_size;
+                result.size_x = size_x;
+                result.size_y = size_y;
+                result.size_z = size_z;
+                return result;
+            }
+
+            /// Bin triangles by the Z slabs their bounds touch
+            std::vector<std::vector<std::uint32_t>> bin_slabs(const indexed_mesh& p_mesh, const std::size_t p_slab) const
+            {
+                std::vector<std::vector<std::uint32_t>> slabs((size_z + p_slab - 1) / p_slab);
+                for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+                {
+                    const aabb3 box = triangle_bounds(p_mesh.triangle(t), 0.0);
+                    std::size_t k0 = 0, k1 = 0;
+                    if (!range(box.minimum.z, box.maximum.z, origin.z, voxel_size, size_z, k0, k1))
+                        continue;
+                    for (std::size_t s = k0 / p_slab; s <= k1 / p_slab; ++s)
+                        slabs[s].push_back(static_cast<std::uint32_t>(t));
+                }
+                return slabs;
+            }
+
+            /// Visit every voxel within Z layers [p_k_lo, p_k_hi] that a triangle touches
+            ///
+            /// Walks the columns along the dominant normal axis and tests only the
+            /// voxels of each column the plane can reach, so the cost follows the
+            /// triangle's area instead of its bounding volume.
+            template <typename TFunc>
+            void rasterize(const triangle3& p_triangle, const std::size_t p_k_lo, const std::size_t p_k_hi, TFunc&& p_func) const
+            {
+                const aabb3 box = triangle_bounds(p_triangle, 0.0);
+                std::size_t lo[3] = {}, hi[3] = {};
+                if (!range(box.minimum.x, box.maximum.x, origin.x, voxel_size, size_x, lo[0], hi[0]) ||
+                    !range(box.minimum.y, box.maximum.y, origin.y, voxel_size, size_y, lo[1], hi[1]) ||
+                    !range(box.minimum.z, box.maximum.z, origin.z, voxel_size, size_z, lo[2], hi[2]))
+                    return;
+
+                lo[2] = std::max(lo[2], p_k_lo);
+                hi[2] = std::min(hi[2], p_k_hi);
+                if (hi[2] < lo[2])
+                    return;
+
+                const voxel_triangle triangle{ p_triangle, voxel_size * 0.5 };
+                const double normal[3] = { triangle.plane.normal.x, triangle.plane.normal.y, triangle.plane.normal.z };
+                const double start[3] = { origin.x, origin.y, origin.z };
+                const int a = std::abs(normal[0]) >= std::abs(normal[1]) && std::abs(normal[0]) >= std::abs(normal[2]) ? 0 : (std::abs(normal[1]) >= std::abs(normal[2]) ? 1 : 2);
+                const int u = (a + 1) % 3;
+                const int v = (a + 2) % 3;
+                const std::size_t size[3] = { size_x, size_y, size_z };
+
+                // The plane's dominant coordinate is linear over the columns
+                const double inv = normal[a] != 0.0 ? 1.0 / normal[a] : 0.0;
+                const double du = -normal[u] * inv * voxel_size;
+                const double dv = -normal[v] * inv * voxel_size;
+                const double base = (triangle.plane.distance - normal[u] * start[u] - normal[v] * start[v]) * inv;
+                const double spread_min = std::min(du, 0.0) + std::min(dv, 0.0) - voxel_size * 1e-6;
+                const double spread_max = std::max(du, 0.0) + std::max(dv, 0.0) + voxel_size * 1e-6;
+
+                std::size_t index[3] = {};
+                for (index[u] = lo[u]; index[u] <= hi[u]; ++index[u])
+                {
+                    for (index[v] = lo[v]; index[v] <= hi[v]; ++index[v])
+                    {
+                        // Voxels of this column the plane can reach, slightly widened
+                        std::size_t a0 = lo[a], a1 = hi[a];
+                        if (normal[a] != 0.0)
+                        {
+                            const double column = base + static_cast<double>(index[u]) * du + static_cast<double>(index[v]) * dv;
+                            if (!range(column + spread_min, column + spread_max, start[a], voxel_size, size[a], a0, a1))
+                                continue;
+                            a0 = std::max(a0, lo[a]);
+                            a1 = std::min(a1, hi[a]);
+                        }
+
+                        for (index[a] = a0; index[a] <= a1; ++index[a])
+                        {
+                            const vector3 center = origin + vector3{ static_cast<double>(index[0]) + 0.5, static_cast<double>(index[1]) + 0.5, static_cast<double>(index[2]) + 0.5 } * voxel_size;
+                            if (triangle.overlaps(center))
+                                p_func(index[0], index[1], index[2]);
+                        }
+                    }
+                }
+            }
+
+            /// Visit the inclusive X ranges of voxels whose centers are inside, from sorted crossings
+            template <typename TFunc>
+            void inside_ranges(const std::vector<double>& p_xs, TFunc&& p_func) const
+            {
+                // A center is inside when an odd number of crossings lie before it
+                const double x0 = origin.x + voxel_size * 0.5;
+                for (std::size_t n = 0; n + 1 < p_xs.size(); n += 2)
+                {
+                    const double lo = std::max(std::floor((p_xs[n] - x0) / voxel_size) + 1.0, 0.0);
+                    const double hi = std::min(std::floor((p_xs[n + 1] - x0) / voxel_size), static_cast<double>(size_x) - 1.0);
+                    if (lo <= hi)
+                        p_func(static_cast<std::size_t>(lo), static_cast<std::size_t>(hi));
+                }
+            }
+        };
+    }
+
+    /// Test if a triangle and a box overlap (including touching)
+    ///
+    /// Separating axis test over the box faces, the triangle plane and the nine
+    /// edge cross axes (Akenine-Moller, "Fast 3D Triangle-Box Overlap Testing").
+    /// @param p_triangle           Triangle to test
+    /// @param p_box                Box to test
+    /// @return                     True if the triangle touches the box
+    inline bool intersect_triangle_aabb(const triangle3& p_triangle, const aabb3& p_box)
+    {
+        const vector3 center = p_box.center();
+        const vector3 half = p_box.size() * 0.5;
+        const vector3 v[3] = { p_triangle.point1 - center, p_triangle.point2 - center, p_triangle.point3 - center };
+
+        // Box faces
+        if (std::min({ v[0].x, v[1].x, v[2].x }) > half.x || std::max({ v[0].x, v[1].x, v[2].x }) < -half.x ||
+            std::min({ v[0].y, v[1].y, v[2].y }) > half.y || std::max({ v[0].y, v[1].y, v[2].y }) < -half.y ||
+            std::min({ v[0].z, v[1].z, v[2].z }) > half.z || std::max({ v[0].z, v[1].z, v[2].z }) < -half.z)
+            return false;
+
+        // Triangle plane
+        const plane3 plane{ p_triangle.normal(), v[0] };
+        const double radius = half.x * std::abs(plane.normal.x) + half.y * std::abs(plane.normal.y) + half.z * std::abs(plane.normal.z);
+        if (std::abs(plane.distance_to(vector3{ 0.0, 0.0, 0.0 })) > radius)
+            return false;
+
+        // Edge cross axes: the edge's own vertices project equally, so test its start and the opposite vertex
+        for (int e = 0; e < 3; ++e)
+        {
+            const vector3 d = v[(e + 1) % 3] - v[e];
+            const vector3& a = v[e];
+            const vector3& b = v[(e + 2) % 3];
+            const vector3 axes[3] = { vector3{ 0.0, -d.z, d.y }, vector3{ d.z, 0.0, -d.x }, vector3{ -d.y, d.x, 0.0 } };
+            for (const vector3& axis : axes)
+            {
+                const double pa = axis.dot(a);
+                const double pb = axis.dot(b);
+                const double r = half.x * std::abs(axis.x) + half.y * std::abs(axis.y) + half.z * std::abs(axis.z);
+                if (std::min(pa, pb) > r || std::max(pa, pb) < -r)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    /// Voxelize a mesh into a dense bit-packed grid
+    ///
+    /// Surface voxels are found with triangle-box separating axis tests, so every
+    /// voxel a triangle touches is marked. Solid fill also marks voxels whose
+    /// center is inside by ray parity along +X. Z slabs are processed in parallel.
+    /// @param p_mesh               Mesh to voxelize (closed for solid fill)
+    /// @param p_options            Voxelization options
+    /// @return                     Voxel grid (empty for an empty mesh or an invalid voxel size)
+    inline voxel_grid voxelize(const indexed_mesh& p_mesh, const voxel_options& p_options = voxel_options{})
+    {
+        MESH_PROFILE_SCOPE("voxel.voxelize", p_mesh.triangle_count());
+        const detail::voxel_layout layout = detail::voxel_layout::create(p_mesh, p_options, 1);
+        voxel_grid grid{ layout.origin, layout.voxel_size, layout.size_x, layout.size_y, layout.size_z };
+        if (grid.bits.empty())
+            return grid;
+
+        const std::size_t slab = sparse_voxel_grid::block_size;
+        const std::vector<std::vector<std::uint32_t>> slab_triangles = layout.bin_slabs(p_mesh, slab);
+        const bool solid = p_options.fill == voxel_fill::solid;
+        const detail::sdf_layout centers = layout.centers();
+        const indexed_mesh no_triangles;
+        const detail::sdf_row_bins bins{ solid ? p_mesh : no_triangles, centers, slab };
+
+        // Slabs own whole Z layers, so their rows never share words
+        parallel_for(slab_triangles.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            std::vector<double> xs;
+            for (std::size_t s = p_begin; s < p_end; ++s)
+            {
+                const std::size_t slab_lo = s * slab;
+                const std::size_t slab_hi = std::min(slab_lo + slab, layout.size_z) - 1;
+                for (const std::uint32_t t : slab_triangles[s])
+                {
+                    layout.rasterize(p_mesh.triangle(t), slab_lo, slab_hi, [&](const std::size_t p_i, const std::size_t p_j, const std::size_t p_k)
+                    {
+                        grid.set(p_i, p_j, p_k);
+                    });
+                }
+
+                if (!solid)
+                    continue;
+                for (std::size_t k = slab_lo; k <= slab_hi; ++k)
+                {
+                    for (std::size_t j = 0; j < layout.size_y; ++j)
+                    {
+                        bins.crossings(p_mesh, centers, slab, j, k, xs);
+                        std::uint64_t* row = grid.row(j, k);
+                        layout.inside_ranges(xs, [&](const std::size_t p_lo, const std::size_t p_hi)
+                        {
+                            detail::set_bit_range(row, p_lo, p_hi);
+                        });
+                    }
+                }
+            }
+        });
+        return grid;
+    }
+
+    /// Voxelize a mesh into a sparse-block bit-packed grid
+    ///
+    /// Produces the same occupancy as voxelize() (over the dense grid's extent)
+    /// but only allocates blocks containing surface voxels. With solid fill the
+    /// remaining blocks become full or empty tiles by the parity of their first
+    /// voxel, which is exact because no triangle touches them.
+    /// @param p_mesh               Mesh to voxelize (closed for solid fill)
+    /// @param p_options            Voxelization options
+    /// @return                     Sparse voxel grid (empty for an empty mesh or an invalid voxel size)
+    inline sparse_voxel_grid voxelize_sparse(const indexed_mesh& p_mesh, const voxel_options& p_options = voxel_options{})
+    {
+        MESH_PROFILE_SCOPE("voxel.voxelize_sparse", p_mesh.triangle_count());
+        const std::size_t bs = sparse_voxel_grid::block_size;
+        const detail::voxel_layout layout = detail::voxel_layout::create(p_mesh, p_options, bs);
+        sparse_voxel_grid grid;
+        grid.origin = layout.origin;
+        grid.voxel_size = layout.voxel_size;
+        grid.size_x = layout.size_x;
+        grid.size_y = layout.size_y;
+        grid.size_z = layout.size_z;
+        grid.blocks_x = layout.size_x / bs;
+        grid.blocks_y = layout.size_y / bs;
+        grid.blocks_z = layout.size_z / bs;
+        grid.block_table.assign(grid.blocks_x * grid.blocks_y * grid.blocks_z, sparse_voxel_grid::empty_tile);
+        if (grid.block_table.empty())
+            return grid;
+
+        // One slab per block layer, so slabs own disjoint block table entries
+        const std::vector<std::vector<std::uint32_t>> slab_triangles = layout.bin_slabs(p_mesh, bs);
+        const bool solid = p_options.fill == voxel_fill::solid;
+        const detail::sdf_layout centers = layout.centers();
+        const indexed_mesh no_triangles;
+        const detail::sdf_row_bins bins{ solid ? p_mesh : no_triangles, centers, bs };
+        std::vector<std::vector<std::uint64_t>> slab_bits(grid.blocks_z);
+        std::vector<std::vector<std::uint32_t>> slab_blocks(grid.blocks_z);
+
+        parallel_for(grid.blocks_z, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            std::vector<double> xs;
+            for (std::size_t s = p_begin; s < p_end; ++s)
+            {
+                // Blocks are numbered within the slab until the slabs are joined
+                std::vector<std::uint64_t>& bits = slab_bits[s];
+                std::vector<std::uint32_t>& blocks = slab_blocks[s];
+                auto block_words = [&](const std::size_t p_bx, const std::size_t p_by) -> std::uint64_t*
+                {
+                    const std::size_t index = grid.block_index(p_bx, p_by, s);
+                    std::int32_t& entry = grid.block_table[index];
+                    if (entry < 0)
+                    {
+                        entry = static_cast<std::int32_t>(blocks.size());
+                        blocks.push_back(static_cast<std::uint32_t>(index));
+                        bits.resize(bits.size() + sparse_voxel_grid::block_words, 0);
+                    }
+                    return bits.data() + static_cast<std::size_t>(entry) * sparse_voxel_grid::block_words;
+                };
+
+                const std::size_t slab_lo = s * bs;
+                const std::size_t slab_hi = slab_lo + bs - 1;
+                // Consecutive voxels mostly share a block, so keep the last one
+                std::size_t last_block = static_cast<std::size_t>(-1);
+                std::uint64_t* words = nullptr;
+                for (const std::uint32_t t : slab_triangles[s])
+                {
+                    layout.rasterize(p_mesh.triangle(t), slab_lo, slab_hi, [&](const std::size_t p_i, const std::size_t p_j, const std::size_t p_k)
+                    {
+                        const std::size_t block = (p_j / bs) * grid.blocks_x + p_i / bs;
+                        if (block != last_block)
+                        {
+                            words = block_words(p_i / bs, p_j / bs);
+                            last_block = block;
+                        }
+                        const std::size_t local = sparse_voxel_grid::local_index(p_i, p_j, p_k);
+                        words[local / 64] |= 1ull << (local % 64);
+                    });
+                }
+
+                if (!solid)
+                    continue;
+
+                // Allocated blocks of each block row, so inside runs skip tiles
+                std::vector<std::vector<std::size_t>> row_blocks(grid.blocks_y);
+                for (const std::uint32_t index : blocks)
+                    row_blocks[(index / grid.blocks_x) % grid.blocks_y].push_back(index % grid.blocks_x);
+                for (auto& row : row_blocks)
+                    std::sort(row.begin(), row.end());
+
+                for (std::size_t k = slab_lo; k <= slab_hi; ++k)
+                {
+                    for (std::size_t j = 0; j < layout.size_y; ++j)
+                    {
+                        bins.crossings(p_mesh, centers, bs, j, k, xs);
+                        const std::vector<std::size_t>& allocated = row_blocks[j / bs];
+                        const bool classify = k == slab_lo && j % bs == 0;
+                        layout.inside_ranges(xs, [&](const std::size_t p_lo, const std::size_t p_hi)
+                        {
+                            // Untouched blocks take the state of their first voxel
+                            if (classify)
+                            {
+                                for (std::size_t bx = (p_lo + bs - 1) / bs; bx <= p_hi / bs; ++bx)
+                                {
+                                    std::int32_t& entry = grid.block_table[grid.block_index(bx, j / bs, s)];
+                                    if (entry < 0)
+                                        entry = sparse_voxel_grid::full_tile;
+                                }
+                            }
+
+                            // Set this row's bits within the allocated blocks
+                            const std::size_t row = sparse_voxel_grid::local_index(0, j, k);
+                            for (auto it = std::lower_bound(allocated.begin(), allocated.end(), p_lo / bs); it != allocated.end() && *it <= p_hi / bs; ++it)
+                            {
+                                const std::size_t bx = *it;
+                                const std::int32_t entry = grid.block_table[grid.block_index(bx, j / bs, s)];
+                                std::uint64_t* words = bits.data() + static_cast<std::size_t>(entry) * sparse_voxel_grid::block_words;
+                                const std::size_t lo = std::max(p_lo, bx * bs);
+                                const std::size_t hi = std::min(p_hi, bx * bs + bs - 1);
+                                detail::set_bit_range(words, row + lo % bs, row + hi % bs);
+                            }
+                        });
+                    }
+                }
+            }
+        });
+
+        // Join the slabs in order and renumber their blocks
+        std::vector<std::size_t> offsets(grid.blocks_z + 1, 0);
+        for (std::size_t s = 0; s < grid.blocks_z; ++s)
+            offsets[s + 1] = offsets[s] + slab_blocks[s].size();
+        grid.block_bits.resize(offsets.back() * sparse_voxel_grid::block_words);
+        parallel_for(grid.blocks_z, [&](const std::size_t p_begin, const std::size_t p_end)
+        {
+            for (std::size_t s = p_begin; s < p_end; ++s)
+            {
+                std::copy(slab_bits[s].begin(), slab_bits[s].end(), grid.block_bits.begin() + static_cast<std::ptrdiff_t>(offsets[s] * sparse_voxel_grid::block_words));
+                for (const std::uint32_t index : slab_blocks[s])
+                    grid.block_table[index] += static_cast<std::int32_t>(offsets[s]);
+            }
+        });
+        return grid;
+    }
+}
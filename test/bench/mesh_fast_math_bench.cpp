@@ -0,0 +1,79 @@
+// Compares exact and approximate vector normalization.
+//
+//     g++ -std=c++17 -O3 -march=native -I../../src mesh_fast_math_bench.cpp -o mesh_fast_math_bench
+//     ./mesh_fast_math_bench [vector count] [repetitions]
+
+#include "mesh/mesh_fast_math.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace mesh;
+
+namespace
+{
+    /// Time the best of several runs of a batch function, in nanoseconds per vector
+    template <typename F>
+    double time_batch(const std::size_t p_count, const int p_repetitions, F p_func)
+    {
+        double best = 1e300;
+        for (int r = 0; r < p_repetitions; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            p_func();
+            const auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+        }
+        return best / static_cast<double>(p_count);
+    }
+
+    /// Maximum relative error of a normalized batch against the exact result
+    double max_error(const std::vector<vector3>& p_exact, const std::vector<vector3>& p_approx)
+    {
+        double error = 0.0;
+        for (std::size_t i = 0; i < p_exact.size(); ++i)
+            error = std::max(error, (p_exact[i] - p_approx[i]).length());
+        return error;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1u << 20;
+    const int repetitions = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> dist(-100.0, 100.0);
+    std::vector<vector3> input(count);
+    for (auto& v : input)
+        v = vector3{ dist(rng), dist(rng), dist(rng) };
+
+    std::vector<vector3> exact(count);
+    std::vector<vector3> approx(count);
+    std::printf("%zu vectors, best of %d\n", count, repetitions);
+    std::printf("%-24s %10s %12s\n", "path", "ns/vector", "max error");
+
+    const double exact_time = time_batch(count, repetitions, [&] { normalize(input.data(), count, exact.data()); });
+    std::printf("%-24s %10.3f %12s\n", "normalize", exact_time, "-");
+
+    const double scalar_time = time_batch(count, repetitions, [&] {
+        for (std::size_t i = 0; i < count; ++i)
+            approx[i] = fast_normalized(input[i]);
+    });
+    std::printf("%-24s %10.3f %12.2e\n", "fast_normalized", scalar_time, max_error(exact, approx));
+
+    const double batch2 = time_batch(count, repetitions, [&] { fast_normalize<2>(input.data(), count, approx.data()); });
+    std::printf("%-24s %10.3f %12.2e\n", "fast_normalize<2>", batch2, max_error(exact, approx));
+
+    const double batch3 = time_batch(count, repetitions, [&] { fast_normalize<3>(input.data(), count, approx.data()); });
+    std::printf("%-24s %10.3f %12.2e\n", "fast_normalize<3>", batch3, max_error(exact, approx));
+
+    const double batch4 = time_batch(count, repetitions, [&] { fast_normalize<4>(input.data(), count, approx.data()); });
+    std::printf("%-24s %10.3f %12.2e\n", "fast_normalize<4>", batch4, max_error(exact, approx));
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Measures the per-call latency of small parallel_for ranges on the persistent
+// worker pool against spawning a thread per chunk.
+//
+//     g++ -std=c++17 -O3 -march=native -pthread -I../../src mesh_parallel_bench.cpp -o mesh_parallel_bench
+//     ./mesh_parallel_bench [call count] [repetitions]
+
+#include "mesh/mesh_parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace mesh;
+
+namespace
+{
+    /// Time the best of several runs of a batch function, in microseconds per call
+    template <typename F>
+    double time_batch(const std::size_t p_count, const int p_repetitions, F p_func)
+    {
+        double best = 1e300;
+        for (int r = 0; r < p_repetitions; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            p_func();
+            const auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+        }
+        return best / static_cast<double>(p_count);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000;
+    const int repetitions = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::atomic<std::size_t> sum{ 0 };
+    std::printf("%zu calls of 4 items, best of %d\n", count, repetitions);
+    std::printf("%-24s %8s %12s\n", "path", "threads", "us/call");
+    for (const unsigned int threads : { 1u, 2u, 4u, 8u })
+    {
+        set_thread_count(threads);
+        const double pool_time = time_batch(count, repetitions, [&] {
+            for (std::size_t n = 0; n < count; ++n)
+                parallel_for(4, [&](const std::size_t p_begin, const std::size_t p_end) { sum += p_end - p_begin; });
+        });
+        std::printf("%-24s %8u %12.3f\n", "parallel_for", threads, pool_time);
+
+        const double spawn_time = time_batch(count, repetitions, [&] {
+            std::vector<std::thread> workers;
+            for (std::size_t n = 0; n < count; ++n)
+            {
+                for (unsigned int t = 0; t < threads; ++t)
+                    workers.emplace_back([&] { sum += 1; });
+                for (auto& w : workers)
+                    w.join();
+                workers.clear();
+            }
+        });
+        std::printf("%-24s %8u %12.3f\n", "std::thread per chunk", threads, spawn_time);
+    }
+    set_thread_count(0);
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Stand-in for the libFuzzer driver on compilers without -fsanitize=fuzzer.
+//
+//     <target> [-runs=N] [-seed=N] [file or directory...]
+//
+// Runs the fuzz target on every given file (directories are read one level
+// deep), then on N pseudo-random inputs from a fixed seed. Corpora found with
+// libFuzzer can be replayed this way under GCC sanitizer builds, and the
+// random runs give CTest a deterministic smoke test.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* p_data, std::size_t p_size);
+
+namespace
+{
+    /// Run the target on the contents of a file
+    void run_file(const std::filesystem::path& p_path)
+    {
+        std::ifstream file(p_path, std::ios::binary);
+        const std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long runs = 0;
+    unsigned long seed = 1;
+    std::size_t files = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg.rfind("-runs=", 0) == 0)
+            runs = std::strtoul(arg.c_str() + 6, nullptr, 10);
+        else if (arg.rfind("-seed=", 0) == 0)
+            seed = std::strtoul(arg.c_str() + 6, nullptr, 10);
+        else if (!arg.empty() && arg[0] == '-')
+            continue;
+        else if (std::filesystem::is_directory(arg))
+        {
+            for (const auto& entry : std::filesystem::directory_iterator(arg))
+            {
+                if (entry.is_regular_file())
+                {
+                    run_file(entry.path());
+                    ++files;
+                }
+            }
+        }
+        else
+        {
+            run_file(arg);
+            ++files;
+        }
+    }
+
+    // Random inputs, mostly short, some up to a few kilobytes
+    std::mt19937_64 rng(seed);
+    std::vector<std::uint8_t> data;
+    for (unsigned long r = 0; r < runs; ++r)
+    {
+        data.resize(rng() % 8 == 0 ? rng() % 4096 : rng() % 256);
+        for (auto& b : data)
+            b = static_cast<std::uint8_t>(rng());
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    std::printf("replayed %zu files and %lu random inputs\n", files, runs);
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Fuzzes mesh cache validation and reading.
+//
+// Each input is opened as a cache as is, and also applied as byte patches to
+// a valid cache image so mutations reach the section table and section
+// checks behind the magic, version and checksum. Every accepted cache is
+// read back completely; with verification on, its triangles are streamed
+// through indexed_triangle_source, which dereferences every index.
+
+#include "mesh/mesh_cache.hpp"
+#include "mesh/mesh_primitives.hpp"
+#include "mesh/mesh_streaming.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace mesh;
+
+namespace
+{
+    /// Build a valid cache with every well-known section type
+    std::vector<std::uint8_t> make_image()
+    {
+        static const indexed_mesh sphere = make_icosphere<1>(1.0).to_mesh();
+        static const std::vector<std::uint32_t> adjacency = compute_edge_adjacency(sphere);
+        mesh_cache_writer writer(sphere);
+        writer.add_section(mesh_cache_section::normals, sphere.vertices.data(), sphere.vertices.size());
+        writer.add_section(mesh_cache_section::edge_adjacency, adjacency.data(), adjacency.size());
+        return writer.serialize();
+    }
+
+    /// Open cache bytes both ways and read everything an accepted cache exposes
+    void check(const std::uint8_t* p_data, const std::size_t p_size)
+    {
+        // The cache reads in place and needs 8-byte alignment
+        std::vector<std::uint64_t> aligned((p_size + 7) / 8);
+        if (p_size != 0)
+            std::memcpy(aligned.data(), p_data, p_size);
+
+        for (const bool verify : { true, false })
+        {
+            mesh_cache cache;
+            if (cache.open(aligned.data(), p_size, verify) != mesh_cache_status::ok)
+                continue;
+
+            const indexed_mesh copy = cache.to_mesh();
+            volatile double sum = 0.0;
+            for (const auto& v : copy.vertices)
+                sum = sum + v.x + v.y + v.z;
+            std::size_t count = 0;
+            if (const vector3* normals = cache.section<vector3>(mesh_cache_section::normals, count))
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                    sum = sum + normals[i].x;
+            }
+            if (const std::uint32_t* adjacency = cache.section<std::uint32_t>(mesh_cache_section::edge_adjacency, count))
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                    sum = sum + adjacency[i];
+            }
+
+            // Verified caches guarantee in-range indices
+            if (verify && cache.positions() && cache.indices())
+            {
+                indexed_triangle_source source(cache);
+                triangle3 buffer[64];
+                while (const std::size_t read = source.read(buffer, 64))
+                {
+                    for (std::size_t i = 0; i < read; ++i)
+                        sum = sum + buffer[i].point1.x + buffer[i].point2.y + buffer[i].point3.z;
+                }
+            }
+        }
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* p_data, std::size_t p_size)
+{
+    check(p_data, p_size);
+
+    // Control byte, then (offset low, offset high, value) patches
+    static const std::vector<std::uint8_t> image = make_image();
+    if (p_size == 0)
+        return 0;
+    std::vector<std::uint8_t> patched = image;
+    const std::uint8_t control = p_data[0];
+    for (std::size_t i = 1; i + 3 <= p_size; i += 3)
+    {
+        const std::size_t offset = (p_data[i] | (p_data[i + 1] << 8)) % patched.size();
+        patched[offset] = p_data[i + 2];
+    }
+    if (control & 1)
+        patched.resize(patched.size() * (control >> 1) / 128);
+    if ((control & 2) && patched.size() >= sizeof(mesh_cache_header))
+    {
+        // Re-seal the checksum so the mutated sections reach the full checks
+        mesh_cache_header header;
+        std::memcpy(&header, patched.data(), sizeof(header));
+        if (header.file_size <= patched.size() && header.file_size >= sizeof(header))
+            header.checksum = detail::mesh_cache_checksum(patched.data() + sizeof(header), static_cast<std::size_t>(header.file_size - sizeof(header)));
+        std::memcpy(patched.data(), &header, sizeof(header));
+    }
+    check(patched.data(), patched.size());
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Fuzzes out-of-core streaming on arbitrary indexed triangle input.
+//
+// The first bytes choose the chunk, weld and clustering sizes; the rest are
+// read as vertex coordinates followed by triangle indices taken modulo the
+// vertex count. Coordinates are usually on a coarse lattice (so welds,
+// degenerate and duplicate triangles are common) and otherwise raw doubles,
+// including huge, infinite and NaN values; the chunk size may be raw as well.
+// Invalid chunk sizes must fail. Otherwise the streamed result must reference
+// only written vertices, never grow the triangle count, and keep exactly the
+// finite, non-degenerate input triangles when neither welding nor clustering
+// is on.
+
+#include "mesh/mesh_streaming.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace mesh;
+
+namespace
+{
+    /// Read a raw double from the input
+    double read_double(const std::uint8_t* p_data)
+    {
+        double value = 0.0;
+        std::memcpy(&value, p_data, sizeof(value));
+        return value;
+    }
+
+    /// Check that a position is finite
+    bool is_finite(const vector3& p_v)
+    {
+        return std::isfinite(p_v.x) && std::isfinite(p_v.y) && std::isfinite(p_v.z);
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* p_data, std::size_t p_size)
+{
+    if (p_size < 4)
+        return 0;
+
+    streaming_options options;
+    options.chunk_size = 1.0 + p_data[0] % 8;
+    options.weld_tolerance = (p_data[1] % 4) * 0.125;
+    options.cluster_size = (p_data[2] & 1) ? 0.5 * (1 + p_data[2] % 4) : 0.0;
+    options.compute_normals = (p_data[3] & 1) != 0;
+    options.read_batch = 1 + p_data[3] % 16;
+    options.spill_batch = 1 + p_data[3] % 8;
+    const bool raw_chunk = (p_data[0] & 0x80) != 0;
+    const bool raw_coordinates = (p_data[1] & 0x80) != 0;
+    p_data += 4;
+    p_size -= 4;
+    if (raw_chunk)
+    {
+        if (p_size < sizeof(double))
+            return 0;
+        options.chunk_size = read_double(p_data);
+        p_data += sizeof(double);
+        p_size -= sizeof(double);
+    }
+    const std::size_t coordinate_size = raw_coordinates ? sizeof(double) : 1;
+    if (p_size < 1 + 3 * coordinate_size)
+        return 0;
+
+    // Vertex count, coordinates, then indices
+    const std::size_t vertex_count = std::min<std::size_t>((p_size - 1) / (3 * coordinate_size), 1 + p_data[0] % 64);
+    std::vector<vector3> vertices(vertex_count);
+    std::size_t next = 1;
+    for (auto& v : vertices)
+    {
+        if (raw_coordinates)
+            v = vector3(read_double(p_data + next), read_double(p_data + next + 8), read_double(p_data + next + 16));
+        else
+            v = vector3(static_cast<std::int8_t>(p_data[next]) * 0.25, static_cast<std::int8_t>(p_data[next + 1]) * 0.25, static_cast<std::int8_t>(p_data[next + 2]) * 0.25);
+        next += 3 * coordinate_size;
+    }
+    std::vector<std::uint32_t> indices;
+    for (; next < p_size && indices.size() < 3 * 4096; ++next)
+        indices.push_back(p_data[next] % static_cast<std::uint32_t>(vertex_count));
+    indices.resize(indices.size() - indices.size() % 3);
+
+    indexed_triangle_source source(vertices.data(), indices.data(), indices.size() / 3);
+    indexed_mesh output;
+    std::vector<vector3> normals;
+    const streaming_result result = process_streaming(source, indexed_mesh_sink{ output, &normals }, options);
+    if (result.ok && !(options.chunk_size > 0.0 && std::isfinite(options.chunk_size)))
+        std::abort();
+    if (!result.ok)
+        return 0;
+
+    if (result.input_triangles != indices.size() / 3)
+        std::abort();
+    if (output.triangle_count() > indices.size() / 3)
+        std::abort();
+    if (options.weld_tolerance == 0.0 && options.cluster_size == 0.0)
+    {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < indices.size(); i += 3)
+        {
+            const vector3& a = vertices[indices[i]];
+            const vector3& b = vertices[indices[i + 1]];
+            const vector3& c = vertices[indices[i + 2]];
+            if (is_finite(a) && is_finite(b) && is_finite(c) && !(a == b) && !(b == c) && !(c == a))
+                ++kept;
+        }
+        if (output.triangle_count() != kept)
+            std::abort();
+    }
+    if (options.compute_normals && normals.size() != output.vertex_count())
+        std::abort();
+    for (const std::uint32_t i : output.indices)
+    {
+        if (i >= output.vertex_count())
+            std::abort();
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_aabb3.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_aabb3)
+	{
+	public:
+		TEST_METHOD(test_construct)
+		{
+			constexpr aabb3 b1;
+			Assert::IsTrue(b1.minimum.is_zero_approx());
+			Assert::IsTrue(b1.maximum.is_zero_approx());
+			Assert::IsFalse(b1.is_empty());
+
+			constexpr aabb3 b2{ vector3{ 1.0, 2.0, 3.0 }, vector3{ 4.0, 5.0, 6.0 } };
+			Assert::IsTrue(b2.minimum.is_equal_approx(vector3{ 1.0, 2.0, 3.0 }));
+			Assert::IsTrue(b2.maximum.is_equal_approx(vector3{ 4.0, 5.0, 6.0 }));
+
+			constexpr aabb3 b3 = aabb3::empty();
+			Assert::IsTrue(b3.is_empty());
+		}
+
+		TEST_METHOD(test_expand)
+		{
+			aabb3 b1 = aabb3::empty();
+			b1.expand(vector3{ 1.0, 2.0, 3.0 });
+			b1.expand(vector3{ -1.0, 4.0, 0.0 });
+			Assert::IsTrue(b1 == aabb3{ vector3{ -1.0, 2.0, 0.0 }, vector3{ 1.0, 4.0, 3.0 } });
+
+			b1.expand(aabb3{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 5.0, 1.0, 1.0 } });
+			Assert::IsTrue(b1 == aabb3{ vector3{ -1.0, 0.0, 0.0 }, vector3{ 5.0, 4.0, 3.0 } });
+		}
+
+		TEST_METHOD(test_measure)
+		{
+			constexpr aabb3 b1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 2.0, 3.0 } };
+			Assert::IsTrue(b1.center().is_equal_approx(vector3{ 0.5, 1.0, 1.5 }));
+			Assert::IsTrue(b1.size().is_equal_approx(vector3{ 1.0, 2.0, 3.0 }));
+			Assert::AreEqual(22.0, b1.surface_area());
+			Assert::IsTrue(b1.grown(1.0) == aabb3{ vector3{ -1.0, -1.0, -1.0 }, vector3{ 2.0, 3.0, 4.0 } });
+		}
+
+		TEST_METHOD(test_contains)
+		{
+			constexpr aabb3 b1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 1.0, 1.0 } };
+			Assert::IsTrue(b1.contains(vector3{ 0.5, 0.5, 0.5 }));
+			Assert::IsTrue(b1.contains(vector3{ 1.0, 1.0, 1.0 }));
+			Assert::IsFalse(b1.contains(vector3{ 1.5, 0.5, 0.5 }));
+		}
+
+		TEST_METHOD(test_intersects)
+		{
+			constexpr aabb3 b1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 1.0, 1.0 } };
+			Assert::IsTrue(b1.intersects(aabb3{ vector3{ 0.5, 0.5, 0.5 }, vector3{ 2.0, 2.0, 2.0 } }));
+			Assert::IsFalse(b1.intersects(aabb3{ vector3{ 1.5, 0.5, 0.5 }, vector3{ 2.0, 2.0, 2.0 } }));
+		}
+
+		TEST_METHOD(test_closest_point)
+		{
+			constexpr aabb3 b1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 1.0, 1.0 } };
+			Assert::IsTrue(b1.closest_point(vector3{ 2.0, 0.5, -1.0 }).is_equal_approx(vector3{ 1.0, 0.5, 0.0 }));
+			Assert::AreEqual(2.0, b1.distance2_to(vector3{ 2.0, 0.5, -1.0 }));
+			Assert::AreEqual(0.0, b1.distance2_to(vector3{ 0.5, 0.5, 0.5 }));
+		}
+
+		TEST_METHOD(test_intersect_ray)
+		{
+			constexpr aabb3 b1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 1.0, 1.0 } };
+
+			double d1 = 0.0;
+			Assert::IsTrue(b1.intersect_ray(vector3{ -1.0, 0.5, 0.5 }, vector3{ 1.0, 0.0, 0.0 }, &d1));
+			Assert::AreEqual(1.0, d1);
+
+			Assert::IsFalse(b1.intersect_ray(vector3{ -1.0, 0.5, 0.5 }, vector3{ -1.0, 0.0, 0.0 }));
+			Assert::IsFalse(b1.intersect_ray(vector3{ -1.0, 2.0, 0.5 }, vector3{ 1.0, 0.0, 0.0 }));
+
+			// Rays starting inside report zero entry distance
+			double d2 = 1.0;
+			Assert::IsTrue(b1.intersect_ray(vector3{ 0.5, 0.5, 0.5 }, vector3{ 0.0, 1.0, 0.0 }, &d2));
+			Assert::AreEqual(0.0, d2);
+		}
+	};
+}
@@ -0,0 +1,369 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_bvh.hpp"
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_bvh)
+	{
+		/// Make a UV sphere with outward facing triangles, optionally leaving out the top rings
+		static indexed_mesh make_sphere(const std::uint32_t p_rings, const std::uint32_t p_segments, const std::uint32_t p_skip_rings = 0)
+		{
+			const double pi = 3.14159265358979323846;
+			indexed_mesh mesh;
+			for (std::uint32_t r = 0; r <= p_rings; ++r)
+			{
+				const double theta = pi * r / p_rings;
+				for (std::uint32_t s = 0; s < p_segments; ++s)
+				{
+					const double phi = 2.0 * pi * s / p_segments;
+					mesh.add_vertex(vector3{ std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) });
+				}
+			}
+
+			for (std::uint32_t r = p_skip_rings; r < p_rings; ++r)
+			{
+				for (std::uint32_t s = 0; s < p_segments; ++s)
+				{
+					const std::uint32_t a = r * p_segments + s;
+					const std::uint32_t b = r * p_segments + (s + 1) % p_segments;
+					const std::uint32_t c = a + p_segments;
+					const std::uint32_t d = b + p_segments;
+					if (r != 0)
+						mesh.add_triangle(a, c, b);
+					if (r + 1 != p_rings)
+						mesh.add_triangle(b, c, d);
+				}
+			}
+			return mesh;
+		}
+
+		/// Make random query points in a cube
+		static std::vector<vector3> make_points(const std::size_t p_count, const double p_extent, const unsigned p_seed)
+		{
+			std::mt19937 rng(p_seed);
+			std::uniform_real_distribution<double> dist(-p_extent, p_extent);
+			std::vector<vector3> points(p_count);
+			for (auto& p : points)
+				p = vector3{ dist(rng), dist(rng), dist(rng) };
+			return points;
+		}
+
+		/// Check every triangle sits in exactly one leaf inside every ancestor's bounds and matches the mesh
+		static void check_hierarchy(const mesh::mesh_bvh& p_bvh, const indexed_mesh& p_mesh)
+		{
+			const auto& nodes = p_bvh.nodes();
+			std::vector<int> seen(p_mesh.triangle_count(), 0);
+			std::vector<std::uint32_t> stack = { 0 };
+			while (!stack.empty())
+			{
+				const bvh_node node = nodes[stack.back()];
+				stack.pop_back();
+				if (node.is_leaf())
+				{
+					for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+					{
+						const triangle3& tri = p_bvh.triangles()[i];
+						Assert::IsTrue(node.bounds.contains(tri.point1) && node.bounds.contains(tri.point2) && node.bounds.contains(tri.point3));
+						const triangle3 expected = p_mesh.triangle(p_bvh.triangle_indices()[i]);
+						Assert::IsTrue(tri.point1 == expected.point1 && tri.point2 == expected.point2 && tri.point3 == expected.point3);
+						++seen[p_bvh.triangle_indices()[i]];
+					}
+					continue;
+				}
+
+				for (const std::uint32_t child : { node.first, node.first + 1 })
+				{
+					Assert::IsTrue(node.bounds.contains(nodes[child].bounds.minimum));
+					Assert::IsTrue(node.bounds.contains(nodes[child].bounds.maximum));
+					stack.push_back(child);
+				}
+			}
+			for (const int n : seen)
+				Assert::AreEqual(1, n);
+		}
+
+		/// Check closest points and winding numbers against brute force
+		static void check_queries(const mesh::mesh_bvh& p_bvh, const indexed_mesh& p_mesh, const std::vector<vector3>& p_points)
+		{
+			for (const auto& p : p_points)
+			{
+				double best = std::numeric_limits<double>::infinity();
+				double exact = 0.0;
+				for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+				{
+					best = std::min(best, p_mesh.triangle(t).distance2_to(p));
+					exact += p_mesh.triangle(t).solid_angle(p);
+				}
+				Assert::AreEqual(best, p_bvh.closest_point(p).distance2, 1e-12);
+				Assert::AreEqual(exact / (4.0 * 3.14159265358979323846), p_bvh.winding_number(p, 100.0), 1e-9);
+			}
+		}
+
+	public:
+		TEST_METHOD(test_build)
+		{
+			const indexed_mesh mesh = make_sphere(24, 48);
+			const mesh::mesh_bvh bvh(mesh);
+			Assert::IsFalse(bvh.empty());
+			Assert::AreEqual(bvh.nodes().size(), bvh.expansions().size());
+			for (const bvh_node& node : bvh.nodes())
+				Assert::IsTrue(node.count <= 4);
+			check_hierarchy(bvh, mesh);
+			Assert::AreEqual(1.0, bvh.quality(), 1e-12);
+		}
+
+		TEST_METHOD(test_closest_point)
+		{
+			const indexed_mesh mesh = make_sphere(20, 40);
+			const mesh::mesh_bvh bvh(mesh);
+			const std::vector<vector3> points = make_points(500, 2.0, 7);
+			std::vector<bvh_closest_hit> hits(points.size());
+			bvh.closest_points(points.data(), points.size(), hits.data());
+
+			// Matches a brute force search
+			for (std::size_t i = 0; i < points.size(); ++i)
+			{
+				double best = std::numeric_limits<double>::infinity();
+				for (std::size_t t = 0; t < mesh.triangle_count(); ++t)
+					best = std::min(best, mesh.triangle(t).distance2_to(points[i]));
+
+				Assert::IsTrue(hits[i].hit);
+				Assert::AreEqual(best, hits[i].distance2, 1e-12);
+				Assert::AreEqual(hits[i].distance2, (hits[i].point - points[i]).length2(), 1e-12);
+				Assert::AreEqual(best, mesh.triangle(hits[i].triangle).distance2_to(points[i]), 1e-12);
+			}
+
+			// Range limited queries
+			Assert::IsFalse(bvh.closest_point(vector3{ 5.0, 0.0, 0.0 }, 3.0).hit);
+			Assert::IsTrue(bvh.closest_point(vector3{ 5.0, 0.0, 0.0 }, 4.1).hit);
+			Assert::IsFalse(mesh::mesh_bvh{}.closest_point(vector3{ 0.0, 0.0, 0.0 }).hit);
+		}
+
+		TEST_METHOD(test_intersect_ray)
+		{
+			const indexed_mesh mesh = make_sphere(20, 40);
+			const mesh::mesh_bvh bvh(mesh);
+			const std::vector<vector3> origins = make_points(200, 3.0, 11);
+			const std::vector<vector3> directions = make_points(200, 1.0, 12);
+			for (std::size_t i = 0; i < origins.size(); ++i)
+			{
+				double best = std::numeric_limits<double>::infinity();
+				for (std::size_t t = 0; t < mesh.triangle_count(); ++t)
+				{
+					double dist = 0.0;
+					if (mesh.triangle(t).intersect_ray(origins[i], directions[i], nullptr, &dist))
+						best = std::min(best, dist);
+				}
+
+				const bvh_ray_hit hit = bvh.intersect_ray(origins[i], directions[i]);
+				Assert::AreEqual(std::isfinite(best), hit.hit);
+				if (hit.hit)
+					Assert::AreEqual(best, hit.distance, 1e-12);
+			}
+		}
+
+		TEST_METHOD(test_intersect_rays)
+		{
+			const indexed_mesh mesh = make_sphere(20, 40);
+			const mesh::mesh_bvh bvh(mesh);
+			const std::vector<vector3> origins = make_points(400, 0.5, 13);
+			const std::vector<vector3> jitter = make_points(400, 0.2, 14);
+			std::size_t coherent_hits = 0;
+			for (std::size_t p = 0; p + 8 <= origins.size(); p += 8)
+			{
+				// Alternate coherent bundles aimed past the sphere with scattered rays
+				const bool coherent = (p / 8) % 2 == 0;
+				ray_packet<8> packet;
+				for (std::size_t lane = 0; lane < 8; ++lane)
+				{
+					const vector3 direction = coherent ? vector3{ 1.0, 0.3, 0.2 } + jitter[p + lane] : jitter[p + lane];
+					packet.set(lane, origins[p + lane] - vector3{ 4.0, 1.2, 0.8 } * (coherent ? 1.0 : 0.0), direction, lane == 3 ? 2.5 : std::numeric_limits<double>::infinity());
+				}
+				const ray_packet<8> original = packet;
+
+				// Lane 5 is inactive and keeps its distance
+				const ray_mask active = ray_packet<8>::all & ~ray_mask{ 1u << 5 };
+				ray_packet_hit<8> hit;
+				const ray_mask mask = bvh.intersect_rays(packet, hit, active);
+				Assert::AreEqual(original.max_distance[5], packet.max_distance[5]);
+				for (std::size_t lane = 0; lane < 8; ++lane)
+				{
+					const bvh_ray_hit expected = bvh.intersect_ray(original.origin(lane), original.direction(lane), original.max_distance[lane]);
+					const bool lane_hit = ((mask >> lane) & 1) != 0;
+					Assert::AreEqual(lane != 5 && expected.hit, lane_hit);
+					if (lane_hit)
+					{
+						Assert::AreEqual(expected.distance, hit.distance[lane], 1e-9);
+						Assert::AreEqual(expected.distance, packet.max_distance[lane], 1e-9);
+						double dist = 0.0;
+						Assert::IsTrue(mesh.triangle(hit.index[lane]).intersect_ray(original.origin(lane), original.direction(lane), nullptr, &dist));
+						Assert::AreEqual(hit.distance[lane], dist, 1e-9);
+						coherent_hits += coherent ? 1 : 0;
+					}
+				}
+			}
+			Assert::IsTrue(coherent_hits > 100);
+
+			// An empty hierarchy misses
+			ray_packet<4> packet;
+			ray_packet_hit<4> hit;
+			Assert::AreEqual(ray_mask{ 0 }, mesh::mesh_bvh{}.intersect_rays(packet, hit));
+		}
+
+		TEST_METHOD(test_winding_number)
+		{
+			const indexed_mesh mesh = make_sphere(32, 64);
+			const mesh::mesh_bvh bvh(mesh);
+			const std::vector<vector3> points = make_points(1000, 1.5, 5);
+			std::vector<double> winding(points.size());
+			bvh.winding_numbers(points.data(), points.size(), winding.data());
+
+			// Close to the exact sum, and classifying points away from the surface correctly
+			const double pi = 3.14159265358979323846;
+			for (std::size_t i = 0; i < points.size(); ++i)
+			{
+				double exact = 0.0;
+				for (std::size_t t = 0; t < mesh.triangle_count(); ++t)
+					exact += mesh.triangle(t).solid_angle(points[i]);
+				exact /= 4.0 * pi;
+
+				Assert::AreEqual(exact, winding[i], 0.08);
+				Assert::AreEqual(exact, bvh.winding_number(points[i], 4.0), 0.02);
+				Assert::AreEqual(exact, bvh.winding_number(points[i], 100.0), 1e-9);
+				const double radius = points[i].length();
+				if (radius < 0.98)
+					Assert::IsTrue(winding[i] > 0.9);
+				else if (radius > 1.02)
+					Assert::IsTrue(winding[i] < 0.1);
+			}
+
+			std::size_t expected = 0;
+			for (const auto& p : points)
+				expected += p.length() < 0.98 ? 1 : 0;
+			std::unique_ptr<bool[]> inside(new bool[points.size()]);
+			const std::size_t count = bvh.contains(points.data(), points.size(), inside.get());
+			Assert::IsTrue(count >= expected);
+			Assert::IsTrue(count <= expected + 20);
+		}
+
+		TEST_METHOD(test_winding_number_open)
+		{
+			// Points inside a sphere with its top cap removed are still classified
+			const mesh::mesh_bvh bvh(make_sphere(32, 64, 4));
+			Assert::IsTrue(bvh.contains(vector3{ 0.0, 0.0, 0.0 }));
+			Assert::IsTrue(bvh.contains(vector3{ 0.0, 0.0, -0.5 }));
+			Assert::IsFalse(bvh.contains(vector3{ 0.0, 0.0, -1.5 }));
+			Assert::IsFalse(bvh.contains(vector3{ 2.0, 0.0, 0.0 }));
+			Assert::AreEqual(0.0, mesh::mesh_bvh{}.winding_number(vector3{ 0.0, 0.0, 0.0 }));
+		}
+
+		TEST_METHOD(test_refit)
+		{
+			indexed_mesh mesh = make_sphere(24, 48);
+			mesh::mesh_bvh bvh(mesh);
+			const std::size_t node_count = bvh.nodes().size();
+
+			// Stretch and twist every vertex
+			for (auto& v : mesh.vertices)
+			{
+				const double angle = v.z * 0.5;
+				v = vector3{ v.x * std::cos(angle) - v.y * std::sin(angle), v.x * std::sin(angle) + v.y * std::cos(angle), v.z * 1.5 };
+			}
+			const bvh_refit_result result = bvh.refit(mesh);
+			Assert::IsTrue(result.ok);
+			Assert::AreEqual(mesh.triangle_count(), result.refitted_triangles);
+			Assert::AreEqual(node_count, result.refitted_nodes);
+			Assert::AreEqual(size_t{ 0 }, result.rebuilt_subtrees);
+			check_hierarchy(bvh, mesh);
+			check_queries(bvh, mesh, make_points(100, 2.0, 21));
+
+			// Quality stays close to a fresh build for a smooth deformation
+			Assert::IsTrue(bvh.quality() < 1.5);
+			Assert::AreEqual(mesh::mesh_bvh(mesh).sah_cost(), bvh.sah_cost(), bvh.sah_cost() * 0.5);
+
+			// Topology changes are rejected
+			indexed_mesh other = mesh;
+			other.add_vertex(vector3{ 0.0, 0.0, 0.0 });
+			Assert::IsFalse(bvh.refit(other).ok);
+			other = mesh;
+			other.add_triangle(0, 1, 2);
+			Assert::IsFalse(bvh.refit(other).ok);
+			Assert::IsTrue(mesh::mesh_bvh{}.refit(indexed_mesh{}).ok);
+		}
+
+		TEST_METHOD(test_refit_partial)
+		{
+			indexed_mesh mesh = make_sphere(32, 64);
+			mesh::mesh_bvh bvh(mesh);
+
+			// Push out two rings of vertices
+			const bvh_vertex_range ranges[2] = { { 10 * 64, 64 }, { 11 * 64, 64 } };
+			for (std::uint32_t v = 10 * 64; v < 12 * 64; ++v)
+				mesh.vertices[v] = mesh.vertices[v] * 1.05;
+			const bvh_refit_result result = bvh.refit(mesh, ranges, 2);
+			Assert::IsTrue(result.ok);
+
+			// Only the triangles touching the rings and their ancestors are updated
+			std::size_t touching = 0;
+			for (std::size_t t = 0; t < mesh.triangle_count(); ++t)
+			{
+				bool moved = false;
+				for (int c = 0; c < 3; ++c)
+					moved = moved || (mesh.indices[t * 3 + c] >= 10 * 64 && mesh.indices[t * 3 + c] < 12 * 64);
+				touching += moved ? 1 : 0;
+			}
+			Assert::AreEqual(touching, result.refitted_triangles);
+			Assert::IsTrue(result.refitted_nodes < bvh.nodes().size() / 2);
+			check_hierarchy(bvh, mesh);
+			check_queries(bvh, mesh, make_points(100, 1.5, 22));
+
+			// Nothing moved, nothing refitted; out of range vertices are ignored
+			const bvh_vertex_range outside = { 1000000, 10 };
+			Assert::AreEqual(size_t{ 0 }, bvh.refit(mesh, &outside, 1).refitted_nodes);
+		}
+
+		TEST_METHOD(test_partial_rebuild)
+		{
+			indexed_mesh mesh = make_sphere(32, 64);
+			mesh::mesh_bvh bvh(mesh);
+
+			// Scatter one cap of the sphere so its subtrees overlap badly
+			std::mt19937 rng(5);
+			std::uniform_real_distribution<double> dist(-1.0, 1.0);
+			const std::uint32_t cap = 8 * 64;
+			for (std::uint32_t v = 0; v < cap; ++v)
+				mesh.vertices[v] = vector3{ dist(rng), dist(rng), dist(rng) };
+			const bvh_vertex_range range = { 0, cap };
+
+			mesh::mesh_bvh refitted = bvh;
+			bvh_refit_options no_rebuild;
+			no_rebuild.rebuild_threshold = 0.0;
+			Assert::AreEqual(size_t{ 0 }, refitted.refit(mesh, &range, 1, no_rebuild).rebuilt_subtrees);
+
+			const bvh_refit_result result = bvh.refit(mesh, &range, 1);
+			Assert::IsTrue(result.ok);
+			Assert::IsTrue(result.rebuilt_subtrees > 0);
+			Assert::IsTrue(result.rebuilt_triangles < mesh.triangle_count());
+			Assert::IsTrue(bvh.sah_cost() < refitted.sah_cost());
+			check_hierarchy(bvh, mesh);
+			check_hierarchy(refitted, mesh);
+			check_queries(bvh, mesh, make_points(100, 1.5, 23));
+
+			// Rebuilt subtrees keep working with later refits
+			for (std::uint32_t v = 0; v < cap; ++v)
+				mesh.vertices[v] = mesh.vertices[v] * 0.5;
+			Assert::IsTrue(bvh.refit(mesh, &range, 1).ok);
+			check_hierarchy(bvh, mesh);
+			check_queries(bvh, mesh, make_points(50, 1.5, 24));
+			Assert::IsTrue(bvh.refit(mesh).ok);
+			check_hierarchy(bvh, mesh);
+		}
+	};
+}
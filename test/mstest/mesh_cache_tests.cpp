@@ -0,0 +1,156 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_cache.hpp"
+
+#include <cstdio>
+#include <filesystem>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_cache)
+	{
+		/// Make a small two-triangle mesh
+		static indexed_mesh make_quad()
+		{
+			indexed_mesh mesh;
+			mesh.add_vertex(vector3{ 0.0, 0.0, 0.0 });
+			mesh.add_vertex(vector3{ 1.0, 0.0, 0.0 });
+			mesh.add_vertex(vector3{ 1.0, 1.0, 0.0 });
+			mesh.add_vertex(vector3{ 0.0, 1.0, 0.5 });
+			mesh.add_triangle(0, 1, 2);
+			mesh.add_triangle(0, 2, 3);
+			return mesh;
+		}
+
+	public:
+		TEST_METHOD(test_memory_round_trip)
+		{
+			const indexed_mesh mesh = make_quad();
+			const std::vector<std::uint32_t> adjacency = compute_edge_adjacency(mesh);
+			mesh_cache_writer writer{ mesh };
+			writer.add_section(mesh_cache_section::edge_adjacency, adjacency.data(), adjacency.size());
+			const std::vector<std::uint8_t> bytes = writer.serialize();
+			Assert::AreEqual(size_t{ 0 }, bytes.size() % 64);
+
+			mesh::mesh_cache cache;
+			Assert::IsTrue(cache.open(bytes.data(), bytes.size()) == mesh_cache_status::ok);
+			Assert::IsTrue(cache.is_open());
+			Assert::AreEqual(size_t{ 4 }, cache.vertex_count());
+			Assert::AreEqual(size_t{ 2 }, cache.triangle_count());
+
+			// Sections point into the buffer at aligned offsets
+			Assert::IsTrue(reinterpret_cast<const std::uint8_t*>(cache.positions()) >= bytes.data());
+			Assert::AreEqual(size_t{ 0 }, static_cast<size_t>(reinterpret_cast<const std::uint8_t*>(cache.positions()) - bytes.data()) % 64);
+
+			const indexed_mesh loaded = cache.to_mesh();
+			Assert::IsTrue(loaded.vertices == mesh.vertices);
+			Assert::IsTrue(loaded.indices == mesh.indices);
+
+			std::size_t count = 0;
+			const std::uint32_t* loaded_adjacency = cache.section<std::uint32_t>(mesh_cache_section::edge_adjacency, count);
+			Assert::AreEqual(adjacency.size(), count);
+			Assert::IsTrue(std::equal(adjacency.begin(), adjacency.end(), loaded_adjacency));
+
+			// Missing sections and mismatched element types
+			Assert::IsFalse(cache.has_section(mesh_cache_section::texcoords));
+			Assert::IsNull(cache.section<std::uint32_t>(mesh_cache_section::normals, count));
+			Assert::IsNull(cache.section<std::uint64_t>(mesh_cache_section::indices, count));
+			Assert::AreEqual(size_t{ 0 }, count);
+		}
+
+		TEST_METHOD(test_file_round_trip)
+		{
+			const indexed_mesh mesh = make_quad();
+			const std::string path = (std::filesystem::temp_directory_path() / "mesh_cache_test.bin").string();
+			Assert::IsTrue(mesh_cache_writer{ mesh }.write(path));
+
+			{
+				mesh::mesh_cache cache;
+				Assert::IsTrue(cache.open(path) == mesh_cache_status::ok);
+				Assert::IsTrue(cache.to_mesh().vertices == mesh.vertices);
+				Assert::IsTrue(cache.to_mesh().indices == mesh.indices);
+
+				cache.close();
+				Assert::IsFalse(cache.is_open());
+				Assert::IsTrue(cache.open(path, false) == mesh_cache_status::ok);
+			}
+
+			std::remove(path.c_str());
+			mesh::mesh_cache missing;
+			Assert::IsTrue(missing.open(path) == mesh_cache_status::open_failed);
+		}
+
+		TEST_METHOD(test_validation)
+		{
+			const indexed_mesh mesh = make_quad();
+			const std::vector<std::uint8_t> bytes = mesh_cache_writer{ mesh }.serialize();
+			mesh::mesh_cache cache;
+
+			// Truncation
+			Assert::IsTrue(cache.open(bytes.data(), 10) == mesh_cache_status::truncated);
+			Assert::IsTrue(cache.open(bytes.data(), bytes.size() - 64) == mesh_cache_status::truncated);
+
+			// Bad magic and version
+			std::vector<std::uint8_t> bad(bytes);
+			bad[0] = 'X';
+			Assert::IsTrue(cache.open(bad.data(), bad.size()) == mesh_cache_status::bad_magic);
+			bad = bytes;
+			bad[8] = 99;
+			Assert::IsTrue(cache.open(bad.data(), bad.size()) == mesh_cache_status::bad_version);
+
+			// Corrupted payload fails the checksum only when verifying
+			bad = bytes;
+			bad[bad.size() - 70] ^= 0x40;
+			Assert::IsTrue(cache.open(bad.data(), bad.size()) == mesh_cache_status::checksum_mismatch);
+			Assert::IsTrue(cache.open(bad.data(), bad.size(), false) == mesh_cache_status::ok);
+
+			// Section beyond the end of the data
+			bad = bytes;
+			mesh_cache_section_entry entry;
+			std::memcpy(&entry, bad.data() + 64, sizeof(entry));
+			entry.count = 1000000;
+			std::memcpy(bad.data() + 64, &entry, sizeof(entry));
+			Assert::IsTrue(cache.open(bad.data(), bad.size(), false) == mesh_cache_status::truncated);
+
+			// Sections overlapping the header or the section table
+			for (const std::uint64_t offset : { 0, 64 })
+			{
+				bad = bytes;
+				std::memcpy(&entry, bad.data() + 64, sizeof(entry));
+				entry.offset = offset;
+				entry.count = 1;
+				std::memcpy(bad.data() + 64, &entry, sizeof(entry));
+				Assert::IsTrue(cache.open(bad.data(), bad.size(), false) == mesh_cache_status::bad_section);
+			}
+
+			// Well-known sections must use the library's element types
+			const float float_texcoords[4][2] = {};
+			mesh_cache_writer float_writer{ mesh };
+			float_writer.add_section(mesh_cache_section::texcoords, float_texcoords, sizeof(float_texcoords[0]), 4);
+			const std::vector<std::uint8_t> float_bytes = float_writer.serialize();
+			Assert::IsTrue(cache.open(float_bytes.data(), float_bytes.size()) == mesh_cache_status::bad_section);
+			Assert::IsFalse(cache.is_open());
+			const std::vector<vector2> texcoords(mesh.vertex_count(), vector2{ 0.5, 0.5 });
+			mesh_cache_writer uv_writer{ mesh };
+			uv_writer.add_section(mesh_cache_section::texcoords, texcoords.data(), texcoords.size());
+			const std::vector<std::uint8_t> uv_bytes = uv_writer.serialize();
+			Assert::IsTrue(cache.open(uv_bytes.data(), uv_bytes.size()) == mesh_cache_status::ok);
+
+			// Caller memory must be aligned before anything is read in place
+			std::vector<std::uint64_t> shifted(bytes.size() / 8 + 1);
+			auto* unaligned = reinterpret_cast<std::uint8_t*>(shifted.data()) + 4;
+			std::memcpy(unaligned, bytes.data(), bytes.size());
+			Assert::IsTrue(cache.open(unaligned, bytes.size()) == mesh_cache_status::misaligned);
+			Assert::IsFalse(cache.is_open());
+
+			// Out of range indices are rejected when verifying
+			indexed_mesh broken = mesh;
+			broken.indices[4] = 17;
+			const std::vector<std::uint8_t> broken_bytes = mesh_cache_writer{ broken }.serialize();
+			Assert::IsTrue(cache.open(broken_bytes.data(), broken_bytes.size()) == mesh_cache_status::bad_section);
+			Assert::IsFalse(cache.is_open());
+		}
+	};
+}
@@ -0,0 +1,204 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_curvature.hpp"
+#include "mesh/mesh_primitives.hpp"
+
+#include <cmath>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_curvature)
+	{
+		static constexpr double pi = 3.14159265358979323846;
+
+		/// Open cylinder along Z
+		static indexed_mesh make_cylinder(const double p_radius, const double p_height, const std::uint32_t p_segments, const std::uint32_t p_rings)
+		{
+			indexed_mesh mesh;
+			for (std::uint32_t r = 0; r <= p_rings; ++r)
+			{
+				for (std::uint32_t s = 0; s < p_segments; ++s)
+				{
+					const double a = 2.0 * pi * (s + 0.5 * (r % 2)) / p_segments;
+					mesh.add_vertex(vector3(p_radius * std::cos(a), p_radius * std::sin(a), p_height * r / p_rings));
+				}
+			}
+			for (std::uint32_t r = 0; r < p_rings; ++r)
+			{
+				for (std::uint32_t s = 0; s < p_segments; ++s)
+				{
+					const std::uint32_t a = r * p_segments + s;
+					const std::uint32_t b = r * p_segments + (s + 1) % p_segments;
+					const std::uint32_t c = (r + 1) * p_segments + s;
+					const std::uint32_t d = (r + 1) * p_segments + (s + 1) % p_segments;
+					if (r % 2 == 0)
+					{
+						mesh.add_triangle(a, b, c);
+						mesh.add_triangle(b, d, c);
+					}
+					else
+					{
+						mesh.add_triangle(a, d, c);
+						mesh.add_triangle(a, b, d);
+					}
+				}
+			}
+			return mesh;
+		}
+
+		static double surface_area(const indexed_mesh& p_mesh)
+		{
+			double area = 0.0;
+			for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+				area += p_mesh.triangle(t).normal().length() * 0.5;
+			return area;
+		}
+
+	public:
+		TEST_METHOD(test_laplacian)
+		{
+			const indexed_mesh sphere = make_icosphere<3>(1.0).to_mesh();
+			const sparse_matrix l = build_cotangent_laplacian(sphere);
+			Assert::AreEqual(sphere.vertex_count(), l.rows);
+			Assert::AreEqual(sphere.vertex_count() + sphere.triangle_count() * 3, l.nonzeros());
+
+			// Symmetric with zero row sums
+			for (std::size_t i = 0; i < l.rows; ++i)
+			{
+				double sum = 0.0;
+				for (std::uint32_t k = l.offsets[i]; k < l.offsets[i + 1]; ++k)
+				{
+					sum += l.values[k];
+					Assert::AreEqual(l.values[k], l.at(l.columns[k], i), 1e-14);
+					Assert::IsTrue(k == l.offsets[i] || l.columns[k - 1] < l.columns[k]);
+				}
+				Assert::AreEqual(0.0, sum, 1e-12);
+				Assert::IsTrue(l.at(i, i) < 0.0);
+			}
+
+			// Linear functions are harmonic at interior vertices of a plane
+			const indexed_mesh grid = make_grid<6, 6>(3.0, 2.0).to_mesh();
+			const sparse_matrix lg = build_cotangent_laplacian(grid);
+			std::vector<double> f(grid.vertex_count());
+			for (std::size_t v = 0; v < f.size(); ++v)
+				f[v] = 2.0 * grid.vertices[v].x - 3.0 * grid.vertices[v].y;
+			std::vector<double> lf(f.size());
+			lg.multiply(f.data(), lf.data());
+			for (std::size_t v = 0; v < f.size(); ++v)
+			{
+				if (std::abs(grid.vertices[v].x) < 1.49 && std::abs(grid.vertices[v].y) < 0.99)
+					Assert::AreEqual(0.0, lf[v], 1e-12);
+			}
+		}
+
+		TEST_METHOD(test_vertex_areas)
+		{
+			for (const indexed_mesh& mesh : { make_icosphere<3>(2.0).to_mesh(), make_grid<5, 3>(3.0, 2.0).to_mesh(), make_cylinder(1.0, 0.5, 32, 4) })
+			{
+				const std::vector<double> areas = compute_vertex_areas(mesh);
+				double sum = 0.0;
+				for (const double a : areas)
+				{
+					Assert::IsTrue(a > 0.0);
+					sum += a;
+				}
+				Assert::AreEqual(surface_area(mesh), sum, 1e-12);
+			}
+		}
+
+		TEST_METHOD(test_sphere)
+		{
+			const indexed_mesh sphere = make_icosphere<4>(2.0).to_mesh();
+			const std::vector<double> areas = compute_vertex_areas(sphere);
+			const std::vector<vertex_curvature> curvature = compute_curvature(sphere);
+			double total = 0.0;
+			for (std::size_t v = 0; v < sphere.vertex_count(); ++v)
+			{
+				const vertex_curvature& c = curvature[v];
+				Assert::AreEqual(0.5, c.mean, 0.01);
+				Assert::AreEqual(0.25, c.gaussian, 0.01);
+				Assert::IsTrue(c.k1 >= c.k2);
+				Assert::AreEqual(1.0, c.normal.dot(sphere.vertices[v] * 0.5), 1e-3);
+				Assert::AreEqual(0.0, c.direction1.dot(c.normal), 1e-12);
+				Assert::AreEqual(0.0, c.direction1.dot(c.direction2), 1e-12);
+				total += c.gaussian * areas[v];
+			}
+
+			// Gauss-Bonnet holds exactly for the angle defect
+			Assert::AreEqual(4.0 * pi, total, 1e-9);
+		}
+
+		TEST_METHOD(test_cylinder)
+		{
+			const double radius = 2.0;
+			const indexed_mesh cylinder = make_cylinder(radius, 2.0, 64, 16);
+			const std::vector<vertex_curvature> curvature = compute_curvature(cylinder);
+			for (std::size_t v = 64; v < cylinder.vertex_count() - 64; ++v)
+			{
+				const vertex_curvature& c = curvature[v];
+				Assert::AreEqual(0.5 / radius, c.mean, 0.01);
+				Assert::AreEqual(0.0, c.gaussian, 1e-9);
+				Assert::AreEqual(1.0 / radius, c.k1, 0.02);
+				Assert::AreEqual(0.0, c.k2, 0.02);
+
+				// Bending runs around the axis, the flat direction along it
+				Assert::IsTrue(std::abs(c.direction1.z) < 0.05);
+				Assert::IsTrue(std::abs(c.direction2.z) > 0.99);
+			}
+		}
+
+		TEST_METHOD(test_smooth)
+		{
+			// Radial noise on a sphere
+			indexed_mesh noisy = make_icosphere<4>(1.0).to_mesh();
+			for (std::size_t v = 0; v < noisy.vertex_count(); ++v)
+				noisy.vertices[v] = noisy.vertices[v] * (1.0 + 0.02 * std::sin(37.0 * static_cast<double>(v)));
+			auto deviation = [](const indexed_mesh& p_mesh, double& p_mean)
+			{
+				double sum = 0.0;
+				double sum2 = 0.0;
+				for (const auto& v : p_mesh.vertices)
+				{
+					sum += v.length();
+					sum2 += v.length2();
+				}
+				const double n = static_cast<double>(p_mesh.vertex_count());
+				p_mean = sum / n;
+				return std::sqrt(std::max(sum2 / n - p_mean * p_mean, 0.0));
+			};
+			double mean = 0.0;
+			const double before = deviation(noisy, mean);
+
+			// One assembled operator serves every iteration
+			const sparse_matrix laplacian = build_cotangent_laplacian(noisy);
+			indexed_mesh plain = noisy;
+			smooth_laplacian(plain, laplacian);
+			double plain_mean = 0.0;
+			Assert::IsTrue(deviation(plain, plain_mean) < 0.2 * before);
+
+			indexed_mesh taubin = noisy;
+			smoothing_options options;
+			options.lambda = 0.5;
+			options.mu = -0.53;
+			options.iterations = 20;
+			smooth_laplacian(taubin, laplacian, options);
+			double taubin_mean = 0.0;
+			Assert::IsTrue(deviation(taubin, taubin_mean) < 0.5 * before);
+			Assert::IsTrue(std::abs(taubin_mean - mean) < std::abs(plain_mean - mean));
+
+			// Boundary vertices stay put
+			indexed_mesh grid = make_grid<6, 6>(3.0, 2.0).to_mesh();
+			for (auto& v : grid.vertices)
+				v.z = 0.1 * std::sin(11.0 * v.x + 7.0 * v.y);
+			const indexed_mesh original = grid;
+			smooth_laplacian(grid, build_cotangent_laplacian(grid));
+			for (std::size_t v = 0; v < grid.vertex_count(); ++v)
+			{
+				const bool edge = std::abs(original.vertices[v].x) > 1.49 || std::abs(original.vertices[v].y) > 0.99;
+				Assert::AreEqual(edge, grid.vertices[v] == original.vertices[v]);
+			}
+		}
+	};
+}
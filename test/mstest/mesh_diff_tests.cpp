@@ -0,0 +1,182 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_diff.hpp"
+#include "mesh/mesh_primitives.hpp"
+
+#include <algorithm>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_diff)
+	{
+		/// Reverse the vertex order, reverse the triangle order and rotate every triangle's corners
+		static indexed_mesh shuffle(const indexed_mesh& p_mesh)
+		{
+			indexed_mesh result;
+			const std::size_t n = p_mesh.vertex_count();
+			result.vertices.assign(p_mesh.vertices.rbegin(), p_mesh.vertices.rend());
+			for (std::size_t t = p_mesh.triangle_count(); t-- > 0;)
+			{
+				for (std::size_t c = 0; c < 3; ++c)
+					result.indices.push_back(static_cast<std::uint32_t>(n - 1 - p_mesh.indices[t * 3 + (c + t) % 3]));
+			}
+			return result;
+		}
+
+	public:
+		TEST_METHOD(test_hash)
+		{
+			const indexed_mesh sphere = make_icosphere<3>(1.0).to_mesh();
+			const std::uint64_t hash = geometric_hash(sphere);
+			Assert::AreEqual(hash, geometric_hash(shuffle(sphere)));
+
+			// Unused vertices do not count; moved vertices and flipped winding do
+			indexed_mesh extra = sphere;
+			extra.vertices.push_back(vector3(5.0, 5.0, 5.0));
+			Assert::AreEqual(hash, geometric_hash(extra));
+			indexed_mesh moved = sphere;
+			moved.vertices[17] += vector3(1e-4, 0.0, 0.0);
+			Assert::AreNotEqual(hash, geometric_hash(moved));
+			indexed_mesh flipped = sphere;
+			std::swap(flipped.indices[1], flipped.indices[2]);
+			Assert::AreNotEqual(hash, geometric_hash(flipped));
+
+			// A coarser grid absorbs the move
+			const indexed_mesh box = make_box(vector3{ 1.0, 1.0, 1.0 }).to_mesh();
+			indexed_mesh nudged = shuffle(box);
+			nudged.vertices[3] += vector3(1e-4, 0.0, 0.0);
+			Assert::AreEqual(geometric_hash(box, 0.25), geometric_hash(nudged, 0.25));
+			Assert::AreNotEqual(geometric_hash(box), geometric_hash(nudged));
+			Assert::AreNotEqual(hash, geometric_hash(indexed_mesh{}));
+		}
+
+		TEST_METHOD(test_identical)
+		{
+			// Reordering and noise below the tolerance are not changes
+			const indexed_mesh sphere = make_icosphere<3>(1.0).to_mesh();
+			indexed_mesh noisy = shuffle(sphere);
+			for (std::size_t v = 0; v < noisy.vertex_count(); ++v)
+				noisy.vertices[v] += vector3(((v * 7) % 5 - 2.0) * 2e-7, ((v * 3) % 5 - 2.0) * 2e-7, 0.0);
+			const mesh::mesh_diff diff = diff_meshes(sphere, noisy);
+			Assert::IsTrue(diff.identical());
+			Assert::IsTrue(diff.regions.empty());
+			for (std::size_t t = 0; t < sphere.triangle_count(); ++t)
+				Assert::AreEqual(static_cast<std::uint32_t>(sphere.triangle_count() - 1 - t), diff.matches[t]);
+		}
+
+		TEST_METHOD(test_regions)
+		{
+			// Two vertices on opposite sides move: each changes its fan of triangles
+			const indexed_mesh sphere = make_icosphere<3>(1.0).to_mesh();
+			std::uint32_t top = 0;
+			std::uint32_t bottom = 0;
+			for (std::uint32_t v = 0; v < sphere.vertex_count(); ++v)
+			{
+				if (sphere.vertices[v].z > sphere.vertices[top].z)
+					top = v;
+				if (sphere.vertices[v].z < sphere.vertices[bottom].z)
+					bottom = v;
+			}
+			indexed_mesh edited = sphere;
+			edited.vertices[top] *= 1.1;
+			edited.vertices[bottom] *= 0.9;
+
+			const mesh::mesh_diff diff = diff_meshes(sphere, edited);
+			std::vector<std::uint32_t> expected;
+			for (std::uint32_t t = 0; t < sphere.triangle_count(); ++t)
+			{
+				const std::uint32_t* tri = sphere.indices.data() + t * 3;
+				if (std::find(tri, tri + 3, top) != tri + 3 || std::find(tri, tri + 3, bottom) != tri + 3)
+					expected.push_back(t);
+			}
+			Assert::IsTrue(diff.removed == expected);
+			Assert::IsTrue(diff.added == expected);
+			Assert::AreEqual(size_t{ 2 }, diff.regions.size());
+			for (const auto& region : diff.regions)
+			{
+				Assert::AreEqual(region.removed.size(), region.added.size());
+				const bool has_top = region.bounds.contains(edited.vertices[top]) && region.bounds.contains(sphere.vertices[top]);
+				const bool has_bottom = region.bounds.contains(edited.vertices[bottom]) && region.bounds.contains(sphere.vertices[bottom]);
+				Assert::IsTrue(has_top != has_bottom);
+			}
+			for (std::size_t t = 0; t < sphere.triangle_count(); ++t)
+			{
+				if (!std::binary_search(expected.begin(), expected.end(), static_cast<std::uint32_t>(t)))
+					Assert::AreEqual(static_cast<std::uint32_t>(t), diff.matches[t]);
+			}
+		}
+
+		TEST_METHOD(test_added_geometry)
+		{
+			// A separate part appended to the mesh, and a duplicated triangle
+			const indexed_mesh sphere = make_icosphere<2>(1.0).to_mesh();
+			indexed_mesh assembly = sphere;
+			const indexed_mesh box = make_box(vector3{ 0.5, 0.5, 0.5 }).to_mesh();
+			const std::uint32_t base = static_cast<std::uint32_t>(assembly.vertex_count());
+			for (const auto& v : box.vertices)
+				assembly.vertices.push_back(v + vector3(3.0, 0.0, 0.0));
+			for (const std::uint32_t i : box.indices)
+				assembly.indices.push_back(base + i);
+			assembly.indices.insert(assembly.indices.end(), sphere.indices.begin(), sphere.indices.begin() + 3);
+
+			const mesh::mesh_diff diff = diff_meshes(sphere, assembly);
+			Assert::IsTrue(diff.removed.empty());
+			Assert::AreEqual(box.triangle_count() + 1, diff.added.size());
+			Assert::AreEqual(size_t{ 2 }, diff.regions.size());
+			Assert::AreEqual(box.triangle_count(), diff.regions[0].added.size());
+			Assert::AreEqual(size_t{ 1 }, diff.regions[1].added.size());
+			Assert::IsTrue(diff.regions[0].bounds.minimum.x > 2.0 && diff.regions[1].bounds.maximum.x < 2.0);
+
+			// Reversed, the same triangles are removed
+			const mesh::mesh_diff reverse = diff_meshes(assembly, sphere);
+			Assert::IsTrue(reverse.added.empty());
+			Assert::AreEqual(box.triangle_count() + 1, reverse.removed.size());
+
+			Assert::AreEqual(sphere.triangle_count(), diff_meshes(indexed_mesh{}, sphere).added.size());
+			Assert::IsTrue(diff_meshes(indexed_mesh{}, indexed_mesh{}).identical());
+		}
+
+		TEST_METHOD(test_deterministic)
+		{
+			const indexed_mesh sphere = make_icosphere<4>(1.0).to_mesh();
+			indexed_mesh edited = shuffle(sphere);
+			for (std::size_t v = 0; v < edited.vertex_count(); v += 97)
+				edited.vertices[v] *= 1.01;
+			set_thread_count(1);
+			const mesh::mesh_diff serial = diff_meshes(sphere, edited);
+			set_thread_count(4);
+			const mesh::mesh_diff threaded = diff_meshes(sphere, edited);
+			set_thread_count(0);
+			Assert::IsTrue(serial.matches == threaded.matches);
+			Assert::IsTrue(serial.added == threaded.added);
+			Assert::AreEqual(serial.regions.size(), threaded.regions.size());
+			Assert::IsTrue(serial.regions.size() > 10);
+		}
+
+		TEST_METHOD(test_large_mesh)
+		{
+			const indexed_mesh sphere = make_icosphere<6>(1.0).to_mesh();
+
+			// A small edit yields one region
+			indexed_mesh edited = sphere;
+			edited.vertices[0] *= 1.01;
+			const mesh::mesh_diff small = diff_meshes(sphere, edited);
+			Assert::AreEqual(size_t{ 1 }, small.regions.size());
+			Assert::AreEqual(small.removed.size(), small.regions[0].removed.size());
+			Assert::IsTrue(small.removed.size() >= 5 && small.removed.size() <= 6);
+
+			// Changing every triangle yields one connected region per revision
+			indexed_mesh scaled = sphere;
+			for (auto& v : scaled.vertices)
+				v *= 1.01;
+			const mesh::mesh_diff full = diff_meshes(sphere, scaled);
+			Assert::AreEqual(sphere.triangle_count(), full.removed.size());
+			Assert::AreEqual(sphere.triangle_count(), full.added.size());
+			Assert::AreEqual(size_t{ 2 }, full.regions.size());
+			Assert::AreEqual(sphere.triangle_count(), full.regions[0].removed.size());
+			Assert::AreEqual(sphere.triangle_count(), full.regions[1].added.size());
+		}
+	};
+}
@@ -0,0 +1,446 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_bvh.hpp"
+#include "mesh/mesh_fast_math.hpp"
+#include "mesh/mesh_primitives.hpp"
+#include "mesh/mesh_quantize.hpp"
+#include "mesh/mesh_ray_packet.hpp"
+#include "mesh/mesh_spatial_hash.hpp"
+#include "mesh/mesh_sparse_matrix.hpp"
+#include "mesh/mesh_tlas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	/// Randomized comparisons of every batch and packet kernel against its scalar reference
+	TEST_CLASS(mesh_differential)
+	{
+		static vector3 random_vector(std::mt19937& p_rng, const double p_extent)
+		{
+			std::uniform_real_distribution<double> dist(-p_extent, p_extent);
+			return vector3{ dist(p_rng), dist(p_rng), dist(p_rng) };
+		}
+
+		static std::vector<triangle3> random_triangles(std::mt19937& p_rng, const std::size_t p_count, const double p_extent)
+		{
+			std::vector<triangle3> triangles(p_count);
+			for (auto& t : triangles)
+			{
+				const vector3 center = random_vector(p_rng, p_extent);
+				t = triangle3{ center + random_vector(p_rng, 1.0), center + random_vector(p_rng, 1.0), center + random_vector(p_rng, 1.0) };
+			}
+			return triangles;
+		}
+
+		/// Closed, bumpy sphere so inside tests and ray hits are meaningful
+		static indexed_mesh random_blob(std::mt19937& p_rng)
+		{
+			indexed_mesh mesh = make_icosphere<3>(2.0).to_mesh();
+			std::uniform_real_distribution<double> bump(0.8, 1.2);
+			for (auto& v : mesh.vertices)
+				v *= bump(p_rng);
+			return mesh;
+		}
+
+		/// Check a ray packet kernel against the scalar triangle loop, lane by lane
+		template <std::size_t N>
+		static void check_packet(std::mt19937& p_rng, const std::vector<triangle3>& p_triangles, const bool p_coherent)
+		{
+			ray_packet<N> packet;
+			const vector3 shared = random_vector(p_rng, 1.0);
+			for (std::size_t lane = 0; lane < N; ++lane)
+			{
+				vector3 direction = random_vector(p_rng, 1.0);
+				if (p_coherent)
+					direction = shared * 4.0 + direction * 0.1;
+				packet.set(lane, random_vector(p_rng, 2.0) - direction * 10.0, direction, lane % 3 == 0 ? 15.0 : std::numeric_limits<double>::infinity());
+			}
+			const ray_packet<N> original = packet;
+
+			ray_packet_hit<N> hit;
+			const ray_mask mask = intersect_triangles(packet, p_triangles.data(), p_triangles.size(), hit);
+			Assert::AreEqual(mask, hit.mask);
+			for (std::size_t lane = 0; lane < N; ++lane)
+			{
+				double best = original.max_distance[lane];
+				std::size_t best_index = p_triangles.size();
+				for (std::size_t i = 0; i < p_triangles.size(); ++i)
+				{
+					double dist = 0.0;
+					if (p_triangles[i].intersect_ray(original.origin(lane), original.direction(lane), nullptr, &dist) && dist <= best)
+					{
+						best = dist;
+						best_index = i;
+					}
+				}
+				const bool lane_hit = (mask >> lane) & 1;
+				Assert::AreEqual(best_index != p_triangles.size(), lane_hit);
+				if (lane_hit)
+				{
+					Assert::AreEqual(best, hit.distance[lane], 1e-9 * std::max(1.0, best));
+					Assert::AreEqual(best_index, hit.index[lane]);
+				}
+
+				// Single-primitive kernels against the scalar shape tests
+				const triangle3& t = p_triangles[lane % p_triangles.size()];
+				double dist = 0.0;
+				double packet_dist[N] = {};
+				const bool scalar_triangle = t.intersect_ray(original.origin(lane), original.direction(lane), nullptr, &dist) && dist <= original.max_distance[lane];
+				const ray_mask triangle_mask = original.intersect_triangle(t, packet_dist);
+				Assert::AreEqual(scalar_triangle, ((triangle_mask >> lane) & 1) != 0);
+				if (scalar_triangle)
+					Assert::AreEqual(dist, packet_dist[lane], 1e-9 * std::max(1.0, dist));
+
+				const aabb3 box{ t.point1 - vector3{ 0.5, 0.5, 0.5 }, t.point2 + vector3{ 1.5, 1.5, 1.5 } };
+				const bool scalar_box = !box.is_empty() && box.intersect_ray_inv(original.origin(lane), vector3{ original.inv_direction_x[lane], original.inv_direction_y[lane], original.inv_direction_z[lane] }, original.max_distance[lane], &dist);
+				const ray_mask box_mask = original.intersect_aabb(box, packet_dist);
+				Assert::AreEqual(scalar_box, ((box_mask >> lane) & 1) != 0);
+				if (scalar_box)
+					Assert::AreEqual(dist, packet_dist[lane], 1e-12 * std::max(1.0, dist));
+
+				const vector3 normal = t.normal().normalized();
+				const plane3 plane{ normal, normal.dot(t.point1) };
+				vector3 point;
+				const bool scalar_plane = plane.intersect_ray(original.origin(lane), original.direction(lane), &point) &&
+					(point - original.origin(lane)).length() <= original.max_distance[lane] * original.direction(lane).length();
+				const ray_mask plane_mask = original.intersect_plane(plane, packet_dist);
+				Assert::AreEqual(scalar_plane, ((plane_mask >> lane) & 1) != 0);
+			}
+		}
+
+	public:
+		TEST_METHOD(test_fast_math)
+		{
+			std::mt19937 rng(11);
+			std::uniform_real_distribution<double> exponent(-100.0, 100.0);
+			std::vector<vector3> vectors(4096);
+			for (auto& v : vectors)
+				v = random_vector(rng, 1.0) * std::pow(10.0, exponent(rng));
+			vectors[7] = vector3{ 0.0, 0.0, 0.0 };
+
+			std::vector<double> lengths(vectors.size());
+			std::vector<vector3> fast(vectors.size());
+			std::vector<vector3> exact(vectors.size());
+			fast_lengths(vectors.data(), vectors.size(), lengths.data());
+			fast_normalize(vectors.data(), vectors.size(), fast.data());
+			normalize(vectors.data(), vectors.size(), exact.data());
+			for (std::size_t i = 0; i < vectors.size(); ++i)
+			{
+				const double length = vectors[i].length();
+				Assert::AreEqual(length, lengths[i], length * 1e-6);
+				Assert::IsTrue((fast[i] - vectors[i].normalized()).length() <= 1e-6);
+				Assert::IsTrue(exact[i] == vectors[i].normalized());
+			}
+
+			// Four iterations are within a few ulps
+			fast_lengths<4>(vectors.data(), vectors.size(), lengths.data());
+			for (std::size_t i = 0; i < vectors.size(); ++i)
+				Assert::AreEqual(vectors[i].length(), lengths[i], vectors[i].length() * 1e-14);
+		}
+
+		TEST_METHOD(test_quantize)
+		{
+			std::mt19937 rng(12);
+			for (int round = 0; round < 8; ++round)
+			{
+				const vector3 a = random_vector(rng, 100.0);
+				const aabb3 bounds{ a, a + random_vector(rng, 50.0) * 0.5 + vector3{ 30.0, 30.0, 30.0 } };
+				std::vector<vector3> points(1000);
+				for (auto& p : points)
+					p = bounds.center() + random_vector(rng, 60.0);
+
+				const position_quantizer<16> q16(bounds);
+				std::vector<quantized_position16> e16(points.size());
+				std::vector<vector3> d16(points.size());
+				q16.encode(points.data(), points.size(), e16.data());
+				q16.decode(e16.data(), e16.size(), d16.data());
+				const position_quantizer<21> q21(bounds);
+				std::vector<quantized_position21> e21(points.size());
+				std::vector<vector3> d21(points.size());
+				q21.encode(points.data(), points.size(), e21.data());
+				q21.decode(e21.data(), e21.size(), d21.data());
+				for (std::size_t i = 0; i < points.size(); ++i)
+				{
+					Assert::IsTrue(e16[i] == q16.encode(points[i]));
+					Assert::IsTrue(d16[i] == q16.decode(e16[i]));
+					Assert::AreEqual(q21.encode(points[i]), e21[i]);
+					Assert::IsTrue(d21[i] == q21.decode(e21[i]));
+				}
+
+				std::vector<vector3> normals(1000);
+				for (auto& n : normals)
+					n = random_vector(rng, 1.0).normalized();
+				std::vector<octahedral_normal> encoded(normals.size());
+				std::vector<vector3> decoded(normals.size());
+				encode_octahedral(normals.data(), normals.size(), encoded.data());
+				decode_octahedral(encoded.data(), encoded.size(), decoded.data());
+				for (std::size_t i = 0; i < normals.size(); ++i)
+				{
+					Assert::AreEqual(encode_octahedral(normals[i]), encoded[i]);
+					Assert::IsTrue((decoded[i] - decode_octahedral(encoded[i])).length() <= 1e-15);
+				}
+			}
+		}
+
+		TEST_METHOD(test_ray_packets)
+		{
+			for (unsigned seed = 0; seed < 20; ++seed)
+			{
+				std::mt19937 rng(seed);
+				const std::vector<triangle3> triangles = random_triangles(rng, 64, 3.0);
+				for (const bool coherent : { true, false })
+				{
+					check_packet<4>(rng, triangles, coherent);
+					check_packet<8>(rng, triangles, coherent);
+					check_packet<16>(rng, triangles, coherent);
+				}
+			}
+
+			// Axis-parallel rays and origins on slab planes, which random rays never produce
+			const aabb3 box{ vector3{ -1.0, -1.0, -1.0 }, vector3{ 1.0, 1.0, 1.0 } };
+			const vector3 origins[8] = {
+				vector3{ 1.0, 1.0, -5.0 }, vector3{ -1.0, 0.0, -5.0 }, vector3{ 0.0, 0.0, -5.0 }, vector3{ 2.0, 0.0, -5.0 },
+				vector3{ 0.0, 1.0, 0.0 }, vector3{ -5.0, -1.0, -1.0 }, vector3{ -5.0, 1.0 + 1e-9, 0.0 }, vector3{ 0.0, 0.0, -5.0 }
+			};
+			const vector3 directions[8] = {
+				vector3{ 0.0, 0.0, 1.0 }, vector3{ 0.0, 0.0, 1.0 }, vector3{ 0.0, 0.0, 1.0 }, vector3{ 0.0, 0.0, 1.0 },
+				vector3{ 1.0, 0.0, 0.0 }, vector3{ 1.0, 0.0, 0.0 }, vector3{ 1.0, 0.0, 0.0 }, vector3{ 0.0, 0.0, -1.0 }
+			};
+			const bool expected[8] = { true, true, true, false, true, true, false, false };
+			ray_packet<8> packet;
+			for (std::size_t lane = 0; lane < 8; ++lane)
+				packet.set(lane, origins[lane], directions[lane]);
+			double packet_dist[8] = {};
+			const ray_mask box_mask = packet.intersect_aabb(box, packet_dist);
+			for (std::size_t lane = 0; lane < 8; ++lane)
+			{
+				double dist = 0.0;
+				const vector3 inv{ packet.inv_direction_x[lane], packet.inv_direction_y[lane], packet.inv_direction_z[lane] };
+				const bool scalar_box = box.intersect_ray_inv(origins[lane], inv, std::numeric_limits<double>::infinity(), &dist);
+				Assert::AreEqual(expected[lane], scalar_box);
+				Assert::AreEqual(scalar_box, ((box_mask >> lane) & 1) != 0);
+				if (scalar_box)
+					Assert::AreEqual(dist, packet_dist[lane]);
+			}
+		}
+
+		TEST_METHOD(test_triangle_batches)
+		{
+			std::mt19937 rng(13);
+			for (int round = 0; round < 50; ++round)
+			{
+				const std::vector<triangle3> triangles = random_triangles(rng, 200, 2.0);
+				const triangle3 query = random_triangles(rng, 1, 1.0)[0];
+
+				bool results[200];
+				std::size_t expected = 0;
+				const std::size_t hits = intersect_triangles(query, triangles.data(), triangles.size(), results);
+				for (std::size_t i = 0; i < triangles.size(); ++i)
+				{
+					const bool hit = query.intersect_triangle(triangles[i]);
+					Assert::AreEqual(hit, results[i]);
+					expected += hit ? 1 : 0;
+				}
+				Assert::AreEqual(expected, hits);
+
+				std::vector<vector3> points(400);
+				for (auto& p : points)
+					p = random_vector(rng, 2.0);
+				expected = 0;
+				const std::size_t segment_hits = intersect_segments(query, points.data(), 200, results);
+				for (std::size_t i = 0; i < 200; ++i)
+				{
+					const bool hit = query.intersect_segment(points[i * 2], points[i * 2 + 1]);
+					Assert::AreEqual(hit, results[i]);
+					expected += hit ? 1 : 0;
+				}
+				Assert::AreEqual(expected, segment_hits);
+
+				std::vector<vector3> closest(points.size());
+				closest_points(query, points.data(), points.size(), closest.data());
+				for (std::size_t i = 0; i < points.size(); ++i)
+				{
+					Assert::IsTrue(closest[i] == query.closest_point(points[i]));
+					double best = std::numeric_limits<double>::infinity();
+					std::size_t best_index = triangles.size();
+					for (std::size_t t = 0; t < triangles.size(); ++t)
+					{
+						const double d2 = triangles[t].distance2_to(points[i]);
+						if (d2 <= best)
+						{
+							best = d2;
+							best_index = t;
+						}
+					}
+					double distance2 = std::numeric_limits<double>::infinity();
+					Assert::AreEqual(best_index, closest_triangle(triangles.data(), triangles.size(), points[i], distance2));
+					Assert::AreEqual(best, distance2);
+				}
+			}
+		}
+
+		TEST_METHOD(test_bvh_batches)
+		{
+			for (unsigned seed = 0; seed < 3; ++seed)
+			{
+				std::mt19937 rng(seed);
+				const indexed_mesh blob = random_blob(rng);
+				const mesh::mesh_bvh bvh(blob);
+				std::vector<vector3> points(2000);
+				for (auto& p : points)
+					p = random_vector(rng, 3.0);
+
+				std::vector<bvh_closest_hit> closest(points.size());
+				std::vector<double> winding(points.size());
+				std::unique_ptr<bool[]> inside(new bool[points.size()]);
+				bvh.closest_points(points.data(), points.size(), closest.data());
+				bvh.winding_numbers(points.data(), points.size(), winding.data());
+				const std::size_t inside_count = bvh.contains(points.data(), points.size(), inside.get());
+				std::size_t expected_inside = 0;
+				for (std::size_t i = 0; i < points.size(); ++i)
+				{
+					const bvh_closest_hit single = bvh.closest_point(points[i]);
+					Assert::AreEqual(single.distance2, closest[i].distance2);
+					Assert::AreEqual(single.triangle, closest[i].triangle);
+					Assert::AreEqual(bvh.winding_number(points[i]), winding[i]);
+					Assert::AreEqual(bvh.contains(points[i]), inside[i]);
+					expected_inside += inside[i] ? 1 : 0;
+
+					// Brute force over every triangle
+					double best = std::numeric_limits<double>::infinity();
+					for (std::size_t t = 0; t < blob.triangle_count(); ++t)
+						best = std::min(best, blob.triangle(t).distance2_to(points[i]));
+					Assert::AreEqual(best, closest[i].distance2, 1e-12);
+				}
+				Assert::AreEqual(expected_inside, inside_count);
+
+				for (std::size_t i = 0; i < 500; ++i)
+				{
+					const vector3 origin = random_vector(rng, 4.0);
+					const vector3 direction = random_vector(rng, 1.0);
+					const bvh_ray_hit hit = bvh.intersect_ray(origin, direction);
+					double best = std::numeric_limits<double>::infinity();
+					for (std::size_t t = 0; t < blob.triangle_count(); ++t)
+					{
+						double dist = 0.0;
+						if (blob.triangle(t).intersect_ray(origin, direction, nullptr, &dist))
+							best = std::min(best, dist);
+					}
+					Assert::AreEqual(std::isfinite(best), hit.hit);
+					if (hit.hit)
+						Assert::AreEqual(best, hit.distance, 1e-9);
+				}
+			}
+		}
+
+		TEST_METHOD(test_tlas_batches)
+		{
+			std::mt19937 rng(14);
+			const mesh::mesh_bvh blob(random_blob(rng));
+			mesh::mesh_tlas tlas;
+			for (int i = 0; i < 30; ++i)
+				tlas.add_instance(blob, transform3::translation(random_vector(rng, 20.0)) * transform3::rotation(random_vector(rng, 1.0) + vector3{ 0.0, 0.0, 2.0 }, i * 0.3));
+			tlas.build();
+
+			std::vector<vector3> origins(1000);
+			std::vector<vector3> directions(origins.size());
+			for (std::size_t i = 0; i < origins.size(); ++i)
+			{
+				origins[i] = random_vector(rng, 25.0);
+				directions[i] = random_vector(rng, 25.0) - origins[i];
+			}
+			std::vector<tlas_ray_hit> hits(origins.size());
+			tlas.intersect_rays(origins.data(), directions.data(), origins.size(), hits.data());
+			for (std::size_t i = 0; i < origins.size(); ++i)
+			{
+				const tlas_ray_hit single = tlas.intersect_ray(origins[i], directions[i]);
+				Assert::AreEqual(single.hit, hits[i].hit);
+				Assert::AreEqual(single.distance, hits[i].distance);
+				Assert::AreEqual(single.instance, hits[i].instance);
+				Assert::AreEqual(single.triangle, hits[i].triangle);
+			}
+		}
+
+		TEST_METHOD(test_sparse_multiply)
+		{
+			// Large enough to split the rows across threads
+			std::mt19937 rng(15);
+			std::uniform_real_distribution<double> value(-1.0, 1.0);
+			const std::size_t n = 9000;
+			sparse_matrix a;
+			a.rows = n;
+			a.cols = n;
+			a.offsets.push_back(0);
+			for (std::size_t r = 0; r < n; ++r)
+			{
+				std::vector<std::uint32_t> columns;
+				for (int k = 0; k < 6; ++k)
+					columns.push_back(static_cast<std::uint32_t>(rng() % n));
+				std::sort(columns.begin(), columns.end());
+				columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+				for (const std::uint32_t c : columns)
+				{
+					a.columns.push_back(c);
+					a.values.push_back(value(rng));
+				}
+				a.offsets.push_back(static_cast<std::uint32_t>(a.columns.size()));
+			}
+
+			std::vector<double> x(n);
+			std::vector<vector3> x3(n);
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				x[i] = value(rng);
+				x3[i] = random_vector(rng, 1.0);
+			}
+			std::vector<double> y(n);
+			std::vector<vector3> y3(n);
+			a.multiply(x.data(), y.data());
+			a.multiply(x3.data(), y3.data());
+			for (std::size_t r = 0; r < n; ++r)
+			{
+				double sum = 0.0;
+				vector3 sum3;
+				for (std::uint32_t k = a.offsets[r]; k < a.offsets[r + 1]; ++k)
+				{
+					sum += a.values[k] * x[a.columns[k]];
+					sum3 += x3[a.columns[k]] * a.values[k];
+				}
+				Assert::AreEqual(sum, y[r], 1e-12);
+				Assert::IsTrue((sum3 - y3[r]).length() <= 1e-12);
+			}
+		}
+
+		TEST_METHOD(test_spatial_hash_neighbors)
+		{
+			std::mt19937 rng(16);
+			std::vector<vector3> points(3000);
+			for (auto& p : points)
+				p = random_vector(rng, 5.0);
+			spatial_hash hash(0.5);
+			hash.build(points, 256);
+
+			std::vector<std::size_t> offsets;
+			std::vector<std::uint32_t> neighbors;
+			hash.find_neighbors(points.data(), 500, 0.5, offsets, neighbors);
+			for (std::size_t q = 0; q < 500; ++q)
+			{
+				std::vector<std::uint32_t> found(neighbors.begin() + static_cast<std::ptrdiff_t>(offsets[q]), neighbors.begin() + static_cast<std::ptrdiff_t>(offsets[q + 1]));
+				std::sort(found.begin(), found.end());
+				std::vector<std::uint32_t> expected;
+				for (std::uint32_t i = 0; i < points.size(); ++i)
+				{
+					if ((points[i] - points[q]).length2() <= 0.25)
+						expected.push_back(i);
+				}
+				Assert::IsTrue(found == expected);
+			}
+		}
+	};
+}
@@ -0,0 +1,74 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_fast_math.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_fast_math)
+	{
+		/// Maximum relative error of fast_rsqrt over a wide range of exponents
+		template <int Iterations>
+		static double rsqrt_error()
+		{
+			std::mt19937_64 rng(3);
+			std::uniform_real_distribution<double> mantissa(1.0, 4.0);
+			std::uniform_int_distribution<int> exponent(-1000, 1000);
+			double error = 0.0;
+			for (int i = 0; i < 200000; ++i)
+			{
+				const double x = std::ldexp(mantissa(rng), exponent(rng));
+				const double exact = 1.0 / std::sqrt(x);
+				error = std::max(error, std::abs(fast_rsqrt<Iterations>(x) - exact) / exact);
+			}
+			return error;
+		}
+
+	public:
+		TEST_METHOD(test_rsqrt)
+		{
+			Assert::IsTrue(rsqrt_error<1>() < 1.8e-3);
+			Assert::IsTrue(rsqrt_error<2>() < 4.7e-6);
+			Assert::IsTrue(rsqrt_error<3>() < 3.3e-11);
+			Assert::IsTrue(rsqrt_error<4>() < 5e-16);
+			Assert::AreEqual(0.5, fast_rsqrt<4>(4.0), 1e-15);
+			Assert::IsTrue(std::isfinite(fast_rsqrt(0.0)));
+		}
+
+		TEST_METHOD(test_normalized)
+		{
+			Assert::IsTrue(fast_normalized(vector3{ 0.0, 0.0, 0.0 }) == vector3(0.0, 0.0, 0.0));
+			Assert::AreEqual(5.0, fast_length(vector3{ 3.0, 4.0, 0.0 }), 1e-9);
+
+			std::mt19937 rng(7);
+			std::uniform_real_distribution<double> dist(-1.0, 1.0);
+			std::uniform_int_distribution<int> exponent(-300, 300);
+			std::vector<vector3> vectors(10000);
+			for (auto& v : vectors)
+				v = vector3{ dist(rng), dist(rng), dist(rng) } * std::ldexp(1.0, exponent(rng));
+
+			std::vector<vector3> exact(vectors.size());
+			std::vector<vector3> fast(vectors.size());
+			std::vector<double> lengths(vectors.size());
+			normalize(vectors.data(), vectors.size(), exact.data());
+			fast_normalize(vectors.data(), vectors.size(), fast.data());
+			fast_lengths(vectors.data(), vectors.size(), lengths.data());
+			for (std::size_t i = 0; i < vectors.size(); ++i)
+			{
+				Assert::IsTrue((exact[i] - fast[i]).length() < 1e-10);
+				Assert::IsTrue((fast_normalized(vectors[i]) - fast[i]).length() < 1e-15);
+				Assert::AreEqual(vectors[i].length(), lengths[i], vectors[i].length() * 1e-10);
+			}
+
+			// In place
+			fast_normalize<4>(vectors.data(), vectors.size(), vectors.data());
+			for (std::size_t i = 0; i < vectors.size(); ++i)
+				Assert::IsTrue((exact[i] - vectors[i]).length() < 1e-15);
+		}
+	};
+}
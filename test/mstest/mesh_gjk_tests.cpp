@@ -0,0 +1,228 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_gjk.hpp"
+#include "mesh/mesh_transform3.hpp"
+
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_gjk)
+	{
+		/// Make a closed box mesh with outward facing triangles
+		static indexed_mesh make_box(const vector3& p_min, const vector3& p_max)
+		{
+			indexed_mesh mesh;
+			for (int i = 0; i < 8; ++i)
+			{
+				mesh.add_vertex(vector3{
+					(i & 1) ? p_max.x : p_min.x,
+					(i & 2) ? p_max.y : p_min.y,
+					(i & 4) ? p_max.z : p_min.z });
+			}
+
+			mesh.indices = { 0, 4, 6, 0, 6, 2, 1, 3, 7, 1, 7, 5, 0, 1, 5, 0, 5, 4, 2, 6, 7, 2, 7, 3, 0, 2, 3, 0, 3, 1, 4, 5, 7, 4, 7, 6 };
+			return mesh;
+		}
+
+	public:
+		TEST_METHOD(test_shape_support)
+		{
+			std::uint32_t hint = 0;
+			const sphere_shape sphere{ vector3{ 1.0, 0.0, 0.0 }, 2.0 };
+			Assert::IsTrue(sphere.support(vector3{ 0.0, 3.0, 0.0 }, hint) == vector3{ 1.0, 2.0, 0.0 });
+
+			const box_shape box{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 2.0, 3.0 } };
+			Assert::IsTrue(box.support(vector3{ -1.0, 1.0, -1.0 }, hint) == vector3{ -1.0, 2.0, -3.0 });
+
+			const capsule_shape capsule{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 0.0, 0.0, 4.0 }, 1.0 };
+			Assert::IsTrue(capsule.support(vector3{ 0.0, 0.0, 1.0 }, hint) == vector3{ 0.0, 0.0, 5.0 });
+
+			// Hill-climbing over hull adjacency agrees with a linear search
+			const auto hull = convex_hull_shape::from_mesh(make_box(vector3{ -1.0, -2.0, -3.0 }, vector3{ 1.0, 2.0, 3.0 }));
+			const point_cloud_shape cloud{ hull.vertices.data(), hull.vertices.size() };
+			std::mt19937 rng(1);
+			std::uniform_real_distribution<double> dist(-1.0, 1.0);
+			for (int i = 0; i < 100; ++i)
+			{
+				const vector3 d{ dist(rng), dist(rng), dist(rng) };
+				std::uint32_t h1 = static_cast<std::uint32_t>(i % 8), h2 = 0;
+				Assert::IsTrue(hull.support(d, h1) == cloud.support(d, h2));
+			}
+
+			// Empty clouds support at the origin
+			Assert::IsTrue(point_cloud_shape{}.support(vector3{ 1.0, 0.0, 0.0 }, hint) == vector3{ 0.0, 0.0, 0.0 });
+		}
+
+		TEST_METHOD(test_transformed_shape)
+		{
+			// A rotated, scaled and moved box agrees with the hull of the transformed box mesh
+			const transform3 transform = transform3::translation(vector3{ 5.0, 1.0, -2.0 }) * transform3::rotation(vector3{ 1.0, 2.0, 3.0 }, 0.7) * transform3::scaling(vector3{ 1.0, 2.0, 0.5 });
+			const transformed_shape<box_shape> box{ box_shape{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 1.0, 1.0 } }, transform };
+			indexed_mesh mesh = make_box(vector3{ -1.0, -1.0, -1.0 }, vector3{ 1.0, 1.0, 1.0 });
+			for (auto& v : mesh.vertices)
+				v = transform.transform_point(v);
+			const auto hull = convex_hull_shape::from_mesh(mesh);
+
+			std::mt19937 rng(3);
+			std::uniform_real_distribution<double> dist(-1.0, 1.0);
+			for (int i = 0; i < 100; ++i)
+			{
+				const vector3 d{ dist(rng), dist(rng), dist(rng) };
+				std::uint32_t h1 = 0, h2 = 0;
+				Assert::IsTrue((box.support(d, h1) - hull.support(d, h2)).length() < 1e-12);
+			}
+
+			// Queries match the hull, including through a referenced shape
+			const transformed_shape<const convex_hull_shape&> moved{ hull, transform3::translation(vector3{ 0.0, 0.0, 10.0 }) };
+			const sphere_shape sphere{ vector3{ 5.0, 1.0, 4.0 }, 0.5 };
+			const convex_contact c1 = gjk_distance(box, sphere);
+			const convex_contact c2 = gjk_distance(hull, sphere);
+			Assert::AreEqual(c2.distance, c1.distance, 1e-9);
+			const convex_contact c3 = gjk_distance(moved, sphere_shape{ sphere.center + vector3{ 0.0, 0.0, 10.0 }, 0.5 });
+			Assert::AreEqual(c2.distance, c3.distance, 1e-9);
+		}
+
+		TEST_METHOD(test_hull_from_planes)
+		{
+			const std::vector<plane3> planes = {
+				plane3{ vector3{ 1.0, 0.0, 0.0 }, 1.0 }, plane3{ vector3{ -1.0, 0.0, 0.0 }, 1.0 },
+				plane3{ vector3{ 0.0, 1.0, 0.0 }, 2.0 }, plane3{ vector3{ 0.0, -1.0, 0.0 }, 2.0 },
+				plane3{ vector3{ 0.0, 0.0, 1.0 }, 3.0 }, plane3{ vector3{ 0.0, 0.0, -1.0 }, 3.0 }
+			};
+			const auto hull = convex_hull_shape::from_planes(planes);
+			Assert::AreEqual(size_t{ 8 }, hull.vertices.size());
+
+			// A box vertex has exactly three edge neighbours
+			for (std::size_t v = 0; v < hull.vertices.size(); ++v)
+				Assert::AreEqual(3u, hull.adjacency_offsets[v + 1] - hull.adjacency_offsets[v]);
+
+			std::uint32_t hint = 0;
+			Assert::IsTrue(hull.support(vector3{ 1.0, 1.0, 1.0 }, hint) == vector3{ 1.0, 2.0, 3.0 });
+			Assert::IsTrue(hull.support(vector3{ -1.0, 1.0, -1.0 }, hint) == vector3{ -1.0, 2.0, -3.0 });
+		}
+
+		TEST_METHOD(test_distance)
+		{
+			// Separated spheres
+			const sphere_shape a{ vector3{ 0.0, 0.0, 0.0 }, 1.0 };
+			const sphere_shape b{ vector3{ 4.0, 0.0, 0.0 }, 1.5 };
+			auto c = gjk_distance(a, b);
+			Assert::IsFalse(c.intersecting);
+			Assert::AreEqual(1.5, c.distance, 1e-6);
+			Assert::AreEqual(1.0, c.normal.x, 1e-9);
+			Assert::AreEqual(1.0, c.point_a.x, 1e-6);
+			Assert::AreEqual(2.5, c.point_b.x, 1e-6);
+
+			// Box against box across a corner
+			const box_shape box1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 1.0, 1.0 } };
+			const box_shape box2{ vector3{ 3.0, 4.0, 1.0 }, vector3{ 1.0, 1.0, 1.0 } };
+			c = gjk_distance(box1, box2);
+			Assert::IsFalse(c.intersecting);
+			Assert::AreEqual(std::sqrt(1.0 + 4.0), c.distance, 1e-9);
+
+			// Capsule against hull
+			const auto hull = convex_hull_shape::from_mesh(make_box(vector3{ -1.0, -1.0, -1.0 }, vector3{ 1.0, 1.0, 1.0 }));
+			const capsule_shape capsule{ vector3{ 3.0, -5.0, 0.0 }, vector3{ 3.0, 5.0, 0.0 }, 0.5 };
+			c = gjk_distance(hull, capsule);
+			Assert::IsFalse(c.intersecting);
+			Assert::AreEqual(1.5, c.distance, 1e-9);
+			Assert::AreEqual(1.0, c.normal.x, 1e-9);
+
+			// Overlapping shapes report intersection
+			c = gjk_distance(hull, sphere_shape{ vector3{ 1.5, 0.0, 0.0 }, 1.0 });
+			Assert::IsTrue(c.intersecting);
+			Assert::AreEqual(0.0, c.distance);
+		}
+
+		TEST_METHOD(test_penetration)
+		{
+			// Overlapping boxes separate along the shallowest axis
+			const box_shape box1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 1.0, 1.0 } };
+			const box_shape box2{ vector3{ 1.5, 0.2, 0.1 }, vector3{ 1.0, 1.0, 1.0 } };
+			auto c = gjk_epa(box1, box2);
+			Assert::IsTrue(c.intersecting);
+			Assert::AreEqual(-0.5, c.distance, 1e-9);
+			Assert::AreEqual(1.0, c.normal.x, 1e-9);
+			Assert::AreEqual(1.0, c.point_a.x, 1e-9);
+			Assert::AreEqual(0.5, c.point_b.x, 1e-9);
+
+			// Spheres converge to the analytic depth
+			c = gjk_epa(sphere_shape{ vector3{ 0.0, 0.0, 0.0 }, 1.0 }, sphere_shape{ vector3{ 0.0, 1.5, 0.0 }, 1.0 });
+			Assert::IsTrue(c.intersecting);
+			Assert::AreEqual(-0.5, c.distance, 1e-3);
+			Assert::AreEqual(1.0, c.normal.y, 1e-3);
+
+			// Touching boxes have zero depth
+			c = gjk_epa(box1, box_shape{ vector3{ 2.0, 0.0, 0.0 }, vector3{ 1.0, 1.0, 1.0 } });
+			Assert::IsTrue(c.intersecting);
+			Assert::AreEqual(0.0, c.distance, 1e-9);
+
+			// Separated shapes behave like gjk_distance
+			c = gjk_epa(box1, box_shape{ vector3{ 3.0, 0.0, 0.0 }, vector3{ 1.0, 1.0, 1.0 } });
+			Assert::IsFalse(c.intersecting);
+			Assert::AreEqual(1.0, c.distance, 1e-9);
+		}
+
+		TEST_METHOD(test_warm_start)
+		{
+			// Small motions from a warm cache need fewer iterations than cold starts
+			const auto hull = convex_hull_shape::from_mesh(make_box(vector3{ -1.0, -1.0, -1.0 }, vector3{ 1.0, 1.0, 1.0 }));
+			gjk_cache cache;
+			int warm = 0, cold = 0;
+			for (int frame = 0; frame < 50; ++frame)
+			{
+				const double t = frame * 0.01;
+				const sphere_shape sphere{ vector3{ 3.0 + t, 2.0 * t, 1.5 - t }, 0.5 };
+				const auto w = gjk_distance(hull, sphere, &cache);
+				const auto c = gjk_distance(hull, sphere);
+				Assert::AreEqual(c.distance, w.distance, 1e-6);
+				warm += w.iterations;
+				cold += c.iterations;
+			}
+			Assert::IsTrue(warm < cold);
+		}
+
+		TEST_METHOD(test_random_point_clouds)
+		{
+			// Distances between random clouds agree with the closest-point invariant
+			std::mt19937 rng(7);
+			std::uniform_real_distribution<double> dist(-1.0, 1.0);
+			for (int trial = 0; trial < 200; ++trial)
+			{
+				std::vector<vector3> pa(12), pb(12);
+				const vector3 offset{ dist(rng) * 3.0, dist(rng) * 3.0, dist(rng) * 3.0 };
+				for (auto& p : pa)
+					p = vector3{ dist(rng), dist(rng), dist(rng) };
+				for (auto& p : pb)
+					p = vector3{ dist(rng), dist(rng), dist(rng) } + offset;
+
+				const point_cloud_shape a{ pa.data(), pa.size() };
+				const point_cloud_shape b{ pb.data(), pb.size() };
+				const auto c = gjk_epa(a, b);
+				if (!c.intersecting)
+				{
+					// No point of either cloud lies beyond the separating planes
+					Assert::AreEqual(c.distance, (c.point_b - c.point_a).length(), 1e-9);
+					for (const auto& p : pa)
+						Assert::IsTrue(c.normal.dot(p - c.point_a) <= 1e-9);
+					for (const auto& p : pb)
+						Assert::IsTrue(c.normal.dot(p - c.point_b) >= -1e-9);
+				}
+				else
+				{
+					// Moving the second cloud out along the normal leaves them touching
+					Assert::IsTrue(c.distance <= 1e-9);
+					std::vector<vector3> moved(pb);
+					for (auto& p : moved)
+						p += c.normal * (-c.distance + 1e-6);
+					const auto s = gjk_distance(a, point_cloud_shape{ moved.data(), moved.size() });
+					Assert::IsFalse(s.intersecting);
+					Assert::IsTrue(s.distance < 1e-5);
+				}
+			}
+		}
+	};
+}
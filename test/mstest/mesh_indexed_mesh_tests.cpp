@@ -0,0 +1,59 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_indexed_mesh.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_indexed_mesh)
+	{
+	public:
+		TEST_METHOD(test_construct)
+		{
+			const indexed_mesh m1;
+			Assert::AreEqual(size_t{ 0 }, m1.vertex_count());
+			Assert::AreEqual(size_t{ 0 }, m1.triangle_count());
+			Assert::IsTrue(m1.bounds().is_empty());
+		}
+
+		TEST_METHOD(test_add)
+		{
+			indexed_mesh m1;
+			Assert::AreEqual(0u, m1.add_vertex(vector3{ 0.0, 0.0, 0.0 }));
+			Assert::AreEqual(1u, m1.add_vertex(vector3{ 1.0, 0.0, 0.0 }));
+			Assert::AreEqual(2u, m1.add_vertex(vector3{ 0.0, 2.0, 0.0 }));
+			m1.add_triangle(0, 1, 2);
+			Assert::AreEqual(size_t{ 3 }, m1.vertex_count());
+			Assert::AreEqual(size_t{ 1 }, m1.triangle_count());
+			Assert::IsTrue(m1.triangle(0) == triangle3{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 0.0, 0.0 }, vector3{ 0.0, 2.0, 0.0 } });
+			Assert::IsTrue(m1.bounds() == aabb3{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 2.0, 0.0 } });
+
+			m1.clear();
+			Assert::AreEqual(size_t{ 0 }, m1.vertex_count());
+			Assert::AreEqual(size_t{ 0 }, m1.triangle_count());
+		}
+
+		TEST_METHOD(test_edge_adjacency)
+		{
+			// Two triangles sharing the diagonal of a quad, plus a dangling triangle
+			indexed_mesh m1;
+			for (int i = 0; i < 6; ++i)
+				m1.add_vertex(vector3{ static_cast<double>(i & 1), static_cast<double>(i >> 1), 0.0 });
+			m1.add_triangle(0, 1, 3);
+			m1.add_triangle(0, 3, 2);
+			m1.add_triangle(2, 3, 5);
+
+			const auto adjacency = compute_edge_adjacency(m1);
+			Assert::AreEqual(size_t{ 9 }, adjacency.size());
+			Assert::AreEqual(no_neighbor, adjacency[0]);
+			Assert::AreEqual(no_neighbor, adjacency[1]);
+			Assert::AreEqual(1u, adjacency[2]);
+			Assert::AreEqual(0u, adjacency[3]);
+			Assert::AreEqual(2u, adjacency[4]);
+			Assert::AreEqual(no_neighbor, adjacency[5]);
+			Assert::AreEqual(1u, adjacency[6]);
+			Assert::AreEqual(no_neighbor, adjacency[7]);
+		}
+	};
+}
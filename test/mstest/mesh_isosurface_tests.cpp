@@ -0,0 +1,149 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_isosurface.hpp"
+
+#include <map>
+#include <set>
+#include <utility>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_isosurface)
+	{
+		/// Sample the signed distance of a sphere into a grid
+		static sdf_grid make_sphere(const vector3& p_center, const double p_radius)
+		{
+			sdf_grid grid{ vector3{ -2.0, -2.0, -2.0 }, 0.25, 17, 17, 17 };
+			for (std::size_t k = 0; k < grid.size_z; ++k)
+				for (std::size_t j = 0; j < grid.size_y; ++j)
+					for (std::size_t i = 0; i < grid.size_x; ++i)
+						grid.at(i, j, k) = (grid.position(i, j, k) - p_center).length() - p_radius;
+			return grid;
+		}
+
+		/// Check that every directed edge is matched by exactly one opposite edge
+		static bool is_closed(const indexed_mesh& p_mesh)
+		{
+			std::map<std::pair<std::uint32_t, std::uint32_t>, int> edges;
+			for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+			{
+				for (int e = 0; e < 3; ++e)
+				{
+					const std::uint32_t a = p_mesh.indices[t * 3 + e];
+					const std::uint32_t b = p_mesh.indices[t * 3 + (e + 1) % 3];
+					++edges[std::make_pair(a, b)];
+				}
+			}
+
+			for (const auto& e : edges)
+			{
+				const auto it = edges.find(std::make_pair(e.first.second, e.first.first));
+				if (e.second != 1 || it == edges.end() || it->second != 1)
+					return false;
+			}
+			return true;
+		}
+
+		/// Check that every triangle faces away from a center point
+		static bool faces_outward(const indexed_mesh& p_mesh, const vector3& p_center)
+		{
+			for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+			{
+				const triangle3 tri = p_mesh.triangle(t);
+				const vector3 centroid = (tri.point1 + tri.point2 + tri.point3) / 3.0;
+				if (tri.normal().dot(centroid - p_center) <= 0.0)
+					return false;
+			}
+			return true;
+		}
+
+	public:
+		TEST_METHOD(test_marching_cubes_table)
+		{
+			Assert::AreEqual(-1, static_cast<int>(detail::marching_cubes.triangles[0][0]));
+			Assert::AreEqual(-1, static_cast<int>(detail::marching_cubes.triangles[255][0]));
+
+			// A single inside corner cuts off one triangle
+			Assert::AreEqual(-1, static_cast<int>(detail::marching_cubes.triangles[1][3]));
+
+			// Complementary cases produce the same number of triangles
+			for (int c = 1; c < 255; ++c)
+			{
+				int n1 = 0, n2 = 0;
+				while (detail::marching_cubes.triangles[c][n1] >= 0)
+					++n1;
+				while (detail::marching_cubes.triangles[255 - c][n2] >= 0)
+					++n2;
+				Assert::IsTrue(n1 > 0 && n1 <= 15);
+				Assert::IsTrue(n2 > 0 && n2 <= 15);
+			}
+		}
+
+		TEST_METHOD(test_marching_cubes)
+		{
+			const vector3 center{ 0.1, -0.05, 0.02 };
+			const sdf_grid grid = make_sphere(center, 1.3);
+
+			isosurface_options options;
+			options.slab_size = 3;
+			const indexed_mesh m1 = extract_marching_cubes(grid, options);
+			Assert::IsTrue(m1.triangle_count() > 100);
+			Assert::IsTrue(is_closed(m1));
+			Assert::IsTrue(faces_outward(m1, center));
+
+			// Vertices are shared, never duplicated
+			std::set<vector3> unique(m1.vertices.begin(), m1.vertices.end());
+			Assert::AreEqual(m1.vertices.size(), unique.size());
+
+			for (const auto& v : m1.vertices)
+				Assert::AreEqual(1.3, (v - center).length(), 0.05);
+
+			// Slab size does not change the result
+			for (const std::size_t slab_size : { std::size_t{ 1 }, std::size_t{ 100 } })
+			{
+				options.slab_size = slab_size;
+				const indexed_mesh m2 = extract_marching_cubes(grid, options);
+				Assert::IsTrue(m1.vertices == m2.vertices);
+				Assert::IsTrue(m1.indices == m2.indices);
+			}
+		}
+
+		TEST_METHOD(test_dual_contouring)
+		{
+			const vector3 center{ 0.1, -0.05, 0.02 };
+			const sdf_grid grid = make_sphere(center, 1.3);
+
+			isosurface_options options;
+			options.method = isosurface_method::dual_contouring;
+			options.slab_size = 3;
+			const indexed_mesh m1 = extract_isosurface(grid, options);
+			Assert::IsTrue(m1.triangle_count() > 100);
+			Assert::IsTrue(is_closed(m1));
+			Assert::IsTrue(faces_outward(m1, center));
+
+			for (const auto& v : m1.vertices)
+				Assert::AreEqual(1.3, (v - center).length(), 0.05);
+
+			// Slab size does not change the result
+			for (const std::size_t slab_size : { std::size_t{ 1 }, std::size_t{ 100 } })
+			{
+				options.slab_size = slab_size;
+				const indexed_mesh m2 = extract_isosurface(grid, options);
+				Assert::IsTrue(m1.vertices == m2.vertices);
+				Assert::IsTrue(m1.indices == m2.indices);
+			}
+		}
+
+		TEST_METHOD(test_empty)
+		{
+			const sdf_grid grid{ vector3{ 0.0, 0.0, 0.0 }, 1.0, 4, 4, 4, 1.0 };
+			Assert::AreEqual(size_t{ 0 }, extract_marching_cubes(grid).triangle_count());
+
+			isosurface_options options;
+			options.method = isosurface_method::dual_contouring;
+			Assert::AreEqual(size_t{ 0 }, extract_isosurface(grid, options).triangle_count());
+		}
+	};
+}
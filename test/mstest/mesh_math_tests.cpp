@@ -1,6 +1,9 @@
 #include "CppUnitTest.h"
 #include "mesh/mesh_math.hpp"
 
+#include <cmath>
+#include <random>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace mesh;
 
@@ -48,5 +51,33 @@ namespace mesh_tests
 			Assert::AreEqual(10.0, lerp(0.0, 10.0, 1.0));
 			Assert::AreEqual(5.0, lerp(0.0, 10.0, 0.5));
 		}
+
+		TEST_METHOD(test_csqrt)
+		{
+			// Compile-time evaluation
+			static_assert(csqrt(0.0) == 0.0, "csqrt(0)");
+			static_assert(csqrt(4.0) == 2.0, "csqrt(4)");
+			static_assert(csqrt(0.25) == 0.5, "csqrt(0.25)");
+			static_assert(csqrt(1e300) > 9.99e149 && csqrt(1e300) < 1.001e150, "csqrt(1e300)");
+			constexpr double root2 = csqrt(2.0);
+			Assert::AreEqual(std::sqrt(2.0), root2, 1e-15);
+
+			// Runtime evaluation uses the hardware square root
+			volatile double value = 2.0;
+			Assert::AreEqual(std::sqrt(2.0), csqrt(value));
+
+			// The constant-evaluable path is within one ulp over a wide range
+			std::mt19937 rng(1);
+			std::uniform_real_distribution<double> exponent(-300.0, 300.0);
+			for (int i = 0; i < 10000; ++i)
+			{
+				const double x = std::pow(10.0, exponent(rng));
+				const double expected = std::sqrt(x);
+				Assert::IsTrue(std::abs(detail::sqrt_constexpr(x) - expected) <= std::nextafter(expected, HUGE_VAL) - expected);
+			}
+			Assert::IsTrue(std::isnan(detail::sqrt_constexpr(-1.0)));
+			Assert::IsTrue(std::isinf(detail::sqrt_constexpr(HUGE_VAL)));
+			Assert::AreEqual(std::sqrt(5e-324), detail::sqrt_constexpr(5e-324), 1e-170);
+		}
 	};
 }
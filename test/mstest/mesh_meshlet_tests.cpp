@@ -0,0 +1,203 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_meshlet.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_meshlet)
+	{
+		/// Make a UV sphere with outward facing triangles
+		static indexed_mesh make_sphere(const std::uint32_t p_rings, const std::uint32_t p_segments)
+		{
+			const double pi = 3.14159265358979323846;
+			indexed_mesh mesh;
+			for (std::uint32_t r = 0; r <= p_rings; ++r)
+			{
+				const double theta = pi * r / p_rings;
+				for (std::uint32_t s = 0; s < p_segments; ++s)
+				{
+					const double phi = 2.0 * pi * s / p_segments;
+					mesh.add_vertex(vector3{ std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) });
+				}
+			}
+
+			for (std::uint32_t r = 0; r < p_rings; ++r)
+			{
+				for (std::uint32_t s = 0; s < p_segments; ++s)
+				{
+					const std::uint32_t a = r * p_segments + s;
+					const std::uint32_t b = r * p_segments + (s + 1) % p_segments;
+					const std::uint32_t c = a + p_segments;
+					const std::uint32_t d = b + p_segments;
+					if (r != 0)
+						mesh.add_triangle(a, c, b);
+					if (r + 1 != p_rings)
+						mesh.add_triangle(b, c, d);
+				}
+			}
+			return mesh;
+		}
+
+	public:
+		TEST_METHOD(test_partition)
+		{
+			const indexed_mesh mesh = make_sphere(24, 48);
+			meshlet_options options;
+			options.max_vertices = 32;
+			options.max_triangles = 40;
+			const meshlet_set set = build_meshlets(mesh, options);
+			Assert::AreEqual(set.meshlets.size(), set.bounds.size());
+
+			// Every triangle appears once with its original winding
+			std::vector<std::vector<std::uint32_t>> expected, actual;
+			for (std::size_t t = 0; t < mesh.triangle_count(); ++t)
+			{
+				std::vector<std::uint32_t> tri(mesh.indices.begin() + static_cast<std::ptrdiff_t>(t) * 3, mesh.indices.begin() + static_cast<std::ptrdiff_t>(t) * 3 + 3);
+				std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+				expected.push_back(tri);
+			}
+			for (std::size_t m = 0; m < set.meshlets.size(); ++m)
+			{
+				const meshlet& ml = set.meshlets[m];
+				Assert::IsTrue(ml.vertex_count <= 32);
+				Assert::IsTrue(ml.triangle_count <= 40);
+				Assert::IsTrue(ml.triangle_count > 0);
+				for (std::uint32_t t = 0; t < ml.triangle_count; ++t)
+				{
+					std::vector<std::uint32_t> tri = { set.vertex_index(m, t, 0), set.vertex_index(m, t, 1), set.vertex_index(m, t, 2) };
+					std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+					actual.push_back(tri);
+				}
+			}
+			std::sort(expected.begin(), expected.end());
+			std::sort(actual.begin(), actual.end());
+			Assert::IsTrue(actual == expected);
+
+			// Clusters are well filled
+			Assert::IsTrue(set.meshlets.size() * 40 < mesh.triangle_count() * 2);
+		}
+
+		TEST_METHOD(test_edge_connected)
+		{
+			// Two spheres side by side, so seeds also start meshlets on disconnected parts
+			indexed_mesh mesh = make_sphere(20, 40);
+			const indexed_mesh other = make_sphere(12, 24);
+			const std::uint32_t base = static_cast<std::uint32_t>(mesh.vertex_count());
+			for (const auto& v : other.vertices)
+				mesh.add_vertex(v + vector3{ 2.5, 0.0, 0.0 });
+			for (const std::uint32_t i : other.indices)
+				mesh.indices.push_back(base + i);
+
+			for (const std::uint32_t max_vertices : { 16u, 64u, 255u })
+			{
+				meshlet_options options;
+				options.max_vertices = max_vertices;
+				options.max_triangles = 124;
+				const meshlet_set set = build_meshlets(mesh, options);
+				for (std::size_t m = 0; m < set.meshlets.size(); ++m)
+				{
+					// Flood fill across shared edges from the first triangle
+					const meshlet& ml = set.meshlets[m];
+					std::vector<std::uint8_t> reached(ml.triangle_count, 0);
+					std::vector<std::uint32_t> stack = { 0 };
+					reached[0] = 1;
+					std::size_t count = 1;
+					while (!stack.empty())
+					{
+						const std::uint32_t t = stack.back();
+						stack.pop_back();
+						for (std::uint32_t u = 0; u < ml.triangle_count; ++u)
+						{
+							int shared = 0;
+							for (int a = 0; a < 3; ++a)
+								for (int b = 0; b < 3; ++b)
+									shared += set.vertex_index(m, t, a) == set.vertex_index(m, u, b) ? 1 : 0;
+							if (!reached[u] && shared >= 2)
+							{
+								reached[u] = 1;
+								stack.push_back(u);
+								++count;
+							}
+						}
+					}
+					Assert::AreEqual(static_cast<std::size_t>(ml.triangle_count), count);
+				}
+			}
+		}
+
+		TEST_METHOD(test_bounds)
+		{
+			const indexed_mesh mesh = make_sphere(16, 32);
+			const meshlet_set set = build_meshlets(mesh);
+			for (std::size_t m = 0; m < set.meshlets.size(); ++m)
+			{
+				const meshlet& ml = set.meshlets[m];
+				const meshlet_bounds& b = set.bounds[m];
+
+				// The sphere holds every vertex
+				for (std::uint32_t i = 0; i < ml.vertex_count; ++i)
+					Assert::IsTrue((mesh.vertices[set.vertices[ml.vertex_offset + i]] - b.center).length() <= b.radius + 1e-12);
+
+				// The cone holds every face normal
+				if (b.cone_cutoff < 1.0)
+				{
+					const double min_dot = std::sqrt(1.0 - b.cone_cutoff * b.cone_cutoff);
+					for (std::uint32_t t = 0; t < ml.triangle_count; ++t)
+					{
+						const triangle3 tri{ mesh.vertices[set.vertex_index(m, t, 0)], mesh.vertices[set.vertex_index(m, t, 1)], mesh.vertices[set.vertex_index(m, t, 2)] };
+						Assert::IsTrue(tri.plane().normal.dot(b.cone_axis) >= min_dot - 1e-12);
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(test_culling)
+		{
+			// Back-face culling is conservative and culls a good share of a sphere from outside
+			const indexed_mesh mesh = make_sphere(32, 64);
+			meshlet_options options;
+			options.max_vertices = 16;
+			options.max_triangles = 16;
+			const meshlet_set set = build_meshlets(mesh, options);
+
+			const vector3 camera{ 0.0, 0.0, 6.0 };
+			std::size_t culled = 0;
+			for (std::size_t m = 0; m < set.meshlets.size(); ++m)
+			{
+				if (!set.bounds[m].is_backfacing(camera))
+					continue;
+
+				++culled;
+				for (std::uint32_t t = 0; t < set.meshlets[m].triangle_count; ++t)
+				{
+					const triangle3 tri{ mesh.vertices[set.vertex_index(m, t, 0)], mesh.vertices[set.vertex_index(m, t, 1)], mesh.vertices[set.vertex_index(m, t, 2)] };
+					Assert::IsTrue(tri.normal().dot(tri.point1 - camera) >= 0.0);
+				}
+			}
+			Assert::IsTrue(culled * 4 > set.meshlets.size());
+
+			// Plane culling against the sphere bounds
+			const plane3 plane{ vector3{ 0.0, 0.0, 1.0 }, 0.5 };
+			for (std::size_t m = 0; m < set.meshlets.size(); ++m)
+			{
+				if (!set.bounds[m].is_outside(plane))
+					continue;
+				for (std::uint32_t i = 0; i < set.meshlets[m].vertex_count; ++i)
+					Assert::IsTrue(mesh.vertices[set.vertices[set.meshlets[m].vertex_offset + i]].z > 0.5);
+			}
+		}
+
+		TEST_METHOD(test_empty)
+		{
+			const meshlet_set set = build_meshlets(indexed_mesh{});
+			Assert::AreEqual(size_t{ 0 }, set.meshlets.size());
+			Assert::AreEqual(size_t{ 0 }, set.bounds.size());
+		}
+	};
+}
@@ -0,0 +1,125 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_parallel.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_parallel)
+	{
+	public:
+		TEST_METHOD(test_thread_count)
+		{
+			Assert::IsTrue(thread_count() >= 1);
+
+			set_thread_count(3);
+			Assert::AreEqual(3u, thread_count());
+			set_thread_count(0);
+			Assert::IsTrue(thread_count() >= 1);
+		}
+
+		TEST_METHOD(test_parallel_for)
+		{
+			set_thread_count(4);
+			std::vector<int> values(10000, 0);
+			parallel_for(values.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+			{
+				for (std::size_t i = p_begin; i < p_end; ++i)
+					values[i] += static_cast<int>(i);
+			}, 100);
+
+			set_thread_count(0);
+			for (std::size_t i = 0; i < values.size(); ++i)
+				Assert::AreEqual(static_cast<int>(i), values[i]);
+
+			// Empty ranges never call the function
+			bool called = false;
+			parallel_for(0, [&](std::size_t, std::size_t) { called = true; });
+			Assert::IsFalse(called);
+		}
+
+		TEST_METHOD(test_parallel_for_exception)
+		{
+			Assert::ExpectException<std::runtime_error>([]
+			{
+				parallel_for(1000, [](const std::size_t p_begin, const std::size_t p_end)
+				{
+					if (p_begin <= 500 && 500 < p_end)
+						throw std::runtime_error("failure");
+				}, 10);
+			});
+		}
+
+		TEST_METHOD(test_parallel_for_nested)
+		{
+			// Inner loops run inline instead of waiting on the busy pool
+			set_thread_count(4);
+			std::vector<std::atomic<int>> counts(64);
+			parallel_for(counts.size(), [&](const std::size_t p_begin, const std::size_t p_end)
+			{
+				for (std::size_t i = p_begin; i < p_end; ++i)
+				{
+					parallel_for(100, [&](const std::size_t p_inner_begin, const std::size_t p_inner_end)
+					{
+						counts[i] += static_cast<int>(p_inner_end - p_inner_begin);
+					}, 10);
+				}
+			});
+
+			// Callers on other threads share the pool or run inline
+			std::atomic<int> total{ 0 };
+			std::thread other([&]()
+			{
+				for (int n = 0; n < 200; ++n)
+					parallel_for(64, [&](const std::size_t p_begin, const std::size_t p_end) { total += static_cast<int>(p_end - p_begin); }, 8);
+			});
+			for (int n = 0; n < 200; ++n)
+				parallel_for(64, [&](const std::size_t p_begin, const std::size_t p_end) { total += static_cast<int>(p_end - p_begin); }, 8);
+			other.join();
+			set_thread_count(0);
+
+			for (const auto& c : counts)
+				Assert::AreEqual(100, c.load());
+			Assert::AreEqual(2 * 200 * 64, total.load());
+		}
+
+		TEST_METHOD(test_parallel_for_reuses_threads)
+		{
+			// Thousands of small calls run on the persistent workers; mesh_parallel_bench measures their latency
+			set_thread_count(4);
+			std::atomic<std::size_t> sum{ 0 };
+			for (int n = 0; n < 5000; ++n)
+				parallel_for(4, [&](const std::size_t p_begin, const std::size_t p_end) { sum += p_end - p_begin; });
+			set_thread_count(0);
+			Assert::AreEqual(std::size_t{ 20000 }, sum.load());
+		}
+
+		TEST_METHOD(test_bounded_queue)
+		{
+			// Items arrive in order across threads with the producer held back by the capacity
+			bounded_queue<int> queue(2);
+			std::thread producer([&]()
+			{
+				for (int i = 0; i < 1000; ++i)
+					queue.push(i);
+				queue.close();
+			});
+
+			int expected = 0;
+			int value = 0;
+			while (queue.pop(value))
+				Assert::AreEqual(expected++, value);
+			producer.join();
+			Assert::AreEqual(1000, expected);
+
+			// Closed queues drop pushes
+			Assert::IsFalse(queue.push(5));
+			Assert::IsFalse(queue.pop(value));
+		}
+	};
+}
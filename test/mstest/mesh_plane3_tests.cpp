@@ -1,6 +1,8 @@
 #include "CppUnitTest.h"
 #include "mesh/mesh_plane3.hpp"
 
+#include <cmath>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace mesh;
 
@@ -23,9 +25,15 @@ namespace mesh_tests
 			Assert::IsTrue(p3.normal.is_equal_approx(vector3{ 0.0, 1.0, 0.0 }));
 			Assert::AreEqual(1.0, p3.distance);
 
-			const plane3 p4{ vector3{ 0.0, 1.0, 0.0 }, vector3{ 0.0, 1.0, 1.0 }, vector3{ 1.0, 1.0, 0.0 } };
+			constexpr plane3 p4{ vector3{ 0.0, 1.0, 0.0 }, vector3{ 0.0, 1.0, 1.0 }, vector3{ 1.0, 1.0, 0.0 } };
 			Assert::IsTrue(p4.normal.is_equal_approx(vector3{ 0.0, 1.0, 0.0 }));
 			Assert::AreEqual(1.0, p4.distance);
+
+			// Slanted planes evaluate at compile time too
+			constexpr plane3 p5{ vector3{ 1.0, 0.0, 0.0 }, vector3{ 0.0, 1.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 } };
+			static_assert(p5.distance > 0.577 && p5.distance < 0.578, "constexpr plane");
+			Assert::AreEqual(1.0 / std::sqrt(3.0), p5.normal.x, 1e-15);
+			Assert::AreEqual(1.0 / std::sqrt(3.0), p5.distance, 1e-15);
 		}
 
 		TEST_METHOD(test_is_equal_approx)
@@ -0,0 +1,113 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_primitives.hpp"
+
+#include <cmath>
+#include <map>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_primitives)
+	{
+		/// Check a closed mesh: every edge used twice in opposite directions, positive volume
+		template <std::size_t V, std::size_t T>
+		static double check_closed(const static_mesh<V, T>& p_mesh)
+		{
+			std::map<std::pair<std::uint32_t, std::uint32_t>, int> edges;
+			double volume = 0.0;
+			for (std::size_t t = 0; t < T; ++t)
+			{
+				for (int c = 0; c < 3; ++c)
+				{
+					const std::uint32_t a = p_mesh.indices[t * 3 + c];
+					const std::uint32_t b = p_mesh.indices[t * 3 + (c + 1) % 3];
+					Assert::IsTrue(a < V && b < V && a != b);
+					++edges[std::make_pair(a, b)];
+				}
+				const triangle3 tri = p_mesh.triangle(t);
+				volume += tri.point1.dot(tri.point2.cross(tri.point3)) / 6.0;
+			}
+			for (const auto& e : edges)
+			{
+				Assert::AreEqual(1, e.second);
+				Assert::IsTrue(edges.count(std::make_pair(e.first.second, e.first.first)) == 1);
+			}
+			return volume;
+		}
+
+	public:
+		TEST_METHOD(test_box)
+		{
+			constexpr auto box = make_box(vector3{ 1.0, 2.0, 3.0 });
+			static_assert(box.vertex_count() == 8 && box.triangle_count() == 12, "box size");
+			static_assert(box.vertices[7].z == 3.0, "box corner");
+			Assert::AreEqual(48.0, check_closed(box), 1e-12);
+
+			const indexed_mesh mesh = box.to_mesh();
+			Assert::AreEqual(size_t{ 8 }, mesh.vertex_count());
+			Assert::AreEqual(size_t{ 12 }, mesh.triangle_count());
+			Assert::IsTrue(mesh.bounds() == aabb3(vector3{ -1.0, -2.0, -3.0 }, vector3{ 1.0, 2.0, 3.0 }));
+		}
+
+		TEST_METHOD(test_octahedron)
+		{
+			constexpr auto octahedron = make_octahedron(2.0);
+			Assert::AreEqual(32.0 / 3.0, check_closed(octahedron), 1e-12);
+		}
+
+		TEST_METHOD(test_icosahedron)
+		{
+			constexpr auto icosahedron = make_icosahedron(1.0);
+			static_assert(icosahedron.vertices[0].length() > 0.9999999 && icosahedron.vertices[0].length() < 1.0000001, "unit vertices");
+
+			// Regular: unit vertices and equal edges
+			for (const auto& v : icosahedron.vertices)
+				Assert::AreEqual(1.0, v.length(), 1e-15);
+			const double edge = (icosahedron.vertices[icosahedron.indices[0]] - icosahedron.vertices[icosahedron.indices[1]]).length();
+			for (std::size_t t = 0; t < 20; ++t)
+			{
+				const triangle3 tri = icosahedron.triangle(t);
+				Assert::AreEqual(edge, (tri.point2 - tri.point1).length(), 1e-14);
+				Assert::AreEqual(edge, (tri.point3 - tri.point2).length(), 1e-14);
+			}
+			Assert::AreEqual(5.0 / 12.0 * (3.0 + std::sqrt(5.0)) * edge * edge * edge, check_closed(icosahedron), 1e-12);
+		}
+
+		TEST_METHOD(test_icosphere)
+		{
+			constexpr auto sphere = make_icosphere<2>(3.0);
+			static_assert(sphere.vertex_count() == 162 && sphere.triangle_count() == 320, "icosphere size");
+			for (const auto& v : sphere.vertices)
+				Assert::AreEqual(3.0, v.length(), 1e-14);
+
+			// Compile-time and run-time generation agree
+			volatile double radius = 3.0;
+			const auto runtime = make_icosphere<2>(radius);
+			Assert::IsTrue(runtime.indices == sphere.indices);
+			for (std::size_t i = 0; i < sphere.vertex_count(); ++i)
+				Assert::IsTrue((runtime.vertices[i] - sphere.vertices[i]).length() < 1e-14);
+
+			const double volume = check_closed(sphere);
+			Assert::IsTrue(volume < 4.0 / 3.0 * 3.14159265358979323846 * 27.0);
+			Assert::IsTrue(volume > 0.95 * 4.0 / 3.0 * 3.14159265358979323846 * 27.0);
+			Assert::AreEqual(size_t{ 12 }, make_icosphere<0>(1.0).vertex_count());
+		}
+
+		TEST_METHOD(test_grid)
+		{
+			constexpr auto grid = make_grid<4, 2>(8.0, 2.0);
+			static_assert(grid.vertex_count() == 15 && grid.triangle_count() == 16, "grid size");
+			static_assert(grid.vertices[0].x == -4.0 && grid.vertices[14].y == 1.0, "grid corners");
+			double area = 0.0;
+			for (std::size_t t = 0; t < grid.triangle_count(); ++t)
+			{
+				const vector3 n = grid.triangle(t).normal();
+				Assert::IsTrue(n.z > 0.0);
+				area += n.length() * 0.5;
+			}
+			Assert::AreEqual(16.0, area, 1e-12);
+		}
+	};
+}
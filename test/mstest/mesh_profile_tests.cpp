@@ -0,0 +1,95 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_parallel.hpp"
+#include "mesh/mesh_profile.hpp"
+
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+// Built into its own runner (MeshProfileTest.vcxproj, mesh_profile_tests in CMake) with
+// MESH_ENABLE_PROFILING set for every translation unit
+#if defined(MESH_ENABLE_PROFILING)
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_profile)
+	{
+		/// Find a stage in a report
+		static profile_entry find(const std::vector<profile_entry>& p_entries, const std::string& p_name)
+		{
+			for (const auto& e : p_entries)
+			{
+				if (e.name == p_name)
+					return e;
+			}
+			return profile_entry{};
+		}
+
+		static void timed_stage(const std::size_t p_elements)
+		{
+			MESH_PROFILE_SCOPE("test.timed", p_elements);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+	public:
+		TEST_METHOD(test_scope)
+		{
+			profile_reset();
+			timed_stage(10);
+			timed_stage(5);
+			MESH_PROFILE_COUNT("test.counted", 7);
+
+			const std::vector<profile_entry> report = profile_report();
+			const profile_entry timed = find(report, "test.timed");
+			Assert::AreEqual(std::uint64_t{ 2 }, timed.calls);
+			Assert::AreEqual(std::uint64_t{ 15 }, timed.elements);
+			Assert::IsTrue(timed.nanoseconds >= 2000000);
+
+			const profile_entry counted = find(report, "test.counted");
+			Assert::AreEqual(std::uint64_t{ 1 }, counted.calls);
+			Assert::AreEqual(std::uint64_t{ 7 }, counted.elements);
+			Assert::AreEqual(std::uint64_t{ 0 }, counted.nanoseconds);
+			Assert::IsTrue(format_profile_report(report).find("test.timed") != std::string::npos);
+
+			profile_reset();
+			Assert::AreEqual(std::uint64_t{ 0 }, find(profile_report(), "test.timed").calls);
+		}
+
+		TEST_METHOD(test_threads)
+		{
+			profile_reset();
+
+			// Counts from worker threads survive the threads exiting
+			parallel_for(1000, [](const std::size_t p_begin, const std::size_t p_end)
+			{
+				for (std::size_t i = p_begin; i < p_end; ++i)
+					MESH_PROFILE_COUNT("test.parallel", 2);
+			}, 10);
+			std::thread worker([] { MESH_PROFILE_COUNT("test.parallel", 1); });
+			worker.join();
+
+			const profile_entry entry = find(profile_report(), "test.parallel");
+			Assert::AreEqual(std::uint64_t{ 1001 }, entry.calls);
+			Assert::AreEqual(std::uint64_t{ 2001 }, entry.elements);
+		}
+
+		TEST_METHOD(test_hardware_counters)
+		{
+			// Unavailable in many containers and virtual machines; only check consistency
+			profile_reset();
+			const bool available = enable_profile_hardware_counters(true);
+			volatile double sum = 0.0;
+			{
+				MESH_PROFILE_SCOPE("test.hardware", 100000);
+				for (int i = 0; i < 100000; ++i)
+					sum = sum + i;
+			}
+			enable_profile_hardware_counters(false);
+
+			const profile_entry entry = find(profile_report(), "test.hardware");
+			Assert::AreEqual(std::uint64_t{ 1 }, entry.calls);
+			Assert::AreEqual(available, entry.cycles != 0);
+		}
+	};
+}
+#endif
@@ -0,0 +1,112 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_quantize.hpp"
+
+#include <cmath>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_quantize)
+	{
+		/// Check every decoded position is within the documented error
+		template <int Bits>
+		static void check_positions()
+		{
+			const aabb3 bounds{ vector3{ -10.0, 2.0, -0.5 }, vector3{ 30.0, 2.5, 0.5 } };
+			const position_quantizer<Bits> quantizer{ bounds };
+			const vector3 error = quantizer.max_error();
+
+			std::mt19937 rng(Bits);
+			std::uniform_real_distribution<double> dist(0.0, 1.0);
+			std::vector<vector3> points(1000);
+			for (auto& p : points)
+				p = bounds.minimum + bounds.size() * vector3{ dist(rng), dist(rng), dist(rng) };
+			points.push_back(bounds.minimum);
+			points.push_back(bounds.maximum);
+
+			std::vector<typename position_quantizer<Bits>::storage_type> encoded(points.size());
+			std::vector<vector3> decoded(points.size());
+			quantizer.encode(points.data(), points.size(), encoded.data());
+			quantizer.decode(encoded.data(), encoded.size(), decoded.data());
+			for (std::size_t i = 0; i < points.size(); ++i)
+			{
+				Assert::IsTrue(decoded[i] == quantizer.decode(encoded[i]));
+				Assert::IsTrue(std::abs(decoded[i].x - points[i].x) <= error.x * (1.0 + 1e-9));
+				Assert::IsTrue(std::abs(decoded[i].y - points[i].y) <= error.y * (1.0 + 1e-9));
+				Assert::IsTrue(std::abs(decoded[i].z - points[i].z) <= error.z * (1.0 + 1e-9));
+			}
+
+			// Bounds corners survive exactly and outside points clamp to the box
+			Assert::IsTrue(decoded[points.size() - 2] == bounds.minimum);
+			const vector3 clamped = quantizer.decode(quantizer.encode(vector3{ 100.0, -100.0, 0.0 }));
+			Assert::AreEqual(30.0, clamped.x, 1e-12);
+			Assert::AreEqual(2.0, clamped.y);
+		}
+
+	public:
+		TEST_METHOD(test_position16)
+		{
+			check_positions<16>();
+			Assert::AreEqual(size_t{ 6 }, sizeof(quantized_position16));
+			const position_quantizer<16> quantizer{ aabb3{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 65535.0, 1.0, 0.0 } } };
+			Assert::AreEqual(0.5, quantizer.max_error().x);
+			Assert::AreEqual(0.0, quantizer.max_error().z);
+		}
+
+		TEST_METHOD(test_position21)
+		{
+			check_positions<21>();
+			Assert::AreEqual(size_t{ 8 }, sizeof(quantized_position21));
+			const position_quantizer<21> quantizer{ aabb3{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 1.0, 1.0 } } };
+			const auto q = quantizer.encode(vector3{ 1.0, 0.0, 1.0 });
+			Assert::IsTrue(q == (quantized_position21{ 0x1FFFFF } | (quantized_position21{ 0x1FFFFF } << 42)));
+		}
+
+		TEST_METHOD(test_octahedral)
+		{
+			// Axis directions round trip exactly
+			for (const auto& n : { vector3{ 1.0, 0.0, 0.0 }, vector3{ -1.0, 0.0, 0.0 }, vector3{ 0.0, 1.0, 0.0 },
+								   vector3{ 0.0, -1.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 }, vector3{ 0.0, 0.0, -1.0 } })
+				Assert::IsTrue(decode_octahedral(encode_octahedral(n)) == n);
+
+			// Random directions stay within the documented angular error
+			std::mt19937 rng(3);
+			std::normal_distribution<double> dist;
+			std::vector<vector3> normals(20000);
+			for (auto& n : normals)
+				n = vector3{ dist(rng), dist(rng), dist(rng) }.normalized();
+
+			std::vector<octahedral_normal> encoded(normals.size());
+			std::vector<vector3> decoded(normals.size());
+			encode_octahedral(normals.data(), normals.size(), encoded.data());
+			decode_octahedral(encoded.data(), encoded.size(), decoded.data());
+			const double pi = 3.14159265358979323846;
+			for (std::size_t i = 0; i < normals.size(); ++i)
+			{
+				Assert::IsTrue((decoded[i] - decode_octahedral(encoded[i])).length() < 1e-15);
+				Assert::AreEqual(1.0, decoded[i].length(), 1e-15);
+				const double angle = std::atan2(normals[i].cross(decoded[i]).length(), normals[i].dot(decoded[i])) * 180.0 / pi;
+				Assert::IsTrue(angle <= 0.0025);
+			}
+		}
+
+		TEST_METHOD(test_quantized_mesh)
+		{
+			indexed_mesh mesh;
+			mesh.add_vertex(vector3{ 0.0, 0.0, 0.0 });
+			mesh.add_vertex(vector3{ 1.0, 0.3, 0.0 });
+			mesh.add_vertex(vector3{ 0.2, 4.0, -1.0 });
+			mesh.add_triangle(0, 1, 2);
+
+			const auto q = quantized_mesh<16>::encode(mesh);
+			Assert::AreEqual(size_t{ 3 }, q.positions.size());
+			const indexed_mesh decoded = q.decode();
+			Assert::IsTrue(decoded.indices == mesh.indices);
+			for (std::size_t i = 0; i < mesh.vertex_count(); ++i)
+				Assert::IsTrue((decoded.vertices[i] - mesh.vertices[i]).length() <= q.quantizer.max_error().length() * (1.0 + 1e-9));
+		}
+	};
+}
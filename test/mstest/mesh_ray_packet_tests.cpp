@@ -0,0 +1,128 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_ray_packet.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_ray_packet)
+	{
+	public:
+		TEST_METHOD(test_mask_count)
+		{
+			Assert::AreEqual(0, mask_count(0));
+			Assert::AreEqual(4, mask_count(0xF));
+			Assert::AreEqual(16, mask_count(ray_packet<16>::all));
+		}
+
+		TEST_METHOD(test_set)
+		{
+			ray_packet<4> p;
+			p.set(2, vector3{ 1.0, 2.0, 3.0 }, vector3{ 0.0, 0.0, 1.0 }, 10.0);
+			Assert::IsTrue(p.origin(2).is_equal_approx(vector3{ 1.0, 2.0, 3.0 }));
+			Assert::IsTrue(p.direction(2).is_equal_approx(vector3{ 0.0, 0.0, 1.0 }));
+			Assert::AreEqual(10.0, p.max_distance[2]);
+		}
+
+		TEST_METHOD(test_is_coherent)
+		{
+			ray_packet<4> p;
+			for (std::size_t i = 0; i < 4; ++i)
+				p.set(i, vector3{ static_cast<double>(i), 0.0, 0.0 }, vector3{ 0.1, 0.2, 1.0 });
+			Assert::IsTrue(p.is_coherent());
+
+			p.set(3, vector3{ 0.0, 0.0, 0.0 }, vector3{ -0.1, 0.2, 1.0 });
+			Assert::IsFalse(p.is_coherent());
+			Assert::IsTrue(p.is_coherent(0x7));
+		}
+
+		TEST_METHOD(test_intersect_plane)
+		{
+			constexpr plane3 pl{ vector3{ 0.0, 0.0, 1.0 }, 2.0 };
+
+			ray_packet<4> p;
+			p.set(0, vector3{ 0.0, 0.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 });
+			p.set(1, vector3{ 0.0, 0.0, 0.0 }, vector3{ 0.0, 0.0, -1.0 });
+			p.set(2, vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 0.0, 0.0 });
+			p.set(3, vector3{ 0.0, 0.0, 0.0 }, vector3{ 0.0, 0.0, 2.0 }, 0.5);
+
+			double dist[4] = {};
+			Assert::AreEqual(ray_mask{ 0x1 }, p.intersect_plane(pl, dist));
+			Assert::AreEqual(2.0, dist[0]);
+
+			// Lanes must agree with the single ray path
+			for (std::size_t i = 0; i < 3; ++i)
+				Assert::AreEqual(pl.intersect_ray(p.origin(i), p.direction(i)), (p.intersect_plane(pl) & (1u << i)) != 0);
+		}
+
+		TEST_METHOD(test_intersect_aabb)
+		{
+			constexpr aabb3 b{ vector3{ -1.0, -1.0, 4.0 }, vector3{ 1.0, 1.0, 6.0 } };
+
+			ray_packet<8> p;
+			for (std::size_t i = 0; i < 8; ++i)
+				p.set(i, vector3{ static_cast<double>(i) * 0.4, 0.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 });
+
+			double dist[8] = {};
+			Assert::AreEqual(ray_mask{ 0x7 }, p.intersect_aabb(b, dist));
+			Assert::AreEqual(4.0, dist[0]);
+			Assert::AreEqual(ray_mask{ 0x5 }, p.intersect_aabb(b, nullptr, 0x5));
+
+			// Rays parallel to a slab with the origin on its plane (0 * inf) hit, unless outside another slab
+			ray_packet<4> q;
+			q.set(0, vector3{ -1.0, 0.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 });
+			q.set(1, vector3{ 1.0, 1.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 });
+			q.set(2, vector3{ 0.0, -1.0, 5.0 }, vector3{ 1.0, 0.0, 0.0 });
+			q.set(3, vector3{ 1.0, 2.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 });
+			Assert::AreEqual(ray_mask{ 0x7 }, q.intersect_aabb(b, dist));
+			Assert::AreEqual(4.0, dist[0]);
+			Assert::AreEqual(0.0, dist[2]);
+		}
+
+		TEST_METHOD(test_intersect_triangle)
+		{
+			constexpr triangle3 t{ vector3{ 0.0, 0.0, 3.0 }, vector3{ 4.0, 0.0, 3.0 }, vector3{ 0.0, 4.0, 3.0 } };
+
+			ray_packet<4> p;
+			p.set(0, vector3{ 1.0, 1.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 });
+			p.set(1, vector3{ 3.0, 3.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 });
+			p.set(2, vector3{ 1.0, 1.0, 0.0 }, vector3{ 0.0, 0.0, -1.0 });
+			p.set(3, vector3{ 0.5, 0.5, 0.0 }, vector3{ 0.0, 0.0, 1.0 }, 1.0);
+
+			double dist[4] = {};
+			Assert::AreEqual(ray_mask{ 0x1 }, p.intersect_triangle(t, dist));
+			Assert::AreEqual(3.0, dist[0]);
+		}
+
+		TEST_METHOD(test_intersect_triangles)
+		{
+			const triangle3 tris[] = {
+				triangle3{ vector3{ -10.0, -10.0, 5.0 }, vector3{ 30.0, -10.0, 5.0 }, vector3{ -10.0, 30.0, 5.0 } },
+				triangle3{ vector3{ -10.0, -10.0, 2.0 }, vector3{ 30.0, -10.0, 2.0 }, vector3{ -10.0, 30.0, 2.0 } }
+			};
+
+			// Coherent packet
+			ray_packet<4> p1;
+			for (std::size_t i = 0; i < 4; ++i)
+				p1.set(i, vector3{ static_cast<double>(i), 0.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 });
+			ray_packet_hit<4> h1;
+			Assert::AreEqual(ray_mask{ 0xF }, intersect_triangles(p1, tris, 2, h1));
+			for (std::size_t i = 0; i < 4; ++i)
+			{
+				Assert::AreEqual(2.0, h1.distance[i]);
+				Assert::AreEqual(size_t{ 1 }, h1.index[i]);
+			}
+
+			// Incoherent packets give the same lanes as single rays
+			ray_packet<4> p2;
+			for (std::size_t i = 0; i < 4; ++i)
+				p2.set(i, vector3{ static_cast<double>(i), 0.0, 0.0 }, vector3{ 0.0, 0.0, i == 3 ? -1.0 : 1.0 });
+			Assert::IsFalse(p2.is_coherent());
+			ray_packet_hit<4> h2;
+			Assert::AreEqual(ray_mask{ 0x7 }, intersect_triangles(p2, tris, 2, h2));
+			Assert::AreEqual(2.0, h2.distance[0]);
+			Assert::AreEqual(size_t{ 1 }, h2.index[0]);
+		}
+	};
+}
@@ -0,0 +1,154 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_primitives.hpp"
+#include "mesh/mesh_remesh.hpp"
+
+#include <cmath>
+#include <map>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_remesh)
+	{
+		/// Check every edge is used at most once per direction, returning the boundary edge count
+		static std::size_t check_manifold(const indexed_mesh& p_mesh)
+		{
+			std::map<std::pair<std::uint32_t, std::uint32_t>, int> edges;
+			for (std::size_t i = 0; i < p_mesh.indices.size(); ++i)
+			{
+				const std::uint32_t a = p_mesh.indices[i];
+				const std::uint32_t b = p_mesh.indices[i - i % 3 + (i + 1) % 3];
+				Assert::IsTrue(a < p_mesh.vertex_count() && b < p_mesh.vertex_count() && a != b);
+				Assert::AreEqual(1, ++edges[std::make_pair(a, b)]);
+			}
+			std::size_t open = 0;
+			for (const auto& e : edges)
+			{
+				if (edges.count(std::make_pair(e.first.second, e.first.first)) == 0)
+					++open;
+			}
+			return open;
+		}
+
+		/// Calculate the mean edge length and the fraction of edges within the remeshing band
+		static double edge_statistics(const indexed_mesh& p_mesh, const double p_target, double& p_within)
+		{
+			double sum = 0.0;
+			std::size_t within = 0;
+			for (std::size_t i = 0; i < p_mesh.indices.size(); ++i)
+			{
+				const double l = (p_mesh.vertices[p_mesh.indices[i]] - p_mesh.vertices[p_mesh.indices[i - i % 3 + (i + 1) % 3]]).length();
+				sum += l;
+				if (l > 0.5 * p_target && l < 1.5 * p_target)
+					++within;
+			}
+			p_within = static_cast<double>(within) / static_cast<double>(p_mesh.indices.size());
+			return sum / static_cast<double>(p_mesh.indices.size());
+		}
+
+		static double signed_volume(const indexed_mesh& p_mesh)
+		{
+			double volume = 0.0;
+			for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+			{
+				const triangle3 tri = p_mesh.triangle(t);
+				volume += tri.point1.dot(tri.point2.cross(tri.point3)) / 6.0;
+			}
+			return volume;
+		}
+
+	public:
+		TEST_METHOD(test_refine)
+		{
+			const indexed_mesh original = make_icosphere<2>(1.0).to_mesh();
+			indexed_mesh mesh = original;
+			remesh_options options;
+			options.target_edge_length = 0.05;
+			const remesh_result result = remesh_isotropic(mesh, options);
+			Assert::IsTrue(result.ok);
+			Assert::IsTrue(result.splits > 0 && result.flips > 0);
+			Assert::IsTrue(mesh.triangle_count() > 10 * original.triangle_count());
+
+			// Closed, on the input surface, with edges near the target
+			Assert::AreEqual(size_t{ 0 }, check_manifold(mesh));
+			const mesh_bvh surface(original);
+			for (const auto& v : mesh.vertices)
+				Assert::IsTrue(surface.closest_point(v).distance2 < 1e-20);
+			double within = 0.0;
+			Assert::AreEqual(0.05, edge_statistics(mesh, 0.05, within), 0.01);
+			Assert::IsTrue(within > 0.95);
+			Assert::AreEqual(signed_volume(original), signed_volume(mesh), 0.01);
+		}
+
+		TEST_METHOD(test_coarsen)
+		{
+			const indexed_mesh original = make_icosphere<4>(1.0).to_mesh();
+			indexed_mesh mesh = original;
+			remesh_options options;
+			options.target_edge_length = 0.25;
+			const remesh_result result = remesh_isotropic(mesh, options);
+			Assert::IsTrue(result.ok && result.collapses > 0);
+			Assert::IsTrue(mesh.triangle_count() * 5 < original.triangle_count());
+			Assert::AreEqual(size_t{ 0 }, check_manifold(mesh));
+			double within = 0.0;
+			Assert::AreEqual(0.25, edge_statistics(mesh, 0.25, within), 0.05);
+			Assert::IsTrue(within > 0.9);
+		}
+
+		TEST_METHOD(test_boundary)
+		{
+			// Long thin cells become near-equilateral; the outline is kept
+			indexed_mesh mesh = make_grid<40, 2>(8.0, 2.0).to_mesh();
+			remesh_options options;
+			options.target_edge_length = 0.25;
+			Assert::IsTrue(remesh_isotropic(mesh, options).ok);
+			Assert::IsTrue(check_manifold(mesh) > 0);
+
+			double area = 0.0;
+			for (std::size_t t = 0; t < mesh.triangle_count(); ++t)
+			{
+				const vector3 n = mesh.triangle(t).normal();
+				Assert::IsTrue(n.z > 0.0);
+				area += n.length() * 0.5;
+			}
+			Assert::AreEqual(16.0, area, 1e-9);
+			for (const auto& v : mesh.vertices)
+				Assert::IsTrue(v.z == 0.0 && std::abs(v.x) <= 4.0 && std::abs(v.y) <= 1.0);
+			double within = 0.0;
+			edge_statistics(mesh, 0.25, within);
+			Assert::IsTrue(within > 0.9);
+		}
+
+		TEST_METHOD(test_deterministic)
+		{
+			const indexed_mesh original = make_icosphere<3>(2.0).to_mesh();
+			remesh_options options;
+			options.target_edge_length = 0.1;
+
+			indexed_mesh serial = original;
+			set_thread_count(1);
+			remesh_isotropic(serial, options);
+			indexed_mesh threaded = original;
+			set_thread_count(4);
+			remesh_isotropic(threaded, options);
+			set_thread_count(0);
+			Assert::IsTrue(serial.indices == threaded.indices);
+			Assert::IsTrue(serial.vertices == threaded.vertices);
+		}
+
+		TEST_METHOD(test_invalid)
+		{
+			indexed_mesh mesh = make_box(vector3{ 1.0, 1.0, 1.0 }).to_mesh();
+			mesh.indices[5] = 8;
+			const indexed_mesh copy = mesh;
+			Assert::IsFalse(remesh_isotropic(mesh).ok);
+			Assert::IsTrue(mesh.indices == copy.indices);
+
+			indexed_mesh empty;
+			Assert::IsTrue(remesh_isotropic(empty).ok);
+			Assert::AreEqual(size_t{ 0 }, empty.triangle_count());
+		}
+	};
+}
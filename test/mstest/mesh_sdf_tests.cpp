@@ -0,0 +1,104 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_sdf.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_sdf)
+	{
+		/// Build a closed box mesh with outward-facing triangles
+		static indexed_mesh make_box(const vector3& p_min, const vector3& p_max)
+		{
+			indexed_mesh m;
+			for (int i = 0; i < 8; ++i)
+			{
+				m.add_vertex(vector3{
+					(i & 1) ? p_max.x : p_min.x,
+					(i & 2) ? p_max.y : p_min.y,
+					(i & 4) ? p_max.z : p_min.z });
+			}
+
+			const std::uint32_t faces[] = {
+				0, 4, 6, 0, 6, 2,
+				1, 3, 7, 1, 7, 5,
+				0, 1, 5, 0, 5, 4,
+				2, 6, 7, 2, 7, 3,
+				0, 2, 3, 0, 3, 1,
+				4, 5, 7, 4, 7, 6
+			};
+			m.indices.assign(std::begin(faces), std::end(faces));
+			return m;
+		}
+
+	public:
+		TEST_METHOD(test_grid_sample)
+		{
+			sdf_grid g1{ vector3{ 0.0, 0.0, 0.0 }, 1.0, 2, 2, 2 };
+			for (std::size_t k = 0; k < 2; ++k)
+				for (std::size_t j = 0; j < 2; ++j)
+					for (std::size_t i = 0; i < 2; ++i)
+						g1.at(i, j, k) = static_cast<double>(i + j + k);
+
+			Assert::AreEqual(1.5, g1.sample(vector3{ 0.5, 0.5, 0.5 }), 1e-12);
+			Assert::AreEqual(0.0, g1.sample(vector3{ -1.0, -1.0, -1.0 }), 1e-12);
+			Assert::AreEqual(3.0, g1.sample(vector3{ 2.0, 2.0, 2.0 }), 1e-12);
+		}
+
+		TEST_METHOD(test_build_sdf)
+		{
+			const indexed_mesh box = make_box(vector3{ 0.0, 0.0, 0.0 }, vector3{ 2.0, 2.0, 2.0 });
+
+			sdf_options options;
+			options.cell_size = 0.25;
+			options.padding = 4;
+			const sdf_grid g1 = build_sdf(box, options);
+			Assert::AreEqual(size_t{ 17 }, g1.size_x);
+
+			// Center is deep inside (reached by sweeping), faces are zero, outside is positive
+			Assert::AreEqual(-1.0, g1.sample(vector3{ 1.0, 1.0, 1.0 }), 1e-9);
+			Assert::AreEqual(0.0, g1.sample(vector3{ 0.0, 1.0, 1.0 }), 1e-9);
+			Assert::AreEqual(0.5, g1.sample(vector3{ -0.5, 1.0, 1.0 }), 1e-9);
+			Assert::AreEqual(-0.25, g1.sample(vector3{ 1.0, 1.75, 1.0 }), 1e-9);
+
+			// Corner region distance is to the corner vertex
+			Assert::AreEqual(std::sqrt(0.75), g1.sample(vector3{ -0.5, -0.5, -0.5 }), 1e-9);
+		}
+
+		TEST_METHOD(test_build_sdf_winding_number)
+		{
+			const indexed_mesh box = make_box(vector3{ 0.0, 0.0, 0.0 }, vector3{ 2.0, 2.0, 2.0 });
+
+			sdf_options options;
+			options.cell_size = 0.5;
+			options.sign = sdf_sign_method::winding_number;
+			const sdf_grid g1 = build_sdf(box, options);
+			Assert::AreEqual(-1.0, g1.sample(vector3{ 1.0, 1.0, 1.0 }), 1e-9);
+			Assert::AreEqual(0.5, g1.sample(vector3{ 2.5, 1.0, 1.0 }), 1e-9);
+		}
+
+		TEST_METHOD(test_build_sparse_sdf)
+		{
+			const indexed_mesh box = make_box(vector3{ 0.0, 0.0, 0.0 }, vector3{ 8.0, 8.0, 8.0 });
+
+			sdf_options options;
+			options.cell_size = 0.25;
+			options.band = 2.0;
+			const sparse_sdf_grid g1 = build_sparse_sdf(box, options);
+			Assert::IsTrue(g1.block_count() > 0);
+			Assert::IsTrue(g1.block_count() < g1.block_table.size());
+
+			// Exact near the surface, clamped to the background elsewhere
+			Assert::AreEqual(0.0, g1.sample(vector3{ 0.0, 4.0, 4.0 }), 1e-9);
+			Assert::AreEqual(-0.25, g1.sample(vector3{ 0.25, 4.0, 4.0 }), 1e-9);
+			Assert::AreEqual(0.25, g1.sample(vector3{ -0.25, 4.0, 4.0 }), 1e-9);
+			Assert::AreEqual(-0.5, g1.sample(vector3{ 4.0, 4.0, 4.0 }), 1e-9);
+
+			// Matches the dense field within the band
+			const sdf_grid g2 = build_sdf(box, options);
+			for (double x = -0.4; x < 0.4; x += 0.1)
+				Assert::AreEqual(g2.sample(vector3{ x, 3.0, 5.0 }), g1.sample(vector3{ x, 3.0, 5.0 }), 1e-9);
+		}
+	};
+}
@@ -0,0 +1,73 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_sparse_matrix.hpp"
+#include "mesh/mesh_vector3.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_sparse_matrix)
+	{
+		/// Tridiagonal matrix with 2 on the diagonal and -1 beside it
+		static sparse_matrix tridiagonal(const std::size_t p_size)
+		{
+			sparse_matrix m;
+			m.rows = p_size;
+			m.cols = p_size;
+			m.offsets.push_back(0);
+			for (std::size_t i = 0; i < p_size; ++i)
+			{
+				for (std::size_t j = i == 0 ? 0 : i - 1; j <= i + 1 && j < p_size; ++j)
+				{
+					m.columns.push_back(static_cast<std::uint32_t>(j));
+					m.values.push_back(i == j ? 2.0 : -1.0);
+				}
+				m.offsets.push_back(static_cast<std::uint32_t>(m.columns.size()));
+			}
+			return m;
+		}
+
+	public:
+		TEST_METHOD(test_access)
+		{
+			const sparse_matrix m = tridiagonal(4);
+			Assert::AreEqual(size_t{ 10 }, m.nonzeros());
+			Assert::AreEqual(2.0, m.at(2, 2));
+			Assert::AreEqual(-1.0, m.at(2, 1));
+			Assert::AreEqual(-1.0, m.at(2, 3));
+			Assert::AreEqual(0.0, m.at(0, 3));
+			Assert::AreEqual(0.0, m.at(3, 0));
+			const std::vector<double> d = m.diagonal();
+			Assert::AreEqual(size_t{ 4 }, d.size());
+			for (const double v : d)
+				Assert::AreEqual(2.0, v);
+		}
+
+		TEST_METHOD(test_multiply)
+		{
+			// Second differences of a quadratic are constant
+			const std::size_t n = 100000;
+			const sparse_matrix m = tridiagonal(n);
+			std::vector<double> x(n);
+			std::vector<vector3> xv(n);
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				const double t = static_cast<double>(i);
+				x[i] = t * t;
+				xv[i] = vector3(t, t * t, 1.0);
+			}
+			std::vector<double> y(n);
+			std::vector<vector3> yv(n);
+			m.multiply(x.data(), y.data());
+			m.multiply(xv.data(), yv.data());
+			for (std::size_t i = 1; i + 1 < n; ++i)
+			{
+				Assert::AreEqual(-2.0, y[i]);
+				Assert::IsTrue(yv[i] == vector3(0.0, -2.0, 0.0));
+			}
+			Assert::AreEqual(-1.0, y[0]);
+			Assert::IsTrue(yv[n - 1] == xv[n - 1] * 2.0 - xv[n - 2]);
+		}
+	};
+}
@@ -0,0 +1,178 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_spatial_hash.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_spatial_hash)
+	{
+		/// Make random points in a cube centered on the origin
+		static std::vector<vector3> make_points(const std::size_t p_count, const double p_extent, const unsigned int p_seed)
+		{
+			std::mt19937 rng(p_seed);
+			std::uniform_real_distribution<double> dist(-p_extent, p_extent);
+			std::vector<vector3> points(p_count);
+			for (auto& p : points)
+				p = vector3{ dist(rng), dist(rng), dist(rng) };
+			return points;
+		}
+
+		/// Find the points within a radius by brute force
+		static std::vector<std::uint32_t> brute_force(const std::vector<vector3>& p_points, const vector3& p_center, const double p_radius)
+		{
+			std::vector<std::uint32_t> result;
+			for (std::size_t i = 0; i < p_points.size(); ++i)
+			{
+				if ((p_points[i] - p_center).length2() <= p_radius * p_radius)
+					result.push_back(static_cast<std::uint32_t>(i));
+			}
+			return result;
+		}
+
+	public:
+		TEST_METHOD(test_build)
+		{
+			const auto points = make_points(5000, 10.0, 1);
+			spatial_hash hash{ 0.5 };
+			hash.build(points);
+			Assert::AreEqual(points.size(), hash.size());
+			Assert::AreEqual(size_t{ 8192 }, hash.table_size());
+
+			// Every point appears once and the entries are grouped by bucket
+			std::vector<int> seen(points.size(), 0);
+			for (std::size_t s = 0; s < hash.size(); ++s)
+			{
+				const std::uint32_t index = hash.indices()[s];
+				++seen[index];
+				Assert::IsTrue(hash.points()[s] == points[index]);
+				if (s > 0)
+					Assert::IsTrue(hash.bucket_of(hash.points()[s - 1]) <= hash.bucket_of(hash.points()[s]));
+			}
+			Assert::IsTrue(std::all_of(seen.begin(), seen.end(), [](const int p_n) { return p_n == 1; }));
+
+			// Empty rebuild
+			hash.build(nullptr, 0);
+			Assert::AreEqual(size_t{ 0 }, hash.size());
+			std::vector<std::uint32_t> result;
+			hash.query_radius(vector3{ 0.0, 0.0, 0.0 }, 1.0, result);
+			Assert::AreEqual(size_t{ 0 }, result.size());
+		}
+
+		TEST_METHOD(test_query_radius)
+		{
+			const auto points = make_points(4000, 5.0, 2);
+			const auto queries = make_points(200, 6.0, 3);
+			spatial_hash hash{ 0.75 };
+			hash.build(points, 512);
+
+			for (const double radius : { 0.3, 0.75, 2.0 })
+			{
+				for (const auto& q : queries)
+				{
+					std::vector<std::uint32_t> result;
+					hash.query_radius(q, radius, result);
+					std::sort(result.begin(), result.end());
+					Assert::IsTrue(result == brute_force(points, q, radius));
+				}
+			}
+		}
+
+		TEST_METHOD(test_extreme_positions)
+		{
+			// Huge and non-finite positions clamp to the outermost cells
+			const double inf = std::numeric_limits<double>::infinity();
+			const double nan = std::numeric_limits<double>::quiet_NaN();
+			spatial_hash hash{ 0.5 };
+			Assert::AreEqual(hash.cell_coordinate(inf), hash.cell_coordinate(1e300));
+			Assert::AreEqual(hash.cell_coordinate(-inf), hash.cell_coordinate(-1e300));
+			Assert::AreEqual(hash.cell_coordinate(-inf), hash.cell_coordinate(nan));
+			Assert::IsTrue(hash.cell_coordinate(1e300) > 0 && hash.cell_coordinate(-1e300) < 0);
+			Assert::AreEqual(std::int64_t{ -3 }, hash.cell_coordinate(-1.2));
+
+			std::vector<vector3> points = make_points(500, 3.0, 4);
+			points.push_back(vector3{ 1e300, 0.0, 0.0 });
+			points.push_back(vector3{ nan, nan, nan });
+			points.push_back(vector3{ -inf, inf, 0.0 });
+			hash.build(points);
+			Assert::AreEqual(points.size(), hash.size());
+
+			// Finite queries are unaffected and huge queries visit everything once
+			for (std::size_t q = 0; q < 50; ++q)
+			{
+				std::vector<std::uint32_t> result;
+				hash.query_radius(points[q], 0.6, result);
+				std::sort(result.begin(), result.end());
+				Assert::IsTrue(result == brute_force(points, points[q], 0.6));
+			}
+			std::vector<std::uint32_t> all;
+			hash.query_radius(vector3{ 0.0, 0.0, 0.0 }, 1e10, all);
+			Assert::AreEqual(size_t{ 500 }, all.size());
+		}
+
+		TEST_METHOD(test_neighbor_cells)
+		{
+			const auto points = make_points(3000, 4.0, 4);
+			spatial_hash hash{ 1.0 };
+			hash.build(points);
+
+			// The 3x3x3 cell block covers every point within one cell size
+			for (std::size_t i = 0; i < points.size(); i += 37)
+			{
+				std::vector<std::uint32_t> found;
+				hash.for_each_neighbor_cell(points[i], [&](const std::uint32_t p_begin, const std::uint32_t p_end)
+				{
+					for (std::uint32_t s = p_begin; s < p_end; ++s)
+					{
+						if ((hash.points()[s] - points[i]).length2() <= 1.0)
+							found.push_back(hash.indices()[s]);
+					}
+				});
+				std::sort(found.begin(), found.end());
+				Assert::IsTrue(std::adjacent_find(found.begin(), found.end()) == found.end());
+				Assert::IsTrue(found == brute_force(points, points[i], 1.0));
+			}
+		}
+
+		TEST_METHOD(test_find_neighbors)
+		{
+			const auto points = make_points(6000, 8.0, 5);
+			spatial_hash hash{ 0.5 };
+			hash.build(points);
+
+			std::vector<std::size_t> offsets;
+			std::vector<std::uint32_t> neighbors;
+			hash.find_neighbors(points.data(), points.size(), 0.5, offsets, neighbors);
+			Assert::AreEqual(points.size() + 1, offsets.size());
+			Assert::AreEqual(neighbors.size(), offsets.back());
+
+			for (std::size_t q = 0; q < points.size(); q += 11)
+			{
+				std::vector<std::uint32_t> row(neighbors.begin() + static_cast<std::ptrdiff_t>(offsets[q]), neighbors.begin() + static_cast<std::ptrdiff_t>(offsets[q + 1]));
+				std::sort(row.begin(), row.end());
+				Assert::IsTrue(row == brute_force(points, points[q], 0.5));
+			}
+		}
+
+		TEST_METHOD(test_rebuild)
+		{
+			// Rebuilding with moved points gives the same answers as a fresh hash
+			auto points = make_points(2000, 3.0, 6);
+			spatial_hash hash{ 0.4 };
+			hash.build(points);
+			for (auto& p : points)
+				p += vector3{ 0.1, -0.2, 0.05 };
+			hash.build(points);
+
+			spatial_hash fresh{ 0.4 };
+			fresh.build(points);
+			Assert::IsTrue(hash.indices() == fresh.indices());
+			Assert::IsTrue(hash.points() == fresh.points());
+		}
+	};
+}
@@ -0,0 +1,243 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_streaming.hpp"
+
+#include <cmath>
+#include <limits>
+#include <map>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_streaming)
+	{
+		/// Make a wavy height field over [0, p_size] squared
+		static indexed_mesh make_terrain(const std::uint32_t p_size)
+		{
+			indexed_mesh mesh;
+			for (std::uint32_t y = 0; y <= p_size; ++y)
+				for (std::uint32_t x = 0; x <= p_size; ++x)
+					mesh.add_vertex(vector3{ double(x), double(y), 2.0 + std::sin(x * 0.3) * std::cos(y * 0.2) });
+
+			for (std::uint32_t y = 0; y < p_size; ++y)
+			{
+				for (std::uint32_t x = 0; x < p_size; ++x)
+				{
+					const std::uint32_t a = y * (p_size + 1) + x;
+					mesh.add_triangle(a, a + 1, a + p_size + 2);
+					mesh.add_triangle(a, a + p_size + 2, a + p_size + 1);
+				}
+			}
+			return mesh;
+		}
+
+		/// Make a UV sphere whose pole vertices are duplicated per segment
+		static indexed_mesh make_sphere(const double p_radius, const std::uint32_t p_rings, const std::uint32_t p_segments)
+		{
+			const double pi = 3.14159265358979323846;
+			indexed_mesh mesh;
+			for (std::uint32_t r = 0; r <= p_rings; ++r)
+			{
+				const double theta = pi * r / p_rings;
+				for (std::uint32_t s = 0; s < p_segments; ++s)
+				{
+					const double phi = 2.0 * pi * s / p_segments;
+					if (r == 0 || r == p_rings)
+						mesh.add_vertex(vector3{ 0.0, 0.0, r == 0 ? p_radius : -p_radius });
+					else
+						mesh.add_vertex(vector3{ std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) } * p_radius);
+				}
+			}
+
+			for (std::uint32_t r = 0; r < p_rings; ++r)
+			{
+				for (std::uint32_t s = 0; s < p_segments; ++s)
+				{
+					const std::uint32_t a = r * p_segments + s;
+					const std::uint32_t b = r * p_segments + (s + 1) % p_segments;
+					const std::uint32_t c = a + p_segments;
+					const std::uint32_t d = b + p_segments;
+					if (r != 0)
+						mesh.add_triangle(a, c, b);
+					if (r + 1 != p_rings)
+						mesh.add_triangle(b, c, d);
+				}
+			}
+			return mesh;
+		}
+
+		/// Count how many triangles use each undirected edge
+		static std::map<std::pair<std::uint32_t, std::uint32_t>, int> edge_uses(const indexed_mesh& p_mesh)
+		{
+			std::map<std::pair<std::uint32_t, std::uint32_t>, int> uses;
+			for (std::size_t i = 0; i < p_mesh.indices.size(); ++i)
+			{
+				const std::uint32_t a = p_mesh.indices[i];
+				const std::uint32_t b = p_mesh.indices[i - i % 3 + (i + 1) % 3];
+				++uses[std::make_pair(std::min(a, b), std::max(a, b))];
+			}
+			return uses;
+		}
+
+	public:
+		TEST_METHOD(test_stitching)
+		{
+			const indexed_mesh input = make_terrain(40);
+			streaming_options options;
+			options.chunk_size = 7.0;
+			options.max_chunks_in_flight = 3;
+			options.read_batch = 100;
+			options.spill_batch = 16;
+
+			// Chunks arrive in order with contiguous vertex ids
+			indexed_mesh output;
+			std::vector<vector3> normals;
+			std::size_t next_chunk = 0;
+			indexed_triangle_source source{ input };
+			const streaming_result result = process_streaming(source, [&](const streamed_chunk& p_chunk)
+			{
+				Assert::AreEqual(next_chunk++, p_chunk.index);
+				Assert::AreEqual(output.vertex_count(), size_t{ p_chunk.first_vertex });
+				for (const std::uint32_t index : p_chunk.indices)
+					Assert::IsTrue(index < p_chunk.first_vertex + p_chunk.vertices.size());
+				indexed_mesh_sink{ output, &normals }(p_chunk);
+			}, options);
+
+			Assert::IsTrue(result.ok);
+			Assert::AreEqual(size_t{ 36 }, result.chunks);
+			Assert::AreEqual(input.triangle_count(), result.input_triangles);
+			Assert::AreEqual(input.triangle_count(), result.output_triangles);
+			Assert::IsTrue(result.max_chunk_triangles <= 2 * 7 * 7 + 14);
+
+			// Shared vertices are written once so the seams close up
+			Assert::AreEqual(input.vertex_count(), output.vertex_count());
+			Assert::AreEqual(result.output_vertices, output.vertex_count());
+			std::size_t open = 0;
+			for (const auto& use : edge_uses(output))
+				open += use.second == 1 ? 1 : 0;
+			Assert::AreEqual(size_t{ 160 }, open);
+
+			// Normals match processing the whole mesh as one chunk
+			options.chunk_size = 1000.0;
+			indexed_mesh whole;
+			std::vector<vector3> whole_normals;
+			indexed_triangle_source whole_source{ input };
+			Assert::IsTrue(process_streaming(whole_source, indexed_mesh_sink{ whole, &whole_normals }, options).ok);
+			std::map<vector3, vector3> reference;
+			for (std::size_t i = 0; i < whole.vertex_count(); ++i)
+				reference[whole.vertices[i]] = whole_normals[i];
+			for (std::size_t i = 0; i < output.vertex_count(); ++i)
+			{
+				const vector3 expected = reference.at(output.vertices[i]);
+				Assert::IsTrue((normals[i] - expected).length() < 1e-12);
+				Assert::AreEqual(1.0, normals[i].length(), 1e-12);
+			}
+		}
+
+		TEST_METHOD(test_weld)
+		{
+			// Welding merges the duplicated pole vertices into a closed sphere
+			const indexed_mesh input = make_sphere(10.0, 16, 32);
+			streaming_options options;
+			options.chunk_size = 4.0;
+
+			indexed_mesh output;
+			std::vector<vector3> normals;
+			indexed_triangle_source source{ input };
+			const streaming_result result = process_streaming(source, indexed_mesh_sink{ output, &normals }, options);
+			Assert::IsTrue(result.ok);
+			Assert::IsTrue(result.chunks > 20);
+			Assert::AreEqual(size_t{ 2 + 15 * 32 }, output.vertex_count());
+			for (const auto& use : edge_uses(output))
+				Assert::AreEqual(2, use.second);
+			for (std::size_t i = 0; i < output.vertex_count(); ++i)
+				Assert::IsTrue(normals[i].dot(output.vertices[i].normalized()) > 0.95);
+		}
+
+		TEST_METHOD(test_simplify)
+		{
+			const indexed_mesh input = make_sphere(10.0, 64, 128);
+			streaming_options options;
+			options.chunk_size = 5.0;
+			options.cluster_size = 1.5;
+
+			indexed_mesh output;
+			indexed_triangle_source source{ input };
+			const streaming_result result = process_streaming(source, indexed_mesh_sink{ output }, options);
+			Assert::IsTrue(result.ok);
+			Assert::IsTrue(result.output_triangles * 3 < result.input_triangles);
+
+			// Collapsing a closed surface keeps every edge used an even number of times,
+			// so a crack between chunks would show up as an odd count
+			for (const auto& use : edge_uses(output))
+				Assert::AreEqual(0, use.second % 2);
+			for (const auto& v : output.vertices)
+				Assert::AreEqual(10.0, v.length(), 0.5);
+		}
+
+		TEST_METHOD(test_cache_source)
+		{
+			// Memory-mapped caches stream like in-memory meshes
+			const indexed_mesh input = make_terrain(12);
+			const std::vector<std::uint8_t> bytes = mesh_cache_writer{ input }.serialize();
+			mesh_cache cache;
+			Assert::IsTrue(cache.open(bytes.data(), bytes.size()) == mesh_cache_status::ok);
+
+			streaming_options options;
+			options.chunk_size = 5.0;
+			options.compute_normals = false;
+			indexed_mesh from_cache, from_mesh;
+			indexed_triangle_source cache_source{ cache };
+			indexed_triangle_source mesh_source{ input };
+			Assert::IsTrue(process_streaming(cache_source, indexed_mesh_sink{ from_cache }, options).ok);
+			Assert::IsTrue(process_streaming(mesh_source, indexed_mesh_sink{ from_mesh }, options).ok);
+			Assert::IsTrue(from_cache.vertices == from_mesh.vertices);
+			Assert::IsTrue(from_cache.indices == from_mesh.indices);
+		}
+
+		TEST_METHOD(test_empty)
+		{
+			indexed_mesh output;
+			const indexed_mesh input;
+			indexed_triangle_source source{ input };
+			const streaming_result result = process_streaming(source, indexed_mesh_sink{ output });
+			Assert::IsTrue(result.ok);
+			Assert::AreEqual(size_t{ 0 }, result.chunks);
+			Assert::AreEqual(size_t{ 0 }, output.vertex_count());
+		}
+
+		TEST_METHOD(test_invalid_input)
+		{
+			const indexed_mesh terrain = make_terrain(8);
+
+			// Chunk sizes that are not positive and finite fail
+			for (const double chunk_size : { 0.0, -1.0, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity() })
+			{
+				indexed_mesh output;
+				indexed_triangle_source source{ terrain };
+				streaming_options options;
+				options.chunk_size = chunk_size;
+				Assert::IsFalse(process_streaming(source, indexed_mesh_sink{ output }, options).ok);
+			}
+
+			// Non-finite triangles are dropped and huge ones land in clamped chunks
+			indexed_mesh input = terrain;
+			const std::uint32_t first = static_cast<std::uint32_t>(input.vertex_count());
+			input.add_vertex(vector3{ std::numeric_limits<double>::quiet_NaN(), 0.0, 0.0 });
+			input.add_vertex(vector3{ 1e300, 1e300, -1e300 });
+			input.add_vertex(vector3{ 1e300, 2e300, -1e300 });
+			input.add_vertex(vector3{ 2e300, 1e300, -1e300 });
+			input.indices.insert(input.indices.end(), { 0, 1, first, first + 1, first + 2, first + 3 });
+
+			indexed_mesh output;
+			indexed_triangle_source source{ input };
+			streaming_options options;
+			options.chunk_size = 1e-300;
+			const streaming_result result = process_streaming(source, indexed_mesh_sink{ output }, options);
+			Assert::IsTrue(result.ok);
+			Assert::AreEqual(input.triangle_count(), result.input_triangles);
+			Assert::AreEqual(terrain.triangle_count() + 1, output.triangle_count());
+		}
+	};
+}
@@ -0,0 +1,213 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_sweep_prune.hpp"
+
+#include <random>
+#include <set>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_sweep_prune)
+	{
+		/// Make a box from a center and half size
+		static aabb3 make_box(const vector3& p_center, const double p_half)
+		{
+			return aabb3{ p_center - vector3{ p_half, p_half, p_half }, p_center + vector3{ p_half, p_half, p_half } };
+		}
+
+	public:
+		TEST_METHOD(test_insert)
+		{
+			sweep_and_prune sap;
+			const auto a = sap.insert(make_box(vector3{ 0.0, 0.0, 0.0 }, 1.0));
+			const auto b = sap.insert(make_box(vector3{ 1.5, 0.0, 0.0 }, 1.0));
+			const auto c = sap.insert(make_box(vector3{ 5.0, 0.0, 0.0 }, 1.0));
+			Assert::AreEqual(size_t{ 3 }, sap.size());
+			Assert::AreEqual(size_t{ 1 }, sap.pair_count());
+			Assert::IsTrue(sap.contains_pair(a, b));
+			Assert::IsFalse(sap.contains_pair(a, c));
+
+			std::vector<broad_phase_pair> added, removed;
+			sap.update(added, removed);
+			Assert::AreEqual(size_t{ 1 }, added.size());
+			Assert::IsTrue(added[0] == broad_phase_pair{ a, b });
+			Assert::AreEqual(size_t{ 0 }, removed.size());
+		}
+
+		TEST_METHOD(test_update)
+		{
+			sweep_and_prune sap;
+			const auto a = sap.insert(make_box(vector3{ 0.0, 0.0, 0.0 }, 1.0));
+			const auto b = sap.insert(make_box(vector3{ 5.0, 0.0, 0.0 }, 1.0));
+			std::vector<broad_phase_pair> added, removed;
+			sap.update(added, removed);
+			Assert::AreEqual(size_t{ 0 }, added.size());
+
+			// Moving into contact adds the pair
+			sap.set_bounds(b, make_box(vector3{ 2.0, 0.0, 0.0 }, 1.0));
+			sap.update(added, removed);
+			Assert::AreEqual(size_t{ 1 }, added.size());
+			Assert::IsTrue(sap.contains_pair(a, b));
+
+			// Moving apart on another axis removes it
+			added.clear();
+			sap.set_bounds(b, make_box(vector3{ 2.0, 3.0, 0.0 }, 1.0));
+			sap.update(added, removed);
+			Assert::AreEqual(size_t{ 0 }, added.size());
+			Assert::AreEqual(size_t{ 1 }, removed.size());
+			Assert::IsFalse(sap.contains_pair(a, b));
+		}
+
+		TEST_METHOD(test_remove)
+		{
+			sweep_and_prune sap;
+			const aabb3 boxes[] = {
+				make_box(vector3{ 0.0, 0.0, 0.0 }, 1.0),
+				make_box(vector3{ 1.0, 0.0, 0.0 }, 1.0),
+				make_box(vector3{ 2.0, 0.0, 0.0 }, 1.0)
+			};
+			sweep_and_prune::handle h[3] = {};
+			sap.insert(boxes, 3, h);
+			Assert::AreEqual(size_t{ 3 }, sap.pair_count());
+
+			std::vector<broad_phase_pair> added, removed;
+			sap.update(added, removed);
+			Assert::AreEqual(size_t{ 3 }, added.size());
+
+			sap.remove(h[1]);
+			Assert::AreEqual(size_t{ 2 }, sap.size());
+			Assert::AreEqual(size_t{ 1 }, sap.pair_count());
+
+			added.clear();
+			sap.update(added, removed);
+			Assert::AreEqual(size_t{ 0 }, added.size());
+			Assert::AreEqual(size_t{ 2 }, removed.size());
+
+			// Removed handles are reused
+			Assert::AreEqual(h[1], sap.insert(make_box(vector3{ 10.0, 0.0, 0.0 }, 1.0)));
+		}
+
+		TEST_METHOD(test_remove_dead)
+		{
+			sweep_and_prune sap;
+			const aabb3 boxes[] = {
+				make_box(vector3{ 0.0, 0.0, 0.0 }, 1.0),
+				make_box(vector3{ 1.0, 0.0, 0.0 }, 1.0),
+				make_box(vector3{ 2.0, 0.0, 0.0 }, 1.0)
+			};
+			sweep_and_prune::handle h[3] = {};
+			sap.insert(boxes, 3, h);
+
+			// Removing a handle twice, or updating its bounds, is ignored
+			const sweep_and_prune::handle twice[] = { h[0], h[0] };
+			sap.remove(twice, 2);
+			sap.remove(h[0]);
+			sap.set_bounds(h[0], make_box(vector3{ 2.0, 0.0, 0.0 }, 1.0));
+			Assert::AreEqual(size_t{ 2 }, sap.size());
+			Assert::AreEqual(size_t{ 1 }, sap.pair_count());
+
+			std::vector<broad_phase_pair> added, removed;
+			sap.update(added, removed);
+			Assert::AreEqual(size_t{ 1 }, added.size());
+			Assert::IsTrue(removed.empty());
+
+			// The handle enters the free list once
+			const auto a = sap.insert(make_box(vector3{ 20.0, 0.0, 0.0 }, 1.0));
+			const auto b = sap.insert(make_box(vector3{ 30.0, 0.0, 0.0 }, 1.0));
+			Assert::AreEqual(h[0], a);
+			Assert::AreNotEqual(a, b);
+			Assert::AreEqual(size_t{ 4 }, sap.size());
+		}
+
+		TEST_METHOD(test_insert_into_large_world)
+		{
+			std::mt19937 rng(11);
+			std::uniform_real_distribution<double> position(-100.0, 100.0);
+			std::vector<aabb3> world(50000);
+			for (auto& box : world)
+				box = make_box(vector3{ position(rng), position(rng), position(rng) }, 0.5);
+			// One large object widens the search around every new box
+			world[0] = make_box(vector3{ 0.0, 0.0, 0.0 }, 60.0);
+
+			sweep_and_prune sap;
+			sap.insert(world.data(), world.size());
+			std::vector<broad_phase_pair> added, removed;
+			sap.update(added, removed);
+			const std::size_t pairs = sap.pair_count();
+
+			// Small batches find exactly their overlaps with the world and each other
+			std::uniform_real_distribution<double> half(0.2, 3.0);
+			std::vector<aabb3> batch(100);
+			std::vector<sweep_and_prune::handle> handles(batch.size());
+			for (int n = 0; n < 10; ++n)
+			{
+				for (auto& box : batch)
+					box = make_box(vector3{ position(rng), position(rng), position(rng) }, half(rng));
+				sap.insert(batch.data(), batch.size(), handles.data());
+
+				std::size_t expected = 0;
+				for (std::size_t i = 0; i < batch.size(); ++i)
+				{
+					for (const aabb3& box : world)
+						expected += batch[i].intersects(box) ? 1 : 0;
+					for (std::size_t j = i + 1; j < batch.size(); ++j)
+						expected += batch[i].intersects(batch[j]) ? 1 : 0;
+				}
+				Assert::AreEqual(pairs + expected, sap.pair_count());
+				sap.remove(handles.data(), handles.size());
+			}
+
+			sap.update(added, removed);
+			Assert::AreEqual(pairs, sap.pair_count());
+			Assert::AreEqual(world.size(), sap.size());
+		}
+
+		TEST_METHOD(test_random_motion)
+		{
+			std::mt19937 rng(7);
+			std::uniform_real_distribution<double> position(-10.0, 10.0);
+			std::uniform_real_distribution<double> step(-0.3, 0.3);
+
+			std::vector<vector3> centers(200);
+			std::vector<aabb3> boxes(centers.size());
+			for (std::size_t i = 0; i < centers.size(); ++i)
+			{
+				centers[i] = vector3{ position(rng), position(rng), position(rng) };
+				boxes[i] = make_box(centers[i], 1.0);
+			}
+
+			sweep_and_prune sap;
+			std::vector<sweep_and_prune::handle> handles(centers.size());
+			sap.insert(boxes.data(), boxes.size(), handles.data());
+
+			std::set<broad_phase_pair> tracked;
+			for (int frame = 0; frame < 20; ++frame)
+			{
+				std::vector<broad_phase_pair> added, removed;
+				sap.update(added, removed);
+				for (const auto& p : removed)
+					Assert::AreEqual(size_t{ 1 }, tracked.erase(p));
+				for (const auto& p : added)
+					Assert::IsTrue(tracked.insert(p).second);
+
+				// Compare the tracked pairs against brute force
+				std::set<broad_phase_pair> expected;
+				for (std::size_t i = 0; i < boxes.size(); ++i)
+					for (std::size_t j = i + 1; j < boxes.size(); ++j)
+						if (boxes[i].intersects(boxes[j]))
+							expected.insert(broad_phase_pair{ handles[i], handles[j] });
+				Assert::IsTrue(expected == tracked);
+
+				// Move every object a little
+				for (std::size_t i = 0; i < centers.size(); ++i)
+				{
+					centers[i] += vector3{ step(rng), step(rng), step(rng) };
+					boxes[i] = make_box(centers[i], 1.0);
+					sap.set_bounds(handles[i], boxes[i]);
+				}
+			}
+		}
+	};
+}
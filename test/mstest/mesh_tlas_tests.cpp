@@ -0,0 +1,133 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_primitives.hpp"
+#include "mesh/mesh_tlas.hpp"
+
+#include <cmath>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_tlas)
+	{
+		/// Copy a mesh with a transform applied to every vertex
+		static void append_transformed(indexed_mesh& p_scene, const indexed_mesh& p_part, const transform3& p_transform)
+		{
+			const std::uint32_t base = static_cast<std::uint32_t>(p_scene.vertex_count());
+			for (const auto& v : p_part.vertices)
+				p_scene.add_vertex(p_transform.transform_point(v));
+			for (std::size_t t = 0; t < p_part.triangle_count(); ++t)
+				p_scene.add_triangle(base + p_part.indices[t * 3], base + p_part.indices[t * 3 + 1], base + p_part.indices[t * 3 + 2]);
+		}
+
+		/// Random transform with rotation, non-uniform scale (possibly mirrored) and translation
+		static transform3 random_transform(std::mt19937& p_rng)
+		{
+			std::uniform_real_distribution<double> unit(-1.0, 1.0);
+			std::uniform_real_distribution<double> scale(0.5, 2.0);
+			const vector3 axis{ unit(p_rng), unit(p_rng), unit(p_rng) + 2.0 };
+			const vector3 scales{ scale(p_rng), scale(p_rng), scale(p_rng) * (unit(p_rng) < 0.0 ? -1.0 : 1.0) };
+			return transform3::translation(vector3{ unit(p_rng) * 20.0, unit(p_rng) * 20.0, unit(p_rng) * 20.0 }) *
+				transform3::rotation(axis, unit(p_rng) * 3.0) * transform3::scaling(scales);
+		}
+
+		/// Check every ray against a flattened scene
+		static void check_rays(const mesh::mesh_tlas& p_tlas, const indexed_mesh& p_scene, const std::vector<std::size_t>& p_first_triangle, const unsigned p_seed)
+		{
+			const mesh_bvh flat(p_scene);
+			std::mt19937 rng(p_seed);
+			std::uniform_real_distribution<double> dist(-25.0, 25.0);
+			std::vector<vector3> origins(500);
+			std::vector<vector3> directions(500);
+			for (std::size_t i = 0; i < origins.size(); ++i)
+			{
+				origins[i] = vector3{ dist(rng), dist(rng), dist(rng) };
+				directions[i] = vector3{ dist(rng), dist(rng), dist(rng) } - origins[i];
+			}
+			std::vector<tlas_ray_hit> hits(origins.size());
+			p_tlas.intersect_rays(origins.data(), directions.data(), origins.size(), hits.data());
+
+			std::size_t hit_count = 0;
+			for (std::size_t i = 0; i < origins.size(); ++i)
+			{
+				const bvh_ray_hit expected = flat.intersect_ray(origins[i], directions[i]);
+				Assert::AreEqual(expected.hit, hits[i].hit);
+				if (!expected.hit)
+					continue;
+				++hit_count;
+				Assert::AreEqual(expected.distance, hits[i].distance, 1e-9);
+				Assert::AreEqual(expected.triangle, static_cast<std::uint32_t>(p_first_triangle[hits[i].instance] + hits[i].triangle));
+			}
+			Assert::IsTrue(hit_count > 20);
+		}
+
+	public:
+		TEST_METHOD(test_intersect_ray)
+		{
+			// Two shared parts placed many times
+			const indexed_mesh sphere = make_icosphere<2>(1.0).to_mesh();
+			const indexed_mesh box = make_box(vector3{ 1.0, 0.5, 0.25 }).to_mesh();
+			const mesh_bvh parts[2] = { mesh_bvh(sphere), mesh_bvh(box) };
+
+			mesh::mesh_tlas tlas;
+			indexed_mesh scene;
+			std::vector<std::size_t> first_triangle;
+			std::mt19937 rng(3);
+			for (int i = 0; i < 200; ++i)
+			{
+				const transform3 t = random_transform(rng);
+				Assert::AreEqual(static_cast<std::uint32_t>(i), tlas.add_instance(parts[i % 2], t));
+				first_triangle.push_back(scene.triangle_count());
+				append_transformed(scene, i % 2 ? box : sphere, t);
+			}
+			tlas.build();
+			Assert::AreEqual(size_t{ 200 }, tlas.instance_order().size());
+			check_rays(tlas, scene, first_triangle, 4);
+
+			// Moving instances only rebuilds the top level
+			scene.clear();
+			for (std::uint32_t i = 0; i < 200; ++i)
+			{
+				const transform3 t = random_transform(rng);
+				tlas.set_transform(i, t);
+				append_transformed(scene, i % 2 ? box : sphere, t);
+			}
+			tlas.build();
+			check_rays(tlas, scene, first_triangle, 5);
+
+			// Limited range
+			const tlas_ray_hit hit = tlas.intersect_ray(tlas.instances()[0].transform.origin + vector3{ 0.0, 0.0, 50.0 }, vector3{ 0.0, 0.0, -1.0 });
+			Assert::IsTrue(hit.hit);
+			Assert::IsFalse(tlas.intersect_ray(tlas.instances()[0].transform.origin + vector3{ 0.0, 0.0, 50.0 }, vector3{ 0.0, 0.0, -1.0 }, hit.distance * 0.99).hit);
+		}
+
+		TEST_METHOD(test_instance_bounds)
+		{
+			const indexed_mesh sphere = make_icosphere<1>(1.0).to_mesh();
+			const mesh_bvh part(sphere);
+			mesh::mesh_tlas tlas;
+			const transform3 t = transform3::translation(vector3{ 3.0, 0.0, 0.0 }) * transform3::rotation(vector3{ 1.0, 1.0, 1.0 }, 0.8) * transform3::scaling(vector3{ 2.0, 1.0, 1.0 });
+			tlas.add_instance(part, t);
+
+			// Contains the transformed vertices
+			const aabb3& bounds = tlas.instances()[0].bounds;
+			for (const auto& v : sphere.vertices)
+				Assert::IsTrue(bounds.grown(1e-12).contains(t.transform_point(v)));
+
+			// Singular transforms and empty parts are never hit
+			const mesh_bvh empty;
+			tlas.add_instance(part, transform3::scaling(vector3{ 1.0, 1.0, 0.0 }));
+			tlas.add_instance(empty, transform3());
+			tlas.build();
+			Assert::AreEqual(size_t{ 1 }, tlas.instance_order().size());
+			Assert::IsFalse(tlas.intersect_ray(vector3{ 0.0, 0.0, 5.0 }, vector3{ 0.0, 0.0, -1.0 }).hit);
+			Assert::IsTrue(tlas.intersect_ray(vector3{ 3.0, 0.0, 5.0 }, vector3{ 0.0, 0.0, -1.0 }).hit);
+
+			tlas.clear();
+			tlas.build();
+			Assert::IsFalse(tlas.intersect_ray(vector3{ 3.0, 0.0, 5.0 }, vector3{ 0.0, 0.0, -1.0 }).hit);
+		}
+	};
+}
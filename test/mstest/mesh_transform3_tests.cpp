@@ -0,0 +1,107 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_transform3.hpp"
+
+#include <cmath>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_transform3)
+	{
+		/// Check if two vectors agree to rounding error
+		static bool near(const vector3& p_a, const vector3& p_b)
+		{
+			return (p_a - p_b).length() < 1e-12;
+		}
+
+	public:
+		TEST_METHOD(test_construct)
+		{
+			constexpr transform3 identity;
+			static_assert(identity.transform_point(vector3{ 1.0, 2.0, 3.0 }) == vector3(1.0, 2.0, 3.0), "identity");
+			static_assert(identity.determinant() == 1.0, "identity determinant");
+
+			constexpr transform3 moved = transform3::translation(vector3{ 1.0, 0.0, -1.0 });
+			static_assert(moved.transform_point(vector3{ 1.0, 1.0, 1.0 }) == vector3(2.0, 1.0, 0.0), "translation");
+			static_assert(moved.transform_direction(vector3{ 1.0, 1.0, 1.0 }) == vector3(1.0, 1.0, 1.0), "translation direction");
+
+			constexpr transform3 scaled = transform3::scaling(vector3{ 2.0, 3.0, 4.0 });
+			static_assert(scaled.transform_point(vector3{ 1.0, 1.0, 1.0 }) == vector3(2.0, 3.0, 4.0), "scaling");
+			static_assert(scaled.determinant() == 24.0, "scaling determinant");
+		}
+
+		TEST_METHOD(test_rotation)
+		{
+			const double pi = 3.14159265358979323846;
+			const transform3 r = transform3::rotation(vector3{ 0.0, 0.0, 2.0 }, pi * 0.5);
+			Assert::IsTrue(near(r.transform_point(vector3{ 1.0, 0.0, 0.0 }), vector3{ 0.0, 1.0, 0.0 }));
+			Assert::IsTrue(near(r.transform_point(vector3{ 0.0, 1.0, 0.0 }), vector3{ -1.0, 0.0, 0.0 }));
+			Assert::AreEqual(1.0, r.determinant(), 1e-15);
+
+			// Rotations about an arbitrary axis keep lengths and the axis
+			const vector3 axis{ 1.0, 2.0, 3.0 };
+			const transform3 q = transform3::rotation(axis, 0.7);
+			Assert::IsTrue(near(q.transform_direction(axis), axis));
+			Assert::AreEqual(vector3(3.0, -1.0, 2.0).length(), q.transform_direction(vector3{ 3.0, -1.0, 2.0 }).length(), 1e-14);
+		}
+
+		TEST_METHOD(test_inverse)
+		{
+			const transform3 t = transform3::translation(vector3{ 1.0, -2.0, 3.0 }) * transform3::rotation(vector3{ 1.0, 1.0, 0.0 }, 0.3) * transform3::scaling(vector3{ 2.0, 0.5, -1.0 });
+			const transform3 inv = t.inverse();
+			const vector3 p{ 0.3, -0.7, 1.9 };
+			Assert::IsTrue(near(inv.transform_point(t.transform_point(p)), p));
+			Assert::IsTrue(near(t.transform_point(inv.transform_point(p)), p));
+			const transform3 identity = t * inv;
+			Assert::IsTrue(near(identity.x_axis, vector3(1.0, 0.0, 0.0)) && near(identity.y_axis, vector3(0.0, 1.0, 0.0)));
+			Assert::IsTrue(near(identity.z_axis, vector3(0.0, 0.0, 1.0)) && near(identity.origin, vector3(0.0, 0.0, 0.0)));
+			Assert::AreEqual(-1.0, t.determinant(), 1e-14);
+
+			// Composition applies the right-hand transform first
+			const transform3 a = transform3::translation(vector3{ 1.0, 0.0, 0.0 });
+			const transform3 b = transform3::scaling(vector3{ 2.0, 2.0, 2.0 });
+			Assert::IsTrue((a * b).transform_point(vector3{ 1.0, 1.0, 1.0 }) == vector3(3.0, 2.0, 2.0));
+			Assert::IsTrue((b * a).transform_point(vector3{ 1.0, 1.0, 1.0 }) == vector3(4.0, 2.0, 2.0));
+			Assert::IsTrue(a != b);
+		}
+
+		TEST_METHOD(test_transform_normal)
+		{
+			// Normals stay perpendicular to transformed tangents, also when mirrored
+			const transform3 t = transform3::rotation(vector3{ 0.0, 1.0, 1.0 }, 0.4) * transform3::scaling(vector3{ 3.0, 1.0, -0.5 });
+			const vector3 tangent1{ 1.0, 1.0, 0.0 };
+			const vector3 tangent2{ 0.0, 1.0, 2.0 };
+			const vector3 normal = tangent1.cross(tangent2);
+			const vector3 transformed = t.transform_normal(normal);
+			Assert::AreEqual(0.0, transformed.dot(t.transform_direction(tangent1)), 1e-12);
+			Assert::AreEqual(0.0, transformed.dot(t.transform_direction(tangent2)), 1e-12);
+
+			// Mirroring flips the winding but not the side the normal points to
+			const vector3 winding = t.transform_direction(tangent1).cross(t.transform_direction(tangent2));
+			Assert::IsTrue(t.determinant() < 0.0);
+			Assert::IsTrue(transformed.dot(winding) < 0.0);
+		}
+
+		TEST_METHOD(test_transform_box)
+		{
+			const aabb3 box{ vector3{ -1.0, -2.0, -3.0 }, vector3{ 1.0, 2.0, 3.0 } };
+			const transform3 t = transform3::translation(vector3{ 5.0, 0.0, 0.0 }) * transform3::rotation(vector3{ 1.0, 2.0, 0.5 }, 1.1);
+			const aabb3 bounds = t.transform_box(box);
+
+			// Every transformed corner is inside, and each face touches a corner
+			int touching = 0;
+			for (int c = 0; c < 8; ++c)
+			{
+				const vector3 corner{ c & 1 ? 1.0 : -1.0, c & 2 ? 2.0 : -2.0, c & 4 ? 3.0 : -3.0 };
+				const vector3 p = t.transform_point(corner);
+				Assert::IsTrue(bounds.grown(1e-12).contains(p));
+				touching += std::abs(p.x - bounds.minimum.x) < 1e-12 ? 1 : 0;
+				touching += std::abs(p.x - bounds.maximum.x) < 1e-12 ? 1 : 0;
+			}
+			Assert::AreEqual(2, touching);
+			Assert::IsTrue(t.transform_box(aabb3::empty()).is_empty());
+		}
+	};
+}
@@ -0,0 +1,187 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_triangle3.hpp"
+
+#include <limits>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_triangle3)
+	{
+	public:
+		TEST_METHOD(test_construct)
+		{
+			constexpr triangle3 t1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 0.0, 0.0 }, vector3{ 0.0, 1.0, 0.0 } };
+			Assert::IsTrue(t1.point1.is_equal_approx(vector3{ 0.0, 0.0, 0.0 }));
+			Assert::IsTrue(t1.point2.is_equal_approx(vector3{ 1.0, 0.0, 0.0 }));
+			Assert::IsTrue(t1.point3.is_equal_approx(vector3{ 0.0, 1.0, 0.0 }));
+		}
+
+		TEST_METHOD(test_normal)
+		{
+			constexpr triangle3 t1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 2.0, 0.0, 0.0 }, vector3{ 0.0, 2.0, 0.0 } };
+			Assert::IsTrue(t1.normal().is_equal_approx(vector3{ 0.0, 0.0, 4.0 }));
+			Assert::IsTrue(t1.plane().is_equal_approx(plane3{ vector3{ 0.0, 0.0, 1.0 }, 0.0 }));
+			Assert::IsFalse(t1.is_degenerate());
+
+			constexpr triangle3 t2{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 0.0, 0.0 }, vector3{ 2.0, 0.0, 0.0 } };
+			Assert::IsTrue(t2.is_degenerate());
+		}
+
+		TEST_METHOD(test_closest_point)
+		{
+			constexpr triangle3 t1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 4.0, 0.0, 0.0 }, vector3{ 0.0, 4.0, 0.0 } };
+
+			// Face, edge and vertex regions
+			Assert::IsTrue(t1.closest_point(vector3{ 1.0, 1.0, 3.0 }).is_equal_approx(vector3{ 1.0, 1.0, 0.0 }));
+			Assert::IsTrue(t1.closest_point(vector3{ 2.0, -1.0, 0.0 }).is_equal_approx(vector3{ 2.0, 0.0, 0.0 }));
+			Assert::IsTrue(t1.closest_point(vector3{ 3.0, 3.0, 0.0 }).is_equal_approx(vector3{ 2.0, 2.0, 0.0 }));
+			Assert::IsTrue(t1.closest_point(vector3{ -1.0, -1.0, 1.0 }).is_equal_approx(vector3{ 0.0, 0.0, 0.0 }));
+			Assert::IsTrue(t1.closest_point(vector3{ 5.0, -1.0, 0.0 }).is_equal_approx(vector3{ 4.0, 0.0, 0.0 }));
+			Assert::AreEqual(9.0, t1.distance2_to(vector3{ 1.0, 1.0, 3.0 }));
+		}
+
+		TEST_METHOD(test_solid_angle)
+		{
+			// One face of an octahedron subtends an eighth of the sphere at the center
+			constexpr triangle3 t1{ vector3{ 1.0, 0.0, 0.0 }, vector3{ 0.0, 1.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 } };
+			const double pi = 3.14159265358979323846;
+			Assert::AreEqual(pi / 2.0, t1.solid_angle(vector3{ 0.0, 0.0, 0.0 }), 1e-12);
+
+			constexpr triangle3 t2{ vector3{ 1.0, 0.0, 0.0 }, vector3{ 0.0, 0.0, 1.0 }, vector3{ 0.0, 1.0, 0.0 } };
+			Assert::AreEqual(-pi / 2.0, t2.solid_angle(vector3{ 0.0, 0.0, 0.0 }), 1e-12);
+		}
+
+		TEST_METHOD(test_intersect_ray)
+		{
+			constexpr triangle3 t1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 4.0, 0.0, 0.0 }, vector3{ 0.0, 4.0, 0.0 } };
+
+			vector3 i1;
+			double d1 = 0.0;
+			Assert::IsTrue(t1.intersect_ray(vector3{ 1.0, 1.0, -2.0 }, vector3{ 0.0, 0.0, 1.0 }, &i1, &d1));
+			Assert::IsTrue(i1.is_equal_approx(vector3{ 1.0, 1.0, 0.0 }));
+			Assert::AreEqual(2.0, d1);
+
+			Assert::IsFalse(t1.intersect_ray(vector3{ 1.0, 1.0, -2.0 }, vector3{ 0.0, 0.0, -1.0 }));
+			Assert::IsFalse(t1.intersect_ray(vector3{ 3.0, 3.0, -2.0 }, vector3{ 0.0, 0.0, 1.0 }));
+			Assert::IsFalse(t1.intersect_ray(vector3{ 1.0, 1.0, -2.0 }, vector3{ 1.0, 0.0, 0.0 }));
+		}
+
+		TEST_METHOD(test_intersect_segment)
+		{
+			constexpr triangle3 t1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 4.0, 0.0, 0.0 }, vector3{ 0.0, 4.0, 0.0 } };
+
+			vector3 i1;
+			Assert::IsTrue(t1.intersect_segment(vector3{ 1.0, 1.0, -1.0 }, vector3{ 1.0, 1.0, 1.0 }, &i1));
+			Assert::IsTrue(i1.is_equal_approx(vector3{ 1.0, 1.0, 0.0 }));
+
+			// Crosses the plane outside the triangle
+			Assert::IsFalse(t1.intersect_segment(vector3{ 3.0, 3.0, -1.0 }, vector3{ 3.0, 3.0, 1.0 }));
+
+			// Does not reach the plane
+			Assert::IsFalse(t1.intersect_segment(vector3{ 1.0, 1.0, 1.0 }, vector3{ 1.0, 1.0, 2.0 }));
+
+			// Touches the plane at an end point inside the triangle
+			Assert::IsTrue(t1.intersect_segment(vector3{ 1.0, 1.0, 0.0 }, vector3{ 1.0, 1.0, 2.0 }));
+
+			// Coplanar segments
+			Assert::IsTrue(t1.intersect_segment(vector3{ -1.0, 1.0, 0.0 }, vector3{ 5.0, 1.0, 0.0 }));
+			Assert::IsFalse(t1.intersect_segment(vector3{ -1.0, 5.0, 0.0 }, vector3{ 5.0, 5.0, 0.0 }));
+		}
+
+		TEST_METHOD(test_intersect_triangle)
+		{
+			constexpr triangle3 t1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 4.0, 0.0, 0.0 }, vector3{ 0.0, 4.0, 0.0 } };
+
+			// Piercing triangle
+			constexpr triangle3 t2{ vector3{ 1.0, 1.0, -1.0 }, vector3{ 1.0, 1.0, 1.0 }, vector3{ 2.0, 0.5, 0.0 } };
+			Assert::IsTrue(t1.intersect_triangle(t2));
+			Assert::IsTrue(t2.intersect_triangle(t1));
+
+			// Separated triangle
+			constexpr triangle3 t3{ vector3{ 0.0, 0.0, 1.0 }, vector3{ 4.0, 0.0, 1.0 }, vector3{ 0.0, 4.0, 1.0 } };
+			Assert::IsFalse(t1.intersect_triangle(t3));
+
+			// Crosses the plane but misses the triangle
+			constexpr triangle3 t4{ vector3{ 5.0, 5.0, -1.0 }, vector3{ 5.0, 5.0, 1.0 }, vector3{ 6.0, 5.0, 0.0 } };
+			Assert::IsFalse(t1.intersect_triangle(t4));
+
+			// Coplanar overlapping and disjoint triangles
+			constexpr triangle3 t5{ vector3{ 1.0, 1.0, 0.0 }, vector3{ 5.0, 1.0, 0.0 }, vector3{ 1.0, 5.0, 0.0 } };
+			Assert::IsTrue(t1.intersect_triangle(t5));
+			constexpr triangle3 t6{ vector3{ 5.0, 5.0, 0.0 }, vector3{ 6.0, 5.0, 0.0 }, vector3{ 5.0, 6.0, 0.0 } };
+			Assert::IsFalse(t1.intersect_triangle(t6));
+
+			// Coplanar triangle fully contained
+			constexpr triangle3 t7{ vector3{ 0.5, 0.5, 0.0 }, vector3{ 1.0, 0.5, 0.0 }, vector3{ 0.5, 1.0, 0.0 } };
+			Assert::IsTrue(t1.intersect_triangle(t7));
+		}
+
+		TEST_METHOD(test_intersect_triangles)
+		{
+			constexpr triangle3 t1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 4.0, 0.0, 0.0 }, vector3{ 0.0, 4.0, 0.0 } };
+			const triangle3 list[] = {
+				triangle3{ vector3{ 1.0, 1.0, -1.0 }, vector3{ 1.0, 1.0, 1.0 }, vector3{ 2.0, 0.5, 0.0 } },
+				triangle3{ vector3{ 0.0, 0.0, 1.0 }, vector3{ 4.0, 0.0, 1.0 }, vector3{ 0.0, 4.0, 1.0 } },
+				triangle3{ vector3{ 5.0, 5.0, -1.0 }, vector3{ 5.0, 5.0, 1.0 }, vector3{ 6.0, 5.0, 0.0 } },
+				triangle3{ vector3{ 1.0, 1.0, 0.0 }, vector3{ 5.0, 1.0, 0.0 }, vector3{ 1.0, 5.0, 0.0 } }
+			};
+
+			bool results[4] = {};
+			Assert::AreEqual(size_t{ 2 }, intersect_triangles(t1, list, 4, results));
+			Assert::IsTrue(results[0]);
+			Assert::IsFalse(results[1]);
+			Assert::IsFalse(results[2]);
+			Assert::IsTrue(results[3]);
+
+			// Batched results must match the single pair test
+			for (int i = 0; i < 4; ++i)
+				Assert::AreEqual(t1.intersect_triangle(list[i]), results[i]);
+		}
+
+		TEST_METHOD(test_intersect_segments)
+		{
+			constexpr triangle3 t1{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 4.0, 0.0, 0.0 }, vector3{ 0.0, 4.0, 0.0 } };
+			const vector3 points[] = {
+				vector3{ 1.0, 1.0, -1.0 }, vector3{ 1.0, 1.0, 1.0 },
+				vector3{ 3.0, 3.0, -1.0 }, vector3{ 3.0, 3.0, 1.0 },
+				vector3{ 1.0, 1.0, 1.0 }, vector3{ 1.0, 1.0, 2.0 }
+			};
+
+			bool results[3] = {};
+			Assert::AreEqual(size_t{ 1 }, intersect_segments(t1, points, 3, results));
+			Assert::IsTrue(results[0]);
+			Assert::IsFalse(results[1]);
+			Assert::IsFalse(results[2]);
+		}
+
+		TEST_METHOD(test_closest_triangle)
+		{
+			const triangle3 list[] = {
+				triangle3{ vector3{ 0.0, 0.0, 5.0 }, vector3{ 1.0, 0.0, 5.0 }, vector3{ 0.0, 1.0, 5.0 } },
+				triangle3{ vector3{ 0.0, 0.0, 1.0 }, vector3{ 1.0, 0.0, 1.0 }, vector3{ 0.0, 1.0, 1.0 } },
+				triangle3{ vector3{ 0.0, 0.0, -2.0 }, vector3{ 1.0, 0.0, -2.0 }, vector3{ 0.0, 1.0, -2.0 } }
+			};
+
+			double d2 = std::numeric_limits<double>::infinity();
+			vector3 closest;
+			Assert::AreEqual(size_t{ 1 }, closest_triangle(list, 3, vector3{ 0.25, 0.25, 0.0 }, d2, &closest));
+			Assert::AreEqual(1.0, d2);
+			Assert::IsTrue(closest == vector3{ 0.25, 0.25, 1.0 });
+
+			// Nothing closer than the incoming distance
+			d2 = 0.5;
+			Assert::AreEqual(size_t{ 3 }, closest_triangle(list, 3, vector3{ 0.25, 0.25, 0.0 }, d2));
+			Assert::AreEqual(0.5, d2);
+
+			// Batched points match the single point query
+			const vector3 points[] = { vector3{ 2.0, 2.0, 7.0 }, vector3{ 0.1, 0.2, 3.0 }, vector3{ -1.0, 0.5, 5.0 } };
+			vector3 results[3];
+			closest_points(list[0], points, 3, results);
+			for (int i = 0; i < 3; ++i)
+				Assert::IsTrue(results[i] == list[0].closest_point(points[i]));
+		}
+	};
+}
@@ -0,0 +1,229 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_primitives.hpp"
+#include "mesh/mesh_uv.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_uv)
+	{
+		static double uv_area(const vector2& p_a, const vector2& p_b, const vector2& p_c)
+		{
+			return 0.5 * ((p_b.x - p_a.x) * (p_c.y - p_a.y) - (p_b.y - p_a.y) * (p_c.x - p_a.x));
+		}
+
+		/// Check the atlas is in range, unflipped, consistent at shared vertices and has disjoint chart rectangles
+		static void check_atlas(const indexed_mesh& p_mesh, const uv_atlas& p_atlas, const unwrap_options& p_options)
+		{
+			Assert::AreEqual(p_mesh.indices.size(), p_atlas.uvs.size());
+			Assert::AreEqual(p_mesh.triangle_count(), p_atlas.charts.size());
+			std::vector<vector2> low(p_atlas.chart_count, vector2(2.0, 2.0));
+			std::vector<vector2> high(p_atlas.chart_count, vector2(-1.0, -1.0));
+			for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+			{
+				const std::uint32_t c = p_atlas.charts[t];
+				Assert::IsTrue(c < p_atlas.chart_count);
+				Assert::IsTrue(uv_area(p_atlas.uvs[t * 3], p_atlas.uvs[t * 3 + 1], p_atlas.uvs[t * 3 + 2]) > 0.0);
+				for (std::size_t i = t * 3; i < t * 3 + 3; ++i)
+				{
+					const vector2& p = p_atlas.uvs[i];
+					Assert::IsTrue(p.x >= 0.0 && p.x <= 1.0 && p.y >= 0.0 && p.y <= 1.0);
+					low[c] = vector2(std::min(low[c].x, p.x), std::min(low[c].y, p.y));
+					high[c] = vector2(std::max(high[c].x, p.x), std::max(high[c].y, p.y));
+				}
+			}
+
+			// Corners of one vertex within a chart share their coordinates
+			std::vector<std::vector<std::pair<std::uint32_t, vector2>>> seen(p_mesh.vertex_count());
+			for (std::size_t i = 0; i < p_mesh.indices.size(); ++i)
+			{
+				for (const auto& s : seen[p_mesh.indices[i]])
+				{
+					if (s.first == p_atlas.charts[i / 3])
+						Assert::IsTrue((s.second - p_atlas.uvs[i]).length() < 1e-12);
+				}
+				seen[p_mesh.indices[i]].emplace_back(p_atlas.charts[i / 3], p_atlas.uvs[i]);
+			}
+
+			// Chart rectangles are separated by the padding
+			const double gap = (p_options.padding - 1e-6) / p_options.resolution;
+			for (std::size_t a = 0; a < p_atlas.chart_count; ++a)
+			{
+				for (std::size_t b = a + 1; b < p_atlas.chart_count; ++b)
+				{
+					const bool apart = low[a].x >= high[b].x + gap || low[b].x >= high[a].x + gap || low[a].y >= high[b].y + gap || low[b].y >= high[a].y + gap;
+					Assert::IsTrue(apart);
+				}
+			}
+		}
+
+	public:
+		TEST_METHOD(test_skyline_packer)
+		{
+			skyline_packer packer(64, 64);
+			std::vector<std::pair<packed_rect, std::pair<std::uint32_t, std::uint32_t>>> placed;
+			std::uint32_t seed = 7;
+			for (int i = 0; i < 400; ++i)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				const std::uint32_t w = 1 + (seed >> 8) % 9;
+				const std::uint32_t h = 1 + (seed >> 16) % 5;
+				packed_rect r;
+				if (!packer.insert(w, h, r))
+					continue;
+				if (r.rotated)
+					placed.emplace_back(r, std::make_pair(h, w));
+				else
+					placed.emplace_back(r, std::make_pair(w, h));
+			}
+			Assert::IsTrue(placed.size() > 200 && placed.size() < 400);
+			Assert::IsTrue(packer.occupancy() > 0.9 && packer.occupancy() <= 1.0);
+			for (std::size_t a = 0; a < placed.size(); ++a)
+			{
+				const packed_rect& ra = placed[a].first;
+				Assert::IsTrue(ra.x + placed[a].second.first <= 64 && ra.y + placed[a].second.second <= 64);
+				for (std::size_t b = a + 1; b < placed.size(); ++b)
+				{
+					const packed_rect& rb = placed[b].first;
+					const bool apart = ra.x + placed[a].second.first <= rb.x || rb.x + placed[b].second.first <= ra.x ||
+						ra.y + placed[a].second.second <= rb.y || rb.y + placed[b].second.second <= ra.y;
+					Assert::IsTrue(apart);
+				}
+			}
+
+			packed_rect r;
+			Assert::IsFalse(skyline_packer(8, 8).insert(9, 1, r));
+			Assert::IsTrue(skyline_packer(8, 8).insert(1, 8, r));
+		}
+
+		TEST_METHOD(test_box)
+		{
+			// One chart per face, each an exact isometry
+			const indexed_mesh box = make_box(vector3{ 1.0, 2.0, 3.0 }).to_mesh();
+			const unwrap_options options;
+			const uv_atlas atlas = unwrap_uv(box, options);
+			Assert::AreEqual(size_t{ 6 }, atlas.chart_count);
+			Assert::IsTrue(atlas.ok);
+			check_atlas(box, atlas, options);
+			for (std::size_t t = 0; t < box.triangle_count(); ++t)
+			{
+				const double area = uv_area(atlas.uvs[t * 3], atlas.uvs[t * 3 + 1], atlas.uvs[t * 3 + 2]) * options.resolution * options.resolution;
+				const double surface = 0.5 * box.triangle(t).normal().length() * atlas.texels_per_unit * atlas.texels_per_unit;
+				Assert::AreEqual(surface, area, surface * 1e-9);
+			}
+			Assert::IsTrue(atlas.utilization > 0.4 && atlas.utilization < 1.0);
+		}
+
+		TEST_METHOD(test_conformal)
+		{
+			// A bent grid is developable, so its conformal map keeps every angle
+			indexed_mesh mesh = make_grid<24, 16>(3.0, 2.0).to_mesh();
+			for (auto& v : mesh.vertices)
+				v = vector3(2.0 * std::sin(v.x / 2.0), v.y, 2.0 * std::cos(v.x / 2.0));
+			std::vector<std::uint32_t> charts;
+			Assert::AreEqual(size_t{ 1 }, segment_charts(mesh, charts, 1.0));
+			const std::vector<vector2> uvs = parameterize_charts(mesh, charts, 1);
+			for (std::size_t t = 0; t < mesh.triangle_count(); ++t)
+			{
+				const triangle3 tri = mesh.triangle(t);
+				const vector3 p[3] = { tri.point1, tri.point2, tri.point3 };
+				for (std::size_t c = 0; c < 3; ++c)
+				{
+					const vector3 a = p[(c + 1) % 3] - p[c];
+					const vector3 b = p[(c + 2) % 3] - p[c];
+					const vector2 ua = uvs[t * 3 + (c + 1) % 3] - uvs[t * 3 + c];
+					const vector2 ub = uvs[t * 3 + (c + 2) % 3] - uvs[t * 3 + c];
+					const double angle = std::acos(a.dot(b) / (a.length() * b.length()));
+					const double uv_angle = std::acos(ua.dot(ub) / (ua.length() * ub.length()));
+					Assert::AreEqual(angle, uv_angle, 1e-5);
+				}
+			}
+		}
+
+		TEST_METHOD(test_sphere)
+		{
+			const indexed_mesh sphere = make_icosphere<3>(1.0).to_mesh();
+			unwrap_options options;
+			options.resolution = 512;
+			options.padding = 4;
+			const uv_atlas atlas = unwrap_uv(sphere, options);
+			Assert::IsTrue(atlas.chart_count > 4 && atlas.chart_count < sphere.triangle_count() / 10);
+			check_atlas(sphere, atlas, options);
+
+			// Charts are connected, so every chart is reached from its first triangle
+			const std::vector<std::uint32_t> neighbors = compute_edge_adjacency(sphere);
+			std::vector<bool> reached(sphere.triangle_count(), false);
+			for (std::size_t c = 0; c < atlas.chart_count; ++c)
+			{
+				std::vector<std::size_t> stack;
+				for (std::size_t t = 0; t < sphere.triangle_count() && stack.empty(); ++t)
+				{
+					if (atlas.charts[t] == c)
+						stack.push_back(t);
+				}
+				Assert::IsFalse(stack.empty());
+				reached[stack[0]] = true;
+				while (!stack.empty())
+				{
+					const std::size_t t = stack.back();
+					stack.pop_back();
+					for (std::size_t e = t * 3; e < t * 3 + 3; ++e)
+					{
+						if (atlas.charts[neighbors[e]] == c && !reached[neighbors[e]])
+						{
+							reached[neighbors[e]] = true;
+							stack.push_back(neighbors[e]);
+						}
+					}
+				}
+			}
+			for (const bool r : reached)
+				Assert::IsTrue(r);
+		}
+
+		TEST_METHOD(test_deterministic)
+		{
+			const indexed_mesh sphere = make_icosphere<4>(1.0).to_mesh();
+			set_thread_count(1);
+			const uv_atlas serial = unwrap_uv(sphere);
+			set_thread_count(4);
+			const uv_atlas threaded = unwrap_uv(sphere);
+			set_thread_count(0);
+			Assert::IsTrue(serial.charts == threaded.charts);
+			Assert::IsTrue(serial.uvs == threaded.uvs);
+		}
+
+		TEST_METHOD(test_atlas_full)
+		{
+			// One chart per triangle: 320 charts of at least 3x3 texels cannot fit in 30x30
+			const indexed_mesh sphere = make_icosphere<2>(1.0).to_mesh();
+			unwrap_options options;
+			options.max_chart_angle = 0.01;
+			options.resolution = 32;
+			const uv_atlas full = unwrap_uv(sphere, options);
+			Assert::AreEqual(sphere.triangle_count(), full.chart_count);
+			Assert::IsFalse(full.ok);
+			Assert::AreEqual(0.0, full.texels_per_unit);
+			Assert::AreEqual(sphere.indices.size(), full.uvs.size());
+
+			// A large enough atlas holds them
+			options.resolution = 256;
+			const uv_atlas packed = unwrap_uv(sphere, options);
+			Assert::IsTrue(packed.ok);
+			check_atlas(sphere, packed, options);
+		}
+
+		TEST_METHOD(test_empty)
+		{
+			const uv_atlas atlas = unwrap_uv(indexed_mesh{});
+			Assert::IsTrue(atlas.ok);
+			Assert::AreEqual(size_t{ 0 }, atlas.chart_count);
+			Assert::IsTrue(atlas.uvs.empty() && atlas.charts.empty());
+		}
+	};
+}
@@ -38,6 +38,9 @@ namespace mesh_tests
 
 			constexpr vector3 v2{ 3.0, 4.0, 12.0 };
 			Assert::AreEqual(13.0, v2.length());
+
+			constexpr double length = v2.length();
+			static_assert(length == 13.0, "constexpr length");
 		}
 
 		TEST_METHOD(test_dot)
@@ -63,6 +66,11 @@ namespace mesh_tests
 			constexpr vector3 v2{ 352.0, 360.0, 864.0 };
 			constexpr vector3 v3{ 0.352, 0.360, 0.864 };
 			Assert::IsTrue(v2.normalized().is_equal_approx(v3));
+
+			constexpr vector3 v4 = v2.normalized();
+			Assert::AreEqual(v3.x, v4.x, 1e-15);
+			Assert::AreEqual(v3.y, v4.y, 1e-15);
+			Assert::AreEqual(v3.z, v4.z, 1e-15);
 		}
 
 		TEST_METHOD(test_lerp)
@@ -0,0 +1,163 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_vertex_cache.hpp"
+
+#include <algorithm>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_vertex_cache)
+	{
+		/// Make a grid of quads with shuffled triangle order
+		static indexed_mesh make_grid(const std::uint32_t p_size, const unsigned int p_seed)
+		{
+			indexed_mesh mesh;
+			for (std::uint32_t y = 0; y <= p_size; ++y)
+				for (std::uint32_t x = 0; x <= p_size; ++x)
+					mesh.add_vertex(vector3{ static_cast<double>(x), static_cast<double>(y), 0.0 });
+
+			std::vector<std::uint32_t> quads(p_size * p_size);
+			for (std::uint32_t i = 0; i < quads.size(); ++i)
+				quads[i] = i;
+			std::shuffle(quads.begin(), quads.end(), std::mt19937(p_seed));
+			for (const std::uint32_t q : quads)
+			{
+				const std::uint32_t x = q % p_size;
+				const std::uint32_t y = q / p_size;
+				const std::uint32_t i = y * (p_size + 1) + x;
+				mesh.add_triangle(i, i + 1, i + p_size + 2);
+				mesh.add_triangle(i, i + p_size + 2, i + p_size + 1);
+			}
+			return mesh;
+		}
+
+		/// Get the triangles of a mesh as sorted, rotation-normalized position triples
+		static std::vector<std::vector<double>> canonical(const indexed_mesh& p_mesh)
+		{
+			std::vector<std::vector<double>> result;
+			for (std::size_t t = 0; t < p_mesh.triangle_count(); ++t)
+			{
+				const triangle3 tri = p_mesh.triangle(t);
+				std::vector<vector3> p = { tri.point1, tri.point2, tri.point3 };
+				std::rotate(p.begin(), std::min_element(p.begin(), p.end()), p.end());
+				result.push_back({ p[0].x, p[0].y, p[0].z, p[1].x, p[1].y, p[1].z, p[2].x, p[2].y, p[2].z });
+			}
+			std::sort(result.begin(), result.end());
+			return result;
+		}
+
+	public:
+		TEST_METHOD(test_analyze)
+		{
+			indexed_mesh mesh;
+			for (int i = 0; i < 4; ++i)
+				mesh.add_vertex(vector3{ static_cast<double>(i), 0.0, 0.0 });
+			mesh.add_triangle(0, 1, 2);
+			mesh.add_triangle(2, 1, 3);
+
+			const auto stats = analyze_vertex_cache(mesh, 16);
+			Assert::AreEqual(size_t{ 4 }, stats.transformed);
+			Assert::AreEqual(2.0, stats.acmr);
+			Assert::AreEqual(1.0, stats.atvr);
+
+			// A three-entry cache evicts vertices 0 and 1 before the third triangle uses them again
+			mesh.add_triangle(0, 3, 1);
+			Assert::AreEqual(size_t{ 6 }, analyze_vertex_cache(mesh, 3).transformed);
+		}
+
+		TEST_METHOD(test_optimize_vertex_cache)
+		{
+			indexed_mesh mesh = make_grid(40, 1);
+			const auto expected = canonical(mesh);
+
+			std::vector<std::uint32_t> clusters;
+			const auto report = optimize_vertex_cache(mesh, 16, &clusters);
+			Assert::IsTrue(canonical(mesh) == expected);
+			Assert::IsTrue(report.before.acmr > 1.5);
+			Assert::IsTrue(report.after.acmr < 0.8);
+			Assert::IsTrue(report.after.atvr < 1.4);
+			Assert::AreEqual(report.after.acmr, analyze_vertex_cache(mesh, 16).acmr);
+
+			Assert::IsFalse(clusters.empty());
+			Assert::AreEqual(0u, clusters[0]);
+			Assert::IsTrue(std::is_sorted(clusters.begin(), clusters.end()));
+		}
+
+		TEST_METHOD(test_optimize_overdraw)
+		{
+			// Closed box: six faces of gridded quads
+			indexed_mesh mesh;
+			const std::uint32_t n = 8;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				for (int side = 0; side < 2; ++side)
+				{
+					const std::uint32_t base = static_cast<std::uint32_t>(mesh.vertex_count());
+					for (std::uint32_t j = 0; j <= n; ++j)
+					{
+						for (std::uint32_t i = 0; i <= n; ++i)
+						{
+							double p[3];
+							p[axis] = side ? 1.0 : 0.0;
+							p[(axis + 1) % 3] = static_cast<double>(i) / n;
+							p[(axis + 2) % 3] = static_cast<double>(j) / n;
+							mesh.add_vertex(vector3{ p[0], p[1], p[2] });
+						}
+					}
+					for (std::uint32_t j = 0; j < n; ++j)
+					{
+						for (std::uint32_t i = 0; i < n; ++i)
+						{
+							const std::uint32_t a = base + j * (n + 1) + i;
+							if (side)
+							{
+								mesh.add_triangle(a, a + 1, a + n + 2);
+								mesh.add_triangle(a, a + n + 2, a + n + 1);
+							}
+							else
+							{
+								mesh.add_triangle(a, a + n + 2, a + 1);
+								mesh.add_triangle(a, a + n + 1, a + n + 2);
+							}
+						}
+					}
+				}
+			}
+
+			const auto expected = canonical(mesh);
+			std::vector<std::uint32_t> clusters;
+			const auto cache = optimize_vertex_cache(mesh, 16, &clusters);
+			const auto report = optimize_overdraw(mesh, clusters, 16, 1.05);
+			Assert::IsTrue(canonical(mesh) == expected);
+			Assert::AreEqual(cache.after.acmr, report.before.acmr);
+			Assert::IsTrue(report.after.acmr <= report.before.acmr * 1.25);
+		}
+
+		TEST_METHOD(test_optimize_vertex_fetch)
+		{
+			indexed_mesh mesh = make_grid(10, 2);
+			mesh.add_vertex(vector3{ 100.0, 100.0, 100.0 });
+			optimize_vertex_cache(mesh);
+			const auto expected = canonical(mesh);
+			const std::size_t vertices = mesh.vertex_count();
+
+			const auto remap = optimize_vertex_fetch(mesh);
+			Assert::AreEqual(vertices, remap.size());
+			Assert::AreEqual(UINT32_MAX, remap.back());
+			Assert::AreEqual(vertices - 1, mesh.vertex_count());
+			Assert::IsTrue(canonical(mesh) == expected);
+
+			// Each index is at most one past the largest index seen before it
+			std::uint32_t next = 0;
+			for (const std::uint32_t i : mesh.indices)
+			{
+				Assert::IsTrue(i <= next);
+				if (i == next)
+					++next;
+			}
+		}
+	};
+}
@@ -0,0 +1,233 @@
+#include "CppUnitTest.h"
+#include "mesh/mesh_primitives.hpp"
+#include "mesh/mesh_voxel.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace mesh;
+
+namespace mesh_tests
+{
+	TEST_CLASS(mesh_voxel)
+	{
+		/// Build a closed box mesh with outward-facing triangles
+		static indexed_mesh make_box(const vector3& p_min, const vector3& p_max)
+		{
+			indexed_mesh m;
+			for (int i = 0; i < 8; ++i)
+			{
+				m.add_vertex(vector3{
+					(i & 1) ? p_max.x : p_min.x,
+					(i & 2) ? p_max.y : p_min.y,
+					(i & 4) ? p_max.z : p_min.z });
+			}
+
+			const std::uint32_t faces[] = {
+				0, 4, 6, 0, 6, 2,
+				1, 3, 7, 1, 7, 5,
+				0, 1, 5, 0, 5, 4,
+				2, 6, 7, 2, 7, 3,
+				0, 2, 3, 0, 3, 1,
+				4, 5, 7, 4, 7, 6
+			};
+			m.indices.assign(std::begin(faces), std::end(faces));
+			return m;
+		}
+
+		/// Closed, bumpy sphere
+		static indexed_mesh make_blob()
+		{
+			indexed_mesh m = make_icosphere<3>(1.0).to_mesh();
+			for (std::size_t v = 0; v < m.vertex_count(); ++v)
+				m.vertices[v] *= 1.0 + 0.2 * std::sin(static_cast<double>(v) * 0.7);
+			return m;
+		}
+
+		/// Check a grid against voxels touching the surface or, for convex solids, the interior
+		template <typename TGrid>
+		static void check_against_triangles(const TGrid& p_grid, const indexed_mesh& p_mesh, const std::size_t p_size_x, const std::size_t p_size_y, const std::size_t p_size_z)
+		{
+			for (std::size_t k = 0; k < p_size_z; ++k)
+			{
+				for (std::size_t j = 0; j < p_size_y; ++j)
+				{
+					for (std::size_t i = 0; i < p_size_x; ++i)
+					{
+						bool touched = false;
+						for (std::size_t t = 0; t < p_mesh.triangle_count() && !touched; ++t)
+							touched = intersect_triangle_aabb(p_mesh.triangle(t), p_grid.voxel_bounds(i, j, k));
+						Assert::AreEqual(touched, p_grid.get(i, j, k));
+					}
+				}
+			}
+		}
+
+	public:
+		TEST_METHOD(test_intersect_triangle_aabb)
+		{
+			const aabb3 box{ vector3{ 0.0, 0.0, 0.0 }, vector3{ 1.0, 1.0, 1.0 } };
+			const triangle3 t1{ vector3{ -1.0, 0.5, -1.0 }, vector3{ 2.0, 0.5, -1.0 }, vector3{ 0.5, 0.5, 2.0 } };
+			Assert::IsTrue(intersect_triangle_aabb(t1, box));
+
+			// Touching a face counts
+			const triangle3 t2{ vector3{ 1.0, -1.0, -1.0 }, vector3{ 1.0, 2.0, -1.0 }, vector3{ 1.0, 0.5, 2.0 } };
+			Assert::IsTrue(intersect_triangle_aabb(t2, box));
+
+			// Bounding boxes and plane overlap, but an edge cross axis separates
+			const triangle3 t3{ vector3{ 2.6, -0.5, 0.5 }, vector3{ -0.5, 2.6, 0.5 }, vector3{ 3.0, 3.0, 0.5 } };
+			Assert::IsFalse(intersect_triangle_aabb(t3, box));
+			const triangle3 t4{ vector3{ 2.4, -0.5, 0.5 }, vector3{ -0.5, 2.4, 0.5 }, vector3{ 3.0, 3.0, 0.5 } };
+			Assert::IsTrue(intersect_triangle_aabb(t4, box));
+
+			// Plane separates
+			const triangle3 t5{ vector3{ 2.0, 0.0, 0.0 }, vector3{ 0.0, 2.0, 0.0 }, vector3{ 0.0, 0.0, 2.0 } };
+			Assert::IsTrue(intersect_triangle_aabb(t5, box));
+			const triangle3 t6{ vector3{ 3.1, 0.0, 0.0 }, vector3{ 0.0, 3.1, 0.0 }, vector3{ 0.0, 0.0, 3.1 } };
+			Assert::IsFalse(intersect_triangle_aabb(t6, box));
+		}
+
+		TEST_METHOD(test_surface)
+		{
+			const indexed_mesh blob = make_blob();
+			voxel_options options;
+			options.voxel_size = 0.13;
+
+			const voxel_grid g1 = voxelize(blob, options);
+			Assert::IsTrue(g1.count() > 0);
+			check_against_triangles(g1, blob, g1.size_x, g1.size_y, g1.size_z);
+
+			// Sparse sizes round up to whole blocks
+			const sparse_voxel_grid g2 = voxelize_sparse(blob, options);
+			Assert::AreEqual(std::size_t{ 0 }, g2.size_x % sparse_voxel_grid::block_size);
+			Assert::IsTrue(g2.size_x >= g1.size_x);
+			check_against_triangles(g2, blob, g2.size_x, g2.size_y, g2.size_z);
+			Assert::AreEqual(g1.count(), g2.count());
+		}
+
+		TEST_METHOD(test_solid_box)
+		{
+			const vector3 minimum{ 0.3, 0.3, 0.3 };
+			const vector3 maximum{ 4.7, 3.2, 2.7 };
+			const indexed_mesh box = make_box(minimum, maximum);
+			voxel_options options;
+			options.voxel_size = 0.25;
+			options.fill = voxel_fill::solid;
+
+			// A convex solid marks exactly the voxels touching it
+			const aabb3 solid{ minimum, maximum };
+			const voxel_grid g1 = voxelize(box, options);
+			const sparse_voxel_grid g2 = voxelize_sparse(box, options);
+			for (std::size_t k = 0; k < g2.size_z; ++k)
+			{
+				for (std::size_t j = 0; j < g2.size_y; ++j)
+				{
+					for (std::size_t i = 0; i < g2.size_x; ++i)
+					{
+						const bool expected = solid.intersects(g2.voxel_bounds(i, j, k));
+						Assert::AreEqual(expected, g2.get(i, j, k));
+						if (i < g1.size_x && j < g1.size_y && k < g1.size_z)
+							Assert::AreEqual(expected, g1.get(i, j, k));
+					}
+				}
+			}
+			Assert::AreEqual(g1.count(), g2.count());
+		}
+
+		TEST_METHOD(test_solid_sphere)
+		{
+			const indexed_mesh sphere = make_icosphere<4>(1.0).to_mesh();
+			voxel_options options;
+			options.voxel_size = 0.02;
+			options.fill = voxel_fill::solid;
+
+			const voxel_grid g1 = voxelize(sphere, options);
+			const sparse_voxel_grid g2 = voxelize_sparse(sphere, options);
+			Assert::AreEqual(g1.count(), g2.count());
+			// Conservative surface voxels add about half a voxel shell
+			Assert::IsTrue(g1.volume() > 4.0 / 3.0 * 3.14159265358979);
+			Assert::IsTrue(g1.volume() < 4.0 / 3.0 * 3.14159265358979 + 4.0 * 3.14159265358979 * options.voxel_size);
+			for (std::size_t k = 0; k < g1.size_z; ++k)
+			{
+				for (std::size_t j = 0; j < g1.size_y; ++j)
+				{
+					for (std::size_t i = 0; i < g1.size_x; ++i)
+					{
+						const double r = g1.voxel_bounds(i, j, k).center().length();
+						if (r < 0.95)
+							Assert::IsTrue(g1.get(i, j, k));
+						else if (r > 1.05)
+							Assert::IsFalse(g1.get(i, j, k));
+						Assert::AreEqual(g1.get(i, j, k), g2.get(i, j, k));
+					}
+				}
+			}
+
+			// Interior blocks become full tiles
+			std::size_t full = 0;
+			for (const std::int32_t block : g2.block_table)
+				full += block == sparse_voxel_grid::full_tile ? 1 : 0;
+			Assert::IsTrue(full > 0);
+			Assert::IsTrue(g2.block_count() + full < g2.block_table.size());
+		}
+
+		TEST_METHOD(test_sparse_2048)
+		{
+			const indexed_mesh sphere = make_icosphere<4>(1.0).to_mesh();
+			voxel_options options;
+			options.voxel_size = 2.0 / 2048.0;
+			options.fill = voxel_fill::solid;
+			const sparse_voxel_grid g1 = voxelize_sparse(sphere, options);
+			Assert::IsTrue(g1.size_x >= 2048);
+
+			// Only surface blocks are stored
+			Assert::IsTrue(g1.block_count() * 20 < g1.block_table.size());
+			Assert::AreEqual(4.0 / 3.0 * 3.14159265358979, g1.volume(), 0.02);
+			Assert::IsTrue(g1.get(g1.size_x / 2, g1.size_y / 2, g1.size_z / 2));
+			Assert::IsFalse(g1.get(0, 0, 0));
+		}
+
+		TEST_METHOD(test_deterministic)
+		{
+			const indexed_mesh blob = make_blob();
+			voxel_options options;
+			options.voxel_size = 0.01;
+			options.fill = voxel_fill::solid;
+			set_thread_count(1);
+			const voxel_grid g1 = voxelize(blob, options);
+			const sparse_voxel_grid g2 = voxelize_sparse(blob, options);
+			set_thread_count(4);
+			const voxel_grid g3 = voxelize(blob, options);
+			const sparse_voxel_grid g4 = voxelize_sparse(blob, options);
+			set_thread_count(0);
+			Assert::IsTrue(g1.bits == g3.bits);
+			Assert::IsTrue(g2.block_table == g4.block_table);
+			Assert::IsTrue(g2.block_bits == g4.block_bits);
+			Assert::AreEqual(g1.count(), g2.count());
+		}
+
+		TEST_METHOD(test_empty)
+		{
+			const voxel_grid g1 = voxelize(indexed_mesh{});
+			Assert::AreEqual(std::size_t{ 0 }, g1.count());
+			const sparse_voxel_grid g2 = voxelize_sparse(indexed_mesh{});
+			Assert::AreEqual(std::size_t{ 0 }, g2.count());
+			Assert::AreEqual(std::size_t{ 0 }, g2.block_count());
+
+			// Voxel sizes that are not positive and finite give empty grids too
+			const indexed_mesh box = make_box(vector3{ -1.0, -1.0, -1.0 }, vector3{ 1.0, 1.0, 1.0 });
+			for (const double size : { 0.0, -0.5, std::nan(""), std::numeric_limits<double>::infinity() })
+			{
+				voxel_options options;
+				options.voxel_size = size;
+				const voxel_grid dense = voxelize(box, options);
+				Assert::AreEqual(std::size_t{ 0 }, dense.size_x * dense.size_y * dense.size_z);
+				Assert::AreEqual(std::size_t{ 0 }, dense.count());
+				const sparse_voxel_grid sparse = voxelize_sparse(box, options);
+				Assert::AreEqual(std::size_t{ 0 }, sparse.block_count());
+				Assert::AreEqual(std::size_t{ 0 }, sparse.count());
+			}
+		}
+	};
+}
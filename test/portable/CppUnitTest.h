@@ -0,0 +1,240 @@
+#pragma once
+
+// Portable stand-in for the Microsoft C++ unit test framework header.
+//
+// Implements the subset used by test/mstest (TEST_CLASS, TEST_METHOD and the
+// Assert functions) with the same signatures, so the test sources build
+// unchanged with any C++17 compiler. Tests register themselves at static
+// initialization and are run by test_main.cpp.
+
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Microsoft
+{
+    namespace VisualStudio
+    {
+        namespace CppUnitTestFramework
+        {
+            /// Failed assertion
+            class assert_failure : public std::runtime_error
+            {
+            public:
+                using std::runtime_error::runtime_error;
+            };
+
+            /// Registered test method
+            struct test_entry
+            {
+                std::string class_name;             ///< Test class name
+                std::string method_name;            ///< Test method name
+                void (*run)();                      ///< Creates the test class and runs the method
+            };
+
+            /// Get the registered test methods
+            inline std::vector<test_entry>& test_registry()
+            {
+                static std::vector<test_entry> registry;
+                return registry;
+            }
+
+            namespace internal
+            {
+                template <typename T, typename = void>
+                struct is_streamable : std::false_type
+                {
+                };
+
+                template <typename T>
+                struct is_streamable<T, std::void_t<decltype(std::declval<std::ostream&>() << std::declval<const T&>())>> : std::true_type
+                {
+                };
+
+                /// Format a value for a failure message
+                template <typename T>
+                std::string to_string(const T& p_value)
+                {
+                    if constexpr (std::is_same<T, bool>::value)
+                        return p_value ? "true" : "false";
+                    else if constexpr (is_streamable<T>::value)
+                    {
+                        std::ostringstream stream;
+                        stream.precision(17);
+                        stream << p_value;
+                        return stream.str();
+                    }
+                    else
+                        return "<value>";
+                }
+
+                /// Convert an optional wide message to narrow text
+                inline std::string narrow(const wchar_t* p_message)
+                {
+                    std::string result;
+                    for (; p_message && *p_message; ++p_message)
+                        result.push_back(*p_message < 128 ? static_cast<char>(*p_message) : '?');
+                    return result;
+                }
+
+                /// Throw an assertion failure
+                [[noreturn]] inline void fail(const std::string& p_what, const wchar_t* p_message)
+                {
+                    const std::string message = narrow(p_message);
+                    throw assert_failure(message.empty() ? p_what : p_what + " - " + message);
+                }
+
+                /// Registers a test method at static initialization
+                struct test_registrar
+                {
+                    test_registrar(const char* p_class, const char* p_method, void (*p_run)())
+                    {
+                        test_registry().push_back(test_entry{ p_class, p_method, p_run });
+                    }
+                };
+            }
+
+            /// Assertions, throwing assert_failure when they do not hold
+            class Assert
+            {
+            public:
+                template <typename T>
+                static void AreEqual(const T& p_expected, const T& p_actual, const wchar_t* p_message = nullptr)
+                {
+                    if (!(p_expected == p_actual))
+                        internal::fail("AreEqual failed: expected " + internal::to_string(p_expected) + ", actual " + internal::to_string(p_actual), p_message);
+                }
+
+                static void AreEqual(const double p_expected, const double p_actual, const double p_tolerance, const wchar_t* p_message = nullptr)
+                {
+                    if (!(std::abs(p_expected - p_actual) <= std::abs(p_tolerance)))
+                        internal::fail("AreEqual failed: expected " + internal::to_string(p_expected) + ", actual " + internal::to_string(p_actual) + ", tolerance " + internal::to_string(p_tolerance), p_message);
+                }
+
+                static void AreEqual(const float p_expected, const float p_actual, const float p_tolerance, const wchar_t* p_message = nullptr)
+                {
+                    AreEqual(static_cast<double>(p_expected), static_cast<double>(p_actual), static_cast<double>(p_tolerance), p_message);
+                }
+
+                static void AreEqual(const char* p_expected, const char* p_actual, const bool p_ignore_case = false, const wchar_t* p_message = nullptr)
+                {
+                    std::string expected(p_expected ? p_expected : "");
+                    std::string actual(p_actual ? p_actual : "");
+                    if (p_ignore_case)
+                    {
+                        for (auto& c : expected)
+                            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                        for (auto& c : actual)
+                            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                    }
+                    if (expected != actual)
+                        internal::fail("AreEqual failed: expected \"" + expected + "\", actual \"" + actual + "\"", p_message);
+                }
+
+                template <typename T>
+                static void AreNotEqual(const T& p_not_expected, const T& p_actual, const wchar_t* p_message = nullptr)
+                {
+                    if (p_not_expected == p_actual)
+                        internal::fail("AreNotEqual failed: both " + internal::to_string(p_actual), p_message);
+                }
+
+                template <typename T>
+                static void AreSame(const T& p_expected, const T& p_actual, const wchar_t* p_message = nullptr)
+                {
+                    if (&p_expected != &p_actual)
+                        internal::fail("AreSame failed", p_message);
+                }
+
+                static void IsTrue(const bool p_condition, const wchar_t* p_message = nullptr)
+                {
+                    if (!p_condition)
+                        internal::fail("IsTrue failed", p_message);
+                }
+
+                static void IsFalse(const bool p_condition, const wchar_t* p_message = nullptr)
+                {
+                    if (p_condition)
+                        internal::fail("IsFalse failed", p_message);
+                }
+
+                template <typename T>
+                static void IsNull(const T* p_pointer, const wchar_t* p_message = nullptr)
+                {
+                    if (p_pointer != nullptr)
+                        internal::fail("IsNull failed", p_message);
+                }
+
+                template <typename T>
+                static void IsNotNull(const T* p_pointer, const wchar_t* p_message = nullptr)
+                {
+                    if (p_pointer == nullptr)
+                        internal::fail("IsNotNull failed", p_message);
+                }
+
+                [[noreturn]] static void Fail(const wchar_t* p_message = nullptr)
+                {
+                    internal::fail("Fail", p_message);
+                }
+
+                template <typename TException, typename TFunc>
+                static void ExpectException(TFunc p_func, const wchar_t* p_message = nullptr)
+                {
+                    try
+                    {
+                        p_func();
+                    }
+                    catch (const TException&)
+                    {
+                        return;
+                    }
+                    catch (...)
+                    {
+                        internal::fail("ExpectException failed: another exception was thrown", p_message);
+                    }
+                    internal::fail("ExpectException failed: nothing was thrown", p_message);
+                }
+            };
+
+            /// Diagnostic output
+            class Logger
+            {
+            public:
+                static void WriteMessage(const char* p_message)
+                {
+                    std::fputs(p_message, stdout);
+                }
+
+                static void WriteMessage(const wchar_t* p_message)
+                {
+                    std::fputs(internal::narrow(p_message).c_str(), stdout);
+                }
+            };
+
+            /// Base of every test class, giving test methods the class type and name
+            template <typename TClass, typename TName>
+            class test_class
+            {
+            protected:
+                using test_class_type = TClass;
+                using test_class_name = TName;
+            };
+        }
+    }
+}
+
+#define TEST_CLASS(p_class) \
+    struct p_class##_test_name { static const char* get() { return #p_class; } }; \
+    class p_class : public ::Microsoft::VisualStudio::CppUnitTestFramework::test_class<p_class, p_class##_test_name>
+
+#define TEST_METHOD(p_method) \
+    static void p_method##_test_run() { test_class_type instance; instance.p_method(); } \
+    inline static const ::Microsoft::VisualStudio::CppUnitTestFramework::internal::test_registrar p_method##_test_registrar{ test_class_name::get(), #p_method, &p_method##_test_run }; \
+    void p_method()
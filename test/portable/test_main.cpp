@@ -0,0 +1,103 @@
+// Runs the tests in test/mstest without Visual Studio.
+//
+//     mesh_tests [--list] [--threads N] [filter...]
+//
+// A filter selects a test class (mesh_vector3) or one method
+// (mesh_vector3::test_add); without filters every test runs. --threads sets
+// the library thread count, so the same tests can be repeated serially and
+// with several workers. The exit code is non-zero if any test fails.
+
+#include "CppUnitTest.h"
+#include "mesh/mesh_parallel.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+    /// Check whether a test matches any of the filters
+    bool selected(const test_entry& p_test, const std::vector<std::string>& p_filters)
+    {
+        if (p_filters.empty())
+            return true;
+        for (const auto& filter : p_filters)
+        {
+            if (filter == p_test.class_name || filter == p_test.class_name + "::" + p_test.method_name)
+                return true;
+        }
+        return false;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> filters;
+    bool list = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--list")
+            list = true;
+        else if (arg == "--threads" && i + 1 < argc)
+            mesh::set_thread_count(static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10)));
+        else
+            filters.push_back(arg);
+    }
+
+    std::size_t run = 0;
+    std::size_t failed = 0;
+    for (const test_entry& test : test_registry())
+    {
+        if (!selected(test, filters))
+            continue;
+        if (list)
+        {
+            std::printf("%s::%s\n", test.class_name.c_str(), test.method_name.c_str());
+            continue;
+        }
+
+        ++run;
+        const auto start = std::chrono::steady_clock::now();
+        std::string error;
+        try
+        {
+            test.run();
+        }
+        catch (const assert_failure& e)
+        {
+            error = e.what();
+        }
+        catch (const std::exception& e)
+        {
+            error = std::string("unexpected exception: ") + e.what();
+        }
+        catch (...)
+        {
+            error = "unexpected exception";
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (error.empty())
+            std::printf("[ PASS ] %s::%s (%.1f ms)\n", test.class_name.c_str(), test.method_name.c_str(), ms);
+        else
+        {
+            ++failed;
+            std::printf("[ FAIL ] %s::%s: %s\n", test.class_name.c_str(), test.method_name.c_str(), error.c_str());
+        }
+    }
+
+    if (list)
+        return 0;
+    std::printf("%zu tests, %zu failed\n", run, failed);
+    if (run == 0)
+    {
+        std::printf("no tests matched\n");
+        return 1;
+    }
+    return failed == 0 ? 0 : 1;
+}